@@ -22,7 +22,205 @@
 #include "graph/node.h"
 
 namespace ge {
-Anchor::Anchor(const NodePtr &owner_node, int idx) : owner_node_(owner_node), idx_(idx) {}
+namespace {
+bool IsSamePeer(const std::weak_ptr<Anchor> &linked, const AnchorPtr &peer) {
+  return !linked.owner_before(peer) && !peer.owner_before(linked);
+}
+}  // namespace
+
+constexpr size_t AnchorLinks::kNoSlot;
+constexpr size_t AnchorLinks::kIndexMinSize;
+
+AnchorPtr AnchorLinks::front() const {
+  for (size_t i = head_; i < slots_.size(); ++i) {
+    if (slots_[i].anchor != nullptr) {
+      return slots_[i].peer.lock();
+    }
+  }
+  return nullptr;
+}
+
+void AnchorLinks::push_back(const AnchorPtr &peer) {
+  IncreaseVersion();
+  slots_.push_back({peer.get(), peer, kNoSlot});
+  ++size_;
+  if (indexed_) {
+    AddToIndex(slots_.size() - 1U);
+  } else if (slots_.size() >= kIndexMinSize) {
+    BuildIndex();
+  }
+}
+
+size_t AnchorLinks::Find(const AnchorPtr &peer) const {
+  if (peer == nullptr) {
+    return kNoSlot;
+  }
+  if (!indexed_) {
+    for (size_t i = 0U; i < slots_.size(); ++i) {
+      if ((slots_[i].anchor == peer.get()) && IsSamePeer(slots_[i].peer, peer)) {
+        return i;
+      }
+    }
+    return kNoSlot;
+  }
+  auto it = index_.find(peer.get());
+  if (it == index_.end()) {
+    return kNoSlot;
+  }
+  // an expired peer may have left its address to the new one
+  for (size_t pos = it->second.first; pos != kNoSlot; pos = slots_[pos].next) {
+    if (IsSamePeer(slots_[pos].peer, peer)) {
+      return pos;
+    }
+  }
+  return kNoSlot;
+}
+
+bool AnchorLinks::Erase(const AnchorPtr &peer) {
+  size_t pos = Find(peer);
+  if (pos == kNoSlot) {
+    return false;
+  }
+  EraseSlot(pos);
+  return true;
+}
+
+void AnchorLinks::EraseFront() {
+  for (size_t i = head_; i < slots_.size(); ++i) {
+    if (slots_[i].anchor != nullptr) {
+      EraseSlot(i);
+      return;
+    }
+  }
+}
+
+bool AnchorLinks::Replace(const AnchorPtr &old_peer, const AnchorPtr &new_peer) {
+  size_t pos = Find(old_peer);
+  if ((pos == kNoSlot) || (new_peer == nullptr)) {
+    return false;
+  }
+  IncreaseVersion();
+  if (indexed_) {
+    RemoveFromIndex(pos);
+  }
+  slots_[pos].anchor = new_peer.get();
+  slots_[pos].peer = new_peer;
+  slots_[pos].next = kNoSlot;
+  if (indexed_) {
+    AddToIndex(pos);
+  }
+  return true;
+}
+
+void AnchorLinks::EraseSlot(size_t pos) {
+  IncreaseVersion();
+  --size_;
+  if (!indexed_) {
+    (void)slots_.erase(slots_.begin() + static_cast<std::ptrdiff_t>(pos));
+    return;
+  }
+  RemoveFromIndex(pos);
+  slots_[pos].anchor = nullptr;
+  slots_[pos].peer.reset();
+  while ((head_ < slots_.size()) && (slots_[head_].anchor == nullptr)) {
+    ++head_;
+  }
+  // compact once empty slots outnumber the links
+  if ((slots_.size() - size_) > size_) {
+    Compact();
+  }
+}
+
+// Slots linked with the same peer are chained in link order
+void AnchorLinks::AddToIndex(size_t pos) {
+  auto ret = index_.emplace(slots_[pos].anchor, std::make_pair(pos, pos));
+  if (ret.second) {
+    return;
+  }
+  auto &range = ret.first->second;
+  if (pos > range.second) {
+    slots_[range.second].next = pos;
+    range.second = pos;
+  } else if (pos < range.first) {
+    slots_[pos].next = range.first;
+    range.first = pos;
+  } else {
+    size_t prev = range.first;
+    while (slots_[prev].next < pos) {
+      prev = slots_[prev].next;
+    }
+    slots_[pos].next = slots_[prev].next;
+    slots_[prev].next = pos;
+  }
+}
+
+void AnchorLinks::RemoveFromIndex(size_t pos) {
+  auto it = index_.find(slots_[pos].anchor);
+  if (it == index_.end()) {
+    return;
+  }
+  auto &range = it->second;
+  if (range.first == pos) {
+    if (slots_[pos].next == kNoSlot) {
+      (void)index_.erase(it);
+    } else {
+      range.first = slots_[pos].next;
+    }
+    return;
+  }
+  size_t prev = range.first;
+  while ((prev != kNoSlot) && (slots_[prev].next != pos)) {
+    prev = slots_[prev].next;
+  }
+  if (prev == kNoSlot) {
+    return;
+  }
+  slots_[prev].next = slots_[pos].next;
+  if (range.second == pos) {
+    range.second = prev;
+  }
+}
+
+void AnchorLinks::BuildIndex() {
+  index_.clear();
+  indexed_ = true;
+  for (size_t i = 0U; i < slots_.size(); ++i) {
+    if (slots_[i].anchor != nullptr) {
+      slots_[i].next = kNoSlot;
+      AddToIndex(i);
+    }
+  }
+}
+
+void AnchorLinks::IncreaseVersion() {
+  ++version_;
+  NodePtr node = (owner_ == nullptr) ? nullptr : owner_->GetOwnerNode();
+  if (node != nullptr) {
+    node->IncreaseAnchorsVersion();
+  }
+}
+
+void AnchorLinks::Compact() {
+  size_t live = 0U;
+  for (size_t i = head_; i < slots_.size(); ++i) {
+    if (slots_[i].anchor != nullptr) {
+      if (live != i) {
+        slots_[live] = std::move(slots_[i]);
+      }
+      ++live;
+    }
+  }
+  slots_.resize(live);
+  head_ = 0U;
+  if (slots_.size() >= kIndexMinSize / 2U) {
+    BuildIndex();
+  } else {
+    index_.clear();
+    indexed_ = false;
+  }
+}
+
+Anchor::Anchor(const NodePtr &owner_node, int idx) : peer_anchors_(this), owner_node_(owner_node), idx_(idx) {}
 
 bool Anchor::IsTypeOf(TYPE type) const { return strcmp(Anchor::TypeOf<Anchor>(), type) == 0; }
 
@@ -32,30 +230,24 @@ size_t Anchor::GetPeerAnchorsSize() const {
 
 Anchor::Vistor<AnchorPtr> Anchor::GetPeerAnchors() const {
   vector<AnchorPtr> ret;
-  for (const auto &anchor : peer_anchors_) {
-    ret.push_back(anchor.lock());
-  }
+  ret.reserve(peer_anchors_.size());
+  (void)peer_anchors_.ForEach([&ret](const AnchorPtr &anchor) { ret.push_back(anchor); });
   return Anchor::Vistor<AnchorPtr>(shared_from_this(), ret);
 }
 
 AnchorPtr Anchor::GetFirstPeerAnchor() const {
-  if (peer_anchors_.empty()) {
-    return nullptr;
-  } else {
-    return Anchor::DynamicAnchorCast<Anchor>(peer_anchors_.begin()->lock());
-  }
+  return Anchor::DynamicAnchorCast<Anchor>(peer_anchors_.front());
 }
 
 NodePtr Anchor::GetOwnerNode() const { return owner_node_.lock(); }
 
 void Anchor::UnlinkAll() noexcept {
-  if (!peer_anchors_.empty()) {
-    do {
-      auto peer_anchor_ptr = peer_anchors_.begin()->lock();
-      if (Unlink(peer_anchor_ptr) != GRAPH_SUCCESS) {
-        GELOGW("unlink peer_anchor_ptr failed.");
-      }
-    } while (!peer_anchors_.empty());
+  while (!peer_anchors_.empty()) {
+    auto peer_anchor_ptr = peer_anchors_.front();
+    if ((peer_anchor_ptr == nullptr) || (Unlink(peer_anchor_ptr) != GRAPH_SUCCESS)) {
+      GELOGW("unlink peer_anchor_ptr failed.");
+      peer_anchors_.EraseFront();
+    }
   }
 }
 
@@ -64,23 +256,13 @@ graphStatus Anchor::Unlink(const AnchorPtr &peer) {
     GELOGE(GRAPH_FAILED, "peer anchor is invalid.");
     return GRAPH_FAILED;
   }
-  auto it = std::find_if(peer_anchors_.begin(), peer_anchors_.end(), [peer](const std::weak_ptr<Anchor> &an) {
-    auto anchor = an.lock();
-    return peer->Equal(anchor);
-  });
-
-  GE_IF_BOOL_EXEC(it == peer_anchors_.end(), GELOGW("this anchor is not connected to peer"); return GRAPH_FAILED);
+  GE_IF_BOOL_EXEC(!peer_anchors_.Contains(peer), GELOGW("this anchor is not connected to peer"); return GRAPH_FAILED);
 
-  auto it_peer =
-      std::find_if(peer->peer_anchors_.begin(), peer->peer_anchors_.end(), [this](const std::weak_ptr<Anchor> &an) {
-        auto anchor = an.lock();
-        return Equal(anchor);
-      });
+  auto self = shared_from_this();
+  GE_CHK_BOOL_RET_STATUS(peer->peer_anchors_.Contains(self), GRAPH_FAILED, "peer is not connected to this anchor");
 
-  GE_CHK_BOOL_RET_STATUS(it_peer != peer->peer_anchors_.end(), GRAPH_FAILED, "peer is not connected to this anchor");
-
-  (void)peer_anchors_.erase(it);
-  (void)peer->peer_anchors_.erase(it_peer);
+  (void)peer_anchors_.Erase(peer);
+  (void)peer->peer_anchors_.Erase(self);
   return GRAPH_SUCCESS;
 }
 
@@ -88,40 +270,32 @@ graphStatus Anchor::ReplacePeer(const AnchorPtr &old_peer, const AnchorPtr &firs
   GE_CHK_BOOL_RET_STATUS(old_peer != nullptr, GRAPH_FAILED, "this old peer anchor is nullptr");
   GE_CHK_BOOL_RET_STATUS(first_peer != nullptr, GRAPH_FAILED, "this first peer anchor is nullptr");
   GE_CHK_BOOL_RET_STATUS(second_peer != nullptr, GRAPH_FAILED, "this second peer anchor is nullptr");
-  auto this_it = std::find_if(peer_anchors_.begin(), peer_anchors_.end(), [old_peer](const std::weak_ptr<Anchor> &an) {
-    auto anchor = an.lock();
-    return old_peer->Equal(anchor);
-  });
-
-  GE_CHK_BOOL_RET_STATUS(this_it != peer_anchors_.end(), GRAPH_FAILED, "this anchor is not connected to old_peer");
+  GE_CHK_BOOL_RET_STATUS(peer_anchors_.Contains(old_peer), GRAPH_FAILED, "this anchor is not connected to old_peer");
 
-  auto old_it = std::find_if(old_peer->peer_anchors_.begin(), old_peer->peer_anchors_.end(),
-                             [this](const std::weak_ptr<Anchor> &an) {
-                               auto anchor = an.lock();
-                               return Equal(anchor);
-                             });
-
-  GE_CHK_BOOL_RET_STATUS(old_it != old_peer->peer_anchors_.end(), GRAPH_FAILED,
+  auto self = shared_from_this();
+  GE_CHK_BOOL_RET_STATUS(old_peer->peer_anchors_.Contains(self), GRAPH_FAILED,
                          "old_peer is not connected to this anchor");
-  *this_it = first_peer;
-  first_peer->peer_anchors_.push_back(shared_from_this());
-  *old_it = second_peer;
+  (void)peer_anchors_.Replace(old_peer, first_peer);
+  first_peer->peer_anchors_.push_back(self);
+  (void)old_peer->peer_anchors_.Replace(self, second_peer);
   second_peer->peer_anchors_.push_back(old_peer);
   return GRAPH_SUCCESS;
 }
 
 bool Anchor::IsLinkedWith(const AnchorPtr &peer) {
-  auto it = std::find_if(peer_anchors_.begin(), peer_anchors_.end(), [peer](const std::weak_ptr<Anchor> &an) {
-    auto anchor = an.lock();
-    GE_CHK_BOOL_RET_STATUS(peer != nullptr, false, "this old peer anchor is nullptr");
-    return peer->Equal(anchor);
-  });
-  return (it != peer_anchors_.end());
+  GE_CHK_BOOL_RET_STATUS(peer != nullptr, false, "this old peer anchor is nullptr");
+  return peer_anchors_.Contains(peer);
 }
 
 int Anchor::GetIdx() const { return idx_; }
 
-void Anchor::SetIdx(int index) { idx_ = index; }
+void Anchor::SetIdx(int index) {
+  idx_ = index;
+  auto node = GetOwnerNode();
+  if (node != nullptr) {
+    node->IncreaseAnchorsVersion();
+  }
+}
 
 DataAnchor::DataAnchor(const NodePtr &owner_node, int idx) : Anchor(owner_node, idx) {}
 
@@ -135,11 +309,7 @@ bool DataAnchor::IsTypeOf(TYPE type) const {
 InDataAnchor::InDataAnchor(const NodePtr &owner_node, int idx) : DataAnchor(owner_node, idx) {}
 
 OutDataAnchorPtr InDataAnchor::GetPeerOutAnchor() const {
-  if (peer_anchors_.empty()) {
-    return nullptr;
-  } else {
-    return Anchor::DynamicAnchorCast<OutDataAnchor>(peer_anchors_.begin()->lock());
-  }
+  return Anchor::DynamicAnchorCast<OutDataAnchor>(peer_anchors_.front());
 }
 
 graphStatus InDataAnchor::LinkFrom(const OutDataAnchorPtr &src) {
@@ -174,34 +344,34 @@ OutDataAnchor::OutDataAnchor(const NodePtr &owner_node, int idx) : DataAnchor(ow
 
 OutDataAnchor::Vistor<InDataAnchorPtr> OutDataAnchor::GetPeerInDataAnchors() const {
   vector<InDataAnchorPtr> ret;
-  for (const auto &anchor : peer_anchors_) {
-    auto in_data_anchor = Anchor::DynamicAnchorCast<InDataAnchor>(anchor.lock());
+  (void)peer_anchors_.ForEach([&ret](const AnchorPtr &anchor) {
+    auto in_data_anchor = Anchor::DynamicAnchorCast<InDataAnchor>(anchor);
     if (in_data_anchor != nullptr) {
       ret.push_back(in_data_anchor);
     }
-  }
+  });
   return OutDataAnchor::Vistor<InDataAnchorPtr>(shared_from_this(), ret);
 }
 
 uint32_t OutDataAnchor::GetPeerInDataNodesSize() const {
   uint32_t out_nums = 0;
-  for (const auto &anchor : peer_anchors_) {
-    auto in_data_anchor = Anchor::DynamicAnchorCast<InDataAnchor>(anchor.lock());
+  (void)peer_anchors_.ForEach([&out_nums](const AnchorPtr &anchor) {
+    auto in_data_anchor = Anchor::DynamicAnchorCast<InDataAnchor>(anchor);
     if (in_data_anchor != nullptr && in_data_anchor->GetOwnerNode() != nullptr) {
       out_nums++;
     }
-  }
+  });
   return out_nums;
 }
 
 OutDataAnchor::Vistor<InControlAnchorPtr> OutDataAnchor::GetPeerInControlAnchors() const {
   vector<InControlAnchorPtr> ret;
-  for (const auto &anchor : peer_anchors_) {
-    auto in_control_anchor = Anchor::DynamicAnchorCast<InControlAnchor>(anchor.lock());
+  (void)peer_anchors_.ForEach([&ret](const AnchorPtr &anchor) {
+    auto in_control_anchor = Anchor::DynamicAnchorCast<InControlAnchor>(anchor);
     if (in_control_anchor != nullptr) {
       ret.push_back(in_control_anchor);
     }
-  }
+  });
   return OutDataAnchor::Vistor<InControlAnchorPtr>(shared_from_this(), ret);
 }
 
@@ -270,23 +440,23 @@ InControlAnchor::InControlAnchor(const NodePtr &owner_node, int idx) : ControlAn
 
 InControlAnchor::Vistor<OutControlAnchorPtr> InControlAnchor::GetPeerOutControlAnchors() const {
   vector<OutControlAnchorPtr> ret;
-  for (const auto &anchor : peer_anchors_) {
-    auto out_control_anchor = Anchor::DynamicAnchorCast<OutControlAnchor>(anchor.lock());
+  (void)peer_anchors_.ForEach([&ret](const AnchorPtr &anchor) {
+    auto out_control_anchor = Anchor::DynamicAnchorCast<OutControlAnchor>(anchor);
     if (out_control_anchor != nullptr) {
       ret.push_back(out_control_anchor);
     }
-  }
+  });
   return InControlAnchor::Vistor<OutControlAnchorPtr>(shared_from_this(), ret);
 }
 
 InControlAnchor::Vistor<OutDataAnchorPtr> InControlAnchor::GetPeerOutDataAnchors() const {
   vector<OutDataAnchorPtr> ret;
-  for (const auto &anchor : peer_anchors_) {
-    auto out_data_anchor = Anchor::DynamicAnchorCast<OutDataAnchor>(anchor.lock());
+  (void)peer_anchors_.ForEach([&ret](const AnchorPtr &anchor) {
+    auto out_data_anchor = Anchor::DynamicAnchorCast<OutDataAnchor>(anchor);
     if (out_data_anchor != nullptr) {
       ret.push_back(out_data_anchor);
     }
-  }
+  });
   return InControlAnchor::Vistor<OutDataAnchorPtr>(shared_from_this(), ret);
 }
 
@@ -324,23 +494,23 @@ OutControlAnchor::OutControlAnchor(const NodePtr &owner_node, int idx) : Control
 
 OutControlAnchor::Vistor<InControlAnchorPtr> OutControlAnchor::GetPeerInControlAnchors() const {
   vector<InControlAnchorPtr> ret;
-  for (const auto &anchor : peer_anchors_) {
-    auto in_control_anchor = Anchor::DynamicAnchorCast<InControlAnchor>(anchor.lock());
+  (void)peer_anchors_.ForEach([&ret](const AnchorPtr &anchor) {
+    auto in_control_anchor = Anchor::DynamicAnchorCast<InControlAnchor>(anchor);
     if (in_control_anchor != nullptr) {
       ret.push_back(in_control_anchor);
     }
-  }
+  });
   return OutControlAnchor::Vistor<InControlAnchorPtr>(shared_from_this(), ret);
 }
 
 OutControlAnchor::Vistor<InDataAnchorPtr> OutControlAnchor::GetPeerInDataAnchors() const {
   vector<InDataAnchorPtr> ret;
-  for (const auto &anchor : peer_anchors_) {
-    auto in_data_anchor = Anchor::DynamicAnchorCast<InDataAnchor>(anchor.lock());
+  (void)peer_anchors_.ForEach([&ret](const AnchorPtr &anchor) {
+    auto in_data_anchor = Anchor::DynamicAnchorCast<InDataAnchor>(anchor);
     if (in_data_anchor != nullptr) {
       ret.push_back(in_data_anchor);
     }
-  }
+  });
   return OutControlAnchor::Vistor<InDataAnchorPtr>(shared_from_this(), ret);
 }
 
@@ -15,28 +15,27 @@
  */
 
 #include "graph/buffer.h"
+#include "graph/aligned_ptr.h"
 #include "proto/ge_ir.pb.h"
 #include "framework/common/debug/ge_log.h"
 
 namespace ge {
-Buffer::Buffer() {
-  data_.InitDefault();
-  if (data_.GetProtoMsg()) {
-    buffer_ = data_.GetProtoMsg()->mutable_bt();
-  }
-}
+Buffer::Buffer() {}
 
 Buffer::Buffer(const Buffer &other) {
   // Share data
   data_ = other.data_;
   buffer_ = other.buffer_;
+  ext_data_ = other.ext_data_;
+  ext_size_ = other.ext_size_;
 }
 
-Buffer::Buffer(std::size_t buffer_size, std::uint8_t default_val) : Buffer() {  // default
+Buffer::Buffer(std::size_t buffer_size, std::uint8_t default_val) {  // default
+  data_.InitDefault();
   auto proto_msg = data_.GetProtoMsg();
   if (proto_msg != nullptr) {
     try {
-      proto_msg->set_bt(std::string(buffer_size, default_val));
+      proto_msg->mutable_bt()->assign(buffer_size, static_cast<char>(default_val));
       buffer_ = proto_msg->mutable_bt();
     } catch (std::bad_alloc &e) {
       GELOGE(MEMALLOC_FAILED, "Failed to alloc buffer memory, buffer size %zu", buffer_size);
@@ -45,8 +44,24 @@ Buffer::Buffer(std::size_t buffer_size, std::uint8_t default_val) : Buffer() {
   }
 }
 
+Buffer::Buffer(const std::shared_ptr<std::uint8_t> &data, std::size_t buffer_size) {
+  if (data != nullptr) {
+    ext_data_ = data;
+    ext_size_ = buffer_size;
+  }
+}
+
+Buffer Buffer::FromAlignedPtr(const std::shared_ptr<AlignedPtr> &aligned_ptr, std::size_t buffer_size) {
+  if ((aligned_ptr == nullptr) || (aligned_ptr->MutableGet() == nullptr)) {
+    return Buffer();
+  }
+  // shares ownership of the AlignedPtr while pointing at its aligned address
+  return Buffer(std::shared_ptr<std::uint8_t>(aligned_ptr, aligned_ptr->MutableGet()), buffer_size);
+}
+
 Buffer Buffer::CopyFrom(const std::uint8_t *data, std::size_t buffer_size) {
   Buffer buffer;
+  buffer.data_.InitDefault();
   auto proto_msg = buffer.data_.GetProtoMsg();
   if (proto_msg != nullptr && data != nullptr) {
     try {
@@ -77,11 +92,41 @@ Buffer &Buffer::operator=(const Buffer &other) {
     // Share data
     data_ = other.data_;
     buffer_ = other.buffer_;
+    ext_data_ = other.ext_data_;
+    ext_size_ = other.ext_size_;
   }
   return *this;
 }
 
+std::string *Buffer::MutableProtoBytes() {
+  if (buffer_ != nullptr) {
+    return buffer_;
+  }
+  if (data_.GetProtoMsg() == nullptr) {
+    data_.InitDefault();
+  }
+  auto proto_msg = data_.GetProtoMsg();
+  if (proto_msg == nullptr) {
+    return nullptr;
+  }
+  try {
+    if (ext_data_ != nullptr) {
+      proto_msg->set_bt(ext_data_.get(), ext_size_);
+    }
+  } catch (std::bad_alloc &e) {
+    GELOGE(MEMALLOC_FAILED, "Failed to alloc buffer memory, buffer size %zu", ext_size_);
+    return nullptr;
+  }
+  ext_data_.reset();
+  ext_size_ = 0;
+  buffer_ = proto_msg->mutable_bt();
+  return buffer_;
+}
+
 const std::uint8_t *Buffer::GetData() const {
+  if (ext_data_ != nullptr) {
+    return ext_data_.get();
+  }
   if (buffer_ != nullptr) {
     return (const std::uint8_t *)buffer_->data();
   }
@@ -89,6 +134,9 @@ const std::uint8_t *Buffer::GetData() const {
 }
 
 std::uint8_t *Buffer::GetData() {
+  if (ext_data_ != nullptr) {
+    return ext_data_.get();
+  }
   if (buffer_ != nullptr && !buffer_->empty()) {
     // Avoid copy on write
     (void)(*buffer_)[0];
@@ -98,6 +146,9 @@ std::uint8_t *Buffer::GetData() {
 }
 
 std::size_t Buffer::GetSize() const {
+  if (ext_data_ != nullptr) {
+    return ext_size_;
+  }
   if (buffer_ != nullptr) {
     return buffer_->size();
   }
@@ -105,6 +156,9 @@ std::size_t Buffer::GetSize() const {
 }
 
 void Buffer::ClearBuffer() {
+  // external bytes are not ours to clear, only let go of them
+  ext_data_.reset();
+  ext_size_ = 0;
   if (buffer_ != nullptr) {
     buffer_->clear();
   }
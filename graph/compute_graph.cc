@@ -39,10 +39,9 @@ namespace {
 const size_t OUTPUT_PARAM_SIZE = 2;
 const std::string alias_name_attr = "_aliasName";
 bool IsUseBFS() {
-  string run_mode;
-  const int base = 10;
-  if (ge::GetContext().GetOption(ge::OPTION_GRAPH_RUN_MODE, run_mode) == GRAPH_SUCCESS && !run_mode.empty()) {
-    if (GraphRunMode(std::strtol(run_mode.c_str(), nullptr, base)) >= TRAIN) {
+  int64_t run_mode = 0;
+  if (ge::GetContext().GetOption(IntOption::kGraphRunMode, run_mode) == GRAPH_SUCCESS) {
+    if (GraphRunMode(run_mode) >= TRAIN) {
       return true;
     }
   } else {
@@ -952,11 +951,10 @@ graphStatus ComputeGraph::SortNodes(std::vector<NodePtr> &stack, std::map<NodePt
   // Record the number of non data nodes but no input nodes
   uint32_t spec_node_size = 0;
   bool verify_isolated = false;
-  string run_mode;
-  const int base = 10;
+  int64_t run_mode = 0;
   // Need verify isolated point in PREDICTION mode.
-  if (ge::GetContext().GetOption(ge::OPTION_GRAPH_RUN_MODE, run_mode) == GRAPH_SUCCESS && !run_mode.empty()) {
-    if (GraphRunMode(std::strtol(run_mode.c_str(), nullptr, base)) < TRAIN) {
+  if (ge::GetContext().GetOption(IntOption::kGraphRunMode, run_mode) == GRAPH_SUCCESS) {
+    if (GraphRunMode(run_mode) < TRAIN) {
       verify_isolated = true;
     }
   }
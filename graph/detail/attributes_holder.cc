@@ -20,13 +20,24 @@
 #include "debug/ge_util.h"
 #include "framework/common/debug/ge_log.h"
 #include "graph/ge_attr_value.h"
+#include "graph/detail/weights_mapping.h"
 #include "proto/ge_ir.pb.h"
 
 
 namespace ge {
 using std::map;
 using std::set;
-void AttrHolder::CopyAttrsFrom(const AttrHolder &holder) { MutableAttrMap().CopyValueFrom(holder.GetAttrMap()); }
+void AttrHolder::CopyAttrsFrom(const AttrHolder &holder) {
+  auto proto_map = holder.GetAttrMap().GetProtoMsg();
+  if (proto_map != nullptr) {
+    WeightsMapping::Materialize(*proto_map);
+  }
+  auto own_proto_map = MutableAttrMap().GetProtoMsg();
+  if (own_proto_map != nullptr) {
+    WeightsMapping::Drop(*own_proto_map);
+  }
+  MutableAttrMap().CopyValueFrom(holder.GetAttrMap());
+}
 graphStatus AttrHolder::SetAttr(const std::string &name, const GeAttrValue &value) {
   if (value.IsEmpty()) {
     GELOGE(GRAPH_FAILED, "value is empty, key of the attr is %s", name.c_str());
@@ -43,7 +54,11 @@ graphStatus AttrHolder::SetAttr(const std::string &name, const GeAttrValue &valu
         it->second.value_case() != proto_val->value_case()) {
       return GRAPH_FAILED;
     }
+    // the assignment reuses the old TensorDef, its lazy view must not survive the new value
+    WeightsMapping::Drop(it->second);
   }
+  // value may be a view of a lazy tensor from GetAllAttrs, the copy would lose the viewed bytes
+  WeightsMapping::Materialize(*proto_val);
   (*proto_map)[name] = *proto_val;
   return GRAPH_SUCCESS;
 }
@@ -64,6 +79,7 @@ graphStatus AttrHolder::GetAttr(const std::string &name, GeAttrValue &value) con
   }
   auto it = proto_map->find(name);
   if (it != proto_map->end()) {
+    WeightsMapping::Materialize(it->second);
     *proto_val = it->second;
     return GRAPH_SUCCESS;
   }
@@ -87,6 +103,7 @@ graphStatus AttrHolder::DelAttr(const std::string &name) {
   }
   auto it = proto_map->find(name);
   if (it != proto_map->end()) {
+    WeightsMapping::Drop(it->second);
     (void)proto_map->erase(it);
     return GRAPH_SUCCESS;
   }
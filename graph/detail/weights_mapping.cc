@@ -0,0 +1,466 @@
+/**
+ * Copyright 2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "graph/detail/weights_mapping.h"
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include "debug/ge_util.h"
+#include "framework/common/debug/ge_log.h"
+#include "mmpa/mmpa_api.h"
+#include "proto/ge_ir.pb.h"
+
+namespace ge {
+namespace {
+// field numbers of ge_ir.proto on the path from ModelDef to the const weight bytes
+const uint32_t kModelDefGraph = 7U;
+const uint32_t kGraphDefOp = 6U;
+const uint32_t kOpDefAttr = 10U;
+const uint32_t kMapEntryKey = 1U;
+const uint32_t kMapEntryValue = 2U;
+const uint32_t kAttrDefList = 1U;
+const uint32_t kAttrDefTensor = 12U;
+const uint32_t kListValueTensor = 9U;
+const uint32_t kTensorDefData = 2U;
+
+const uint32_t kWireVarint = 0U;
+const uint32_t kWireFixed64 = 1U;
+const uint32_t kWireLengthDelimited = 2U;
+const uint32_t kWireFixed32 = 5U;
+const uint32_t kTagTypeBits = 3U;
+const uint32_t kTagTypeMask = 0x7U;
+const uint32_t kVarintMaxShift = 64U;
+const uint32_t kVarintShift = 7U;
+const uint8_t kVarintMore = 0x80U;
+const uint8_t kVarintPayload = 0x7FU;
+
+enum class FieldAction { kCopy, kReplace, kSkip };
+
+// Called for every length-delimited field, a handler which returns kReplace fills the new payload
+using FieldHandler = std::function<bool(uint32_t field_number, const uint8_t *begin, const uint8_t *end,
+                                        FieldAction &action, std::string &payload)>;
+
+struct LazyWeight {
+  const uint8_t *addr;
+  size_t length;
+};
+
+std::mutex &LazyWeightsMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::unordered_map<const proto::TensorDef *, LazyWeight> &LazyWeights() {
+  static std::unordered_map<const proto::TensorDef *, LazyWeight> lazy_weights;
+  return lazy_weights;
+}
+
+bool ReadVarint(const uint8_t *&pos, const uint8_t *end, uint64_t &value) {
+  value = 0U;
+  for (uint32_t shift = 0U; shift < kVarintMaxShift; shift += kVarintShift) {
+    if (pos >= end) {
+      return false;
+    }
+    uint8_t byte = *pos++;
+    value |= static_cast<uint64_t>(byte & kVarintPayload) << shift;
+    if ((byte & kVarintMore) == 0U) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void AppendVarint(uint64_t value, std::string &out) {
+  while (value >= kVarintMore) {
+    out.push_back(static_cast<char>((value & kVarintPayload) | kVarintMore));
+    value >>= kVarintShift;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+bool PruneMessage(const uint8_t *begin, const uint8_t *end, const FieldHandler &handler, std::string &pruned) {
+  const uint8_t *pos = begin;
+  while (pos < end) {
+    const uint8_t *field_begin = pos;
+    uint64_t tag = 0U;
+    uint64_t value = 0U;
+    if (!ReadVarint(pos, end, tag)) {
+      return false;
+    }
+    switch (static_cast<uint32_t>(tag & kTagTypeMask)) {
+      case kWireVarint:
+        if (!ReadVarint(pos, end, value)) {
+          return false;
+        }
+        break;
+      case kWireFixed64:
+        if (end - pos < static_cast<int64_t>(sizeof(uint64_t))) {
+          return false;
+        }
+        pos += sizeof(uint64_t);
+        break;
+      case kWireFixed32:
+        if (end - pos < static_cast<int64_t>(sizeof(uint32_t))) {
+          return false;
+        }
+        pos += sizeof(uint32_t);
+        break;
+      case kWireLengthDelimited: {
+        if (!ReadVarint(pos, end, value) || value > static_cast<uint64_t>(end - pos)) {
+          return false;
+        }
+        const uint8_t *payload_begin = pos;
+        pos += value;
+        FieldAction action = FieldAction::kCopy;
+        std::string payload;
+        if (!handler(static_cast<uint32_t>(tag >> kTagTypeBits), payload_begin, pos, action, payload)) {
+          return false;
+        }
+        if (action == FieldAction::kSkip) {
+          continue;
+        }
+        if (action == FieldAction::kReplace) {
+          AppendVarint(tag, pruned);
+          AppendVarint(payload.size(), pruned);
+          pruned.append(payload);
+          continue;
+        }
+        break;
+      }
+      default:
+        GELOGW("Unsupported wire type %lu in model file.", tag & kTagTypeMask);
+        return false;
+    }
+    pruned.append(reinterpret_cast<const char *>(field_begin), static_cast<size_t>(pos - field_begin));
+  }
+  return true;
+}
+}  // namespace
+
+std::atomic<size_t> WeightsMapping::lazy_weights_count_(0U);
+
+std::shared_ptr<WeightsMapping> WeightsMapping::Create(const std::string &real_path) {
+  ULONGLONG file_size = 0U;
+  if (mmGetFileSize(real_path.c_str(), &file_size) != EN_OK || file_size == 0U) {
+    GELOGE(GRAPH_FAILED, "get size of file %s failed.", real_path.c_str());
+    return nullptr;
+  }
+  int fd = mmOpen(real_path.c_str(), M_RDONLY);
+  if (fd < 0) {
+    GELOGE(GRAPH_FAILED, "open file failed, %s", strerror(errno));
+    return nullptr;
+  }
+  void *addr = mmMmap(fd, static_cast<mmSize_t>(file_size), 0, &fd, PROT_READ, MAP_PRIVATE);
+  if (mmClose(fd) != 0) {
+    GELOGW("close file descriptor fail.");
+  }
+  if (addr == nullptr || addr == MAP_FAILED) {
+    GELOGE(GRAPH_FAILED, "mmap file %s failed, size %llu.", real_path.c_str(), file_size);
+    return nullptr;
+  }
+  auto mapping = std::shared_ptr<WeightsMapping>(
+      new (std::nothrow) WeightsMapping(static_cast<uint8_t *>(addr), static_cast<size_t>(file_size)));
+  if (mapping == nullptr) {
+    GELOGE(GRAPH_FAILED, "WeightsMapping make shared failed");
+    (void)mmMunMap(addr, static_cast<mmSize_t>(file_size), nullptr);
+    return nullptr;
+  }
+  return mapping;
+}
+
+WeightsMapping::~WeightsMapping() {
+  Release();
+  if (addr_ != nullptr) {
+    (void)mmMunMap(addr_, static_cast<mmSize_t>(size_), nullptr);
+    addr_ = nullptr;
+  }
+}
+
+bool WeightsMapping::Prune(std::string &pruned) {
+  weight_paths_.clear();
+  pruned.clear();
+  if (!PruneModelDef(addr_, addr_ + size_, pruned)) {
+    weight_paths_.clear();
+    return false;
+  }
+  GELOGI("Model file size %zu, %zu weights kept in mapping, pruned size %zu.", size_, weight_paths_.size(),
+         pruned.size());
+  return true;
+}
+
+bool WeightsMapping::AddViews(proto::ModelDef &model_def) {
+  for (const auto &path : weight_paths_) {
+    if (!AddView(model_def, path)) {
+      GELOGE(GRAPH_FAILED, "Can not find weight %s of op %d in graph %d.", path.attr_name.c_str(), path.op_index,
+             path.graph_index);
+      Release();
+      return false;
+    }
+  }
+  weight_paths_.clear();
+  return true;
+}
+
+bool WeightsMapping::PruneModelDef(const uint8_t *begin, const uint8_t *end, std::string &pruned) {
+  int32_t graph_index = 0;
+  return PruneMessage(begin, end, [this, &graph_index](uint32_t field_number, const uint8_t *field_begin,
+                                                       const uint8_t *field_end, FieldAction &action,
+                                                       std::string &payload) {
+    if (field_number != kModelDefGraph) {
+      return true;
+    }
+    action = FieldAction::kReplace;
+    return PruneGraphDef(field_begin, field_end, graph_index++, payload);
+  }, pruned);
+}
+
+bool WeightsMapping::PruneGraphDef(const uint8_t *begin, const uint8_t *end, int32_t graph_index,
+                                   std::string &pruned) {
+  WeightPath path{graph_index, 0, "", -1, 0U, 0U};
+  return PruneMessage(begin, end, [this, &path](uint32_t field_number, const uint8_t *field_begin,
+                                                const uint8_t *field_end, FieldAction &action,
+                                                std::string &payload) {
+    if (field_number != kGraphDefOp) {
+      return true;
+    }
+    action = FieldAction::kReplace;
+    bool ret = PruneOpDef(field_begin, field_end, path, payload);
+    path.op_index++;
+    return ret;
+  }, pruned);
+}
+
+bool WeightsMapping::PruneOpDef(const uint8_t *begin, const uint8_t *end, WeightPath &path, std::string &pruned) {
+  return PruneMessage(begin, end, [this, &path](uint32_t field_number, const uint8_t *field_begin,
+                                                const uint8_t *field_end, FieldAction &action,
+                                                std::string &payload) {
+    if (field_number != kOpDefAttr) {
+      return true;
+    }
+    action = FieldAction::kReplace;
+    return PruneAttrEntry(field_begin, field_end, path, payload);
+  }, pruned);
+}
+
+bool WeightsMapping::PruneAttrEntry(const uint8_t *begin, const uint8_t *end, WeightPath &path,
+                                    std::string &pruned) {
+  size_t first_weight = weight_paths_.size();
+  std::string attr_name;
+  bool ret = PruneMessage(begin, end, [this, &path, &attr_name](uint32_t field_number, const uint8_t *field_begin,
+                                                                const uint8_t *field_end, FieldAction &action,
+                                                                std::string &payload) {
+    if (field_number == kMapEntryKey) {
+      attr_name.assign(reinterpret_cast<const char *>(field_begin), static_cast<size_t>(field_end - field_begin));
+      return true;
+    }
+    if (field_number != kMapEntryValue) {
+      return true;
+    }
+    action = FieldAction::kReplace;
+    return PruneAttrDef(field_begin, field_end, path, payload);
+  }, pruned);
+  // the key of a map entry may follow its value
+  for (size_t i = first_weight; i < weight_paths_.size(); ++i) {
+    weight_paths_[i].attr_name = attr_name;
+  }
+  return ret;
+}
+
+bool WeightsMapping::PruneAttrDef(const uint8_t *begin, const uint8_t *end, WeightPath &path, std::string &pruned) {
+  return PruneMessage(begin, end, [this, &path](uint32_t field_number, const uint8_t *field_begin,
+                                                const uint8_t *field_end, FieldAction &action,
+                                                std::string &payload) {
+    if (field_number == kAttrDefTensor) {
+      action = FieldAction::kReplace;
+      path.list_index = -1;
+      return PruneTensorDef(field_begin, field_end, path, payload);
+    }
+    if (field_number != kAttrDefList) {
+      return true;
+    }
+    action = FieldAction::kReplace;
+    path.list_index = 0;
+    return PruneMessage(field_begin, field_end, [this, &path](uint32_t list_field, const uint8_t *list_begin,
+                                                              const uint8_t *list_end, FieldAction &list_action,
+                                                              std::string &list_payload) {
+      if (list_field != kListValueTensor) {
+        return true;
+      }
+      list_action = FieldAction::kReplace;
+      bool ret = PruneTensorDef(list_begin, list_end, path, list_payload);
+      path.list_index++;
+      return ret;
+    }, payload);
+  }, pruned);
+}
+
+bool WeightsMapping::PruneTensorDef(const uint8_t *begin, const uint8_t *end, WeightPath &path,
+                                    std::string &pruned) {
+  return PruneMessage(begin, end, [this, &path](uint32_t field_number, const uint8_t *field_begin,
+                                                const uint8_t *field_end, FieldAction &action, std::string &) {
+    size_t length = static_cast<size_t>(field_end - field_begin);
+    if (field_number != kTensorDefData || length < kLazyWeightMinSize) {
+      return true;
+    }
+    action = FieldAction::kSkip;
+    path.offset = static_cast<size_t>(field_begin - addr_);
+    path.length = length;
+    weight_paths_.push_back(path);
+    return true;
+  }, pruned);
+}
+
+bool WeightsMapping::AddView(proto::ModelDef &model_def, const WeightPath &path) {
+  if (path.graph_index >= model_def.graph_size()) {
+    return false;
+  }
+  auto graph_def = model_def.mutable_graph(path.graph_index);
+  if (path.op_index >= graph_def->op_size()) {
+    return false;
+  }
+  auto attr_map = graph_def->mutable_op(path.op_index)->mutable_attr();
+  auto it = attr_map->find(path.attr_name);
+  if (it == attr_map->end()) {
+    return false;
+  }
+  proto::TensorDef *tensor_def = nullptr;
+  if (path.list_index < 0) {
+    if (!it->second.has_t()) {
+      return false;
+    }
+    tensor_def = it->second.mutable_t();
+  } else {
+    if (!it->second.has_list() || path.list_index >= it->second.list().t_size()) {
+      return false;
+    }
+    tensor_def = it->second.mutable_list()->mutable_t(path.list_index);
+  }
+  // a repeated map key keeps the last value, which may not be a lazy one
+  if (!tensor_def->data().empty()) {
+    return true;
+  }
+  std::lock_guard<std::mutex> lock(LazyWeightsMutex());
+  auto &lazy_weights = LazyWeights();
+  auto ret = lazy_weights.emplace(tensor_def, LazyWeight{addr_ + path.offset, path.length});
+  if (ret.second) {
+    views_.push_back(tensor_def);
+  } else {
+    ret.first->second = LazyWeight{addr_ + path.offset, path.length};
+  }
+  lazy_weights_count_.store(lazy_weights.size(), std::memory_order_release);
+  return true;
+}
+
+void WeightsMapping::Release() {
+  if (views_.empty()) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(LazyWeightsMutex());
+  auto &lazy_weights = LazyWeights();
+  for (const auto tensor_def : views_) {
+    (void)lazy_weights.erase(tensor_def);
+  }
+  views_.clear();
+  lazy_weights_count_.store(lazy_weights.size(), std::memory_order_release);
+}
+
+bool WeightsMapping::Materialize(const proto::TensorDef *tensor_def) {
+  if (tensor_def == nullptr || !HasLazyWeights()) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(LazyWeightsMutex());
+  auto &lazy_weights = LazyWeights();
+  auto it = lazy_weights.find(tensor_def);
+  if (it == lazy_weights.end()) {
+    return false;
+  }
+  // a lazy tensor has no data of its own, data written past the view makes the view stale
+  if (!tensor_def->data().empty()) {
+    (void)lazy_weights.erase(it);
+    lazy_weights_count_.store(lazy_weights.size(), std::memory_order_release);
+    return false;
+  }
+  // the view stands for bytes which belong to the proto, so filling it keeps the proto logically const
+  const_cast<proto::TensorDef *>(tensor_def)->set_data(it->second.addr, it->second.length);
+  (void)lazy_weights.erase(it);
+  lazy_weights_count_.store(lazy_weights.size(), std::memory_order_release);
+  return true;
+}
+
+void WeightsMapping::Materialize(const proto::AttrDef &attr_def) {
+  if (!HasLazyWeights()) {
+    return;
+  }
+  if (attr_def.has_t()) {
+    (void)Materialize(&attr_def.t());
+  } else if (attr_def.has_list()) {
+    for (const auto &tensor_def : attr_def.list().t()) {
+      (void)Materialize(&tensor_def);
+    }
+  }
+}
+
+void WeightsMapping::Materialize(const ProtoAttrMap &attr_map) {
+  if (!HasLazyWeights()) {
+    return;
+  }
+  for (const auto &it : attr_map) {
+    Materialize(it.second);
+  }
+}
+
+size_t WeightsMapping::GetLazySize(const proto::TensorDef *tensor_def) {
+  if (tensor_def == nullptr || !HasLazyWeights() || !tensor_def->data().empty()) {
+    return 0U;
+  }
+  std::lock_guard<std::mutex> lock(LazyWeightsMutex());
+  auto &lazy_weights = LazyWeights();
+  auto it = lazy_weights.find(tensor_def);
+  return (it == lazy_weights.end()) ? 0U : it->second.length;
+}
+
+void WeightsMapping::Drop(const proto::TensorDef *tensor_def) {
+  if (tensor_def == nullptr || !HasLazyWeights()) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(LazyWeightsMutex());
+  auto &lazy_weights = LazyWeights();
+  (void)lazy_weights.erase(tensor_def);
+  lazy_weights_count_.store(lazy_weights.size(), std::memory_order_release);
+}
+
+void WeightsMapping::Drop(const proto::AttrDef &attr_def) {
+  if (!HasLazyWeights()) {
+    return;
+  }
+  if (attr_def.has_t()) {
+    Drop(&attr_def.t());
+  } else if (attr_def.has_list()) {
+    for (const auto &tensor_def : attr_def.list().t()) {
+      Drop(&tensor_def);
+    }
+  }
+}
+
+void WeightsMapping::Drop(const ProtoAttrMap &attr_map) {
+  if (!HasLazyWeights()) {
+    return;
+  }
+  for (const auto &it : attr_map) {
+    Drop(it.second);
+  }
+}
+}  // namespace ge
@@ -55,16 +55,12 @@ graphStatus ReflectionProcess(const std::unordered_set<RefCell, RefCellHash> &re
     auto in_out_idx = cell.in_out_idx;
     GE_CHECK_NOTNULL(node);
     GE_CHECK_NOTNULL(node->GetOpDesc());
-    if (cell.in_out == ge::NODE_IN) {
-      auto desc = node->GetOpDesc()->GetInputDesc(static_cast<uint32_t>(in_out_idx));
-      desc.SetOriginFormat(to_be_set_format);
-      desc.SetFormat(to_be_set_format);
-      (void)node->GetOpDesc()->UpdateInputDesc(static_cast<uint32_t>(in_out_idx), desc);
-    } else {
-      auto desc = node->GetOpDesc()->GetOutputDesc(static_cast<uint32_t>(in_out_idx));
-      desc.SetOriginFormat(to_be_set_format);
-      desc.SetFormat(to_be_set_format);
-      (void)node->GetOpDesc()->UpdateOutputDesc(static_cast<uint32_t>(in_out_idx), desc);
+    auto desc = (cell.in_out == ge::NODE_IN)
+                    ? node->GetOpDesc()->MutableInputDesc(static_cast<uint32_t>(in_out_idx))
+                    : node->GetOpDesc()->MutableOutputDesc(static_cast<uint32_t>(in_out_idx));
+    if (desc != nullptr) {
+      desc->SetOriginFormat(to_be_set_format);
+      desc->SetFormat(to_be_set_format);
     }
     nodes.push_back(cell.node);
   }
@@ -136,8 +132,7 @@ graphStatus FormatRefiner::RefreshConstantOutProcess(const ComputeGraphPtr &grap
 }
 
 graphStatus FormatRefiner::GetAnchorPoints(const ge::ComputeGraphPtr &graph, std::vector<ge::NodePtr> &anchor_points,
-                                           std::vector<ge::NodePtr> &data_nodes,
-                                           std::unordered_map<ge::NodePtr, bool> &node_status) {
+                                           std::vector<ge::NodePtr> &data_nodes) {
   if (graph == nullptr) {
     GELOGE(GRAPH_FAILED, "input graph is null");
     return GRAPH_FAILED;
@@ -202,23 +197,24 @@ graphStatus FormatRefiner::GetAnchorPoints(const ge::ComputeGraphPtr &graph, std
   GELOGI("anchor_points number is %zu", anchor_points.size());
   return GRAPH_SUCCESS;
 }
-graphStatus FormatRefiner::AnchorProcess(const ge::NodePtr &anchor_node,
-                                         std::unordered_map<ge::NodePtr, bool> &node_status) {
+graphStatus FormatRefiner::AnchorProcess(const ge::NodePtr &anchor_node, RefRelations &ref_relations) {
   if (anchor_node == nullptr) {
     GELOGE(GRAPH_FAILED, "anchor node is null!");
     return GRAPH_FAILED;
   }
+  // Nodes are revisited in FIFO order since the first format reaching a tensor wins. A node is only queued
+  // when one of its tensors leaves ND, so the worklist is bounded by the number of tensors
   std::deque<ge::NodePtr> nodes;
   nodes.push_back(anchor_node);
   while (!nodes.empty()) {
     ge::NodePtr node = nodes.front();
     nodes.pop_front();
-    graphStatus status = BackInferProcess(nodes, node, node_status);
+    graphStatus status = BackInferProcess(nodes, node, ref_relations);
     if (status != GRAPH_SUCCESS && node != nullptr) {
       GELOGE(status, "BackInferProcess failed!node name [%s]", node->GetName().c_str());
       return status;
     }
-    status = ForwardInferProcess(nodes, node, node_status);
+    status = ForwardInferProcess(nodes, node, ref_relations);
     if (status != GRAPH_SUCCESS && node != nullptr) {
       GELOGE(status, "ForwardInferProcess failed!node name [%s]", node->GetName().c_str());
       return status;
@@ -227,7 +223,7 @@ graphStatus FormatRefiner::AnchorProcess(const ge::NodePtr &anchor_node,
   return GRAPH_SUCCESS;
 }
 graphStatus FormatRefiner::BackInferProcess(std::deque<ge::NodePtr> &nodes, ge::NodePtr &node,
-                                            std::unordered_map<ge::NodePtr, bool> &node_status) {
+                                            RefRelations &ref_relations) {
   GE_CHECK_NOTNULL(node);
   GE_CHECK_NOTNULL(node->GetOpDesc());
 
@@ -254,60 +250,57 @@ graphStatus FormatRefiner::BackInferProcess(std::deque<ge::NodePtr> &nodes, ge::
     }
     // Check format whether have been set
     int idx = peer_out_data_anchor->GetIdx();
+    auto peer_out_desc = peer_out_data_node->GetOpDesc()->MutableOutputDesc(static_cast<uint32_t>(idx));
+    if (peer_out_desc == nullptr || peer_out_desc->GetOriginFormat() != FORMAT_ND) {
+      continue;
+    }
+    auto dim_num = peer_out_desc->GetShape().GetDimNum();
+    if (dim_num == 0) {
+      GELOGD("node name:%s idx:%d out is scalar. stop back infer!", peer_out_data_node->GetName().c_str(), idx);
+      continue;
+    }
+    /// Check whether node to change dims ()
+    /// Because some node will calculate with 5D, C dim maybe multi meaning
+    // 4 means dims num
+    if ((kChangeDimNodes.count(peer_out_data_node->GetType()) > 0) && (dim_num < 4)) {
+      GELOGD("Node[%s] is change dim node and shape is smaller than 4. do not modify format",
+             (peer_out_data_node->GetName()).c_str());
+      continue;
+    }
+
     // do peer_out_node name and index as key to lookup reflections
     ge::RefCell key(peer_out_data_node->GetName(), peer_out_data_node, ge::NODE_OUT, idx);
     std::unordered_set<RefCell, RefCellHash> reflection;
-    auto status = reflection_builder.LookUpRefRelations(key, reflection);
+    auto status = ref_relations.LookUpRefRelations(key, reflection);
     if (status != GRAPH_SUCCESS) {
       GELOGE(GRAPH_FAILED, "LookUpRefRelations failed!Node is [%s],the %d out edge",
              (peer_out_data_node->GetName()).c_str(), idx);
       return GRAPH_FAILED;
     }
+    if (reflection.empty()) {
+      peer_out_desc->SetOriginFormat(to_be_set_format);
+      peer_out_desc->SetFormat(to_be_set_format);
 
-    auto ge_tensor_desc = peer_out_data_node->GetOpDesc()->GetOutputDesc(static_cast<uint32_t>(idx));
-    if (ge_tensor_desc.GetOriginFormat() == FORMAT_ND) {
-      auto dim_num = ge_tensor_desc.GetShape().GetDimNum();
-      if (dim_num == 0) {
-        GELOGD("node name:%s idx:%d out is scalar. stop back infer!", peer_out_data_node->GetName().c_str(), idx);
-        continue;
-      }
-      /// Check whether node to change dims ()
-      /// Because some node will calculate with 5D, C dim maybe multi meaning
-      auto peer_out_data_node_type = peer_out_data_node->GetType();
-      auto iter1 = kChangeDimNodes.find(peer_out_data_node_type);
-      // 4 means dims num
-      if ((iter1 != kChangeDimNodes.end()) && (dim_num < 4)) {
-        GELOGD("Node[%s] is change dim node and shape is smaller than 4. do not modify format",
-               (peer_out_data_node->GetName()).c_str());
-        continue;
+      // Call operator infer format api (forward) to get out format
+      GELOGD("call infer format func[Back]!Node is [%s] ", (peer_out_data_node->GetName()).c_str());
+      status = peer_out_data_node->InferOriginFormat();
+      if (status != GRAPH_SUCCESS) {
+        GELOGE(GRAPH_FAILED, "Node[%s] infer format failed", (peer_out_data_node->GetName()).c_str());
+        return GRAPH_FAILED;
       }
-
-      if (reflection.empty()) {
-        ge_tensor_desc.SetOriginFormat(to_be_set_format);
-        ge_tensor_desc.SetFormat(to_be_set_format);
-        (void)peer_out_data_node->GetOpDesc()->UpdateOutputDesc(static_cast<uint32_t>(idx), ge_tensor_desc);
-
-        // Call operator infer format api (forward) to get out format
-        GELOGD("call infer format func[Back]!Node is [%s] ", (peer_out_data_node->GetName()).c_str());
-        status = peer_out_data_node->InferOriginFormat();
-        if (status != GRAPH_SUCCESS) {
-          GELOGE(GRAPH_FAILED, "Node[%s] infer format failed", (peer_out_data_node->GetName()).c_str());
-          return GRAPH_FAILED;
-        }
-        nodes.push_back(peer_out_data_node);
-      } else {
-        auto status = ReflectionProcess(reflection, nodes, to_be_set_format);
-        if (status != GRAPH_SUCCESS) {
-          GELOGE(GRAPH_FAILED, "reflection process failed!");
-          return GRAPH_FAILED;
-        }
+      nodes.push_back(peer_out_data_node);
+    } else {
+      status = ReflectionProcess(reflection, nodes, to_be_set_format);
+      if (status != GRAPH_SUCCESS) {
+        GELOGE(GRAPH_FAILED, "reflection process failed!");
+        return GRAPH_FAILED;
       }
     }
   }
   return GRAPH_SUCCESS;
 }
 graphStatus FormatRefiner::ForwardInferProcess(std::deque<ge::NodePtr> &nodes, ge::NodePtr &node,
-                                               std::unordered_map<ge::NodePtr, bool> &node_status) {
+                                               RefRelations &ref_relations) {
   GE_CHECK_NOTNULL(node);
   GE_CHECK_NOTNULL(node->GetOpDesc());
   GELOGD("Enter forward infer process!Node is [%s]", (node->GetName()).c_str());
@@ -330,57 +323,56 @@ graphStatus FormatRefiner::ForwardInferProcess(std::deque<ge::NodePtr> &nodes, g
 
       // Check format whether have been set
       int idx = peer_in_data_anchor->GetIdx();
+      auto peer_in_desc = peer_in_data_node->GetOpDesc()->MutableInputDesc(static_cast<uint32_t>(idx));
+      if (peer_in_desc == nullptr || peer_in_desc->GetOriginFormat() != FORMAT_ND) {
+        continue;
+      }
+      auto dim_num = peer_in_desc->GetShape().GetDimNum();
+      if (dim_num == 0) {
+        GELOGI("node name:%s idx:%d in is scalar. stop forward infer!", peer_in_data_node->GetName().c_str(), idx);
+        continue;
+      }
+      /// Check whether node to change dims ()
+      /// Because some node will calculate with 5D, C dim maybe multi meaning
+      const auto &peer_in_data_node_type = peer_in_data_node->GetType();
+      // 4 means dims num
+      if ((kChangeDimNodes.count(peer_in_data_node_type) > 0) && (dim_num < 4)) {
+        GELOGD("Node[%s] is change dim node. do not infer origin format", (peer_in_data_node->GetName()).c_str());
+        continue;
+      }
+
       // do peer_out_node name and index as key to lookup reflections
       ge::RefCell key(peer_in_data_node->GetName(), peer_in_data_node, ge::NODE_IN, idx);
       std::unordered_set<RefCell, RefCellHash> reflection;
-      auto status = reflection_builder.LookUpRefRelations(key, reflection);
+      auto status = ref_relations.LookUpRefRelations(key, reflection);
       if (status != GRAPH_SUCCESS) {
         GELOGE(GRAPH_FAILED, "LookUpRefRelations failed!Node is [%s],the %d input edge",
                (peer_in_data_node->GetName()).c_str(), idx);
         return GRAPH_FAILED;
       }
-      auto ge_tensor_desc = peer_in_data_node->GetOpDesc()->GetInputDesc(static_cast<uint32_t>(idx));
-      if (ge_tensor_desc.GetOriginFormat() == FORMAT_ND) {
-        auto dim_num = ge_tensor_desc.GetShape().GetDimNum();
-        if (dim_num == 0) {
-          GELOGI("node name:%s idx:%d in is scalar. stop forward infer!", peer_in_data_node->GetName().c_str(), idx);
-          continue;
-        }
-        /// Check whether node to change dims ()
-        /// Because some node will calculate with 5D, C dim maybe multi meaning
-        auto peer_in_data_node_type = peer_in_data_node->GetType();
-        auto iter1 = kChangeDimNodes.find(peer_in_data_node_type);
-        // 4 means dims num
-        if ((iter1 != kChangeDimNodes.end()) && (dim_num < 4)) {
-          GELOGD("Node[%s] is change dim node. do not infer origin format", (peer_in_data_node->GetName()).c_str());
+      if (reflection.empty()) {
+        peer_in_desc->SetOriginFormat(to_be_set_format);
+        peer_in_desc->SetFormat(to_be_set_format);
+
+        /// Because netoutput node added before infer format ,so netoutput is end condition
+        /// must set netoutput format , because saved result depend on format
+        if (peer_in_data_node_type == NETOUTPUT) {
           continue;
         }
 
-        if (reflection.empty()) {
-          ge_tensor_desc.SetOriginFormat(to_be_set_format);
-          ge_tensor_desc.SetFormat(to_be_set_format);
-          (void)peer_in_data_node->GetOpDesc()->UpdateInputDesc(static_cast<uint32_t>(idx), ge_tensor_desc);
-
-          /// Because netoutput node added before infer format ,so netoutput is end condition
-          /// must set netoutput format , because saved result depend on format
-          if (peer_in_data_node_type == NETOUTPUT) {
-            continue;
-          }
-
-          // Call operator infer format api (forward) to get out format
-          GELOGD("call infer format func[Back]!Node is [%s] ", (peer_in_data_node->GetName()).c_str());
-          status = peer_in_data_node->InferOriginFormat();
-          if (status != GRAPH_SUCCESS) {
-            GELOGE(GRAPH_FAILED, "Node[%s] infer format failed", (peer_in_data_node->GetName()).c_str());
-            return GRAPH_FAILED;
-          }
-          nodes.push_back(peer_in_data_node);
-        } else {
-          auto status = ReflectionProcess(reflection, nodes, to_be_set_format);
-          if (status != GRAPH_SUCCESS) {
-            GELOGE(GRAPH_FAILED, "reflection process failed!");
-            return GRAPH_FAILED;
-          }
+        // Call operator infer format api (forward) to get out format
+        GELOGD("call infer format func[Back]!Node is [%s] ", (peer_in_data_node->GetName()).c_str());
+        status = peer_in_data_node->InferOriginFormat();
+        if (status != GRAPH_SUCCESS) {
+          GELOGE(GRAPH_FAILED, "Node[%s] infer format failed", (peer_in_data_node->GetName()).c_str());
+          return GRAPH_FAILED;
+        }
+        nodes.push_back(peer_in_data_node);
+      } else {
+        status = ReflectionProcess(reflection, nodes, to_be_set_format);
+        if (status != GRAPH_SUCCESS) {
+          GELOGE(GRAPH_FAILED, "reflection process failed!");
+          return GRAPH_FAILED;
         }
       }
     }
@@ -410,8 +402,7 @@ void FormatRefiner::RefreshOriginFormatOfAnchor(std::vector<ge::NodePtr> &anchor
 }
 
 graphStatus FormatRefiner::DataNodeFormatProcess(const ComputeGraphPtr &graph, std::vector<ge::NodePtr> &data_nodes,
-                                                 ge::Format data_format,
-                                                 std::unordered_map<ge::NodePtr, bool> &node_status) {
+                                                 ge::Format data_format, RefRelations &ref_relations) {
   if (!(IsGraphInferred(graph) && (!TypeUtils::IsInternalFormat(data_format)) && (data_format != FORMAT_ND))) {
     GELOGI("no necessary to do DataNodeFormatProcess. is_graph_inferred:%d, data_format:%s", IsGraphInferred(graph),
            TypeUtils::FormatToSerialString(data_format).c_str());
@@ -452,7 +443,7 @@ graphStatus FormatRefiner::DataNodeFormatProcess(const ComputeGraphPtr &graph, s
       continue;
     }
     GELOGD("data node [%s] start infer format process", node->GetName().c_str());
-    auto status = AnchorProcess(node, node_status);
+    auto status = AnchorProcess(node, ref_relations);
     if (status != GRAPH_SUCCESS) {
       GELOGE(GRAPH_FAILED, "data node [%s] infer format process failed!", node->GetName().c_str());
       return GRAPH_FAILED;
@@ -465,8 +456,6 @@ graphStatus FormatRefiner::DataNodeFormatProcess(const ComputeGraphPtr &graph, s
 graphStatus FormatRefiner::InferOrigineFormat(const ge::ComputeGraphPtr &graph) {
   GELOGI("Enter InferOrigineFormat process!");
 
-  // True: infered false:no-infered
-  std::unordered_map<ge::NodePtr, bool> node_status;
   std::vector<ge::NodePtr> anchor_points;
   std::vector<ge::NodePtr> data_nodes;
 
@@ -475,14 +464,15 @@ graphStatus FormatRefiner::InferOrigineFormat(const ge::ComputeGraphPtr &graph)
     return GRAPH_FAILED;
   }
   // build reflection relations of boundary
-  (void)reflection_builder.Clear();
-  auto status = reflection_builder.BuildRefRelations(*graph);
+  auto &ref_relations = reflection_builder;
+  (void)ref_relations.Clear();
+  auto status = ref_relations.BuildRefRelations(*graph);
   if (status != GRAPH_SUCCESS) {
     GELOGE(GRAPH_FAILED, "build reflection relations failed for main and subgraph!");
     return GRAPH_FAILED;
   }
   // User set global net format
-  status = GetAnchorPoints(graph, anchor_points, data_nodes, node_status);
+  status = GetAnchorPoints(graph, anchor_points, data_nodes);
   if (status != GRAPH_SUCCESS) {
     GELOGE(GRAPH_FAILED, "GetAnchorPoints Process Faild!");
     return GRAPH_FAILED;
@@ -494,7 +484,7 @@ graphStatus FormatRefiner::InferOrigineFormat(const ge::ComputeGraphPtr &graph)
     if (anchor_node == nullptr) {
       continue;
     }
-    status = AnchorProcess(anchor_node, node_status);
+    status = AnchorProcess(anchor_node, ref_relations);
     if (status != GRAPH_SUCCESS) {
       GELOGE(GRAPH_FAILED, "Anchor node [%s] process failed!", anchor_node->GetName().c_str());
       return GRAPH_FAILED;
@@ -505,7 +495,7 @@ graphStatus FormatRefiner::InferOrigineFormat(const ge::ComputeGraphPtr &graph)
   /// format for these data nodes.
   /// Notice: ignore 5D formats
   auto data_format = graph->GetDataFormat();
-  status = DataNodeFormatProcess(graph, data_nodes, data_format, node_status);
+  status = DataNodeFormatProcess(graph, data_nodes, data_format, ref_relations);
 
   (void)AttrUtils::SetBool(graph, kIsGraphInferred, true);
 
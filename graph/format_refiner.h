@@ -30,6 +30,7 @@
 #include "./compute_graph.h"
 #include "./external/graph/types.h"
 #include "./ge_error_codes.h"
+#include "graph/ref_relation.h"
 
 namespace ge {
 // ShapeRefiner performs shape inference for compute graphs
@@ -40,16 +41,14 @@ class METADEF_FUNC_VISIBILITY FormatRefiner {
  private:
   static graphStatus RefreshConstantOutProcess(const ComputeGraphPtr &graph, const OpDescPtr &op_desc);
   static graphStatus GetAnchorPoints(const ge::ComputeGraphPtr &graph, std::vector<ge::NodePtr> &anchor_points,
-                                     std::vector<ge::NodePtr> &data_nodes,
-                                     std::unordered_map<ge::NodePtr, bool> &node_status);
-  static graphStatus AnchorProcess(const ge::NodePtr &anchor_node, std::unordered_map<ge::NodePtr, bool> &node_status);
+                                     std::vector<ge::NodePtr> &data_nodes);
+  static graphStatus AnchorProcess(const ge::NodePtr &anchor_node, RefRelations &ref_relations);
   static void RefreshOriginFormatOfAnchor(std::vector<ge::NodePtr> &anchor_points);
-  static graphStatus BackInferProcess(std::deque<ge::NodePtr> &nodes, ge::NodePtr &node,
-                                      std::unordered_map<ge::NodePtr, bool> &node_status);
+  static graphStatus BackInferProcess(std::deque<ge::NodePtr> &nodes, ge::NodePtr &node, RefRelations &ref_relations);
   static graphStatus ForwardInferProcess(std::deque<ge::NodePtr> &nodes, ge::NodePtr &node,
-                                         std::unordered_map<ge::NodePtr, bool> &node_status);
+                                         RefRelations &ref_relations);
   static graphStatus DataNodeFormatProcess(const ComputeGraphPtr &graph, std::vector<ge::NodePtr> &data_nodes,
-                                           ge::Format data_format, std::unordered_map<ge::NodePtr, bool> &node_status);
+                                           ge::Format data_format, RefRelations &ref_relations);
   static bool IsGraphInferred(const ComputeGraphPtr &graph);
 };
 }  // namespace ge
@@ -22,6 +22,7 @@
 #include "graph/model_serialize.h"
 #include "proto/ge_ir.pb.h"
 #include "detail/model_serialize_imp.h"
+#include "graph/detail/weights_mapping.h"
 #include "debug/ge_attr_define.h"
 #include "debug/ge_log.h"
 #include "debug/ge_util.h"
@@ -435,6 +436,8 @@ bool GeAttrValueImp::SetValue(proto::AttrDef &proto_attr_val, const GeTensor &va
   if (!AttrUtilsHelper::SetValueCheckType(proto_attr_val, proto::AttrDef::kT)) {
     return false;
   }
+  // the old TensorDef is reused for the new value
+  WeightsMapping::Drop(proto_attr_val);
   if (val.tensor_def_.GetProtoOwner() != nullptr) {
     auto proto_msg = val.tensor_def_.GetProtoMsg();
     if (proto_msg == nullptr) {
@@ -469,6 +472,7 @@ bool GeAttrValueImp::SetValue(proto::AttrDef &proto_attr_val, const vector<Const
   }
   auto list = proto_attr_val.mutable_list();
   GE_CHECK_NOTNULL_EXEC(list, return false);
+  WeightsMapping::Drop(proto_attr_val);
   list->clear_t();
   for (const auto &item : value) {
     if (item == nullptr) {
@@ -507,6 +511,7 @@ bool GeAttrValueImp::SetValue(proto::AttrDef &proto_attr_val, const vector<GeTen
   }
   auto list = proto_attr_val.mutable_list();
   GE_CHECK_NOTNULL_EXEC(list, return false);
+  WeightsMapping::Drop(proto_attr_val);
   list->clear_t();
   for (const auto &item : value) {
     if (item.tensor_def_.GetProtoOwner() != nullptr) {
@@ -911,11 +916,11 @@ GE_FUNC_HOST_VISIBILITY bool GeAttrValueImp::SetZeroCopyBytes(proto::AttrDef &pr
   if (!AttrUtilsHelper::SetValueCheckType(proto_attr_val, proto::AttrDef::kBt)) {
     return false;
   }
-  auto proto_msg = buffer.data_.GetProtoMsg();
-  if (proto_msg == nullptr) {
+  auto bytes = buffer.MutableProtoBytes();
+  if (bytes == nullptr) {
     return false;
   }
-  proto_attr_val.set_bt(std::move(*proto_msg->mutable_bt()));
+  proto_attr_val.set_bt(std::move(*bytes));
   return true;
 }
 
@@ -938,11 +943,11 @@ bool GeAttrValueImp::SetZeroCopyListBytes(proto::AttrDef &proto_attr_val, const
   GE_CHECK_NOTNULL_EXEC(list, return false);
   list->clear_bt();
   for (auto &item : list_buffer) {
-    auto proto_msg = item.data_.GetProtoMsg();
-    if (proto_msg == nullptr) {
+    auto bytes = item.MutableProtoBytes();
+    if (bytes == nullptr) {
       return false;
     }
-    list->add_bt(std::move(*proto_msg->mutable_bt()));
+    list->add_bt(std::move(*bytes));
   }
   return true;
 }
@@ -1313,6 +1318,8 @@ std::string AttrUtils::GetAllAttrsStr(AttrUtils::ConstAttrHolderAdapter &&obj) {
   if (attrs_map.GetProtoMsg() == nullptr) {
     return "";
   }
+  // lazy tensors have no data in the proto yet, they would all serialize alike
+  WeightsMapping::Materialize(*attrs_map.GetProtoMsg());
 
   std::map<std::string, std::string> ordered_attrs;
   for (auto &attr : *(attrs_map.GetProtoMsg())) {
@@ -1336,6 +1343,8 @@ std::string AttrUtils::GetAttrsStrAfterRid(AttrUtils::ConstAttrHolderAdapter &&o
   if (attrs_map.GetProtoMsg() == nullptr) {
     return "";
   }
+  // lazy tensors have no data in the proto yet, they would all serialize alike
+  WeightsMapping::Materialize(*attrs_map.GetProtoMsg());
 
   std::map<std::string, std::string> ordered_attrs;
   for (auto &attr : *(attrs_map.GetProtoMsg())) {
@@ -23,6 +23,7 @@
 #include "debug/ge_attr_define.h"
 #include "debug/ge_util.h"
 #include "graph/ge_attr_value.h"
+#include "graph/detail/weights_mapping.h"
 #include "graph/model_serialize.h"
 #include "proto/ge_ir.pb.h"
 #include "utils/ge_ir_utils.h"
@@ -628,7 +629,6 @@ TensorData &TensorData::operator=(const TensorData &other) {
   return *this;
 }
 
-graphStatus TensorData::SetData(std::vector<uint8_t> &&data) { return SetData(data.data(), data.size()); }
 graphStatus TensorData::SetData(const std::vector<uint8_t> &data) { return SetData(data.data(), data.size()); }
 graphStatus TensorData::SetData(const Buffer &data) { return SetData(data.data(), data.size()); }
 graphStatus TensorData::SetData(const TensorData &data) { return SetData(data.data(), data.size()); }
@@ -670,6 +670,57 @@ graphStatus TensorData::SetData(const uint8_t *data, size_t size) {
   return GRAPH_SUCCESS;
 }
 
+graphStatus TensorData::SetData(std::vector<uint8_t> &&data) {
+  if (data.empty() || !CanAdopt(data.data(), data.size())) {
+    return SetData(data.data(), data.size());
+  }
+  auto holder = MakeShared<std::vector<uint8_t>>(std::move(data));
+  if (holder == nullptr) {
+    GELOGE(MEMALLOC_FAILED, "make shared for data failed, size=%zu", data.size());
+    return GRAPH_FAILED;
+  }
+  // the deleter keeps the vector alive as long as the aligned ptr
+  return AdoptData(holder->data(), holder->size(), [holder](uint8_t *ptr) { (void)ptr; });
+}
+
+graphStatus TensorData::SetData(uint8_t *data, size_t size, const std::function<void(uint8_t *)> &delete_func) {
+  if (delete_func == nullptr) {
+    GELOGE(GRAPH_PARAM_INVALID, "delete_func is null");
+    return GRAPH_PARAM_INVALID;
+  }
+  if ((data == nullptr) || (size == 0) || !CanAdopt(data, size)) {
+    auto ret = SetData(const_cast<const uint8_t *>(data), size);
+    if (data != nullptr) {
+      delete_func(data);
+    }
+    return ret;
+  }
+  return AdoptData(data, size, delete_func);
+}
+
+bool TensorData::CanAdopt(const uint8_t *data, size_t size) const {
+  // A buffer of the same size shared with other tensors is overwritten in place, they see the new data
+  if ((aligned_ptr_ != nullptr) && (length_ == size) && (aligned_ptr_.use_count() > 1)) {
+    return false;
+  }
+  return (reinterpret_cast<uintptr_t>(data) % kAlignmentBytes) == 0;
+}
+
+graphStatus TensorData::AdoptData(uint8_t *data, size_t size, const std::function<void(uint8_t *)> &delete_func) {
+  auto aligned_ptr = AlignedPtr::BuildFromAllocFunc([data](std::unique_ptr<uint8_t[], deleter> &ptr) {
+                                                      ptr.reset(data);
+                                                    },
+                                                    delete_func);
+  if (aligned_ptr == nullptr) {
+    GELOGE(MEMALLOC_FAILED, "build aligned ptr failed, size=%zu", size);
+    delete_func(data);
+    return GRAPH_FAILED;
+  }
+  aligned_ptr_ = std::move(aligned_ptr);
+  length_ = size;
+  return GRAPH_SUCCESS;
+}
+
 void TensorData::SetData(std::shared_ptr<AlignedPtr> aligned_ptr, size_t size) {
   aligned_ptr_ = std::move(aligned_ptr);
   length_ = size;
@@ -744,7 +795,7 @@ GeTensor::GeTensor(const GeTensorDesc &tensor_desc, const uint8_t *data, size_t
 
 GeTensor::GeTensor(GeTensorDesc &&tensor_desc, vector<uint8_t> &&data) : GeTensor() {
   DescReference() = std::move(tensor_desc);
-  if (tensor_data_.SetData(data) != GRAPH_SUCCESS) {
+  if (tensor_data_.SetData(std::move(data)) != GRAPH_SUCCESS) {
     GELOGW("Set data failed");
   }
 }
@@ -788,6 +839,7 @@ GeTensor::GeTensor(const ProtoMsgOwner &proto_owner, proto::TensorDef *proto_msg
       GeTensorDesc tensor_desc(proto_owner, proto_msg->mutable_desc());
       tensor_data_.tensor_descriptor_ = tensor_desc.tensor_descriptor_;
       DescReference() = tensor_desc;
+      (void)WeightsMapping::Materialize(proto_msg);
       if (tensor_data_.SetData(reinterpret_cast<const uint8_t *>(proto_msg->data().data()),
                                proto_msg->data().size()) != GRAPH_SUCCESS) {
         GELOGW("Set data failed");
@@ -818,6 +870,30 @@ void GeTensor::BuildAlignerPtrWithProtoData() {
                                          });
 }
 
+void GeTensor::MaterializeLazyData() const {
+  if (!WeightsMapping::HasLazyWeights() || tensor_def_.GetProtoOwner() == nullptr) {
+    return;
+  }
+  auto proto_msg = tensor_def_.GetProtoMsg();
+  if (proto_msg == nullptr) {
+    return;
+  }
+  // another tensor sharing the proto may have copied the weight in already
+  if (WeightsMapping::Materialize(proto_msg) || (proto_msg->data().size() != tensor_data_.GetSize())) {
+    const_cast<GeTensor *>(this)->BuildAlignerPtrWithProtoData();
+  }
+}
+
+const TensorData &GeTensor::GetData() const {
+  MaterializeLazyData();
+  return tensor_data_;
+}
+
+TensorData &GeTensor::MutableData() {
+  MaterializeLazyData();
+  return tensor_data_;
+}
+
 GeTensorDesc GeTensor::GetTensorDesc() const { return DescReference(); }
 
 GeTensorDesc &GeTensor::MutableTensorDesc() { return DescReference(); }
@@ -849,17 +925,19 @@ graphStatus GeTensor::SetData(vector<uint8_t> &&data) {
   if (tensor_def_.GetProtoOwner() != nullptr) {
     auto proto_msg = tensor_def_.GetProtoMsg();
     GE_CHECK_NOTNULL(proto_msg);
+    WeightsMapping::Drop(proto_msg);
     proto_msg->set_data(data.data(), data.size());
     BuildAlignerPtrWithProtoData();
     return GRAPH_SUCCESS;
   }
-  return tensor_data_.SetData(data);
+  return tensor_data_.SetData(std::move(data));
 }
 
 graphStatus GeTensor::SetData(const vector<uint8_t> &data) {
   if (tensor_def_.GetProtoOwner() != nullptr) {
     auto proto_msg = tensor_def_.GetProtoMsg();
     GE_CHECK_NOTNULL(proto_msg);
+    WeightsMapping::Drop(proto_msg);
     proto_msg->set_data(data.data(), data.size());
     BuildAlignerPtrWithProtoData();
     return GRAPH_SUCCESS;
@@ -874,6 +952,7 @@ graphStatus GeTensor::SetData(const uint8_t *data, size_t size) {
   if (tensor_def_.GetProtoOwner() != nullptr) {
     auto proto_msg = tensor_def_.GetProtoMsg();
     GE_CHECK_NOTNULL(proto_msg);
+    WeightsMapping::Drop(proto_msg);
     proto_msg->set_data(data, size);
     BuildAlignerPtrWithProtoData();
     return GRAPH_SUCCESS;
@@ -881,10 +960,23 @@ graphStatus GeTensor::SetData(const uint8_t *data, size_t size) {
   return tensor_data_.SetData(data, size);
 }
 
+graphStatus GeTensor::SetData(uint8_t *data, size_t size, const std::function<void(uint8_t *)> &delete_func) {
+  if ((tensor_def_.GetProtoOwner() != nullptr) && (delete_func != nullptr)) {
+    // the proto owns its bytes, so they are copied in
+    auto ret = SetData(const_cast<const uint8_t *>(data), size);
+    if (data != nullptr) {
+      delete_func(data);
+    }
+    return ret;
+  }
+  return tensor_data_.SetData(data, size, delete_func);
+}
+
 graphStatus GeTensor::SetData(const Buffer &data) {
   if (tensor_def_.GetProtoOwner() != nullptr) {
     auto proto_msg = tensor_def_.GetProtoMsg();
     GE_CHECK_NOTNULL(proto_msg);
+    WeightsMapping::Drop(proto_msg);
     if (data.size() == 0) {
       GELOGI("GetSize res is 0.");
     }
@@ -902,6 +994,7 @@ graphStatus GeTensor::SetData(const TensorData &data) {
   if (tensor_def_.GetProtoOwner() != nullptr) {
     auto proto_msg = tensor_def_.GetProtoMsg();
     GE_CHECK_NOTNULL(proto_msg);
+    WeightsMapping::Drop(proto_msg);
     proto_msg->set_data(data.data(), data.size());
     BuildAlignerPtrWithProtoData();
     return GRAPH_SUCCESS;
@@ -913,6 +1006,7 @@ void GeTensor::ClearData() {
   if (tensor_def_.GetProtoOwner() != nullptr) {
     auto proto_msg = tensor_def_.GetProtoMsg();
     if (proto_msg != nullptr) {
+      WeightsMapping::Drop(proto_msg);
       proto_msg->clear_data();
     }
   }
@@ -16,6 +16,7 @@
 
 #include "graph/gnode.h"
 
+#include <atomic>
 #include <utility>
 #include "debug/ge_util.h"
 #include "framework/common/debug/ge_log.h"
@@ -56,14 +57,13 @@ GNode NodeAdapter::Node2GNode(const ge::NodePtr &node) {
     return GNode();
   }
 
-  GNode graph_node;
-  if (graph_node.impl_ == nullptr) {
+  GNodePtr gnode = Node2GNodePtr(node);
+  if (gnode == nullptr) {
     GELOGW("Node2GNode: gnode impl is nullptr, node[%s].", node->GetName().c_str());
-    return graph_node;
+    return GNode();
   }
-  graph_node.impl_->node_ptr_ = node;
-
-  return graph_node;
+  // copies share the impl of the cached handle
+  return *gnode;
 }
 
 GNodePtr NodeAdapter::Node2GNodePtr(const ge::NodePtr &node) {
@@ -72,6 +72,11 @@ GNodePtr NodeAdapter::Node2GNodePtr(const ge::NodePtr &node) {
     return nullptr;
   }
 
+  GNodePtr cached = std::atomic_load(&node->gnode_);
+  if (cached != nullptr) {
+    return cached;
+  }
+
   GNodePtr gnode = std::shared_ptr<GNode>(new (std::nothrow) GNode());
   if (gnode == nullptr) {
     GELOGE(GRAPH_FAILED, "Node2GNodePtr: gnode is nullptr, node[%s].", node->GetName().c_str());
@@ -84,6 +89,10 @@ GNodePtr NodeAdapter::Node2GNodePtr(const ge::NodePtr &node) {
   }
   gnode->impl_->node_ptr_ = node;
 
+  // another thread may have cached its handle first, keep that one so every caller gets the same
+  if (!std::atomic_compare_exchange_strong(&node->gnode_, &cached, gnode)) {
+    return cached;
+  }
   return gnode;
 }
 
@@ -253,6 +262,131 @@ std::vector<GNodePtr> GNode::GetOutControlNodes() const {
   return gnodes;
 }
 
+namespace {
+const int32_t kControlPortIndex = -1;
+
+// Calls visitor with the owners of the peers of anchor that are PeerAnchor, until it fails
+template <typename PeerAnchor>
+graphStatus VisitPeerNodes(const Anchor &anchor, bool is_control, const GNode::NodeVisitor &visitor) {
+  graphStatus ret = GRAPH_SUCCESS;
+  const bool completed = anchor.ForEachPeerAnchor([&visitor, &ret, is_control](const AnchorPtr &peer) {
+    if ((ret != GRAPH_SUCCESS) || !peer->IsTypeOf<PeerAnchor>()) {
+      return;
+    }
+    NodePtr peer_node = peer->GetOwnerNode();
+    if (peer_node == nullptr) {
+      return;
+    }
+    GNodePtr gnode = NodeAdapter::Node2GNodePtr(peer_node);
+    if (gnode == nullptr) {
+      GELOGE(GRAPH_FAILED, "Peer node[%s] to gnode failed.", peer_node->GetName().c_str());
+      ret = GRAPH_FAILED;
+      return;
+    }
+    ret = visitor(*gnode, is_control ? kControlPortIndex : peer->GetIdx());
+  });
+  if (!completed && (ret == GRAPH_SUCCESS)) {
+    GELOGE(GRAPH_FAILED, "Edges of node[%s] were modified while visiting its peers.",
+           (anchor.GetOwnerNode() == nullptr) ? "" : anchor.GetOwnerNode()->GetName().c_str());
+    return GRAPH_FAILED;
+  }
+  return ret;
+}
+}  // namespace
+
+graphStatus GNode::VisitInDataNodes(const NodeVisitor &visitor) const {
+  if (impl_ == nullptr) {
+    GELOGE(GRAPH_FAILED, "VisitInDataNodes: node impl is nullptr.");
+    return GRAPH_FAILED;
+  }
+  std::shared_ptr<Node> node_ptr = impl_->node_ptr_.lock();
+  if (node_ptr == nullptr) {
+    GELOGE(GRAPH_FAILED, "VisitInDataNodes: the node shared ptr is not valid.");
+    return GRAPH_FAILED;
+  }
+
+  const int32_t in_num = static_cast<int32_t>(node_ptr->GetAllInDataAnchorsSize());
+  for (int32_t i = 0; i < in_num; ++i) {
+    auto in_anchor = node_ptr->GetInDataAnchor(i);
+    if (in_anchor == nullptr) {
+      continue;
+    }
+    graphStatus ret = VisitPeerNodes<OutDataAnchor>(*in_anchor, false, visitor);
+    if (ret != GRAPH_SUCCESS) {
+      return ret;
+    }
+  }
+  return GRAPH_SUCCESS;
+}
+
+graphStatus GNode::VisitOutDataNodes(const int32_t index, const NodeVisitor &visitor) const {
+  if (impl_ == nullptr) {
+    GELOGE(GRAPH_FAILED, "VisitOutDataNodes: node impl is nullptr.");
+    return GRAPH_FAILED;
+  }
+  std::shared_ptr<Node> node_ptr = impl_->node_ptr_.lock();
+  if (node_ptr == nullptr) {
+    GELOGE(GRAPH_FAILED, "VisitOutDataNodes: the node shared ptr is not valid.");
+    return GRAPH_FAILED;
+  }
+
+  auto out_anchor = node_ptr->GetOutDataAnchor(index);
+  if (out_anchor == nullptr) {
+    GELOGE(GRAPH_FAILED, "Failed to get out data anchor of index %d from node %s.", index,
+           node_ptr->GetName().c_str());
+    return GRAPH_FAILED;
+  }
+  return VisitPeerNodes<InDataAnchor>(*out_anchor, false, visitor);
+}
+
+graphStatus GNode::VisitInControlNodes(const NodeVisitor &visitor) const {
+  if (impl_ == nullptr) {
+    GELOGE(GRAPH_FAILED, "VisitInControlNodes: node impl is nullptr.");
+    return GRAPH_FAILED;
+  }
+  std::shared_ptr<Node> node_ptr = impl_->node_ptr_.lock();
+  if (node_ptr == nullptr) {
+    GELOGE(GRAPH_FAILED, "VisitInControlNodes: the node shared ptr is not valid.");
+    return GRAPH_FAILED;
+  }
+
+  auto in_control_anchor = node_ptr->GetInControlAnchor();
+  if (in_control_anchor == nullptr) {
+    return GRAPH_SUCCESS;
+  }
+  return VisitPeerNodes<OutControlAnchor>(*in_control_anchor, true, visitor);
+}
+
+graphStatus GNode::VisitOutControlNodes(const NodeVisitor &visitor) const {
+  if (impl_ == nullptr) {
+    GELOGE(GRAPH_FAILED, "VisitOutControlNodes: node impl is nullptr.");
+    return GRAPH_FAILED;
+  }
+  std::shared_ptr<Node> node_ptr = impl_->node_ptr_.lock();
+  if (node_ptr == nullptr) {
+    GELOGE(GRAPH_FAILED, "VisitOutControlNodes: the node shared ptr is not valid.");
+    return GRAPH_FAILED;
+  }
+
+  // same peers and order as Node::GetOutControlNodes
+  const int32_t out_num = static_cast<int32_t>(node_ptr->GetAllOutDataAnchorsSize());
+  for (int32_t i = 0; i < out_num; ++i) {
+    auto out_anchor = node_ptr->GetOutDataAnchor(i);
+    if (out_anchor == nullptr) {
+      continue;
+    }
+    graphStatus ret = VisitPeerNodes<InControlAnchor>(*out_anchor, true, visitor);
+    if (ret != GRAPH_SUCCESS) {
+      return ret;
+    }
+  }
+  auto out_control_anchor = node_ptr->GetOutControlAnchor();
+  if (out_control_anchor == nullptr) {
+    return GRAPH_SUCCESS;
+  }
+  return VisitPeerNodes<Anchor>(*out_control_anchor, true, visitor);
+}
+
 graphStatus GNode::GetInputConstData(const int32_t index, Tensor &data) const {
   if (impl_ == nullptr) {
     GELOGE(GRAPH_FAILED, "GetInputConstData: node impl is nullptr.");
@@ -427,7 +561,7 @@ graphStatus GNode::GetInputDesc(const int32_t index, TensorDesc &tensor_desc) co
     GELOGE(GRAPH_FAILED, "Get tensor desc of node[%s] failed.", node_ptr->GetName().c_str());
     return GRAPH_FAILED;
   }
-  tensor_desc = TensorAdapter::GeTensorDesc2TensorDesc(*ge_tensor_desc);
+  TensorAdapter::AsTensorDesc(ge_tensor_desc, tensor_desc);
 
   return GRAPH_SUCCESS;
 }
@@ -492,7 +626,7 @@ graphStatus GNode::GetOutputDesc(const int32_t index, TensorDesc &tensor_desc) c
     GELOGE(GRAPH_FAILED, "Get tensor desc of node[%s] failed.", node_ptr->GetName().c_str());
     return GRAPH_FAILED;
   }
-  tensor_desc = TensorAdapter::GeTensorDesc2TensorDesc(*ge_tensor_desc);
+  TensorAdapter::AsTensorDesc(ge_tensor_desc, tensor_desc);
 
   return GRAPH_SUCCESS;
 }
@@ -472,9 +472,10 @@ std::vector<GNode> Graph::GetAllNodes() const {
     return graph_nodes;
   }
 
-  for (auto &node : compute_graph_ptr->GetAllNodes()) {
-    GNode gnode = NodeAdapter::Node2GNode(node);
-    graph_nodes.emplace_back(gnode);
+  auto nodes = compute_graph_ptr->GetAllNodes();
+  graph_nodes.reserve(nodes.size());
+  for (auto &node : nodes) {
+    graph_nodes.emplace_back(NodeAdapter::Node2GNode(node));
   }
 
   return graph_nodes;
@@ -492,9 +493,10 @@ std::vector<GNode> Graph::GetDirectNode() const {
     return graph_nodes;
   }
 
-  for (auto &node : compute_graph_ptr->GetDirectNode()) {
-    GNode gnode = NodeAdapter::Node2GNode(node);
-    graph_nodes.emplace_back(gnode);
+  auto nodes = compute_graph_ptr->GetDirectNode();
+  graph_nodes.reserve(nodes.size());
+  for (auto &node : nodes) {
+    graph_nodes.emplace_back(NodeAdapter::Node2GNode(node));
   }
 
   return graph_nodes;
@@ -32,6 +32,7 @@ COMMON_LOCAL_SRC_FILES := \
     ./ge_attr_define.cc \
     ./ge_tensor.cc \
     ./detail/attributes_holder.cc \
+    ./detail/weights_mapping.cc \
     ./utils/anchor_utils.cc \
     ./utils/tuning_utils.cc \
     ./utils/graph_utils.cc \
@@ -39,6 +40,7 @@ COMMON_LOCAL_SRC_FILES := \
     ./utils/op_desc_utils.cc \
     ./utils/type_utils.cc \
     ./utils/tensor_utils.cc \
+    ./utils/thread_pool.cc \
     ./tensor.cc \
     ./debug/graph_debug.cc \
     ./opsproto/opsproto_manager.cc \
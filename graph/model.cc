@@ -29,6 +29,7 @@
 #include "debug/ge_util.h"
 #include "framework/common/debug/ge_log.h"
 #include "graph/model_serialize.h"
+#include "graph/detail/weights_mapping.h"
 #include "mmpa/mmpa_api.h"
 #include "utils/attr_utils.h"
 #include "utils/ge_ir_utils.h"
@@ -145,7 +146,7 @@ graphStatus Model::SaveToFile(const string &file_name) const {
 
 bool Model::IsValid() const { return graph_.IsValid(); }
 
-graphStatus Model::LoadFromFile(const string &file_name) {
+graphStatus Model::LoadFromFile(const string &file_name, bool lazy_load_weights) {
   char real_path[MMPA_MAX_PATH] = {0x00};
   if (strlen(file_name.c_str()) >= MMPA_MAX_PATH) {
     return GRAPH_FAILED;
@@ -155,6 +156,15 @@ graphStatus Model::LoadFromFile(const string &file_name) {
     GELOGE(GRAPH_FAILED, "file %s does not exit, can not load.", file_name.c_str());
     return GRAPH_FAILED;
   }
+  if (lazy_load_weights) {
+    auto weights_mapping = WeightsMapping::Create(real_path);
+    if (weights_mapping == nullptr) {
+      GELOGE(GRAPH_FAILED, "map file %s failed.", real_path);
+      return GRAPH_FAILED;
+    }
+    ModelSerialize serialize;
+    return serialize.UnserializeModel(weights_mapping, *this) ? GRAPH_SUCCESS : GRAPH_FAILED;
+  }
   int fd = mmOpen(real_path, M_RDONLY);
   if (fd < 0) {
     GELOGE(GRAPH_FAILED, "open file failed, %s", strerror(errno));
@@ -15,8 +15,10 @@
  */
 
 #include "graph/model_serialize.h"
+#include <google/protobuf/io/coded_stream.h>
 #include <google/protobuf/text_format.h>
 
+#include <algorithm>
 #include <queue>
 #include <iostream>
 
@@ -24,14 +26,115 @@
 #include "debug/ge_log.h"
 #include "debug/ge_util.h"
 #include "graph/detail/model_serialize_imp.h"
+#include "graph/detail/weights_mapping.h"
 #include "proto/ge_ir.pb.h"
 #include "utils/graph_utils.h"
+#include "utils/thread_pool.h"
 #include "debug/ge_op_types.h"
 
 using std::map;
 using std::string;
 
 namespace ge {
+namespace {
+const int kParallelSubgraphMinNum = 4;
+const int kParallelOpMinNum = 1024;
+const int kOpNumPerTask = 256;
+// Encoded tag sizes, field numbers below 16 take one byte and below 2048 two bytes
+const size_t kSmallTagSize = 1U;
+const size_t kLargeTagSize = 2U;
+
+size_t ProtoByteSize(const google::protobuf::Message &msg) {
+#if !defined(__ANDROID__) && !defined(ANDROID)
+  return msg.ByteSizeLong();
+#else
+  return static_cast<size_t>(msg.ByteSize());
+#endif
+}
+
+size_t LengthDelimitedSize(size_t tag_size, size_t len) {
+  return tag_size + google::protobuf::io::CodedOutputStream::VarintSize64(static_cast<uint64_t>(len)) + len;
+}
+
+size_t DecimalSize(int64_t value) {
+  size_t size = (value < 0) ? 2U : 1U;
+  uint64_t abs_value = (value < 0) ? (0U - static_cast<uint64_t>(value)) : static_cast<uint64_t>(value);
+  while (abs_value >= 10U) {
+    abs_value /= 10U;
+    ++size;
+  }
+  return size;
+}
+
+size_t AttrEntrySize(const std::string &key, size_t value_size) {
+  size_t entry_size = LengthDelimitedSize(kSmallTagSize, key.size()) + LengthDelimitedSize(kSmallTagSize, value_size);
+  return LengthDelimitedSize(kSmallTagSize, entry_size);
+}
+
+// Size of a TensorDef once its lazy weight is copied in
+size_t TensorDefSize(const proto::TensorDef &tensor_def) {
+  size_t size = ProtoByteSize(tensor_def);
+  size_t lazy_size = WeightsMapping::GetLazySize(&tensor_def);
+  return (lazy_size == 0U) ? size : (size + LengthDelimitedSize(kSmallTagSize, lazy_size));
+}
+
+// Size of an AttrDef once the lazy weights of its tensors are copied in
+size_t AttrDefSize(const proto::AttrDef &attr_def) {
+  size_t size = ProtoByteSize(attr_def);
+  if (attr_def.has_t()) {
+    size_t tensor_size = ProtoByteSize(attr_def.t());
+    return size - LengthDelimitedSize(kSmallTagSize, tensor_size) +
+           LengthDelimitedSize(kSmallTagSize, TensorDefSize(attr_def.t()));
+  }
+  if (attr_def.has_list()) {
+    size_t list_size = ProtoByteSize(attr_def.list());
+    size_t full_list_size = list_size;
+    for (const auto &tensor_def : attr_def.list().t()) {
+      full_list_size = full_list_size - LengthDelimitedSize(kSmallTagSize, ProtoByteSize(tensor_def)) +
+                       LengthDelimitedSize(kSmallTagSize, TensorDefSize(tensor_def));
+    }
+    return size - LengthDelimitedSize(kSmallTagSize, list_size) + LengthDelimitedSize(kSmallTagSize, full_list_size);
+  }
+  return size;
+}
+
+// Bytes the lazy weights of attr_map add once they are copied in, the weights themselves stay in the mapping
+size_t LazyWeightsSize(const ProtoAttrMap &attr_map) {
+  if (!WeightsMapping::HasLazyWeights()) {
+    return 0U;
+  }
+  size_t size = 0U;
+  for (const auto &it : attr_map) {
+    if (it.second.has_t() || (it.second.has_list() && (it.second.list().t_size() > 0))) {
+      size += AttrEntrySize(it.first, AttrDefSize(it.second)) - AttrEntrySize(it.first, ProtoByteSize(it.second));
+    }
+  }
+  return size;
+}
+
+// All the attr map fields of ModelDef, GraphDef and OpDef have field numbers below 16
+size_t AttrMapSize(const ProtoAttrMap &attr_map) {
+  size_t size = 0U;
+  for (const auto &it : attr_map) {
+    size += AttrEntrySize(it.first, ProtoByteSize(it.second));
+  }
+  return size;
+}
+
+size_t TensorDescsSize(const google::protobuf::RepeatedPtrField<proto::TensorDescriptor> &descs) {
+  size_t size = 0U;
+  for (const auto &desc : descs) {
+    size += LengthDelimitedSize(kLargeTagSize, ProtoByteSize(desc));
+  }
+  return size;
+}
+
+size_t OpIdSize(int64_t id) {
+  return (id == 0) ? 0U :
+         kLargeTagSize + google::protobuf::io::CodedOutputStream::VarintSize64(static_cast<uint64_t>(id));
+}
+}  // namespace
+
 bool ModelSerializeImp::ParseNodeIndex(const string &node_index, string &node_name, int32_t &index) {
   auto sep = node_index.rfind(":");
   if (sep == string::npos) {
@@ -90,6 +193,7 @@ bool ModelSerializeImp::SerializeOpDesc(const ConstOpDescPtr &op_desc, proto::Op
   GE_CHK_BOOL_EXEC(op_desc != nullptr, return false, "op_desc is null.");
   GE_CHK_BOOL_EXEC(op_def_proto != nullptr, return false, "op_def_proto is null.");
   if (op_desc->op_def_.GetProtoMsg() != nullptr) {
+    WeightsMapping::Materialize(op_desc->op_def_.GetProtoMsg()->attr());
     *op_def_proto = *op_desc->op_def_.GetProtoMsg();
     //Delete unnecessary attr
     if (is_dump) {
@@ -246,6 +350,132 @@ bool ModelSerializeImp::SerializeModel(const Model &model, proto::ModelDef *mode
   return true;
 }
 
+bool ModelSerializeImp::GetNodeSize(const NodePtr &node, size_t &size) {
+  GE_CHK_BOOL_EXEC(node != nullptr, return false, "node is null.");
+  auto op_desc = node->GetOpDesc();
+  GE_CHK_BOOL_EXEC(op_desc != nullptr, return false, "op_desc is null.");
+  size = 0U;
+  auto op_def = op_desc->op_def_.GetProtoMsg();
+  if (op_def != nullptr) {
+    // What SerializeOpDesc copies from op_def, without the fields it rebuilds
+    size = ProtoByteSize(*op_def) + LazyWeightsSize(op_def->attr());
+    for (const auto &input : op_def->input()) {
+      size -= LengthDelimitedSize(kSmallTagSize, input.size());
+    }
+    size -= TensorDescsSize(op_def->input_desc()) + TensorDescsSize(op_def->output_desc()) + OpIdSize(op_def->id());
+
+    auto input_size = static_cast<uint32_t>(op_desc->GetAllInputsSize());
+    for (uint32_t i = 0; i < input_size; i++) {
+      auto tensor_desc = op_desc->GetInputDescPtrDfault(i);
+      if (tensor_desc != nullptr && tensor_desc->tensor_descriptor_.GetProtoMsg() != nullptr) {
+        size += LengthDelimitedSize(kLargeTagSize, ProtoByteSize(*tensor_desc->tensor_descriptor_.GetProtoMsg()));
+      }
+    }
+    auto output_size = static_cast<uint32_t>(op_desc->GetOutputsSize());
+    for (uint32_t i = 0; i < output_size; i++) {
+      auto tensor_desc = op_desc->GetOutputDescPtr(i);
+      if (tensor_desc != nullptr && tensor_desc->tensor_descriptor_.GetProtoMsg() != nullptr) {
+        size += LengthDelimitedSize(kLargeTagSize, ProtoByteSize(*tensor_desc->tensor_descriptor_.GetProtoMsg()));
+      }
+    }
+    size += OpIdSize(op_desc->GetId());
+    for (const std::string &name : op_desc->GetSubgraphInstanceNames()) {
+      size += LengthDelimitedSize(kLargeTagSize, name.size());
+    }
+    // The name index attrs only hold names, and are not added over attrs of the same key
+    proto::OpDef name_attrs;
+    OpDescToAttrDef(op_desc, &name_attrs);
+    for (const auto &it : name_attrs.attr()) {
+      if (op_def->attr().count(it.first) == 0) {
+        size += AttrEntrySize(it.first, ProtoByteSize(it.second));
+      }
+    }
+  }
+
+  // Inputs as written by SerializeEdge, "name:index" for data and "name:-1" for control edges
+  for (const auto &in_data_anchor : node->GetAllInDataAnchors()) {
+    if (in_data_anchor != nullptr) {
+      auto peer_out_anchor = in_data_anchor->GetPeerOutAnchor();
+      size_t input_len = 0U;
+      if (peer_out_anchor != nullptr && peer_out_anchor->GetOwnerNode()) {
+        input_len = peer_out_anchor->GetOwnerNode()->GetName().size() + 1U + DecimalSize(peer_out_anchor->GetIdx());
+      }
+      size += LengthDelimitedSize(kSmallTagSize, input_len);
+    }
+  }
+  auto control_anchor = node->GetInControlAnchor();
+  if (control_anchor != nullptr) {
+    for (const auto &peer_out_anchor : control_anchor->GetPeerOutControlAnchors()) {
+      if (peer_out_anchor != nullptr && peer_out_anchor->GetOwnerNode()) {
+        size += LengthDelimitedSize(kSmallTagSize, peer_out_anchor->GetOwnerNode()->GetName().size() + 3U);
+      }
+    }
+  }
+  return true;
+}
+
+bool ModelSerializeImp::GetGraphSize(const ConstComputeGraphPtr &graph, size_t &size) {
+  if (graph == nullptr) {
+    GELOGE(GRAPH_FAILED, "Input para Invalid");
+    return false;
+  }
+  size = graph->GetName().empty() ? 0U : LengthDelimitedSize(kSmallTagSize, graph->GetName().size());
+  for (const auto &input : graph->GetInputNodes()) {
+    if (input != nullptr) {
+      size += LengthDelimitedSize(kSmallTagSize, input->GetName().size() + 2U);
+    }
+  }
+  for (const auto &output : graph->GetGraphOutNodesInfo()) {
+    if (output.first != nullptr) {
+      size += LengthDelimitedSize(kSmallTagSize, output.first->GetName().size() + 1U + DecimalSize(output.second));
+    }
+  }
+  if (graph->attrs_.GetProtoMsg() != nullptr) {
+    size += AttrMapSize(*graph->attrs_.GetProtoMsg());
+  }
+  for (const auto &node : graph->GetDirectNode()) {
+    size_t node_size = 0U;
+    if (!GetNodeSize(node, node_size)) {
+      GELOGE(GRAPH_FAILED, "Get size of node %s failed", node->GetName().c_str());
+      return false;
+    }
+    size += LengthDelimitedSize(kSmallTagSize, node_size);
+  }
+  return true;
+}
+
+bool ModelSerializeImp::GetModelSize(const Model &model, size_t &size) {
+  auto compute_graph = GraphUtils::GetComputeGraph(model.graph_);
+  if (compute_graph == nullptr) {
+    GELOGE(GRAPH_FAILED, "GetComputeGraph return nullptr");
+    return false;
+  }
+  size = 0U;
+  if (!model.GetName().empty()) {
+    size += LengthDelimitedSize(kSmallTagSize, model.GetName().size());
+  }
+  if (model.GetVersion() != 0U) {
+    size += kSmallTagSize + google::protobuf::io::CodedOutputStream::VarintSize32(model.GetVersion());
+  }
+  if (!model.GetPlatformVersion().empty()) {
+    size += LengthDelimitedSize(kSmallTagSize, model.GetPlatformVersion().size());
+  }
+  if (model.attrs_.GetProtoMsg() != nullptr) {
+    size += AttrMapSize(*model.attrs_.GetProtoMsg());
+  }
+  std::vector<ComputeGraphPtr> graphs = compute_graph->GetAllSubgraphs();
+  graphs.insert(graphs.begin(), compute_graph);
+  for (const auto &graph : graphs) {
+    size_t graph_size = 0U;
+    if (!GetGraphSize(graph, graph_size)) {
+      GELOGE(GRAPH_FAILED, "Get size of graph failed");
+      return false;
+    }
+    size += LengthDelimitedSize(kSmallTagSize, graph_size);
+  }
+  return true;
+}
+
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY bool ModelSerializeImp::UnserializeTensor(
     GeTensorPtr &tensor, proto::TensorDef &tensor_proto) {
   tensor = std::shared_ptr<GeTensor>(new (std::nothrow) GeTensor(protobuf_owner_, &tensor_proto));
@@ -375,37 +605,59 @@ bool ModelSerializeImp::UnserializeNode(ComputeGraphPtr &graph, proto::OpDef &op
   if (!UnserializeOpDesc(op_desc, op_def_proto)) {
     GELOGW("UnserializeOpDesc error.");
   }
+  return AddNode(graph, op_desc, op_def_proto);
+}
 
+bool ModelSerializeImp::AddNode(ComputeGraphPtr &graph, const OpDescPtr &op_desc, const proto::OpDef &op_def_proto) {
+  GE_CHK_BOOL_EXEC(op_desc != nullptr, return false, "op_desc is nullptr.");
   NodePtr node = graph->AddNode(op_desc, op_desc->GetId());
   GE_CHK_BOOL_EXEC(node != nullptr, return false, "node is nullptr.");
 
-  // Inputs
+  // Inputs, producers serialized before this node are bound by index right away
   int dst_index = 0;
   for (const auto &input : op_def_proto.input()) {
     string node_name;
     int32_t index = 0;
     if (ParseNodeIndex(input, node_name, index)) {
-      node_input_node_names_.push_back(NodeNameNodeReq{node_name, index, node, dst_index, op_def_proto.name()});
+      auto it = node_map_.find(node_name);
+      int64_t src_node_index = (it == node_map_.end()) ? -1 : static_cast<int64_t>(it->second);
+      node_input_node_names_.push_back(
+          NodeNameNodeReq{node_name, index, node, dst_index, op_def_proto.name(), src_node_index});
     }
     if (index >= 0) {
       dst_index++;
     }
   }
-  node_map_[op_def_proto.name()] = node;
+  auto ret = node_map_.emplace(op_def_proto.name(), nodes_.size());
+  if (!ret.second) {
+    ret.first->second = nodes_.size();
+    has_duplicate_name_ = true;
+  }
+  nodes_.push_back(node);
   return true;
 }
 
+NodePtr ModelSerializeImp::FindNode(const string &node_name) const {
+  auto it = node_map_.find(node_name);
+  return (it == node_map_.end()) ? nullptr : nodes_[it->second];
+}
+
 bool ModelSerializeImp::HandleNodeNameRef() {
   // Edges
   for (auto &item : node_input_node_names_) {
-    auto src_node_it = node_map_.find(item.src_node_name);
-    if (src_node_it == node_map_.end()) {
-      GELOGE(GRAPH_FAILED, "cannot find node %s", item.src_node_name.c_str());
-      return false;
+    // A later node with the same name takes over the edges, as the name lookup always did
+    if (item.src_node_index < 0 || has_duplicate_name_) {
+      auto src_node_it = node_map_.find(item.src_node_name);
+      if (src_node_it == node_map_.end()) {
+        GELOGE(GRAPH_FAILED, "cannot find node %s", item.src_node_name.c_str());
+        return false;
+      }
+      item.src_node_index = static_cast<int64_t>(src_node_it->second);
     }
-    GE_IF_BOOL_EXEC(src_node_it->second == nullptr || item.dst_node == nullptr, continue);
+    const NodePtr &src_node = nodes_[item.src_node_index];
+    GE_IF_BOOL_EXEC(item.dst_node == nullptr, continue);
     if (item.src_out_index >= 0) {
-      auto src_anchor = src_node_it->second->GetOutDataAnchor(item.src_out_index);
+      auto src_anchor = src_node->GetOutDataAnchor(item.src_out_index);
       auto dst_anchor = item.dst_node->GetInDataAnchor(item.dst_in_index);
       if (src_anchor == nullptr || dst_anchor == nullptr) {
         GELOGE(GRAPH_FAILED, "get anchor failed %s:%d, %s:%d ", item.src_node_name.c_str(), item.src_out_index,
@@ -415,7 +667,7 @@ bool ModelSerializeImp::HandleNodeNameRef() {
       GE_CHK_BOOL_ONLY_LOG((src_anchor->LinkTo(dst_anchor) == GRAPH_SUCCESS), " linkTo failed.");  // lint !e737
     } else {
       // Control edge
-      auto src_anchor = src_node_it->second->GetOutControlAnchor();
+      auto src_anchor = src_node->GetOutControlAnchor();
       auto dst_anchor = item.dst_node->GetInControlAnchor();
       if (src_anchor != nullptr && dst_anchor != nullptr) {
         GE_CHK_BOOL_ONLY_LOG((src_anchor->LinkTo(dst_anchor) == GRAPH_SUCCESS), " linkTo failed.");  // lint !e737
@@ -424,28 +676,28 @@ bool ModelSerializeImp::HandleNodeNameRef() {
   }
   // Graph input
   for (auto &item : graph_input_node_names_) {
-    auto node_it = node_map_.find(item.node_name);
-    if (node_it == node_map_.end()) {
+    auto node = FindNode(item.node_name);
+    if (node == nullptr) {
       GELOGE(GRAPH_FAILED, "cannot find node %s", item.node_name.c_str());
       return false;
     }
     GE_IF_BOOL_EXEC(item.graph == nullptr, continue);
-    auto ret = item.graph->AddInputNode(node_it->second);
+    auto ret = item.graph->AddInputNode(node);
     if (ret == nullptr) {
       return false;
     }
   }
   // Graph output
   for (auto &item : graph_output_node_names_) {
-    auto node_it = node_map_.find(item.node_name);
-    if (node_it == node_map_.end()) {
+    auto node = FindNode(item.node_name);
+    if (node == nullptr) {
       GELOGE(GRAPH_FAILED, "cannot find node %s", item.node_name.c_str());
       return false;
     }
 
     GE_IF_BOOL_EXEC(item.graph == nullptr, continue);
-    auto ret = item.graph->AddOutputNodeByIndex(node_it->second, item.index);
-    GELOGI("node name:%s, item.index:%d", node_it->second->GetName().c_str(), item.index);
+    auto ret = item.graph->AddOutputNodeByIndex(node, item.index);
+    GELOGI("node name:%s, item.index:%d", node->GetName().c_str(), item.index);
     if (ret == nullptr) {
       GELOGE(GRAPH_FAILED, "AddOutputNode failed.");
       return false;
@@ -455,6 +707,8 @@ bool ModelSerializeImp::HandleNodeNameRef() {
   graph_input_node_names_.clear();
   graph_output_node_names_.clear();
   node_map_.clear();
+  nodes_.clear();
+  has_duplicate_name_ = false;
   return true;
 }
 
@@ -487,6 +741,60 @@ bool ModelSerializeImp::RebuildOwnership(ComputeGraphPtr &compute_graph, map<str
   return true;
 }
 
+ComputeGraphPtr ModelSerializeImp::UnserializeSubgraph(proto::GraphDef &graph_proto) {
+  ComputeGraphPtr subgraph;
+  ModelSerializeImp impl;
+  impl.SetProtobufOwner(protobuf_owner_);
+  // Subgraphs are already spread over the workers
+  impl.SetParallelNum(1U);
+  if (!impl.UnserializeGraphWithoutEdge(subgraph, graph_proto)) {
+    GELOGE(GRAPH_FAILED, "UnserializeGraphWithoutEdge failed");
+    return nullptr;
+  }
+
+  if (!impl.HandleNodeNameRef()) {
+    GELOGE(GRAPH_FAILED, "HandleNodeNameRef failed");
+    return nullptr;
+  }
+  return subgraph;
+}
+
+bool ModelSerializeImp::UnserializeSubgraphs(proto::ModelDef &model_proto, map<string, ComputeGraphPtr> &subgraphs) {
+  auto &graphs_proto = *model_proto.mutable_graph();
+  // 0 is main graph, following is subgraph.
+  std::vector<ComputeGraphPtr> results(graphs_proto.size());
+  uint32_t thread_num = (parallel_num_ == 0U) ? ThreadPool::GetThreadNum(graphs_proto.size() - 1) : parallel_num_;
+  if (thread_num > 1U && graphs_proto.size() > kParallelSubgraphMinNum) {
+    ThreadPool pool(thread_num);
+    std::vector<std::future<ComputeGraphPtr>> futures(graphs_proto.size());
+    for (int idx = 1; idx < graphs_proto.size(); ++idx) {
+      futures[idx] = pool.Commit(
+          [this, &graphs_proto, idx]() -> ComputeGraphPtr { return UnserializeSubgraph(graphs_proto[idx]); });
+    }
+    for (int idx = 1; idx < graphs_proto.size(); ++idx) {
+      if (futures[idx].valid()) {
+        results[idx] = futures[idx].get();
+      }
+    }
+  } else {
+    for (int idx = 1; idx < graphs_proto.size(); ++idx) {
+      results[idx] = UnserializeSubgraph(graphs_proto[idx]);
+      if (results[idx] == nullptr) {
+        return false;
+      }
+    }
+  }
+
+  for (int idx = 1; idx < graphs_proto.size(); ++idx) {
+    if (results[idx] == nullptr) {
+      GELOGE(GRAPH_FAILED, "Unserialize subgraph %s failed", graphs_proto[idx].name().c_str());
+      return false;
+    }
+    subgraphs[results[idx]->GetName()] = results[idx];
+  }
+  return true;
+}
+
 bool ModelSerializeImp::UnserializeModel(Model &model, proto::ModelDef &model_proto) {
   model.name_ = model_proto.name();
   model.version_ = model_proto.version();
@@ -501,22 +809,9 @@ bool ModelSerializeImp::UnserializeModel(Model &model, proto::ModelDef &model_pr
       model.graph_ = GraphUtils::CreateGraphFromComputeGraph(compute_graph_ptr);
     }
 
-    // 0 is main graph, following is subgraph.
     map<string, ComputeGraphPtr> subgraphs;
-    for (int idx = 1; idx < graphs_proto.size(); ++idx) {
-      ComputeGraphPtr subgraph;
-      ModelSerializeImp impl;
-      if (!impl.UnserializeGraphWithoutEdge(subgraph, graphs_proto[idx])) {
-        GELOGE(GRAPH_FAILED, "UnserializeGraphWithoutEdge failed");
-        return false;
-      }
-
-      if (!impl.HandleNodeNameRef()) {
-        GELOGE(GRAPH_FAILED, "HandleNodeNameRef failed");
-        return false;
-      }
-
-      subgraphs[subgraph->GetName()] = subgraph;
+    if (!UnserializeSubgraphs(model_proto, subgraphs)) {
+      return false;
     }
 
     if (!RebuildOwnership(compute_graph_ptr, subgraphs)) {
@@ -532,6 +827,35 @@ bool ModelSerializeImp::UnserializeModel(Model &model, proto::ModelDef &model_pr
   return true;
 }
 
+bool ModelSerializeImp::UnserializeOpDescs(proto::GraphDef &graph_proto, std::vector<OpDescPtr> &op_descs,
+                                           uint32_t thread_num) {
+  auto &ops_proto = *graph_proto.mutable_op();
+  op_descs.resize(ops_proto.size());
+  auto unserialize_range = [this, &ops_proto, &op_descs](int begin, int end) {
+    for (int idx = begin; idx < end; ++idx) {
+      if (!UnserializeOpDesc(op_descs[idx], ops_proto[idx])) {
+        GELOGW("UnserializeOpDesc error.");
+      }
+    }
+  };
+
+  int task_num = (ops_proto.size() + kOpNumPerTask - 1) / kOpNumPerTask;
+  ThreadPool pool(thread_num);
+  std::vector<std::future<void>> futures;
+  futures.reserve(task_num);
+  for (int begin = 0; begin < ops_proto.size(); begin += kOpNumPerTask) {
+    futures.emplace_back(pool.Commit(unserialize_range, begin, std::min(begin + kOpNumPerTask, ops_proto.size())));
+  }
+  for (auto &future : futures) {
+    if (!future.valid()) {
+      GELOGE(GRAPH_FAILED, "Commit unserialize op task failed");
+      return false;
+    }
+    future.get();
+  }
+  return true;
+}
+
 bool ModelSerializeImp::UnserializeGraphWithoutEdge(ComputeGraphPtr &graph, proto::GraphDef &graph_proto) {
   graph = ComGraphMakeShared<ComputeGraph>(graph_proto.name());
   if (graph == nullptr) {
@@ -556,6 +880,25 @@ bool ModelSerializeImp::UnserializeGraphWithoutEdge(ComputeGraphPtr &graph, prot
     }
   }
   graph->attrs_ = ProtoAttrMapHelper(protobuf_owner_, graph_proto.mutable_attr());
+  node_map_.reserve(node_map_.size() + graph_proto.op_size());
+  nodes_.reserve(nodes_.size() + graph_proto.op_size());
+
+  // OpDescs only depend on their own OpDef, the nodes are still added in the serialized order
+  uint32_t thread_num = (parallel_num_ == 0U) ? ThreadPool::GetThreadNum(graph_proto.op_size() / kOpNumPerTask)
+                                              : parallel_num_;
+  if (thread_num > 1U && graph_proto.op_size() >= kParallelOpMinNum) {
+    std::vector<OpDescPtr> op_descs;
+    if (!UnserializeOpDescs(graph_proto, op_descs, thread_num)) {
+      return false;
+    }
+    for (int idx = 0; idx < graph_proto.op_size(); ++idx) {
+      if (!AddNode(graph, op_descs[idx], graph_proto.op(idx))) {
+        GELOGE(GRAPH_FAILED, "UnserializeNode fail");
+        return false;
+      }
+    }
+    return true;
+  }
   for (auto &op_def_proto : *graph_proto.mutable_op()) {
     if (!UnserializeNode(graph, op_def_proto)) {
       GELOGE(GRAPH_FAILED, "UnserializeNode fail");
@@ -612,16 +955,12 @@ Buffer ModelSerialize::SerializeModel(const Model &model, bool is_dump) {
 }
 
 size_t ModelSerialize::GetSerializeModelSize(const Model &model) {
-  proto::ModelDef model_def;
   ModelSerializeImp imp;
-  if (!imp.SerializeModel(model, &model_def)) {
+  size_t size = 0U;
+  if (!imp.GetModelSize(model, size)) {
     return 0;
   }
-#if !defined(__ANDROID__) && !defined(ANDROID)
-  return model_def.ByteSizeLong();
-#else
-  return model_def.ByteSize();
-#endif
+  return size;
 }
 
 bool ModelSerialize::UnserializeModel(const uint8_t *data, size_t len, Model &model) {
@@ -665,6 +1004,44 @@ bool ModelSerialize::UnserializeModel(ge::proto::ModelDef &model_def, Model &mod
   return model.IsValid();
 }
 
+bool ModelSerialize::UnserializeModel(const std::shared_ptr<WeightsMapping> &weights_mapping, Model &model) {
+  GE_CHK_BOOL_EXEC(weights_mapping != nullptr, return false, "weights_mapping is null.");
+  const uint8_t *data = weights_mapping->GetData();
+  size_t len = weights_mapping->GetSize();
+  std::string pruned;
+  bool is_pruned = weights_mapping->Prune(pruned);
+  if (is_pruned) {
+    data = reinterpret_cast<const uint8_t *>(pruned.data());
+    len = pruned.size();
+  } else {
+    GELOGW("Model file can not be scanned for lazy weights, parse it fully.");
+  }
+
+  // The mapping lives as long as the proto, and its views are dropped before the tensors are freed
+  std::shared_ptr<proto::ModelDef> model_proto_ptr(new (std::nothrow) proto::ModelDef(),
+                                                   [weights_mapping](proto::ModelDef *model_def) {
+                                                     weights_mapping->Release();
+                                                     delete model_def;
+                                                   });
+  GE_CHK_BOOL_EXEC(model_proto_ptr != nullptr, return false, "proto::ModelDef make shared failed");
+  if (!ReadProtoFromBinaryFile(data, len, model_proto_ptr.get())) {
+    GELOGE(GRAPH_FAILED, "ParseFromArray fail");
+    return false;
+  }
+  if (is_pruned && !weights_mapping->AddViews(*model_proto_ptr)) {
+    GELOGE(GRAPH_FAILED, "Bind lazy weights failed");
+    return false;
+  }
+
+  ModelSerializeImp imp;
+  imp.SetProtobufOwner(model_proto_ptr);
+  if (!imp.UnserializeModel(model, *model_proto_ptr)) {
+    GELOGE(GRAPH_FAILED, "Unserialize Model fail");
+    return false;
+  }
+  return model.IsValid();
+}
+
 Model ModelSerialize::UnserializeModel(const uint8_t *data, size_t len) {
   Model model;
   (void)UnserializeModel(data, len, model);
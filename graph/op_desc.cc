@@ -23,6 +23,7 @@
 #include "graph/common_error_codes.h"
 #include "graph/ge_attr_value.h"
 #include "graph/ge_tensor.h"
+#include "graph/node.h"
 #include "graph/operator_factory_impl.h"
 #include "graph/utils/attr_utils.h"
 #include "graph/utils/ge_ir_utils.h"
@@ -188,8 +189,27 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY string OpDesc::GetType() const {
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY void OpDesc::SetType(const string &type) {
   auto proto_msg = op_def_.GetProtoMsg();
   if (proto_msg != nullptr) {
+    if (proto_msg->type() == type) {
+      return;
+    }
     proto_msg->set_type(type);
   }
+  op_type_id_ = kInvalidOpTypeId;
+  // the const/data split of the inputs of the node and of its consumers depends on this type
+  auto owner_node = owner_node_.lock();
+  if (owner_node != nullptr) {
+    owner_node->IncreaseAnchorsVersion();
+    for (const auto &out_node : owner_node->GetOutDataNodes()) {
+      out_node->IncreaseAnchorsVersion();
+    }
+  }
+}
+
+int32_t OpDesc::GetRegisteredOpTypeId() {
+  if (op_type_id_ == kInvalidOpTypeId) {
+    op_type_id_ = OperatorFactoryImpl::GetOpTypeId(GetType());
+  }
+  return op_type_id_;
 }
 
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY graphStatus OpDesc::AddInputDesc(const ge::GeTensorDesc &input_desc) {
@@ -866,7 +886,9 @@ void OpDesc::AddVerifierFunc(const std::function<graphStatus(Operator &)> &func)
 
 graphStatus OpDesc::InferShapeAndType() {
   if (infer_func_ == nullptr) {
-    infer_func_ = OperatorFactoryImpl::GetInferShapeFunc(GetType());
+    int32_t type_id = GetRegisteredOpTypeId();
+    infer_func_ = (type_id != kInvalidOpTypeId) ? OperatorFactoryImpl::GetInferShapeFunc(type_id) :
+                  OperatorFactoryImpl::GetInferShapeFunc(GetType());
     if (infer_func_ == nullptr) {
       GELOGW("%s does not have inferfunc_.", GetName().c_str());
       /// The infoshape function has not been added for each operator in the current operator information library.
@@ -924,7 +946,9 @@ graphStatus OpDesc::DefaultInferFormat() {
 
 graphStatus OpDesc::OpVerify() {
   if (verifier_func_ == nullptr) {
-    verifier_func_ = OperatorFactoryImpl::GetVerifyFunc(GetType());
+    int32_t type_id = GetRegisteredOpTypeId();
+    verifier_func_ = (type_id != kInvalidOpTypeId) ? OperatorFactoryImpl::GetVerifyFunc(type_id) :
+                     OperatorFactoryImpl::GetVerifyFunc(GetType());
   }
   if (verifier_func_ != nullptr) {
     Operator op_proxy = ge::OpDescUtils::CreateOperatorFromOpDesc(shared_from_this());
@@ -1320,7 +1344,9 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY graphStatus OpDesc::RestoreOutput
 }
 graphStatus OpDesc::CallInferFunc(Operator &op) {
   if (infer_func_ == nullptr) {
-    infer_func_ = OperatorFactoryImpl::GetInferShapeFunc(GetType());
+    int32_t type_id = GetRegisteredOpTypeId();
+    infer_func_ = (type_id != kInvalidOpTypeId) ? OperatorFactoryImpl::GetInferShapeFunc(type_id) :
+                  OperatorFactoryImpl::GetInferShapeFunc(GetType());
     if (infer_func_ == nullptr) {
       GELOGW("%s does not have infer func.", GetName().c_str());
       return GRAPH_PARAM_INVALID;
@@ -1353,7 +1379,9 @@ graphStatus OpDesc::CallInferFunc(Operator &op) {
 }
 graphStatus OpDesc::CallInferFormatFunc(Operator &op) {
   if (infer_format_func_ == nullptr) {
-    infer_format_func_ = OperatorFactoryImpl::GetInferFormatFunc(GetType());
+    int32_t type_id = GetRegisteredOpTypeId();
+    infer_format_func_ = (type_id != kInvalidOpTypeId) ? OperatorFactoryImpl::GetInferFormatFunc(type_id) :
+                         OperatorFactoryImpl::GetInferFormatFunc(GetType());
     if (infer_format_func_ == nullptr) {
       return DefaultInferFormat();
     }
@@ -1452,7 +1480,9 @@ graphStatus OpDesc::GetSubgraphNameByInstanceName(const std::string &instance_na
 
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY graphStatus OpDesc::InferDataSlice() {
   if (infer_data_slice_func_ == nullptr) {
-    infer_data_slice_func_ = OperatorFactoryImpl::GetInferDataSliceFunc(GetType());
+    int32_t type_id = GetRegisteredOpTypeId();
+    infer_data_slice_func_ = (type_id != kInvalidOpTypeId) ? OperatorFactoryImpl::GetInferDataSliceFunc(type_id) :
+                             OperatorFactoryImpl::GetInferDataSliceFunc(GetType());
     if (infer_data_slice_func_ == nullptr) {
       GELOGW("%s does not have infer data slice func.", GetName().c_str());
       return NO_DEPENDENCE_FUNC;
@@ -21,6 +21,7 @@
 #include <mutex>
 #include <queue>
 #include <set>
+#include <unordered_map>
 #include "debug/ge_log.h"
 #include "debug/ge_op_types.h"
 #include "debug/ge_util.h"
@@ -64,11 +65,11 @@ class OpIO {
 
   ~OpIO() = default;
 
-  string GetName() const { return name_; }
+  const string &GetName() const { return name_; }
 
   int GetIndex() const { return index_; }
 
-  OperatorImplPtr GetOwner() const { return owner_; }
+  const OperatorImplPtr &GetOwner() const { return owner_; }
 
   bool operator==(const OpIO &r_value) const {
     return (this->name_ == r_value.GetName()) && (this->index_ == r_value.GetIndex()) &&
@@ -302,7 +303,7 @@ class OperatorImpl : public std::enable_shared_from_this<OperatorImpl> {
       return GRAPH_FAILED;
     }
     if (out_handle.GetOwner() != nullptr && out_handle.GetOwner()->GetOpDescImpl() != nullptr) {
-      Operator const_op(out_handle.GetOwner());
+      Operator const_op(OperatorImplPtr(out_handle.GetOwner()));
       const auto &op_desc_impl_type = out_handle.GetOwner()->GetOpDescImpl()->GetType();
       if (op_desc_impl_type == CONSTANTOP) {
         return const_op.GetAttr(ATTR_NAME_WEIGHTS, data);
@@ -2176,56 +2177,74 @@ class GraphBuilderImpl {
     return graph_;
   }
 
-  const std::map<OperatorImplPtr, NodePtr> &GetAllNodesInfo() const { return all_nodes_info_; }
+  std::map<OperatorImplPtr, NodePtr> GetAllNodesInfo() const {
+    return std::map<OperatorImplPtr, NodePtr>(nodes_.begin(), nodes_.end());
+  }
 
  private:
   graphStatus WalkAllOperators(const std::vector<OperatorImplPtr> &vec_ops) {
     GE_CHK_BOOL_EXEC(graph_ != nullptr, return GRAPH_FAILED, "graph_ is null.")
-    std::queue<std::vector<OperatorImplPtr>> que;
-    que.push(vec_ops);
+    std::vector<OperatorImplPtr> op_impls;
+    if (CollectAllOperators(vec_ops, op_impls) != GRAPH_SUCCESS) {
+      return GRAPH_FAILED;
+    }
+    nodes_.reserve(op_impls.size());
+    for (auto &op_impl : op_impls) {
+      auto node_ptr = graph_->AddNode(op_impl->op_desc_);
+      GE_CHK_BOOL_EXEC(node_ptr != nullptr, return GRAPH_FAILED, "Add node failed.");
+      nodes_.emplace_back(std::move(op_impl), node_ptr);
+      if (WalkAllSubgraphs(node_ptr, nodes_.back().first) != GRAPH_SUCCESS) {
+        return GRAPH_FAILED;
+      }
+    }
+    return MoveSubgraphToRoot(graph_);
+  }
+
+  // Breadth first from the inputs over data and control links in both directions, the operators are numbered
+  // in the order their nodes are going to be added
+  graphStatus CollectAllOperators(const std::vector<OperatorImplPtr> &vec_ops,
+                                  std::vector<OperatorImplPtr> &op_impls) {
+    std::queue<OperatorImplPtr> que;
+    auto push_unvisited = [&que, this](const OperatorImplPtr &op_impl) {
+      if ((op_impl == nullptr) || (node_index_.count(op_impl.get()) == 0)) {
+        que.push(op_impl);
+      }
+    };
+    for (const auto &op_impl : vec_ops) {
+      push_unvisited(op_impl);
+    }
     while (!que.empty()) {
-      auto vec_tem = que.front();
+      OperatorImplPtr op_impl = std::move(que.front());
       que.pop();
-      for (const auto &op_impl : vec_tem) {
-        GE_CHK_BOOL_EXEC(op_impl != nullptr, return GRAPH_FAILED, "Operator Impl is null.")
-        GE_CHK_BOOL_EXEC_INFO(all_nodes_info_.find(op_impl) == all_nodes_info_.end(), continue,
-                              "This node %s has created.", op_impl->GetName().c_str())
-        auto node_ptr = graph_->AddNode(op_impl->op_desc_);
-        GE_CHK_BOOL_EXEC(node_ptr != nullptr, return GRAPH_FAILED, "Add node failed.");
-        all_nodes_info_.insert(std::make_pair(op_impl, node_ptr));
-
-        auto &out_links = op_impl->output_links_;
-        std::vector<OperatorImplPtr> vec_op_forward{};
-        for (const auto &out_link : out_links) {
-          for (const auto &op_forward : out_link.second) {
-            vec_op_forward.push_back(op_forward.GetOwner());
-          }
-        }
-
-        auto &out_control_links = op_impl->control_output_link_;
-        for (const auto &out_link : out_control_links) {
-          vec_op_forward.push_back(out_link.lock());
-        }
-        que.push(vec_op_forward);
-
-        auto &in_links = op_impl->input_link_;
-        std::vector<OperatorImplPtr> vec_op_back_forward{};
-        for (const auto &in_link : in_links) {
-          vec_op_back_forward.push_back(in_link.second.GetOwner());
-        }
-
-        auto &in_control_links = op_impl->control_input_link_;
-        for (const auto &in_link : in_control_links) {
-          vec_op_back_forward.push_back(in_link.lock());
-        }
-        que.push(vec_op_back_forward);
-
-        if (WalkAllSubgraphs(node_ptr, op_impl) != GRAPH_SUCCESS) {
-          return GRAPH_FAILED;
+      GE_CHK_BOOL_EXEC(op_impl != nullptr, return GRAPH_FAILED, "Operator Impl is null.")
+      if (!node_index_.emplace(op_impl.get(), op_impls.size()).second) {
+        continue;
+      }
+      for (const auto &out_link : op_impl->output_links_) {
+        for (const auto &op_forward : out_link.second) {
+          push_unvisited(op_forward.GetOwner());
         }
       }
+      for (const auto &out_link : op_impl->control_output_link_) {
+        push_unvisited(out_link.lock());
+      }
+      for (const auto &in_link : op_impl->input_link_) {
+        push_unvisited(in_link.second.GetOwner());
+      }
+      for (const auto &in_link : op_impl->control_input_link_) {
+        push_unvisited(in_link.lock());
+      }
+      op_impls.push_back(std::move(op_impl));
     }
-    return MoveSubgraphToRoot(graph_);
+    return GRAPH_SUCCESS;
+  }
+
+  NodePtr FindNode(const OperatorImpl *op_impl) const {
+    auto it = node_index_.find(op_impl);
+    if ((it == node_index_.end()) || (it->second >= nodes_.size())) {
+      return nullptr;
+    }
+    return nodes_[it->second].second;
   }
 
   graphStatus WalkAllSubgraphs(const NodePtr &node, const OperatorImplPtr &op_impl) {
@@ -2287,17 +2306,15 @@ class GraphBuilderImpl {
   }
 
   graphStatus AddEdge() {
-    for (const auto &node_info : all_nodes_info_) {
-      auto src_op_impl_ptr = node_info.first;
-      auto src_node_ptr = node_info.second;
+    for (const auto &node_info : nodes_) {
+      const auto &src_op_impl_ptr = node_info.first;
+      const auto &src_node_ptr = node_info.second;
 
       GE_IF_BOOL_EXEC(src_op_impl_ptr == nullptr || src_node_ptr == nullptr, continue);
-      auto out_links = src_op_impl_ptr->output_links_;
       GE_CHK_BOOL_EXEC(src_op_impl_ptr->op_desc_ != nullptr, return GRAPH_FAILED,
                        "Src operator impl's op_desc is null.");
       auto &op_desc = src_op_impl_ptr->op_desc_;
-      GE_IF_BOOL_EXEC(op_desc == nullptr, continue);
-      for (const auto &out : out_links) {
+      for (const auto &out : src_op_impl_ptr->output_links_) {
         auto src_idx = op_desc->GetOutputIndexByName(out.first);
         GE_CHK_BOOL_EXEC(src_idx >= 0, return GRAPH_FAILED, "Find output index by name failed");
 
@@ -2305,35 +2322,31 @@ class GraphBuilderImpl {
         GE_CHK_BOOL_EXEC(src_anchor != nullptr, return GRAPH_FAILED, "GetOutDataAnchor failed.");
 
         for (const auto &dst_opio : out.second) {
-          auto dst_node_info = all_nodes_info_.find(dst_opio.GetOwner());
-          GE_CHK_BOOL_EXEC(dst_node_info != all_nodes_info_.end(), return GRAPH_FAILED, "Find Dst node failed.");
-
-          GE_IF_BOOL_EXEC(dst_node_info->second == nullptr, continue);
+          auto dst_node = FindNode(dst_opio.GetOwner().get());
+          GE_CHK_BOOL_EXEC(dst_node != nullptr, return GRAPH_FAILED, "Find Dst node failed.");
 
-          auto dst_anchor = dst_node_info->second->GetInDataAnchor(dst_opio.GetIndex());
+          auto dst_anchor = dst_node->GetInDataAnchor(dst_opio.GetIndex());
           GE_CHK_BOOL_EXEC(dst_anchor != nullptr, return GRAPH_FAILED, "GetInDataAnchor failed.");
 
           auto ret = GraphUtils::AddEdge(src_anchor, dst_anchor);
           GE_CHK_BOOL_EXEC(ret == GRAPH_SUCCESS, return GRAPH_FAILED,
                            "from node[%s][%d] to node[%s][%d]AddEdge failed.",
                            src_node_ptr->GetName().c_str(), src_anchor->GetIdx(),
-                           dst_node_info->second->GetName().c_str(), dst_anchor->GetIdx());
+                           dst_node->GetName().c_str(), dst_anchor->GetIdx());
         }
       }
       auto out_control_anchor = src_node_ptr->GetOutControlAnchor();
       for (const auto &control_out : src_op_impl_ptr->control_output_link_) {
-        auto dst_node_info = all_nodes_info_.find(control_out.lock());
-        if (dst_node_info == all_nodes_info_.end()) {
+        auto dst_node = FindNode(control_out.lock().get());
+        if (dst_node == nullptr) {
           GELOGE(GRAPH_FAILED, "Find Dst node failed.");
           return GRAPH_FAILED;
         }
-        GE_IF_BOOL_EXEC(dst_node_info->second == nullptr, continue);
-        auto in_control_anchor = dst_node_info->second->GetInControlAnchor();
+        auto in_control_anchor = dst_node->GetInControlAnchor();
         auto ret = GraphUtils::AddEdge(out_control_anchor, in_control_anchor);
         if (ret != GRAPH_SUCCESS) {
           GELOGE(ret, "AddEdge failed. srcNode %s:%s, dstNode %s:%s", op_desc->GetName().c_str(),
-                 op_desc->GetType().c_str(), dst_node_info->second->GetName().c_str(),
-                 dst_node_info->second->GetType().c_str());
+                 op_desc->GetType().c_str(), dst_node->GetName().c_str(), dst_node->GetType().c_str());
           return ret;
         }
       }
@@ -2342,7 +2355,9 @@ class GraphBuilderImpl {
   }
 
   ComputeGraphPtr graph_ = nullptr;
-  std::map<OperatorImplPtr, NodePtr> all_nodes_info_{};
+  // Operators and their nodes in the order the nodes were added
+  std::vector<std::pair<OperatorImplPtr, NodePtr>> nodes_{};
+  std::unordered_map<const OperatorImpl *, size_t> node_index_{};
 };
 
 inline bool HasSameNameNode(const ComputeGraphPtr &compute_graph) {
@@ -15,10 +15,130 @@
  */
 
 #include "graph/operator_factory_impl.h"
+#include <deque>
+#include <unordered_map>
 #include "debug/ge_log.h"
 #include "framework/common/debug/ge_log.h"
+#include "graph/opsproto_manager.h"
+#include "mmpa/mmpa_api.h"
 
 namespace ge {
+namespace {
+struct OpFuncs {
+  std::string op_type;
+  OpCreator creator;
+  OpCreatorV2 creator_v2;
+  InferShapeFunc infer_shape_func;
+  InferFormatFunc infer_format_func;
+  VerifyFunc verify_func;
+  InferDataSliceFunc infer_data_slice_func;
+};
+
+struct OpTypeRegistry {
+  OpTypeRegistry() { (void)mmRWLockInit(&lock); }
+  ~OpTypeRegistry() { (void)mmRWLockDestroy(&lock); }
+  // Registrations may come from a library loaded while other threads look up op types
+  mmRWLock_t lock;
+  std::unordered_map<std::string, OpTypeId> ids;
+  // deque keeps the records in place when it grows
+  std::deque<OpFuncs> funcs;
+};
+
+class ReadGuard {
+ public:
+  explicit ReadGuard(mmRWLock_t &lock) : lock_(lock) { (void)mmRWLockRDLock(&lock_); }
+  ~ReadGuard() { (void)mmRDLockUnLock(&lock_); }
+ private:
+  mmRWLock_t &lock_;
+};
+
+class WriteGuard {
+ public:
+  explicit WriteGuard(mmRWLock_t &lock) : lock_(lock) { (void)mmRWLockWRLock(&lock_); }
+  ~WriteGuard() { (void)mmWRLockUnLock(&lock_); }
+ private:
+  mmRWLock_t &lock_;
+};
+
+// Registrations run in static initializers of other libraries, so the registry is built on first use
+OpTypeRegistry &GetOpTypeRegistry() {
+  static OpTypeRegistry registry;
+  return registry;
+}
+
+// Caller holds the registry lock
+const OpFuncs *FindOpFuncs(const OpTypeRegistry &registry, OpTypeId type_id) {
+  if (type_id < 0 || static_cast<size_t>(type_id) >= registry.funcs.size()) {
+    return nullptr;
+  }
+  return &registry.funcs[static_cast<size_t>(type_id)];
+}
+
+// Caller holds the registry write lock
+OpFuncs &InternOpType(OpTypeRegistry &registry, const std::string &operator_type) {
+  auto it = registry.ids.find(operator_type);
+  if (it != registry.ids.end()) {
+    return registry.funcs[static_cast<size_t>(it->second)];
+  }
+  (void)registry.ids.emplace(operator_type, static_cast<OpTypeId>(registry.funcs.size()));
+  registry.funcs.emplace_back();
+  registry.funcs.back().op_type = operator_type;
+  return registry.funcs.back();
+}
+
+// The interned function of type_id, or the one written to the legacy map of its op type
+template <typename Func>
+Func GetOpFunc(OpTypeId type_id, Func OpFuncs::*field, const shared_ptr<std::map<string, Func>> &legacy_funcs) {
+  auto &registry = GetOpTypeRegistry();
+  ReadGuard guard(registry.lock);
+  const auto *funcs = FindOpFuncs(registry, type_id);
+  if (funcs == nullptr) {
+    return nullptr;
+  }
+  if (funcs->*field != nullptr || legacy_funcs == nullptr) {
+    return funcs->*field;
+  }
+  auto it = legacy_funcs->find(funcs->op_type);
+  return (it == legacy_funcs->end()) ? nullptr : it->second;
+}
+
+// Lookup by name also finds types only written to the legacy map
+template <typename Func>
+Func GetOpFunc(const std::string &operator_type, Func OpFuncs::*field,
+               const shared_ptr<std::map<string, Func>> &legacy_funcs) {
+  OpTypeId type_id = OperatorFactoryImpl::GetOpTypeId(operator_type);
+  if (type_id != kInvalidOpTypeId) {
+    return GetOpFunc(type_id, field, legacy_funcs);
+  }
+  ReadGuard guard(GetOpTypeRegistry().lock);
+  if (legacy_funcs == nullptr) {
+    return nullptr;
+  }
+  auto it = legacy_funcs->find(operator_type);
+  return (it == legacy_funcs->end()) ? nullptr : it->second;
+}
+
+// Records func of operator_type in the legacy map and its interned record, fails if one is there already
+template <typename Func>
+graphStatus RegisterOpFunc(const std::string &operator_type, const Func &func, Func OpFuncs::*field,
+                           shared_ptr<std::map<string, Func>> &legacy_funcs) {
+  auto &registry = GetOpTypeRegistry();
+  WriteGuard guard(registry.lock);
+  if (legacy_funcs == nullptr) {
+    legacy_funcs.reset(new (std::nothrow) std::map<string, Func>());
+    if (legacy_funcs == nullptr) {
+      GELOGE(GRAPH_FAILED, "Failed to create registry for optype[%s]", operator_type.c_str());
+      return GRAPH_FAILED;
+    }
+  }
+  if (!legacy_funcs->emplace(operator_type, func).second) {
+    return GRAPH_FAILED;
+  }
+  InternOpType(registry, operator_type).*field = func;
+  return GRAPH_SUCCESS;
+}
+}  // namespace
+
 shared_ptr<std::map<string, OpCreator>> OperatorFactoryImpl::operator_creators_;
 shared_ptr<std::map<string, OpCreatorV2>> OperatorFactoryImpl::operator_creators_v2_;
 shared_ptr<std::map<string, InferShapeFunc>> OperatorFactoryImpl::operator_infershape_funcs_;
@@ -26,27 +146,48 @@ shared_ptr<std::map<string, InferFormatFunc>> OperatorFactoryImpl::operator_infe
 shared_ptr<std::map<string, VerifyFunc>> OperatorFactoryImpl::operator_verify_funcs_;
 shared_ptr<std::map<string, InferDataSliceFunc>> OperatorFactoryImpl::operator_infer_data_slice_funcs_;
 
+OpTypeId OperatorFactoryImpl::GetOpTypeId(const std::string &operator_type) {
+  // Libraries deferred by the ops proto manifest are loaded on the first lookup of their op types, it returns
+  // at once when nothing is deferred and must not run under the registry lock
+  (void)OpsProtoManager::Instance()->LoadOpsProto(operator_type);
+  auto &registry = GetOpTypeRegistry();
+  ReadGuard guard(registry.lock);
+  auto it = registry.ids.find(operator_type);
+  return (it == registry.ids.end()) ? kInvalidOpTypeId : it->second;
+}
+
+std::string OperatorFactoryImpl::GetOpType(OpTypeId type_id) {
+  auto &registry = GetOpTypeRegistry();
+  ReadGuard guard(registry.lock);
+  const auto *funcs = FindOpFuncs(registry, type_id);
+  return (funcs == nullptr) ? "" : funcs->op_type;
+}
+
+size_t OperatorFactoryImpl::GetOpTypeNum() {
+  auto &registry = GetOpTypeRegistry();
+  ReadGuard guard(registry.lock);
+  return registry.funcs.size();
+}
+
 Operator OperatorFactoryImpl::CreateOperator(const std::string &operator_name, const std::string &operator_type) {
-  if (operator_creators_v2_ != nullptr) {
-    auto it_v2 = operator_creators_v2_->find(operator_type);
-    if (it_v2 != operator_creators_v2_->end()) {
-      return it_v2->second(operator_name.c_str());
-    } else {
-      GELOGW("No OpProto of [%s] registered by AscendString.", operator_type.c_str());
-    }
+  auto creator_v2 = GetOpFunc(operator_type, &OpFuncs::creator_v2, operator_creators_v2_);
+  if (creator_v2 != nullptr) {
+    return creator_v2(operator_name.c_str());
   }
-  if (operator_creators_ == nullptr) {
-    return Operator();
+  if (operator_creators_v2_ != nullptr) {
+    GELOGW("No OpProto of [%s] registered by AscendString.", operator_type.c_str());
   }
-  auto it = operator_creators_->find(operator_type);
-  if (it == operator_creators_->end()) {
+  auto creator = GetOpFunc(operator_type, &OpFuncs::creator, operator_creators_);
+  if (creator == nullptr) {
     GELOGW("no OpProto of [%s] registered by string.", operator_type.c_str());
     return Operator();
   }
-  return it->second(operator_name);
+  return creator(operator_name);
 }
 
 graphStatus OperatorFactoryImpl::GetOpsTypeList(std::vector<std::string> &all_ops) {
+  OpsProtoManager::Instance()->LoadAllOpsProto();
+  ReadGuard guard(GetOpTypeRegistry().lock);
   all_ops.clear();
   if (operator_creators_v2_ != nullptr) {
     for (auto it_v2 = operator_creators_v2_->begin(); it_v2 != operator_creators_v2_->end(); ++it_v2) {
@@ -69,145 +210,75 @@ graphStatus OperatorFactoryImpl::GetOpsTypeList(std::vector<std::string> &all_op
 }
 
 bool OperatorFactoryImpl::IsExistOp(const string &operator_type) {
-  if (operator_creators_v2_ != nullptr) {
-    auto it_v2 = operator_creators_v2_->find(operator_type);
-    if (it_v2 != operator_creators_v2_->end()) {
-      return true;
-    }
-  }
-
-  if (operator_creators_ == nullptr) {
-    return false;
-  }
-  auto it = operator_creators_->find(operator_type);
-  if (it == operator_creators_->end()) {
-    return false;
-  }
-  return true;
+  return (GetOpFunc(operator_type, &OpFuncs::creator_v2, operator_creators_v2_) != nullptr) ||
+         (GetOpFunc(operator_type, &OpFuncs::creator, operator_creators_) != nullptr);
 }
 
 InferShapeFunc OperatorFactoryImpl::GetInferShapeFunc(const std::string &operator_type) {
-  if (operator_infershape_funcs_ == nullptr) {
-    return nullptr;
-  }
-  auto it = operator_infershape_funcs_->find(operator_type);
-  if (it == operator_infershape_funcs_->end()) {
-    return nullptr;
-  }
-  return it->second;
+  return GetOpFunc(operator_type, &OpFuncs::infer_shape_func, operator_infershape_funcs_);
 }
 
 InferFormatFunc OperatorFactoryImpl::GetInferFormatFunc(const std::string &operator_type) {
-  if (operator_inferformat_funcs_ == nullptr) {
-    GELOGI("operator_inferformat_funcs_ is null");
-    return nullptr;
-  }
-  auto it = operator_inferformat_funcs_->find(operator_type);
-  if (it == operator_inferformat_funcs_->end()) {
-    return nullptr;
-  }
-  return it->second;
+  return GetOpFunc(operator_type, &OpFuncs::infer_format_func, operator_inferformat_funcs_);
 }
 
 VerifyFunc OperatorFactoryImpl::GetVerifyFunc(const std::string &operator_type) {
-  if (operator_verify_funcs_ == nullptr) {
-    return nullptr;
-  }
-  auto it = operator_verify_funcs_->find(operator_type);
-  if (it == operator_verify_funcs_->end()) {
-        return nullptr;
-    }
-    return it->second;
+  return GetOpFunc(operator_type, &OpFuncs::verify_func, operator_verify_funcs_);
 }
 
 InferDataSliceFunc OperatorFactoryImpl::GetInferDataSliceFunc(const std::string &operator_type) {
-  if (operator_infer_data_slice_funcs_ == nullptr) {
-    return nullptr;
-  }
-  auto it = operator_infer_data_slice_funcs_->find(operator_type);
-  if (it == operator_infer_data_slice_funcs_->end()) {
-    return nullptr;
-  }
-  return it->second;
+  return GetOpFunc(operator_type, &OpFuncs::infer_data_slice_func, operator_infer_data_slice_funcs_);
+}
+
+InferShapeFunc OperatorFactoryImpl::GetInferShapeFunc(OpTypeId type_id) {
+  return GetOpFunc(type_id, &OpFuncs::infer_shape_func, operator_infershape_funcs_);
+}
+
+InferFormatFunc OperatorFactoryImpl::GetInferFormatFunc(OpTypeId type_id) {
+  return GetOpFunc(type_id, &OpFuncs::infer_format_func, operator_inferformat_funcs_);
+}
+
+VerifyFunc OperatorFactoryImpl::GetVerifyFunc(OpTypeId type_id) {
+  return GetOpFunc(type_id, &OpFuncs::verify_func, operator_verify_funcs_);
+}
+
+InferDataSliceFunc OperatorFactoryImpl::GetInferDataSliceFunc(OpTypeId type_id) {
+  return GetOpFunc(type_id, &OpFuncs::infer_data_slice_func, operator_infer_data_slice_funcs_);
 }
 
 graphStatus OperatorFactoryImpl::RegisterOperatorCreator(const string &operator_type, OpCreator const &op_creator) {
-  if (operator_creators_ == nullptr) {
-    operator_creators_.reset(new (std::nothrow) std::map<string, OpCreator>());
-  }
-  auto it = operator_creators_->find(operator_type);
-  if (it != operator_creators_->end()) {
-    return GRAPH_FAILED;
-  }
-  (void)operator_creators_->emplace(operator_type, op_creator);
-  return GRAPH_SUCCESS;
+  return RegisterOpFunc(operator_type, op_creator, &OpFuncs::creator, operator_creators_);
 }
 
 graphStatus OperatorFactoryImpl::RegisterOperatorCreator(const string &operator_type, OpCreatorV2 const &op_creator) {
-  if (operator_creators_v2_ == nullptr) {
-    operator_creators_v2_.reset(new (std::nothrow) std::map<string, OpCreatorV2>());
-  }
-  auto it = operator_creators_v2_->find(operator_type);
-  if (it != operator_creators_v2_->end()) {
-    return GRAPH_FAILED;
-  }
-  (void)operator_creators_v2_->emplace(operator_type, op_creator);
-  return GRAPH_SUCCESS;
+  return RegisterOpFunc(operator_type, op_creator, &OpFuncs::creator_v2, operator_creators_v2_);
 }
 
 graphStatus OperatorFactoryImpl::RegisterInferShapeFunc(const std::string &operator_type,
                                                         InferShapeFunc const infer_shape_func) {
   if (operator_infershape_funcs_ == nullptr) {
     GELOGI("operator_infershape_funcs_ init");
-    operator_infershape_funcs_.reset(new (std::nothrow) std::map<string, InferShapeFunc>());
   }
-  auto it = operator_infershape_funcs_->find(operator_type);
-  if (it != operator_infershape_funcs_->end()) {
+  graphStatus ret = RegisterOpFunc(operator_type, infer_shape_func, &OpFuncs::infer_shape_func,
+                                   operator_infershape_funcs_);
+  if (ret != GRAPH_SUCCESS) {
     GELOGW("optype[%s] has registered infershape func", operator_type.c_str());
-    return GRAPH_FAILED;
   }
-  (void)operator_infershape_funcs_->emplace(operator_type, infer_shape_func);
-  return GRAPH_SUCCESS;
+  return ret;
 }
 
 graphStatus OperatorFactoryImpl::RegisterInferFormatFunc(const std::string &operator_type,
                                                          InferFormatFunc const infer_format_func) {
-  if (operator_inferformat_funcs_ == nullptr) {
-    GELOGI("operator_inferformat_funcs_ init");
-    operator_inferformat_funcs_.reset(new (std::nothrow) std::map<string, InferFormatFunc>());
-  }
-  auto it = operator_inferformat_funcs_->find(operator_type);
-  if (it != operator_inferformat_funcs_->end()) {
-    return GRAPH_FAILED;
-  }
-  (void)operator_inferformat_funcs_->emplace(operator_type, infer_format_func);
-  return GRAPH_SUCCESS;
+  return RegisterOpFunc(operator_type, infer_format_func, &OpFuncs::infer_format_func, operator_inferformat_funcs_);
 }
 
 graphStatus OperatorFactoryImpl::RegisterVerifyFunc(const std::string &operator_type, VerifyFunc const verify_func) {
-  if (operator_verify_funcs_ == nullptr) {
-    GELOGI("operator_verify_funcs_ init");
-    operator_verify_funcs_.reset(new (std::nothrow) std::map<string, VerifyFunc>());
-  }
-  auto it = operator_verify_funcs_->find(operator_type);
-  if (it != operator_verify_funcs_->end()) {
-    return GRAPH_FAILED;
-  }
-  (void)operator_verify_funcs_->emplace(operator_type, verify_func);
-  return GRAPH_SUCCESS;
+  return RegisterOpFunc(operator_type, verify_func, &OpFuncs::verify_func, operator_verify_funcs_);
 }
 
 graphStatus OperatorFactoryImpl::RegisterInferDataSliceFunc(const std::string &operator_type,
                                                             InferDataSliceFunc const infer_data_slice_func) {
-  if (operator_infer_data_slice_funcs_ == nullptr) {
-    GELOGI("operator_infer_data_slice_funcs_ init");
-    operator_infer_data_slice_funcs_.reset(new (std::nothrow) std::map<string, InferDataSliceFunc>());
-  }
-  auto it = operator_infer_data_slice_funcs_->find(operator_type);
-  if (it != operator_infer_data_slice_funcs_->end()) {
-    return GRAPH_FAILED;
-  }
-  (void)operator_infer_data_slice_funcs_->emplace(operator_type, infer_data_slice_func);
-  return GRAPH_SUCCESS;
+  return RegisterOpFunc(operator_type, infer_data_slice_func, &OpFuncs::infer_data_slice_func,
+                        operator_infer_data_slice_funcs_);
 }
 }  // namespace ge
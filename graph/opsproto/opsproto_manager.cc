@@ -15,24 +15,46 @@
  */
 
 #include "graph/opsproto_manager.h"
+#include <cstdio>
 #include <cstdlib>
 #include <algorithm>
+#include <fstream>
 #include <functional>
 #include <iostream>
 #include <sstream>
 #include "debug/ge_util.h"
 #include "framework/common/debug/ge_log.h"
 #include "graph/debug/ge_log.h"
+#include "graph/operator_factory_impl.h"
 #include "mmpa/mmpa_api.h"
 
 namespace ge {
+namespace {
+const char *const kOptionOpsProtoLibPath = "ge.opsProtoLibPath";
+const char *const kOptionManifestPath = "ge.opsProtoManifestPath";
+const char *const kOptionLazyLoad = "ge.opsProtoLazyLoad";
+const char kManifestFieldDelim = '\t';
+const char kOpTypeDelim = ',';
+const size_t kManifestFieldNum = 4;
+
+bool GetFileStat(const std::string &path, int64_t &mtime, int64_t &size) {
+  mmStat_t stat_buf;
+  if (mmStatGet(path.c_str(), &stat_buf) != EN_OK) {
+    return false;
+  }
+  mtime = static_cast<int64_t>(stat_buf.st_mtime);
+  size = static_cast<int64_t>(stat_buf.st_size);
+  return true;
+}
+}  // namespace
+
 OpsProtoManager *OpsProtoManager::Instance() {
   static OpsProtoManager instance;
   return &instance;
 }
 
 bool OpsProtoManager::Initialize(const std::map<std::string, std::string> &options) {
-  std::lock_guard<std::mutex> lock(mutex_);
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
 
   if (is_init_) {
     GELOGI("OpsProtoManager is already initialized.");
@@ -40,7 +62,7 @@ bool OpsProtoManager::Initialize(const std::map<std::string, std::string> &optio
   }
 
   /*lint -e1561*/
-  auto proto_iter = options.find("ge.opsProtoLibPath");
+  auto proto_iter = options.find(kOptionOpsProtoLibPath);
   /*lint +e1561*/
   if (proto_iter == options.end()) {
     GELOGW("ge.opsProtoLibPath option not set, return.");
@@ -48,6 +70,10 @@ bool OpsProtoManager::Initialize(const std::map<std::string, std::string> &optio
   }
 
   pluginPath_ = proto_iter->second;
+  auto manifest_iter = options.find(kOptionManifestPath);
+  manifestPath_ = (manifest_iter == options.end()) ? "" : manifest_iter->second;
+  auto lazy_iter = options.find(kOptionLazyLoad);
+  lazyLoad_ = !manifestPath_.empty() && (lazy_iter != options.end()) && (lazy_iter->second == "1");
   LoadOpsProtoPluginSo(pluginPath_);
 
   is_init_ = true;
@@ -56,7 +82,7 @@ bool OpsProtoManager::Initialize(const std::map<std::string, std::string> &optio
 }
 
 void OpsProtoManager::Finalize() {
-  std::lock_guard<std::mutex> lock(mutex_);
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
 
   if (!is_init_) {
     GELOGI("OpsProtoManager is not initialized.");
@@ -76,10 +102,38 @@ void OpsProtoManager::Finalize() {
       GELOGW("close opsprotomanager handler failure, handler is nullptr");
     }
   }
+  handles_.clear();
+  hasPending_ = false;
+  pendingPlugins_.clear();
+  pendingOpTypes_.clear();
 
   is_init_ = false;
 }
 
+bool OpsProtoManager::LoadOpsProto(const std::string &op_type) {
+  if (!hasPending_.load()) {
+    return false;
+  }
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  auto iter = pendingOpTypes_.find(op_type);
+  if (iter == pendingOpTypes_.end()) {
+    return false;
+  }
+  GELOGI("Load %s on demand of op type %s", pendingPlugins_[iter->second].path.c_str(), op_type.c_str());
+  LoadPendingPlugin(iter->second);
+  return true;
+}
+
+void OpsProtoManager::LoadAllOpsProto() {
+  if (!hasPending_.load()) {
+    return;
+  }
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  for (size_t i = 0; i < pendingPlugins_.size(); ++i) {
+    LoadPendingPlugin(i);
+  }
+}
+
 static std::vector<std::string> Split(const std::string &str, char delim) {
   std::vector<std::string> elems;
   if (str.empty()) {
@@ -181,18 +235,146 @@ void OpsProtoManager::LoadOpsProtoPluginSo(std::string &path) {
   GELOGW("The shared library will not be checked. Please ensure that the source of the shared library is trusted.");
 
   // Load .so file
-  for (auto elem : file_list) {
-    void *handle = mmDlopen(elem.c_str(), MMPA_RTLD_NOW | MMPA_RTLD_GLOBAL);
-    if (handle == nullptr) {
-      const char *error = mmDlerror();
-      error = (error == nullptr) ? "" : error;
-      GELOGW("OpsProtoManager dlopen failed, plugin name:%s. Message(%s).", elem.c_str(), error);
+  if (manifestPath_.empty()) {
+    for (const auto &elem : file_list) {
+      (void)LoadPlugin(elem, nullptr);
+    }
+    return;
+  }
+
+  std::map<std::string, PluginInfo> manifest;
+  ReadManifest(manifest);
+  std::vector<PluginInfo> plugins;
+  bool manifest_changed = false;
+  for (const auto &elem : file_list) {
+    PluginInfo plugin;
+    plugin.path = elem;
+    if (!GetFileStat(elem, plugin.mtime, plugin.size)) {
+      GELOGW("OpsProtoManager can not stat %s, load it without manifest.", elem.c_str());
+      (void)LoadPlugin(elem, nullptr);
       continue;
-    } else {
-      // Close dl when the program exist, not close here
-      GELOGI("OpsProtoManager plugin load %s success.", elem.c_str());
-      handles_.push_back(handle);
     }
+    auto iter = manifest.find(elem);
+    bool is_cached = (iter != manifest.end()) && (iter->second.mtime == plugin.mtime) &&
+                     (iter->second.size == plugin.size);
+    if (!is_cached) {
+      // Record what the library registers, a library failed to load is retried next time
+      manifest_changed = true;
+      if (LoadPlugin(elem, &plugin.op_types)) {
+        plugins.push_back(plugin);
+      }
+      continue;
+    }
+    plugin.op_types = iter->second.op_types;
+    plugins.push_back(plugin);
+    // Libraries registering no op type may have other side effects, they are always loaded
+    if (!lazyLoad_ || plugin.op_types.empty()) {
+      (void)LoadPlugin(elem, nullptr);
+      continue;
+    }
+    for (const auto &op_type : plugin.op_types) {
+      (void)pendingOpTypes_.emplace(op_type, pendingPlugins_.size());
+    }
+    pendingPlugins_.push_back(plugin);
+  }
+  hasPending_ = !pendingPlugins_.empty();
+  GELOGI("OpsProtoManager defers %zu of %zu plugins.", pendingPlugins_.size(), file_list.size());
+
+  if (manifest_changed || plugins.size() != manifest.size()) {
+    WriteManifest(plugins);
+  }
+}
+
+bool OpsProtoManager::LoadPlugin(const std::string &path, std::vector<std::string> *op_types) {
+  // op type ids are dense, the types first registered by the library get the ids following the former ones
+  auto type_num_before = OperatorFactoryImpl::GetOpTypeNum();
+  void *handle = mmDlopen(path.c_str(), MMPA_RTLD_NOW | MMPA_RTLD_GLOBAL);
+  if (handle == nullptr) {
+    const char *error = mmDlerror();
+    error = (error == nullptr) ? "" : error;
+    GELOGW("OpsProtoManager dlopen failed, plugin name:%s. Message(%s).", path.c_str(), error);
+    return false;
+  }
+  // Close dl when the program exist, not close here
+  GELOGI("OpsProtoManager plugin load %s success.", path.c_str());
+  handles_.push_back(handle);
+  if (op_types != nullptr) {
+    for (auto id = type_num_before; id < OperatorFactoryImpl::GetOpTypeNum(); ++id) {
+      op_types->push_back(OperatorFactoryImpl::GetOpType(static_cast<OpTypeId>(id)));
+    }
+  }
+  return true;
+}
+
+void OpsProtoManager::LoadPendingPlugin(size_t index) {
+  // Taken first, so lookups made by the initializers of the library do not load it again
+  std::vector<std::string> op_types;
+  op_types.swap(pendingPlugins_[index].op_types);
+  // op types of a loaded plugin are cleared
+  if (op_types.empty()) {
+    return;
+  }
+  (void)LoadPlugin(pendingPlugins_[index].path, nullptr);
+  // Other threads wait on mutex_ until here, so they only see the op types once all of them are registered
+  for (const auto &op_type : op_types) {
+    auto iter = pendingOpTypes_.find(op_type);
+    if (iter != pendingOpTypes_.end() && iter->second == index) {
+      (void)pendingOpTypes_.erase(iter);
+    }
+  }
+  hasPending_ = std::any_of(pendingPlugins_.begin(), pendingPlugins_.end(),
+                            [](const PluginInfo &info) { return !info.op_types.empty(); });
+}
+
+// Each line of the manifest is: path \t mtime \t size \t comma separated op types
+void OpsProtoManager::ReadManifest(std::map<std::string, PluginInfo> &manifest) const {
+  std::ifstream fs(manifestPath_);
+  if (!fs.is_open()) {
+    GELOGI("OpsProtoManager manifest %s not exist, it will be created.", manifestPath_.c_str());
+    return;
+  }
+  std::string line;
+  while (std::getline(fs, line)) {
+    auto fields = Split(line, kManifestFieldDelim);
+    if (fields.size() != kManifestFieldNum || fields[0].empty()) {
+      GELOGW("OpsProtoManager skips invalid manifest line: %s", line.c_str());
+      continue;
+    }
+    PluginInfo plugin;
+    plugin.path = fields[0];
+    plugin.mtime = std::strtoll(fields[1].c_str(), nullptr, 10);
+    plugin.size = std::strtoll(fields[2].c_str(), nullptr, 10);
+    for (const auto &op_type : Split(fields[3], kOpTypeDelim)) {
+      if (!op_type.empty()) {
+        plugin.op_types.push_back(op_type);
+      }
+    }
+    manifest[plugin.path] = std::move(plugin);
+  }
+}
+
+void OpsProtoManager::WriteManifest(const std::vector<PluginInfo> &plugins) const {
+  // Write aside and rename, so a concurrent process never reads a partial manifest
+  std::string tmp_path = manifestPath_ + ".tmp";
+  {
+    std::ofstream fs(tmp_path, std::ios::trunc);
+    if (!fs.is_open()) {
+      GELOGW("OpsProtoManager can not write manifest %s.", tmp_path.c_str());
+      return;
+    }
+    for (const auto &plugin : plugins) {
+      fs << plugin.path << kManifestFieldDelim << plugin.mtime << kManifestFieldDelim << plugin.size
+         << kManifestFieldDelim;
+      for (size_t i = 0; i < plugin.op_types.size(); ++i) {
+        fs << ((i == 0) ? "" : ",") << plugin.op_types[i];
+      }
+      fs << "\n";
+    }
+  }
+  if (std::rename(tmp_path.c_str(), manifestPath_.c_str()) != 0) {
+    GELOGW("OpsProtoManager can not update manifest %s.", manifestPath_.c_str());
+    return;
   }
+  GELOGI("OpsProtoManager manifest %s updated with %zu plugins.", manifestPath_.c_str(), plugins.size());
 }
 }  // namespace ge
@@ -36,14 +36,30 @@ graphStatus GEContext::GetOption(const std::string &key, std::string &option) {
   return GetThreadLocalContext().GetOption(key, option);
 }
 
+graphStatus GEContext::GetOption(IntOption key, int64_t &value) {
+  return GetThreadLocalContext().GetOption(key, value);
+}
+
 bool GEContext::GetHostExecFlag() {
+  // The placement is compared again only after the options of this thread change
+  thread_local bool cached = false;
+  thread_local uint64_t cached_version = 0U;
+  thread_local bool host_exec_flag = false;
+  GEThreadLocalContext &context = GetThreadLocalContext();
+  if (cached && (cached_version == context.GetOptionVersion())) {
+    return host_exec_flag;
+  }
+  cached = true;
+  cached_version = context.GetOptionVersion();
   std::string exec_placement;
-  if (GetThreadLocalContext().GetOption("ge.exec.placement", exec_placement) != GRAPH_SUCCESS) {
+  if (context.GetOption("ge.exec.placement", exec_placement) != GRAPH_SUCCESS) {
     GELOGW("get option ge.exec.placement failed.");
-    return false;
+    host_exec_flag = false;
+    return host_exec_flag;
   }
   GELOGD("Option ge.exec.placement is %s.", exec_placement.c_str());
-  return exec_placement == kHostExecPlacement;
+  host_exec_flag = (exec_placement == kHostExecPlacement);
+  return host_exec_flag;
 }
 
 std::map<std::string, std::string> &GetMutableGlobalOptions() {
@@ -52,24 +68,18 @@ std::map<std::string, std::string> &GetMutableGlobalOptions() {
 }
 
 void GEContext::Init() {
-  string session_id;
-  (void)GetOption("ge.exec.sessionId", session_id);
-  try{
-    session_id_ = static_cast<uint64_t>(std::stoi(session_id.c_str()));
-  } catch (std::invalid_argument &) {
-    GELOGW("%s transform to int failed.", session_id.c_str());
-  } catch (std::out_of_range &) {
-    GELOGW("%s transform to int failed.", session_id.c_str());
+  int64_t session_id = 0;
+  if (GetOption(IntOption::kSessionId, session_id) == GRAPH_SUCCESS) {
+    session_id_ = static_cast<uint64_t>(session_id);
+  } else {
+    GELOGW("Option ge.exec.sessionId is not set or not an integer.");
   }
 
-  string device_id;
-  (void)GetOption("ge.exec.deviceId", device_id);
-  try{
-    device_id_ = static_cast<uint32_t>(std::stoi(device_id.c_str()));
-  } catch (std::invalid_argument &) {
-    GELOGW("%s transform to int failed.", device_id.c_str());
-  } catch (std::out_of_range &) {
-    GELOGW("%s transform to int failed.", device_id.c_str());
+  int64_t device_id = 0;
+  if (GetOption(IntOption::kDeviceId, device_id) == GRAPH_SUCCESS) {
+    device_id_ = static_cast<uint32_t>(device_id);
+  } else {
+    GELOGW("Option ge.exec.deviceId is not set or not an integer.");
   }
 
   string job_id;
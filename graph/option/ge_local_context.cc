@@ -15,11 +15,48 @@
  */
 
 #include "./ge_local_context.h"
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
 #include <utility>
+#include "framework/common/debug/ge_log.h"
+#include "ge/ge_api_types.h"
 
 namespace ge {
 namespace {
 thread_local GEThreadLocalContext thread_context;
+const int kDecimal = 10;
+
+// Indexed by IntOption
+const char *const kIntOptionKeys[] = {
+    OPTION_EXEC_SESSION_ID,
+    OPTION_EXEC_DEVICE_ID,
+    OPTION_GRAPH_RUN_MODE,
+    OPTION_GE_MAX_DUMP_FILE_NUM,
+    OPTION_GE_MAX_DUMP_FILE_SIZE,
+};
+static_assert(sizeof(kIntOptionKeys) / sizeof(kIntOptionKeys[0]) == static_cast<size_t>(IntOption::kIntOptionEnd),
+              "every IntOption needs a key");
+
+// Shared by all threads, a context copied to another thread keeps a version no other option set has
+uint64_t NextOptionVersion() {
+  static std::atomic<uint64_t> option_version(0U);
+  return ++option_version;
+}
+
+bool ParseInt64(const string &str, int64_t &value) {
+  if (str.empty()) {
+    return false;
+  }
+  char *end = nullptr;
+  errno = 0;
+  long long result = std::strtoll(str.c_str(), &end, kDecimal);
+  if ((errno == ERANGE) || (end == nullptr) || (*end != '\0')) {
+    return false;
+  }
+  value = static_cast<int64_t>(result);
+  return true;
+}
 }
 
 GEThreadLocalContext &GetThreadLocalContext() { return thread_context; }
@@ -43,19 +80,51 @@ graphStatus GEThreadLocalContext::GetOption(const string &key, string &option) {
   return GRAPH_PARAM_INVALID;
 }
 
+graphStatus GEThreadLocalContext::GetOption(IntOption key, int64_t &value) {
+  auto index = static_cast<size_t>(key);
+  if (index >= static_cast<size_t>(IntOption::kIntOptionEnd)) {
+    GELOGE(GRAPH_PARAM_INVALID, "Int option %zu is out of range.", index);
+    return GRAPH_PARAM_INVALID;
+  }
+  IntOptionSlot &slot = int_options_[index];
+  if (!slot.parsed) {
+    string option;
+    slot.status = GetOption(kIntOptionKeys[index], option);
+    if ((slot.status == GRAPH_SUCCESS) && !ParseInt64(option, slot.value)) {
+      GELOGW("Option %s is %s, which is not an integer.", kIntOptionKeys[index], option.c_str());
+      slot.status = GRAPH_PARAM_INVALID;
+    }
+    slot.parsed = true;
+  }
+  if (slot.status == GRAPH_SUCCESS) {
+    value = slot.value;
+  }
+  return slot.status;
+}
+
+void GEThreadLocalContext::ResetTypedOptions() {
+  for (auto &slot : int_options_) {
+    slot.parsed = false;
+  }
+  version_ = NextOptionVersion();
+}
+
 void GEThreadLocalContext::SetGlobalOption(map<string, string> options_map) {
   global_options_.clear();
   global_options_ = std::move(options_map);
+  ResetTypedOptions();
 }
 
 void GEThreadLocalContext::SetSessionOption(map<string, string> options_map) {
   session_options_.clear();
   session_options_ = std::move(options_map);
+  ResetTypedOptions();
 }
 
 void GEThreadLocalContext::SetGraphOption(map<std::string, string> options_map) {
   graph_options_.clear();
   graph_options_ = std::move(options_map);
+  ResetTypedOptions();
 }
 
 map<string, string> GEThreadLocalContext::GetAllGraphOptions() const {
@@ -16,14 +16,23 @@
 
 #include "graph/shape_refiner.h"
 
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <list>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <iostream>
 #include <unordered_map>
 #include <vector>
 #include <stack>
 #include "graph/debug/ge_attr_define.h"
+#include "graph/ge_context.h"
+#include "graph/ge_local_context.h"
+#include "graph/utils/attr_utils.h"
 #include "graph/utils/graph_utils.h"
+#include "graph/utils/thread_pool.h"
 
 #include "debug/ge_log.h"
 #include "debug/ge_op_types.h"
@@ -570,6 +579,226 @@ InferenceContextPtr CreateInferenceContext(const std::unordered_map<NodePtr, Inf
 
 namespace {
 thread_local std::unordered_map<NodePtr, InferenceContextPtr> context_map;
+
+using InferResult = std::vector<GeTensorDesc>;
+using InferResultPtr = std::shared_ptr<const InferResult>;
+
+// Bounded LRU cache of infer results shared by all threads
+class InferResultCache {
+ public:
+  static InferResultCache &Instance() {
+    static InferResultCache instance;
+    return instance;
+  }
+
+  bool IsEnabled() const { return capacity_.load(std::memory_order_relaxed) > 0; }
+
+  void SetCapacity(size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_.store(capacity, std::memory_order_relaxed);
+    Shrink();
+  }
+
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    index_.clear();
+    entries_.clear();
+    stats_ = InferCacheStats();
+  }
+
+  void RecordBypass() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.bypasses;
+  }
+
+  InferResultPtr Find(const std::string &key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = index_.find(key);
+    if (iter == index_.end()) {
+      ++stats_.misses;
+      return nullptr;
+    }
+    ++stats_.hits;
+    entries_.splice(entries_.begin(), entries_, iter->second);
+    return iter->second->second;
+  }
+
+  void Insert(std::string &&key, const InferResultPtr &result) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (capacity_.load(std::memory_order_relaxed) == 0) {
+      return;
+    }
+    auto iter = index_.find(key);
+    if (iter != index_.end()) {
+      iter->second->second = result;
+      entries_.splice(entries_.begin(), entries_, iter->second);
+      return;
+    }
+    entries_.emplace_front(std::move(key), result);
+    index_.emplace(entries_.front().first, entries_.begin());
+    Shrink();
+  }
+
+  InferCacheStats GetStats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    InferCacheStats stats = stats_;
+    stats.entries = entries_.size();
+    return stats;
+  }
+
+ private:
+  using Entry = std::pair<std::string, InferResultPtr>;
+
+  void Shrink() {
+    while (entries_.size() > capacity_.load(std::memory_order_relaxed)) {
+      (void)index_.erase(entries_.back().first);
+      entries_.pop_back();
+    }
+  }
+
+  std::mutex mutex_;
+  std::atomic<size_t> capacity_{0};
+  std::list<Entry> entries_;
+  std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+  InferCacheStats stats_;
+};
+
+void AppendTensorDescKey(const GeTensorDescPtr &desc, std::string &key) {
+  if (desc == nullptr) {
+    key.append("null;");
+    return;
+  }
+  key.append(std::to_string(static_cast<int32_t>(desc->GetFormat()))).append(",");
+  key.append(std::to_string(static_cast<int32_t>(desc->GetDataType()))).append(",[");
+  for (const auto dim : desc->GetShape().GetDims()) {
+    key.append(std::to_string(dim)).append(",");
+  }
+  // origin shape, format, dtype and shape range all live in the attrs
+  key.append("]").append(AttrUtils::GetAllAttrsStr(desc)).append(";");
+}
+
+// Infer functions may read const inputs or the inference context, those results depend on more than
+// the descs and must not be replayed
+bool IsInferCacheable(const NodePtr &node, bool before_subgraph,
+                      const std::unordered_map<NodePtr, InferenceContextPtr> &contexts) {
+  if (!before_subgraph || node->GetOwnerComputeGraph()->GetGraphUnknownFlag()) {
+    return false;
+  }
+  const auto &op_desc = node->GetOpDesc();
+  if (op_desc->GetType() == CONSTANT || op_desc->GetType() == CONSTANTOP ||
+      !op_desc->GetSubgraphInstanceNames().empty() || !op_desc->GetOpInferDepends().empty()) {
+    return false;
+  }
+  for (const auto &in_anchor : node->GetAllInDataAnchors()) {
+    const auto &peer_out_anchor = in_anchor->GetPeerOutAnchor();
+    if (peer_out_anchor == nullptr) {
+      continue;
+    }
+    auto peer_node = peer_out_anchor->GetOwnerNode();
+    if (peer_node == nullptr || contexts.count(peer_node) > 0) {
+      return false;
+    }
+    const auto &peer_type = peer_node->GetType();
+    if (peer_type == CONSTANT || peer_type == CONSTANTOP || peer_type == ENTER || peer_type == REFENTER ||
+        (peer_type == DATA && NodeUtils::GetParentInput(peer_node) != nullptr)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::string GetInferCacheKey(const OpDescPtr &op_desc) {
+  std::string key = op_desc->GetType();
+  key.append("|").append(AttrUtils::GetAllAttrsStr(op_desc)).append("|");
+  for (const auto &input_desc : op_desc->GetAllInputsDescPtr()) {
+    AppendTensorDescKey(input_desc, key);
+  }
+  key.append("|");
+  for (const auto &output_desc : op_desc->GetAllOutputsDescPtr()) {
+    AppendTensorDescKey(output_desc, key);
+  }
+  return key;
+}
+
+void ReplayInferResult(const OpDescPtr &op_desc, const InferResult &result) {
+  for (size_t i = 0; i < result.size(); ++i) {
+    auto output_desc = op_desc->MutableOutputDesc(static_cast<uint32_t>(i));
+    if (output_desc == nullptr) {
+      continue;
+    }
+    output_desc->SetShape(result[i].GetShape());
+    output_desc->SetFormat(result[i].GetFormat());
+    output_desc->SetDataType(result[i].GetDataType());
+    output_desc->CopyAttrsFrom(result[i]);
+  }
+}
+
+// Group the nodes by their longest distance from a source node, nodes of a level keep the graph order.
+// Returns false if the graph has a cycle such as a loop back edge
+bool SplitIntoLevels(const ComputeGraphPtr &graph, std::vector<std::vector<NodePtr>> &levels) {
+  auto direct_nodes = graph->GetDirectNode();
+  std::vector<NodePtr> nodes(direct_nodes.begin(), direct_nodes.end());
+  std::unordered_map<const Node *, size_t> node_index;
+  node_index.reserve(nodes.size());
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    node_index[nodes[i].get()] = i;
+  }
+  std::vector<size_t> in_degree(nodes.size(), 0);
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    for (const auto &in_node : nodes[i]->GetInAllNodes()) {
+      if (node_index.count(in_node.get()) > 0) {
+        ++in_degree[i];
+      }
+    }
+  }
+  std::vector<size_t> depth(nodes.size(), 0);
+  std::vector<size_t> ready;
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    if (in_degree[i] == 0) {
+      ready.push_back(i);
+    }
+  }
+  size_t visited = 0;
+  size_t max_depth = 0;
+  while (!ready.empty()) {
+    size_t idx = ready.back();
+    ready.pop_back();
+    ++visited;
+    max_depth = std::max(max_depth, depth[idx]);
+    for (const auto &out_node : nodes[idx]->GetOutAllNodes()) {
+      auto iter = node_index.find(out_node.get());
+      if (iter == node_index.end()) {
+        continue;
+      }
+      depth[iter->second] = std::max(depth[iter->second], depth[idx] + 1);
+      if (--in_degree[iter->second] == 0) {
+        ready.push_back(iter->second);
+      }
+    }
+  }
+  if (visited != nodes.size()) {
+    return false;
+  }
+  levels.assign(max_depth + 1, std::vector<NodePtr>());
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    levels[depth[i]].push_back(nodes[i]);
+  }
+  return true;
+}
+
+InferResultPtr SaveInferResult(const OpDescPtr &op_desc) {
+  auto result = ComGraphMakeShared<InferResult>();
+  if (result == nullptr) {
+    return nullptr;
+  }
+  for (const auto &output_desc : op_desc->GetAllOutputsDescPtr()) {
+    if (output_desc == nullptr) {
+      return nullptr;
+    }
+    result->emplace_back(*output_desc);
+  }
+  return result;
+}
 }
 
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY
@@ -577,6 +806,21 @@ void ShapeRefiner::ClearContextMap() {
   context_map.clear();
 }
 
+GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY
+void ShapeRefiner::SetInferCacheCapacity(size_t capacity) {
+  InferResultCache::Instance().SetCapacity(capacity);
+}
+
+GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY
+void ShapeRefiner::ClearInferCache() {
+  InferResultCache::Instance().Clear();
+}
+
+GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY
+InferCacheStats ShapeRefiner::GetInferCacheStats() {
+  return InferResultCache::Instance().GetStats();
+}
+
 graphStatus ShapeRefiner::InferShapeAndType(const ConstNodePtr &node, Operator &op) {
   return InferShapeAndType(node, op, true);
 }
@@ -712,6 +956,16 @@ graphStatus ShapeRefiner::InferShapeAndTypeForRunning(const NodePtr &node, bool
 
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY
 graphStatus ShapeRefiner::InferShapeAndType(const NodePtr &node, bool before_subgraph) {
+  InferenceContextPtr output_context = nullptr;
+  auto ret = InferShapeAndType(node, before_subgraph, context_map, output_context);
+  if (output_context != nullptr) {
+    (void)context_map.emplace(node, output_context);
+  }
+  return ret;
+}
+
+graphStatus ShapeRefiner::InferShapeAndType(const NodePtr &node, bool before_subgraph, const ContextMap &contexts,
+                                            InferenceContextPtr &output_context) {
   GE_IF_BOOL_EXEC(node == nullptr, GELOGE(GRAPH_FAILED, "node is null."); return GRAPH_FAILED);
   bool is_unknown_graph = node->GetOwnerComputeGraph()->GetGraphUnknownFlag();
   auto opdesc = node->GetOpDesc();
@@ -731,16 +985,33 @@ graphStatus ShapeRefiner::InferShapeAndType(const NodePtr &node, bool before_sub
     return GRAPH_FAILED;
   }
   PrintInOutTensorShape(node, "before_infershape");
-  Operator op = OpDescUtils::CreateOperatorFromNode(node);
-
-  if (!is_unknown_graph) {
-    auto inference_context = CreateInferenceContext(context_map, node);
-    GE_CHECK_NOTNULL(inference_context);
-    GELOGD("create context for node:%s, marks %zu", node->GetName().c_str(), inference_context->GetMarks().size());
-    op.SetInferenceContext(inference_context);
+  auto &infer_cache = InferResultCache::Instance();
+  std::string cache_key;
+  InferResultPtr cached_result = nullptr;
+  if (infer_cache.IsEnabled()) {
+    if (IsInferCacheable(node, before_subgraph, contexts)) {
+      cache_key = GetInferCacheKey(opdesc);
+      cached_result = infer_cache.Find(cache_key);
+    } else {
+      infer_cache.RecordBypass();
+    }
   }
 
-  graphStatus status = InferShapeAndType(node, op, before_subgraph);
+  Operator op;
+  graphStatus status = GRAPH_SUCCESS;
+  if (cached_result != nullptr) {
+    GELOGD("node:%s reuses cached infershape result", node->GetName().c_str());
+    ReplayInferResult(opdesc, *cached_result);
+  } else {
+    op = OpDescUtils::CreateOperatorFromNode(node);
+    if (!is_unknown_graph) {
+      auto inference_context = CreateInferenceContext(contexts, node);
+      GE_CHECK_NOTNULL(inference_context);
+      GELOGD("create context for node:%s, marks %zu", node->GetName().c_str(), inference_context->GetMarks().size());
+      op.SetInferenceContext(inference_context);
+    }
+    status = InferShapeAndType(node, op, before_subgraph);
+  }
   if (status == GRAPH_PARAM_INVALID || status == GRAPH_SUCCESS) {
     if (is_unknown_graph) {
       PrintInOutTensorShape(node, "after_infershape when running");
@@ -768,14 +1039,20 @@ graphStatus ShapeRefiner::InferShapeAndType(const NodePtr &node, bool before_sub
     GELOGE(GRAPH_FAILED, "%s call infer function failed.", node->GetName().c_str());
     return GRAPH_FAILED;
   }
-  if (!is_unknown_graph) {
+  if (!is_unknown_graph && cached_result == nullptr) {
     auto ctx_after_infer = op.GetInferenceContext();
     if (ctx_after_infer != nullptr) {
       GELOGD("[%s] after infershape. mark:%zu", node->GetName().c_str(), ctx_after_infer->GetMarks().size());
       if (!ctx_after_infer->GetOutputHandleShapesAndTypes().empty() || !ctx_after_infer->GetMarks().empty()) {
         GELOGD("[%s] set inference context after. mark:%zu", node->GetName().c_str(),
                ctx_after_infer->GetMarks().size());
-        (void)context_map.emplace(node, ctx_after_infer);
+        output_context = ctx_after_infer;
+      }
+    }
+    if (!cache_key.empty() && status == GRAPH_SUCCESS && output_context == nullptr) {
+      auto result = SaveInferResult(opdesc);
+      if (result != nullptr) {
+        infer_cache.Insert(std::move(cache_key), result);
       }
     }
   }
@@ -783,4 +1060,110 @@ graphStatus ShapeRefiner::InferShapeAndType(const NodePtr &node, bool before_sub
 
   return GRAPH_SUCCESS;
 }
+
+graphStatus ShapeRefiner::InferNodeAndSubgraphs(const NodePtr &node, const ContextMap &contexts,
+                                                ContextMap &produced) {
+  GE_CHECK_NOTNULL(node);
+  GE_CHECK_NOTNULL(node->GetOpDesc());
+  InferenceContextPtr output_context = nullptr;
+  auto ret = InferShapeAndType(node, true, contexts, output_context);
+  if (ret != GRAPH_SUCCESS) {
+    return ret;
+  }
+  if (output_context != nullptr) {
+    (void)produced.emplace(node, output_context);
+  }
+  const auto &subgraph_names = node->GetOpDesc()->GetSubgraphInstanceNames();
+  if (subgraph_names.empty()) {
+    return GRAPH_SUCCESS;
+  }
+  for (size_t i = 0; i < subgraph_names.size(); ++i) {
+    auto subgraph = NodeUtils::GetSubgraph(*node, static_cast<uint32_t>(i));
+    if (subgraph == nullptr) {
+      continue;
+    }
+    // nodes of a subgraph only look up the contexts of their own graph
+    ContextMap subgraph_contexts;
+    ret = InferGraph(subgraph, subgraph_contexts);
+    if (ret != GRAPH_SUCCESS) {
+      GELOGE(ret, "Infer subgraph %s of node %s failed", subgraph->GetName().c_str(), node->GetName().c_str());
+      return ret;
+    }
+    produced.insert(subgraph_contexts.begin(), subgraph_contexts.end());
+  }
+  output_context = nullptr;
+  ret = InferShapeAndType(node, false, contexts, output_context);
+  if (output_context != nullptr) {
+    (void)produced.emplace(node, output_context);
+  }
+  return ret;
+}
+
+graphStatus ShapeRefiner::InferGraph(const ComputeGraphPtr &graph, ContextMap &contexts) {
+  for (const auto &node : graph->GetDirectNode()) {
+    ContextMap produced;
+    auto ret = InferNodeAndSubgraphs(node, contexts, produced);
+    if (ret != GRAPH_SUCCESS) {
+      return ret;
+    }
+    contexts.insert(produced.begin(), produced.end());
+  }
+  return GRAPH_SUCCESS;
+}
+
+GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY
+graphStatus ShapeRefiner::InferShapeAndTypeForGraph(const ComputeGraphPtr &graph, uint32_t thread_num) {
+  GE_CHECK_NOTNULL(graph);
+  std::vector<std::vector<NodePtr>> levels;
+  if (thread_num <= 1U || !SplitIntoLevels(graph, levels)) {
+    return InferGraph(graph, context_map);
+  }
+  size_t max_level_size = 0U;
+  for (const auto &level : levels) {
+    max_level_size = std::max(max_level_size, level.size());
+  }
+  // more threads than cores or than nodes of the widest level would only wait
+  thread_num = std::min(thread_num, ThreadPool::GetThreadNum(max_level_size));
+  GELOGD("Infer graph %s with %zu levels on %u threads", graph->GetName().c_str(), levels.size(), thread_num);
+  // deferred ops proto libraries are loaded here, so no library initializer runs next to the workers
+  for (const auto &node : graph->GetAllNodes()) {
+    (void)OperatorFactoryImpl::GetOpTypeId(node->GetType());
+  }
+
+  // the workers only read the contexts of former levels, new ones are merged in graph order after each level
+  const ContextMap &contexts = context_map;
+  // infer funcs read the options and the session of the calling thread, both are thread local
+  const GEThreadLocalContext &thread_context = GetThreadLocalContext();
+  const uint64_t session_id = GetContext().SessionId();
+  ThreadPool pool(thread_num);
+  for (const auto &level : levels) {
+    std::vector<ContextMap> produced(level.size());
+    std::vector<graphStatus> results(level.size(), GRAPH_SUCCESS);
+    if (level.size() == 1U) {
+      results[0] = InferNodeAndSubgraphs(level[0], contexts, produced[0]);
+    } else {
+      std::vector<std::future<graphStatus>> futures;
+      futures.reserve(level.size());
+      for (size_t i = 0; i < level.size(); ++i) {
+        futures.emplace_back(
+            pool.Commit([&level, &contexts, &produced, &thread_context, session_id, i]() -> graphStatus {
+              GetThreadLocalContext() = thread_context;
+              GetContext().SetSessionId(session_id);
+              return InferNodeAndSubgraphs(level[i], contexts, produced[i]);
+            }));
+      }
+      for (size_t i = 0; i < futures.size(); ++i) {
+        results[i] = futures[i].valid() ? futures[i].get() : GRAPH_FAILED;
+      }
+    }
+    for (size_t i = 0; i < level.size(); ++i) {
+      if (results[i] != GRAPH_SUCCESS) {
+        GELOGE(results[i], "Infer node %s of graph %s failed", level[i]->GetName().c_str(), graph->GetName().c_str());
+        return results[i];
+      }
+      context_map.insert(produced[i].begin(), produced[i].end());
+    }
+  }
+  return GRAPH_SUCCESS;
+}
 }  // namespace ge
@@ -18,6 +18,7 @@
 #include "debug/ge_util.h"
 #include "framework/common/debug/ge_log.h"
 #include "graph/ge_tensor.h"
+#include "proto/ge_ir.pb.h"
 #include "securec.h"
 #include "utils/attr_utils.h"
 #include "utils/tensor_adapter.h"
@@ -30,6 +31,10 @@ namespace {
 const int EXTRA_STORE_POINTER_FOR_STRING = 8;
 const int EXTRA_STORE_POINTER_FOR_STRING_AND_END_SYMBOL = 9;
 const int64_t UNKNOWN_DIM_SIZE = -1;
+// attrs of GeTensorDesc read by TensorAdapter::AsTensorDesc
+const char *const kOriginShapeAttr = "origin_shape";
+const char *const kShapeRangeAttr = "shape_range";
+const int kDimRangeSize = 2;
 }  // namespace
 
 namespace ge {
@@ -65,6 +70,56 @@ class TensorDescImpl {
   ~TensorDescImpl() = default;
   TensorDescImpl(const Shape &shape, Format format, DataType dt) : shape_(shape), format_(format), data_type_(dt) {}
 
+  // Fields set on a view since it was filled from base_
+  enum OwnField : uint32_t {
+    kOwnShape = 1U << 0,
+    kOwnRange = 1U << 1,
+    kOwnOriginFormat = 1U << 2,
+    kOwnOriginShape = 1U << 3,
+  };
+
+  // Shapes are kept as dims until read, a view of an unset shape builds the Shape on each read
+  bool ReadsDims(uint32_t field) const { return (base_ != nullptr) && ((own_fields_ & field) == 0U); }
+
+  // The node may still edit its desc in place through OpDesc::MutableInputDesc, so the view copies the fields
+  // it exposes. The attr map is not copied, base_ is only read when the view is converted back.
+  // The shapes and range are read from proto_msg, the GeTensorDesc getters would build a GeShape or go through
+  // AttrUtils for each of them
+  void Snapshot(const ConstGeTensorDescPtr &ge_desc, const proto::TensorDescriptor &proto_msg) {
+    base_ = ge_desc;
+    own_fields_ = 0U;
+    dims_.assign(proto_msg.shape().dim().begin(), proto_msg.shape().dim().end());
+    origin_dims_.clear();
+    range_.clear();
+    auto it = proto_msg.attr().find(kOriginShapeAttr);
+    if ((it != proto_msg.attr().end()) && it->second.has_list()) {
+      origin_dims_.assign(it->second.list().i().begin(), it->second.list().i().end());
+    }
+    it = proto_msg.attr().find(kShapeRangeAttr);
+    if ((it != proto_msg.attr().end()) && it->second.has_list_list_int()) {
+      for (const auto &dim_range : it->second.list_list_int().list_list_i()) {
+        if (dim_range.list_i_size() != kDimRangeSize) {
+          break;
+        }
+        range_.emplace_back(dim_range.list_i(0), dim_range.list_i(1));
+      }
+    }
+    format_ = ge_desc->GetFormat();
+    origin_format_ = ge_desc->GetOriginFormat();
+    data_type_ = ge_desc->GetDataType();
+    size_ = 0;
+    (void)TensorUtils::GetSize(*ge_desc, size_);
+    uint32_t real_dim_cnt = 0U;
+    (void)TensorUtils::GetRealDimCnt(*ge_desc, real_dim_cnt);
+    real_dim_cnt_ = real_dim_cnt;
+    name_ = ge_desc->GetName();
+  }
+
+  ConstGeTensorDescPtr base_;
+  uint32_t own_fields_ = 0U;
+  std::vector<int64_t> dims_;
+  std::vector<int64_t> origin_dims_;
+
   Shape shape_;
   std::vector<std::pair<int64_t, int64_t>> range_;
   Format format_ = FORMAT_ND;
@@ -284,11 +339,15 @@ void TensorDesc::Update(const Shape &shape, Format format, DataType dt) {
     impl->shape_ = shape;
     impl->format_ = format;
     impl->data_type_ = dt;
+    impl->own_fields_ |= TensorDescImpl::kOwnShape;
   }
 }
 
 Shape TensorDesc::GetShape() const {
   if (impl != nullptr) {
+    if (impl->ReadsDims(TensorDescImpl::kOwnShape)) {
+      return Shape(impl->dims_);
+    }
     return impl->shape_;
   }
   return Shape();
@@ -297,6 +356,7 @@ Shape TensorDesc::GetShape() const {
 void TensorDesc::SetShape(const Shape &shape) {
   if (impl != nullptr) {
     impl->shape_ = shape;
+    impl->own_fields_ |= TensorDescImpl::kOwnShape;
   }
 }
 
@@ -304,6 +364,7 @@ void TensorDesc::SetShape(const Shape &shape) {
 graphStatus TensorDesc::SetUnknownDimNumShape() {
   if (impl != nullptr) {
     impl->shape_ = Shape({UNKNOWN_DIM_NUM});
+    impl->own_fields_ |= TensorDescImpl::kOwnShape;
     return GRAPH_SUCCESS;
   }
   GELOGE(GRAPH_FAILED, "Set unknown shape failed,because no impl class!");
@@ -314,6 +375,7 @@ graphStatus TensorDesc::SetUnknownDimNumShape() {
 graphStatus TensorDesc::SetShapeRange(const std::vector<std::pair<int64_t, int64_t>> &range) {
   if (impl != nullptr) {
     impl->range_ = range;
+    impl->own_fields_ |= TensorDescImpl::kOwnRange;
     return GRAPH_SUCCESS;
   }
   GELOGE(GRAPH_FAILED, "SetShapeRange failed!impl is nullptr!");
@@ -330,6 +392,9 @@ graphStatus TensorDesc::GetShapeRange(std::vector<std::pair<int64_t, int64_t>> &
 
 Shape TensorDesc::GetOriginShape() const {
   if (impl != nullptr) {
+    if (impl->ReadsDims(TensorDescImpl::kOwnOriginShape)) {
+      return Shape(impl->origin_dims_);
+    }
     return impl->origin_shape_;
   }
   return Shape();
@@ -338,6 +403,7 @@ Shape TensorDesc::GetOriginShape() const {
 void TensorDesc::SetOriginShape(const Shape &origin_shape) {
   if (impl != nullptr) {
     impl->origin_shape_ = origin_shape;
+    impl->own_fields_ |= TensorDescImpl::kOwnOriginShape;
   }
 }
 
@@ -364,6 +430,7 @@ Format TensorDesc::GetOriginFormat() const {
 void TensorDesc::SetOriginFormat(Format origin_format) {
   if (impl != nullptr) {
     impl->origin_format_ = origin_format;
+    impl->own_fields_ |= TensorDescImpl::kOwnOriginFormat;
   }
 }
 
@@ -545,7 +612,7 @@ size_t Tensor::GetSize() const {
 
 graphStatus Tensor::SetData(std::vector<uint8_t> &&data) {
   if (impl != nullptr) {
-    (void)impl->ge_tensor.SetData(data);
+    (void)impl->ge_tensor.SetData(std::move(data));
     return GRAPH_SUCCESS;
   }
   return GRAPH_FAILED;
@@ -567,6 +634,17 @@ graphStatus Tensor::SetData(const uint8_t *data, size_t size) {
   return GRAPH_FAILED;
 }
 
+graphStatus Tensor::SetData(uint8_t *data, size_t size, const Tensor::DeleteFunc &deleter_func) {
+  if (impl != nullptr) {
+    if (impl->ge_tensor.SetData(data, size, deleter_func) != GRAPH_SUCCESS) {
+      GELOGE(GRAPH_FAILED, "Tensor set data with deleter failed.");
+      return GRAPH_FAILED;
+    }
+    return GRAPH_SUCCESS;
+  }
+  return GRAPH_FAILED;
+}
+
 graphStatus Tensor::SetData(const std::string &data) {
   if (impl != nullptr) {
     if (impl->SetData(data) != GRAPH_SUCCESS) {
@@ -657,6 +735,33 @@ Tensor Tensor::Clone() const {
 }
 
 GeTensorDesc TensorAdapter::TensorDesc2GeTensorDesc(const TensorDesc &tensor_desc) {
+  const auto &impl = tensor_desc.impl;
+  if ((impl != nullptr) && (impl->base_ != nullptr)) {
+    // start from the node's desc for the attrs TensorDesc does not carry, and write every field the view shows.
+    // An origin shape, origin format or range the view neither had nor set is not added
+    GeTensorDesc ge_tensor_desc(*impl->base_);
+    const uint32_t own_fields = impl->own_fields_;
+    ge_tensor_desc.SetShape(GeShape(tensor_desc.GetShape().GetDims()));
+    ge_tensor_desc.SetFormat(impl->format_);
+    ge_tensor_desc.SetDataType(impl->data_type_);
+    if (((own_fields & TensorDescImpl::kOwnOriginShape) != 0U) || !impl->origin_dims_.empty()) {
+      ge_tensor_desc.SetOriginShape(GeShape(tensor_desc.GetOriginShape().GetDims()));
+    }
+    if (((own_fields & TensorDescImpl::kOwnOriginFormat) != 0U) || (impl->origin_format_ != FORMAT_RESERVED)) {
+      ge_tensor_desc.SetOriginFormat(impl->origin_format_);
+    }
+    ge_tensor_desc.SetName(impl->name_);
+    if (((own_fields & TensorDescImpl::kOwnRange) != 0U) || !impl->range_.empty()) {
+      if (ge_tensor_desc.SetShapeRange(impl->range_) != GRAPH_SUCCESS) {
+        GELOGE(GRAPH_FAILED, "Set shape range failed!");
+        return ge_tensor_desc;
+      }
+    }
+    TensorUtils::SetSize(ge_tensor_desc, impl->size_);
+    TensorUtils::SetRealDimCnt(ge_tensor_desc, static_cast<uint32_t>(impl->real_dim_cnt_));
+    return ge_tensor_desc;
+  }
+
   GeTensorDesc ge_tensor_desc(GeShape(tensor_desc.GetShape().GetDims()), tensor_desc.GetFormat(),
                               tensor_desc.GetDataType());
   ge_tensor_desc.SetOriginShape(GeShape(tensor_desc.GetOriginShape().GetDims()));
@@ -708,6 +813,22 @@ TensorDesc TensorAdapter::GeTensorDesc2TensorDesc(const GeTensorDesc &ge_tensor_
   return tensor_desc;
 }
 
+void TensorAdapter::AsTensorDesc(const ConstGeTensorDescPtr &ge_tensor_desc, TensorDesc &tensor_desc) {
+  // reuse the impl of the output when nobody else holds it, so a read allocates nothing
+  if ((tensor_desc.impl == nullptr) || !tensor_desc.impl.unique()) {
+    tensor_desc.impl = ComGraphMakeShared<TensorDescImpl>();  // lint !e665
+    if (tensor_desc.impl == nullptr) {
+      GELOGE(GRAPH_FAILED, "Make shared TensorDescImpl failed.");
+      return;
+    }
+  }
+  if ((ge_tensor_desc == nullptr) || (ge_tensor_desc->tensor_descriptor_.GetProtoMsg() == nullptr)) {
+    GELOGE(GRAPH_FAILED, "GeTensorDesc is nullptr.");
+    return;
+  }
+  tensor_desc.impl->Snapshot(ge_tensor_desc, *ge_tensor_desc->tensor_descriptor_.GetProtoMsg());
+}
+
 GeTensorPtr TensorAdapter::Tensor2GeTensor(const Tensor &tensor) {
   GeTensorPtr ge_tensor;
   if (tensor.impl != nullptr) {
@@ -55,6 +55,10 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY graphStatus AnchorUtils::SetStatu
     return GRAPH_FAILED;
   }
   data_anchor->status_ = anchor_status;
+  auto node = data_anchor->GetOwnerNode();
+  if (node != nullptr) {
+    node->IncreaseAnchorsVersion();
+  }
   return GRAPH_SUCCESS;
 }
 
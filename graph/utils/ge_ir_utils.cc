@@ -15,8 +15,11 @@
  */
 
 #include "graph/utils/ge_ir_utils.h"
+#include <google/protobuf/arena.h>
+#include <mutex>
 #include <utility>
 #include "framework/common/debug/ge_log.h"
+#include "graph/utils/thread_pool.h"
 #include "mmpa/mmpa_api.h"
 
 namespace {
@@ -34,6 +37,73 @@ const int64_t kDumpLevel =
 const int64_t kInputPrefixLength = 5;
 const int64_t kOutputPrefixLength = 6;
 using AttrDefPair = ::google::protobuf::MapPair<std::string, ge::proto::AttrDef>;
+const size_t kArenaStartBlockSize = 64U * 1024U;
+const size_t kArenaMaxBlockSize = 8U * 1024U * 1024U;
+const size_t kMaxKeptBlockSize = 64U * 1024U * 1024U;
+
+// Keeps the first block of one released arena, grown to what the last model needed up to kMaxKeptBlockSize,
+// so that the next dump is encoded into one block that is already there instead of many fresh ones
+class OnnxArenaPool {
+ public:
+  static OnnxArenaPool *Instance() {
+    // never destroyed, the models handed out may be released by other static objects at exit
+    static OnnxArenaPool *pool = new (std::nothrow) OnnxArenaPool();
+    return pool;
+  }
+
+  std::shared_ptr<google::protobuf::Arena> Acquire() {
+    std::unique_ptr<char[]> block;
+    size_t block_size = 0U;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      block = std::move(block_);
+      block_size = block_size_;
+      block_size_ = 0U;
+    }
+    google::protobuf::ArenaOptions options;
+    options.start_block_size = kArenaStartBlockSize;
+    options.max_block_size = kArenaMaxBlockSize;
+    if (block != nullptr) {
+      options.initial_block = block.get();
+      options.initial_block_size = block_size;
+    }
+    auto arena = new (std::nothrow) google::protobuf::Arena(options);
+    if (arena == nullptr) {
+      return nullptr;
+    }
+    char *initial_block = block.release();
+    auto release = [this, initial_block, block_size](google::protobuf::Arena *used) {
+      Release(used, initial_block, block_size);
+    };
+    return std::shared_ptr<google::protobuf::Arena>(arena, release);
+  }
+
+ private:
+  OnnxArenaPool() = default;
+
+  void Release(google::protobuf::Arena *arena, char *initial_block, size_t block_size) {
+    size_t space_allocated = static_cast<size_t>(arena->SpaceAllocated());
+    delete arena;
+    std::unique_ptr<char[]> block(initial_block);
+    if ((space_allocated > block_size) && (space_allocated <= kMaxKeptBlockSize)) {
+      block.reset(new (std::nothrow) char[space_allocated]);
+      block_size = space_allocated;
+    }
+    if ((block == nullptr) || (block_size == 0U)) {
+      return;
+    }
+    // a block of a dump running at the same time is freed, the larger one is kept
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (block_size > block_size_) {
+      block_ = std::move(block);
+      block_size_ = block_size;
+    }
+  }
+
+  std::mutex mutex_;
+  std::unique_ptr<char[]> block_;
+  size_t block_size_ = 0U;
+};
 }  // namespace
 
 namespace ge {
@@ -76,9 +146,8 @@ void OnnxUtils::AddAttrProtoFromAttribute(const std::pair<const std::string, ge:
     GELOGE(GRAPH_FAILED, "attr is nullptr.");
     return;
   }
-  auto attr_name = string_attr_value.first;
-  attr->set_name(attr_name);
-  auto attr_value = string_attr_value.second;
+  attr->set_name(string_attr_value.first);
+  const auto &attr_value = string_attr_value.second;
   auto value_type = attr_value.GetValueType();
   switch (value_type) {
     case GeAttrValue::VT_FLOAT: {
@@ -136,7 +205,7 @@ void OnnxUtils::AddAttrProtoFromAttribute(const std::pair<const std::string, ge:
 }
 
 void OnnxUtils::AddAttrProto(onnx::NodeProto *node_proto, onnx::AttributeProto_AttributeType type, const string &name,
-                             void *data) {
+                             const void *data) {
   if (node_proto == nullptr) {
     GELOGE(FAILED, "Node_proto %s is nullptr.", name.c_str());
     return;
@@ -149,37 +218,37 @@ void OnnxUtils::AddAttrProto(onnx::NodeProto *node_proto, onnx::AttributeProto_A
   attr->set_name(name);
   switch (type) {
     case onnx::AttributeProto_AttributeType_FLOAT:
-      attr->set_f((*(static_cast<float *>(data))));
+      attr->set_f((*(static_cast<const float *>(data))));
       attr->set_type(onnx::AttributeProto_AttributeType_FLOAT);
       break;
 
     case onnx::AttributeProto_AttributeType_FLOATS:
       attr->set_type(onnx::AttributeProto_AttributeType_FLOATS);
-      for (auto &v : (*(static_cast<std::vector<float> *>(data)))) {
+      for (auto &v : (*(static_cast<const std::vector<float> *>(data)))) {
         attr->add_floats(v);
       }
       break;
 
     case onnx::AttributeProto_AttributeType_INT:
       attr->set_type(onnx::AttributeProto_AttributeType_INT);
-      attr->set_i((*(static_cast<int64_t *>(data))));
+      attr->set_i((*(static_cast<const int64_t *>(data))));
       break;
 
     case onnx::AttributeProto_AttributeType_INTS:
       attr->set_type(onnx::AttributeProto_AttributeType_INTS);
-      for (auto &v : *(static_cast<std::vector<int64_t> *>(data))) {
+      for (auto &v : *(static_cast<const std::vector<int64_t> *>(data))) {
         attr->add_ints(v);
       }
       break;
 
     case onnx::AttributeProto_AttributeType_STRING:
       attr->set_type(onnx::AttributeProto_AttributeType_STRING);
-      attr->set_s((*(static_cast<std::string *>(data))));
+      attr->set_s((*(static_cast<const std::string *>(data))));
       break;
 
     case onnx::AttributeProto_AttributeType_STRINGS:
       attr->set_type(onnx::AttributeProto_AttributeType_STRINGS);
-      for (auto &v : *(static_cast<std::vector<std::string> *>(data))) {
+      for (auto &v : *(static_cast<const std::vector<std::string> *>(data))) {
         attr->add_strings(v);
       }
       break;
@@ -191,7 +260,7 @@ void OnnxUtils::AddAttrProto(onnx::NodeProto *node_proto, onnx::AttributeProto_A
 }
 
 void OnnxUtils::AddAttrProto(onnx::NodeProto *node_proto, onnx::AttributeProto_AttributeType type, const string &name,
-                             ::google::protobuf::RepeatedField<::google::protobuf::int64> data) {
+                             const ::google::protobuf::RepeatedField<::google::protobuf::int64> &data) {
   if (node_proto == nullptr) {
     GELOGE(FAILED, "Node_proto %s is nullptr.", name.c_str());
     return;
@@ -211,7 +280,7 @@ void OnnxUtils::AddAttrProto(onnx::NodeProto *node_proto, onnx::AttributeProto_A
 }
 
 void OnnxUtils::AddAttrProto(onnx::NodeProto *node_proto, onnx::AttributeProto_AttributeType type, const string &name,
-                             ::google::protobuf::RepeatedField<bool> data) {
+                             const ::google::protobuf::RepeatedField<bool> &data) {
   if (node_proto == nullptr) {
     GELOGE(FAILED, "Node proto %s is nullptr.", name.c_str());
     return;
@@ -231,7 +300,7 @@ void OnnxUtils::AddAttrProto(onnx::NodeProto *node_proto, onnx::AttributeProto_A
 }
 
 void OnnxUtils::AddAttrProto(onnx::NodeProto *node_proto, onnx::AttributeProto_AttributeType type, const string &name,
-                             ::google::protobuf::RepeatedField<float> data) {
+                             const ::google::protobuf::RepeatedField<float> &data) {
   if (node_proto == nullptr) {
     GELOGE(FAILED, "Node_proto %s is nullptr.", name.c_str());
     return;
@@ -251,7 +320,7 @@ void OnnxUtils::AddAttrProto(onnx::NodeProto *node_proto, onnx::AttributeProto_A
 }
 
 void OnnxUtils::AddAttrProto(onnx::NodeProto *node_proto, onnx::AttributeProto_AttributeType type, const string &name,
-                             ::google::protobuf::RepeatedPtrField<::std::string> data) {
+                             const ::google::protobuf::RepeatedPtrField<::std::string> &data) {
   if (node_proto == nullptr) {
     GELOGE(FAILED, "Node proto %s is nullptr.", name.c_str());
     return;
@@ -285,18 +354,21 @@ void OnnxUtils::AddAttrProtoForOpInAndOutDesc(onnx::NodeProto *node_proto, const
         auto data_type = TypeUtils::DataTypeToSerialString(input_desc->GetDataType());
         AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_STRING, 
                      "input_desc_dtype:" + std::to_string(i), &data_type);
-        auto data_type_origin = TypeUtils::DataTypeToSerialString(input_desc->GetOriginDataType());
-        AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_STRING, 
-                     "input_desc_origin_dtype:" + std::to_string(i), &data_type_origin);
         auto dims = input_desc->GetShape().GetDims();
         AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INTS, 
                      "input_desc_shape:" + std::to_string(i), &dims);
-        auto dims_origin = input_desc->GetOriginShape().GetDims();
-        AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INTS,
-                     "input_desc_origin_shape:" + std::to_string(i), &dims_origin);
         auto layout = TypeUtils::FormatToSerialString(input_desc->GetFormat());
         AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_STRING, 
                      "input_desc_layout:" + std::to_string(i), &layout);
+        if (kDumpLevel == DUMP_WITH_OUT_DESC_ATTR) {
+          continue;
+        }
+        auto data_type_origin = TypeUtils::DataTypeToSerialString(input_desc->GetOriginDataType());
+        AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_STRING, 
+                     "input_desc_origin_dtype:" + std::to_string(i), &data_type_origin);
+        auto dims_origin = input_desc->GetOriginShape().GetDims();
+        AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INTS,
+                     "input_desc_origin_shape:" + std::to_string(i), &dims_origin);
         auto layout_origin = TypeUtils::FormatToSerialString(input_desc->GetOriginFormat());
         AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_STRING,
                      "input_desc_origin_layout:" + std::to_string(i), &layout_origin);
@@ -361,18 +433,21 @@ void OnnxUtils::AddAttrProtoForOpInAndOutDesc(onnx::NodeProto *node_proto, const
         auto data_type = TypeUtils::DataTypeToSerialString(output_desc->GetDataType());
         AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_STRING, 
                      "output_desc_dtype:" + std::to_string(i), &data_type);
-        auto origin_data_type = TypeUtils::DataTypeToSerialString(output_desc->GetOriginDataType());
-        AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_STRING, 
-                     "output_desc_origin_dtype:" + std::to_string(i), &origin_data_type);
         auto dims = output_desc->GetShape().GetDims();
         AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INTS, 
                      "output_desc_shape:" + std::to_string(i), &dims);
-        auto dims_origin = output_desc->GetOriginShape().GetDims();
-        AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INTS,
-                     "output_desc_origin_shape:" + std::to_string(i), &dims_origin);
         auto layout = TypeUtils::FormatToSerialString(output_desc->GetFormat());
         AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_STRING, "output_desc_layout:" + std::to_string(i),
                      &layout);
+        if (kDumpLevel == DUMP_WITH_OUT_DESC_ATTR) {
+          continue;
+        }
+        auto origin_data_type = TypeUtils::DataTypeToSerialString(output_desc->GetOriginDataType());
+        AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_STRING, 
+                     "output_desc_origin_dtype:" + std::to_string(i), &origin_data_type);
+        auto dims_origin = output_desc->GetOriginShape().GetDims();
+        AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INTS,
+                     "output_desc_origin_shape:" + std::to_string(i), &dims_origin);
         auto layout_origin = TypeUtils::FormatToSerialString(output_desc->GetOriginFormat());
         AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_STRING,
                      "output_desc_origin_layout:" + std::to_string(i), &layout_origin);
@@ -409,8 +484,8 @@ void OnnxUtils::AddAttrProtoForAttrsFromAttrMap(
     const ::google::protobuf::Map<std::string, ::ge::proto::AttrDef> &attr_map, onnx::NodeProto *node_proto,
     const std::string& prefix, const std::string& suffix) {
   for (const auto &item : attr_map) {
-    auto attr_name = item.first;
-    auto attr_def = item.second;
+    const auto &attr_name = item.first;
+    const auto &attr_def = item.second;
     auto attr_type = attr_def.value_case();
     if (attr_type == ge::proto::AttrDef::kT) {
       const auto &tensor_def = attr_def.t();
@@ -418,25 +493,23 @@ void OnnxUtils::AddAttrProtoForAttrsFromAttrMap(
       auto data_type = ge::proto::DataType_Name(tensor_desc.dtype());
       AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_STRING, 
                    prefix + attr_name + "_desc_dtype" + suffix, &data_type);
-      auto dims = tensor_desc.shape().dim();
+      const auto &dims = tensor_desc.shape().dim();
       AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INTS, 
                    prefix + attr_name + "_desc_shape" + suffix, dims);
-      auto layout = tensor_desc.layout();
+      const auto &layout = tensor_desc.layout();
       AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_STRING, 
                    prefix + attr_name + "_desc_layout" + suffix, &layout);
-      auto device_type = tensor_desc.device_type();
+      const auto &device_type = tensor_desc.device_type();
       AddAttrProto(node_proto, ge::onnx::AttributeProto_AttributeType_STRING, 
                    prefix + attr_name + "_desc_device_type" + suffix, &device_type);
       if (kDumpLevel == DUMP_ALL) {
-        auto data = tensor_def.data();
         AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_STRING,
-                     prefix + attr_name + "_data" + suffix, &data);
+                     prefix + attr_name + "_data" + suffix, &tensor_def.data());
       }
     }
     if (attr_type == ge::proto::AttrDef::kS) {
       if (kDumpLevel == DUMP_ALL) {
-        auto str_value = attr_def.s();
-        AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_STRING, prefix + attr_name + suffix, &str_value);
+        AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_STRING, prefix + attr_name + suffix, &attr_def.s());
       }
     }
     if (attr_type == ge::proto::AttrDef::kI) {
@@ -484,11 +557,11 @@ void OnnxUtils::AddAttrProtoFromNodeMembers(const NodePtr &node, onnx::NodeProto
     return;
   }
   // 1.Attributes added from node's methods
-  auto send_list = node->send_event_id_list_;
+  const auto &send_list = node->send_event_id_list_;
   if (!send_list.empty()) {
     AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INTS, "send_event_id_list", &send_list);
   }
-  auto recv_list = node->recv_event_id_list_;
+  const auto &recv_list = node->recv_event_id_list_;
   if (!recv_list.empty()) {
     AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INTS, "recv_event_id_list", &recv_list);
   }
@@ -737,6 +810,7 @@ bool OnnxUtils::ConvertGeModelToModelProto(const ge::Model &model, onnx::ModelPr
   }
 
   // For subgraphs: a subgraph is represented by a node
+  std::vector<std::pair<ComputeGraphPtr, onnx::GraphProto *>> subgraphs;
   for (const auto &sub_compute_graph : compute_graph->GetAllSubgraphs()) {
     if (sub_compute_graph != nullptr) {
       auto node_proto = graph_proto->add_node();
@@ -754,18 +828,61 @@ bool OnnxUtils::ConvertGeModelToModelProto(const ge::Model &model, onnx::ModelPr
         GELOGW("Sub graph proto is nullptr");
         continue;
       }
-      if (!EncodeGraph(sub_compute_graph, sub_graph_proto)) {
-        GELOGW("Encode sub graph: %s fail", sub_compute_graph->GetName().c_str());
-        continue;
-      }
+      subgraphs.emplace_back(sub_compute_graph, sub_graph_proto);
     } else {
       GELOGW("Graph: %s subgraph is nullptr, skip EncodeGraph", compute_graph->GetName().c_str());
       continue;
     }
   }
+  EncodeSubgraphs(subgraphs);
   return true;
 }
 
+void OnnxUtils::EncodeSubgraphs(const std::vector<std::pair<ComputeGraphPtr, onnx::GraphProto *>> &subgraphs) {
+  // the node protos are in place already, so the subgraphs can be filled in any order
+  uint32_t thread_num = ThreadPool::GetThreadNum(subgraphs.size());
+  std::vector<bool> results(subgraphs.size(), true);
+  if (thread_num > 1U) {
+    ThreadPool pool(thread_num);
+    std::vector<std::future<bool>> futures;
+    futures.reserve(subgraphs.size());
+    for (const auto &subgraph : subgraphs) {
+      futures.emplace_back(pool.Commit([&subgraph]() -> bool { return EncodeGraph(subgraph.first, subgraph.second); }));
+    }
+    for (size_t idx = 0U; idx < futures.size(); ++idx) {
+      results[idx] = futures[idx].valid() && futures[idx].get();
+    }
+  } else {
+    for (size_t idx = 0U; idx < subgraphs.size(); ++idx) {
+      results[idx] = EncodeGraph(subgraphs[idx].first, subgraphs[idx].second);
+    }
+  }
+  for (size_t idx = 0U; idx < subgraphs.size(); ++idx) {
+    if (!results[idx]) {
+      GELOGW("Encode sub graph: %s fail", subgraphs[idx].first->GetName().c_str());
+    }
+  }
+}
+
+std::shared_ptr<onnx::ModelProto> OnnxUtils::ConvertGeModelToModelProto(const ge::Model &model) {
+  auto arena_pool = OnnxArenaPool::Instance();
+  auto arena = (arena_pool == nullptr) ? nullptr : arena_pool->Acquire();
+  if (arena == nullptr) {
+    GELOGE(GRAPH_FAILED, "Acquire arena failed.");
+    return nullptr;
+  }
+  auto model_proto = google::protobuf::Arena::CreateMessage<onnx::ModelProto>(arena.get());
+  if (model_proto == nullptr) {
+    GELOGE(GRAPH_FAILED, "Create ModelProto on arena failed.");
+    return nullptr;
+  }
+  if (!ConvertGeModelToModelProto(model, *model_proto)) {
+    return nullptr;
+  }
+  // shares the ownership of the arena, the message itself is freed with it
+  return std::shared_ptr<onnx::ModelProto>(arena, model_proto);
+}
+
 // Part 2: from ONNX Protobuf convert to IR
 static std::map<onnx::TensorProto_DataType, ge::DataType> onnxDataTypeToGeMap = {
     {onnx::TensorProto_DataType_INT64, DT_INT64},   {onnx::TensorProto_DataType_UINT64, DT_UINT64},
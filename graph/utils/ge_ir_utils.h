@@ -101,28 +101,41 @@ bool IsEqual(const T &l_value, const T &r_value, const std::string &log_info_tag
 
 class OnnxUtils {
  public:
-  enum DumpLevel { NO_DUMP = 0, DUMP_ALL = 1, DUMP_WITH_OUT_DATA = 2, DUMP_WITH_OUT_DESC = 3, DUMP_LEVEL_END };
+  // DUMP_WITH_OUT_DESC_ATTR keeps only dtype, shape and layout of the input and output descs, for quick visual dumps
+  enum DumpLevel {
+    NO_DUMP = 0,
+    DUMP_ALL = 1,
+    DUMP_WITH_OUT_DATA = 2,
+    DUMP_WITH_OUT_DESC = 3,
+    DUMP_WITH_OUT_DESC_ATTR = 4,
+    DUMP_LEVEL_END
+  };
 
   static bool ConvertGeModelToModelProto(const ge::Model &model, ge::onnx::ModelProto &model_proto);
 
+  // The model proto is allocated on an arena which goes back to a pool once the last reference is dropped,
+  // so that repeated dumps of a graph reuse the same memory
+  static std::shared_ptr<ge::onnx::ModelProto> ConvertGeModelToModelProto(const ge::Model &model);
+
   static bool ConvertModelProtoToGeModel(const ge::onnx::ModelProto &model_proto, ge::Model &model);
 
  private:
   // Part 1: from IR convert to ONNX Protobuf
   static void AddAttrProto(ge::onnx::NodeProto *node_proto, ge::onnx::AttributeProto_AttributeType type,
-                           const std::string &name, void *data);
+                           const std::string &name, const void *data);
 
   static void AddAttrProto(ge::onnx::NodeProto *node_proto, ge::onnx::AttributeProto_AttributeType type,
-                           const std::string &name, ::google::protobuf::RepeatedField<::google::protobuf::int64> data);
+                           const std::string &name,
+                           const ::google::protobuf::RepeatedField<::google::protobuf::int64> &data);
 
   static void AddAttrProto(ge::onnx::NodeProto *node_proto, ge::onnx::AttributeProto_AttributeType type,
-                           const std::string &name, ::google::protobuf::RepeatedField<bool> data);
+                           const std::string &name, const ::google::protobuf::RepeatedField<bool> &data);
 
   static void AddAttrProto(ge::onnx::NodeProto *node_proto, ge::onnx::AttributeProto_AttributeType type,
-                           const std::string &name, ::google::protobuf::RepeatedField<float> data);
+                           const std::string &name, const ::google::protobuf::RepeatedField<float> &data);
 
   static void AddAttrProto(ge::onnx::NodeProto *node_proto, ge::onnx::AttributeProto_AttributeType type,
-                           const std::string &name, ::google::protobuf::RepeatedPtrField<::std::string> data);
+                           const std::string &name, const ::google::protobuf::RepeatedPtrField<::std::string> &data);
 
   static void AddAttrProtoFromNodeMembers(const NodePtr &node, ge::onnx::NodeProto *node_proto);
 
@@ -154,6 +167,7 @@ class OnnxUtils {
   static void EncodeValueInfo(const NodePtr &n, ge::onnx::ValueInfoProto *v);
 
   static bool EncodeGraph(const ConstComputeGraphPtr &graph, ge::onnx::GraphProto *graph_proto);
+  static void EncodeSubgraphs(const std::vector<std::pair<ComputeGraphPtr, ge::onnx::GraphProto *>> &subgraphs);
 
   /// Part 2: from ONNX Protobuf convert to IR
   /// Describes node's link relationships
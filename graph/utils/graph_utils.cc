@@ -28,10 +28,16 @@
 #include <iomanip>
 #include <queue>
 #include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <system_error>
+#include <thread>
 
 #include "./ge_context.h"
 #include "debug/ge_util.h"
 #include "framework/common/debug/ge_log.h"
+#include "common/blocking_queue.h"
+#include "graph/detail/model_serialize_imp.h"
 #include "proto/ge_ir.pb.h"
 #include "utils/attr_utils.h"
 #include "utils/ge_ir_utils.h"
@@ -69,8 +75,241 @@ const char *const kDumpStrSubgraphFunc = "sub_graph";
 const char *const kDumpStrAicpu = "Aicpu";
 const int32_t kNameMax = 255;
 const int32_t kMaxRecursionDepth = 10;
+
+struct DumpGraphPolicy {
+  bool dump_ge_graph_set = false;
+  int64_t dump_ge_graph_level = OnnxUtils::NO_DUMP;
+  int64_t dump_graph_level = kDumpLevel2;
+  std::string dump_graph_path;
+};
+
+// The dump switches come from the environment, which is read once per process
+const DumpGraphPolicy &GetDumpGraphPolicy() {
+  static const DumpGraphPolicy policy = []() {
+    DumpGraphPolicy dump_policy;
+    char env_value[MMPA_MAX_PATH] = { 0x00 };
+#ifdef FMK_SUPPORT_DUMP
+    if (mmGetEnv(kDumpGeGraph, env_value, MMPA_MAX_PATH) == EN_OK) {
+      dump_policy.dump_ge_graph_set = true;
+      dump_policy.dump_ge_graph_level = std::strtol(env_value, nullptr, kBaseOfIntegerValue);
+    }
+#endif
+    if (mmGetEnv(kDumpGraphLevel, env_value, MMPA_MAX_PATH) == EN_OK) {
+      dump_policy.dump_graph_level = std::strtol(env_value, nullptr, kBaseOfIntegerValue);
+    }
+    const char *dump_graph_path = std::getenv(kDumpGraphPath);
+    if ((dump_graph_path != nullptr) && (dump_graph_path[0] != '\0')) {
+      dump_policy.dump_graph_path = std::string(dump_graph_path) + "/";
+    }
+    return dump_policy;
+  }();
+  return policy;
+}
+
+#ifdef FMK_SUPPORT_DUMP
+const uint32_t kMaxPendingDumpNum = 4U;
+
+bool IsOverMaxDumpFileNum(long file_index) {
+  int64_t max_dump_file_num = 0;
+  // Can not check return value, 0 means no limit
+  (void)GetContext().GetOption(IntOption::kMaxDumpFileNum, max_dump_file_num);
+  if (max_dump_file_num != 0 && file_index > max_dump_file_num) {
+    GELOGW("dump graph file cnt > maxDumpFileNum, maxDumpFileNum=%ld.", static_cast<long>(max_dump_file_num));
+    return true;
+  }
+  return false;
+}
+
+long GetMaxDumpFileSize() {
+  int64_t max_dump_file_size = 0;
+  // Can not check return value
+  (void)GetContext().GetOption(IntOption::kMaxDumpFileSize, max_dump_file_size);
+  return static_cast<long>(max_dump_file_size);
+}
+
+// Fails the printer once max_size bytes are out, so an oversized dump stops early instead of being measured after
+class SizeLimitedOutputStream : public google::protobuf::io::ZeroCopyOutputStream {
+ public:
+  SizeLimitedOutputStream(google::protobuf::io::ZeroCopyOutputStream &output, long max_size)
+      : output_(output), max_size_(max_size) {}
+  ~SizeLimitedOutputStream() override = default;
+
+  bool Next(void **data, int *size) override {
+    if ((max_size_ != 0) && (output_.ByteCount() >= max_size_)) {
+      is_over_size_ = true;
+      return false;
+    }
+    if (!output_.Next(data, size)) {
+      return false;
+    }
+    if ((max_size_ != 0) && (output_.ByteCount() > max_size_)) {
+      int over_size = static_cast<int>(output_.ByteCount() - max_size_);
+      output_.BackUp(over_size);
+      *size -= over_size;
+    }
+    return true;
+  }
+  void BackUp(int count) override { output_.BackUp(count); }
+  google::protobuf::int64 ByteCount() const override { return output_.ByteCount(); }
+  bool IsOverSize() const { return is_over_size_; }
+
+ private:
+  google::protobuf::io::ZeroCopyOutputStream &output_;
+  long max_size_;
+  bool is_over_size_ = false;
+};
+
+void WriteProtoToTextFileWithLimit(const google::protobuf::Message &proto, const char *real_path, long max_size) {
+  const int FILE_AUTHORITY = 0600;
+  int fd = mmOpen2(real_path, M_WRONLY | M_CREAT | O_TRUNC, FILE_AUTHORITY);
+  if (fd < 0) {
+    GELOGE(GRAPH_FAILED, "fail to open the file: %s, %s", real_path, strerror(errno));
+    return;
+  }
+  bool ret = false;
+  bool is_over_size = false;
+  {
+    FileOutputStream output(fd);
+    SizeLimitedOutputStream limited_output(output, max_size);
+    ret = google::protobuf::TextFormat::Print(proto, &limited_output);
+    is_over_size = limited_output.IsOverSize();
+    ret = output.Flush() && ret;
+  }
+  GE_CHK_BOOL_EXEC(mmClose(fd) == 0, return, "Close fileoutputstream failed");
+  if (is_over_size) {
+    GELOGW("dump graph file size > maxDumpFileSize, maxDumpFileSize=%ld.", max_size);
+    GE_IF_BOOL_EXEC(remove(real_path) != 0, GELOGW("remove %s failed", real_path));
+    return;
+  }
+  if (!ret) {
+    GELOGE(GRAPH_FAILED, "Fail to write the file: %s", real_path);
+  }
+}
+
+// Prints and writes dump files on a background thread, so the compiling thread only pays for the proto snapshot.
+// The queue is bounded because every pending dump holds a whole graph proto.
+class GraphDumpWorker {
+ public:
+  static GraphDumpWorker &Instance() {
+    static GraphDumpWorker worker;
+    return worker;
+  }
+
+  void Commit(const std::shared_ptr<google::protobuf::Message> &proto, const std::string &real_path, long max_size) {
+    DumpTask task{proto, real_path, max_size};
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++pending_num_;
+    }
+    if (!is_started_ || !queue_.Push(task)) {
+      Write(task);
+    }
+  }
+
+  void WaitAll() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cond_.wait(lock, [this]() { return pending_num_ == 0U; });
+  }
+
+ private:
+  struct DumpTask {
+    std::shared_ptr<google::protobuf::Message> proto;
+    std::string real_path;
+    long max_size;
+  };
+
+  GraphDumpWorker() : queue_(kMaxPendingDumpNum) {
+    try {
+      thread_ = std::thread(&GraphDumpWorker::Run, this);
+      is_started_ = true;
+    } catch (const std::system_error &e) {
+      GELOGW("Start graph dump thread failed, dump on the calling thread instead.");
+    }
+  }
+
+  ~GraphDumpWorker() {
+    if (is_started_) {
+      WaitAll();
+      queue_.Stop();
+      thread_.join();
+    }
+  }
+
+  void Run() {
+    DumpTask task;
+    while (queue_.Pop(task)) {
+      Write(task);
+      task.proto.reset();
+    }
+  }
+
+  void Write(const DumpTask &task) {
+    WriteProtoToTextFileWithLimit(*task.proto, task.real_path.c_str(), task.max_size);
+    std::lock_guard<std::mutex> lock(mutex_);
+    --pending_num_;
+    done_cond_.notify_all();
+  }
+
+  BlockingQueue<DumpTask> queue_;
+  std::thread thread_;
+  bool is_started_ = false;
+  std::mutex mutex_;
+  std::condition_variable done_cond_;
+  size_t pending_num_ = 0U;
 };
 
+// Resolves the dump file path the way the callers did before writing, an empty result means do not write
+std::string GetDumpRealPath(const std::string &proto_file) {
+  if (proto_file.length() >= kNameMax) {
+    GELOGE(GRAPH_FAILED, "File name is too longer!");
+    return "";
+  }
+  char real_path[MMPA_MAX_PATH] = {0x00};
+  /// Returning nullptr means 3 case as follows:
+  /// a.path is MMPA_MAX_PATH chars or more
+  /// b.the file does not exist
+  /// c.the path has no permissions
+  /// Distinguish between last the two cases when the file is opened for writing
+  if (mmRealPath(proto_file.c_str(), real_path, MMPA_MAX_PATH) != EN_OK) {
+    // For case a
+    int err_num = errno;
+    // linux: ENAMETOOLONG windows: ERANGE
+    if (err_num == ENAMETOOLONG || err_num == ERANGE) {
+      GELOGE(GRAPH_FAILED, "Call realpath failed: path is MMPA_MAX_PATH chars or more.");
+      return "";
+    }
+    GELOGI("file %s does not exist, it will be created.", proto_file.c_str());
+  }
+  return real_path;
+}
+
+std::shared_ptr<proto::ModelDef> SnapshotGeGraph(const ComputeGraphPtr &graph, bool is_dump) {
+  ge::Model model("", "");
+  model.SetGraph(GraphUtils::CreateGraphFromComputeGraph(std::const_pointer_cast<ComputeGraph>(graph)));
+  auto ge_proto = ComGraphMakeShared<proto::ModelDef>();
+  GE_CHK_BOOL_EXEC(ge_proto != nullptr, return nullptr, "Make ModelDef failed.");
+  // straight into the ModelDef, without a round trip through the binary encoding
+  ModelSerializeImp serialize_imp;
+  if (!serialize_imp.SerializeModel(model, ge_proto.get(), is_dump) || (ge_proto->graph_size() == 0)) {
+    GELOGE(GRAPH_FAILED, "Serialize graph for dump failed.");
+    return nullptr;
+  }
+  return ge_proto;
+}
+
+std::shared_ptr<onnx::ModelProto> SnapshotOnnxGraph(const ComputeGraph &compute_graph) {
+  ge::Model model("GE", "");
+  std::shared_ptr<ge::ComputeGraph> compute_graph_ptr = ComGraphMakeShared<ge::ComputeGraph>(compute_graph);
+  model.SetGraph(GraphUtils::CreateGraphFromComputeGraph(std::const_pointer_cast<ComputeGraph>(compute_graph_ptr)));
+  auto model_proto = OnnxUtils::ConvertGeModelToModelProto(model);
+  if (model_proto == nullptr) {
+    GELOGE(GRAPH_FAILED, "DumpGEGraphToOnnx failed.");
+  }
+  return model_proto;
+}
+#endif
+}  // namespace
+
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY graphStatus GraphUtils::AddEdge(const OutDataAnchorPtr &src,
                                                                                const InDataAnchorPtr &dst) {
   if ((src != nullptr) && (src->LinkTo(dst) == GRAPH_SUCCESS)) {
@@ -539,9 +778,7 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY void GraphUtils::RecordOriginalNa
 }
 
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY bool GraphUtils::MatchDumpStr(const std::string &suffix) {
-  char dump_level[MMPA_MAX_PATH ] = { 0x00 };
-  INT32 res = mmGetEnv(kDumpGraphLevel, dump_level, MMPA_MAX_PATH);
-  int64_t dump_graph_level = (res == EN_OK) ? std::strtol(dump_level, nullptr, kBaseOfIntegerValue) : kDumpLevel2;
+  int64_t dump_graph_level = GetDumpGraphPolicy().dump_graph_level;
 
   if (dump_graph_level == kDumpLevel1) {
     return false;
@@ -566,9 +803,8 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY void GraphUtils::DumpGEGraph(cons
                                                                             bool is_always_dump,
                                                                             const std::string &user_graph_name) {
 #ifdef FMK_SUPPORT_DUMP
-  char dump_ge_graph[MMPA_MAX_PATH] = { 0x00 };
-  INT32 res = mmGetEnv(kDumpGeGraph, dump_ge_graph, MMPA_MAX_PATH);
-  GE_IF_BOOL_EXEC(res != EN_OK && !is_always_dump, return;);
+  const auto &policy = GetDumpGraphPolicy();
+  GE_IF_BOOL_EXEC(!policy.dump_ge_graph_set && !is_always_dump, return;);
 
   // dump the graph according to different graph level
   if (GraphUtils::MatchDumpStr(suffix) && (!is_always_dump)) {
@@ -579,50 +815,30 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY void GraphUtils::DumpGEGraph(cons
   static std::atomic_long atomic_file_index(0);
   auto file_index = atomic_file_index.fetch_add(1);
   GELOGD("Start to dump om txt: %ld", file_index);
-
-  thread_local long max_dump_file_num = 0;
-  if (max_dump_file_num == 0) {
-    string opt = "0";
-    (void)GetContext().GetOption(OPTION_GE_MAX_DUMP_FILE_NUM, opt);
-    max_dump_file_num = std::strtol(opt.c_str(), nullptr, kBaseOfIntegerValue);
-  }
-  if (max_dump_file_num != 0 && file_index > max_dump_file_num) {
-    GELOGW("dump graph file cnt > maxDumpFileNum, maxDumpFileCnt=%ld.", max_dump_file_num);
+  if (IsOverMaxDumpFileNum(file_index)) {
     return;
   }
 
   std::stringstream stream_file_name;
-  char *dump_graph_path = std::getenv(kDumpGraphPath);
-  if (dump_graph_path != nullptr) {
-    std::string dump_graph_path_str(dump_graph_path);
-    stream_file_name << (dump_graph_path_str.empty() ? "" : dump_graph_path_str + "/");
-  }
+  stream_file_name << policy.dump_graph_path;
   stream_file_name << "ge_proto_" << std::setw(kDumpGraphIndexWidth) << std::setfill('0') << file_index;
   stream_file_name << "_" << suffix << ".txt";
   std::string proto_file = user_graph_name.empty() ? stream_file_name.str() : user_graph_name;
+  GE_CHK_BOOL_TRUE_EXEC_WITH_LOG(strlen(proto_file.c_str()) >= MMPA_MAX_PATH, return, "file path is too longer!");
 
-  // Create buffer
-  ge::Model model("", "");
-  model.SetGraph(GraphUtils::CreateGraphFromComputeGraph(std::const_pointer_cast<ComputeGraph>(graph)));
-  Buffer buffer;
-  const int64_t kDumpLevel =
-      (dump_ge_graph != nullptr) ? std::strtol(dump_ge_graph, nullptr, kBaseOfIntegerValue) : ge::OnnxUtils::NO_DUMP;
-  model.Save(buffer, kDumpLevel != ge::OnnxUtils::DUMP_ALL && !is_always_dump);
-
-  // Write file
-  ge::proto::ModelDef ge_proto;
-  if (buffer.GetData() != nullptr) {
-    std::string str(reinterpret_cast<const char *>(buffer.GetData()), buffer.GetSize());
-    if (!ge_proto.ParseFromString(str)) {
-      GELOGE(GRAPH_FAILED, "parse from string failed.");
-      return;
-    }
-    char real_path[MMPA_MAX_PATH] = {0x00};
-    GE_CHK_BOOL_TRUE_EXEC_WITH_LOG(strlen(proto_file.c_str()) >= MMPA_MAX_PATH, return, "file path is too longer!");
-    GE_IF_BOOL_EXEC(mmRealPath(proto_file.c_str(), real_path, MMPA_MAX_PATH) != EN_OK,
-                    GELOGI("file %s does not exist, it will be created.", proto_file.c_str()));
-
-    GraphUtils::WriteProtoToTextFile(ge_proto, real_path);
+  auto ge_proto =
+      SnapshotGeGraph(graph, policy.dump_ge_graph_level != ge::OnnxUtils::DUMP_ALL && !is_always_dump);
+  if (ge_proto == nullptr) {
+    return;
+  }
+  char real_path[MMPA_MAX_PATH] = {0x00};
+  GE_IF_BOOL_EXEC(mmRealPath(proto_file.c_str(), real_path, MMPA_MAX_PATH) != EN_OK,
+                  GELOGI("file %s does not exist, it will be created.", proto_file.c_str()));
+  // a dump asked for explicitly is read right after, the debug dumps only need to be on disk eventually
+  if (is_always_dump) {
+    WriteProtoToTextFileWithLimit(*ge_proto, real_path, GetMaxDumpFileSize());
+  } else {
+    GraphDumpWorker::Instance().Commit(ge_proto, real_path, GetMaxDumpFileSize());
   }
 #else
   GELOGW("need to define FMK_SUPPORT_DUMP for dump graph.");
@@ -632,19 +848,12 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY void GraphUtils::DumpGEGraph(cons
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY void GraphUtils::DumpGEGrph(const ge::ComputeGraphPtr &graph,
                                                                            const std::string &path,
                                                                            const std::string &suffix) {
+#ifdef FMK_SUPPORT_DUMP
   // file name
   static std::atomic_long atomic_file_index(0);
   auto file_index = atomic_file_index.fetch_add(1);
   GELOGD("Start to dump om txt: %ld", file_index);
-
-  thread_local long max_dump_file_num = 0;
-  if (max_dump_file_num == 0) {
-    string opt = "0";
-    (void)GetContext().GetOption(OPTION_GE_MAX_DUMP_FILE_NUM, opt);
-    max_dump_file_num = std::strtol(opt.c_str(), nullptr, kBaseOfIntegerValue);
-  }
-  if (max_dump_file_num != 0 && file_index > max_dump_file_num) {
-    GELOGW("Dump graph file cnt > maxDumpFileNum, maxDumpFileCnt=%ld.", max_dump_file_num);
+  if (IsOverMaxDumpFileNum(file_index)) {
     return;
   }
 
@@ -653,29 +862,25 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY void GraphUtils::DumpGEGrph(const
                    << file_index;
   stream_file_name << "_" << suffix << ".txt";
   std::string proto_file = stream_file_name.str();
+  GE_CHK_BOOL_TRUE_EXEC_WITH_LOG(strlen(proto_file.c_str()) >= MMPA_MAX_PATH, return, "file path is too longer!");
 
-  // Create buffer
-  ge::Model model("", "");
-  model.SetGraph(GraphUtils::CreateGraphFromComputeGraph(std::const_pointer_cast<ComputeGraph>(graph)));
-  Buffer buffer;
-  const int64_t kDumpLevel = ge::OnnxUtils::NO_DUMP;
-  model.Save(buffer, kDumpLevel != ge::OnnxUtils::DUMP_ALL);
-
-  // Write file
-  ge::proto::ModelDef ge_proto;
-  if (buffer.GetData() != nullptr) {
-    std::string str(reinterpret_cast<const char *>(buffer.GetData()), buffer.GetSize());
-    if (!ge_proto.ParseFromString(str)) {
-      GELOGE(GRAPH_FAILED, "parse from string failed.");
-      return;
-    }
-    char real_path[MMPA_MAX_PATH] = {0x00};
-    GE_CHK_BOOL_TRUE_EXEC_WITH_LOG(strlen(proto_file.c_str()) >= MMPA_MAX_PATH, return, "file path is too longer!");
-    GE_IF_BOOL_EXEC(mmRealPath(proto_file.c_str(), real_path, MMPA_MAX_PATH) != EN_OK,
-                    GELOGI("file %s does not exist, it will be created.", proto_file.c_str()));
-
-    GraphUtils::WriteProtoToTextFile(ge_proto, real_path);
+  auto ge_proto = SnapshotGeGraph(graph, true);
+  if (ge_proto == nullptr) {
+    return;
   }
+  char real_path[MMPA_MAX_PATH] = {0x00};
+  GE_IF_BOOL_EXEC(mmRealPath(proto_file.c_str(), real_path, MMPA_MAX_PATH) != EN_OK,
+                  GELOGI("file %s does not exist, it will be created.", proto_file.c_str()));
+  WriteProtoToTextFileWithLimit(*ge_proto, real_path, GetMaxDumpFileSize());
+#else
+  GELOGW("need to define FMK_SUPPORT_DUMP for dump graph.");
+#endif
+}
+
+GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY void GraphUtils::FlushGraphDump() {
+#ifdef FMK_SUPPORT_DUMP
+  GraphDumpWorker::Instance().WaitAll();
+#endif
 }
 
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY bool GraphUtils::LoadGEGraph(const char *file,
@@ -732,53 +937,7 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY bool GraphUtils::LoadGEGraph(cons
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY void GraphUtils::WriteProtoToTextFile(
     const google::protobuf::Message &proto, const char *real_path) {
 #ifdef FMK_SUPPORT_DUMP
-  const int FILE_AUTHORITY = 0600;
-  int fd = mmOpen2(real_path, M_WRONLY | M_CREAT | O_TRUNC, FILE_AUTHORITY);
-  if (fd < 0) {
-    GELOGE(GRAPH_FAILED, "fail to open the file: %s, %s", real_path, strerror(errno));
-    return;
-  }
-  google::protobuf::io::FileOutputStream *output = new (std::nothrow) FileOutputStream(fd);
-  if (output == nullptr) {
-    GELOGE(GRAPH_FAILED, "Output is nullptr");
-    if (mmClose(fd) != 0) {
-      GELOGE(GRAPH_FAILED, "Close fileoutputstream failed");
-    }
-    return;
-  }
-  bool ret = google::protobuf::TextFormat::Print(proto, output);
-  if (!ret) {
-    GELOGE(GRAPH_FAILED, "Fail to write the file: %s", real_path);
-    delete output;
-    output = nullptr;
-    GE_CHK_BOOL_EXEC(mmClose(fd) == 0, return, "Close fileoutputstream failed");
-    return;
-  }
-  delete output;
-  output = nullptr;
-  GE_CHK_BOOL_EXEC(mmClose(fd) == 0, return, "Close fileoutputstream failed");
-
-  FILE *file = fopen(real_path, "rb");
-  if (file == nullptr) {
-    return;
-  }
-  if (fseek(file, 0L, SEEK_END) == 0) {
-    long fileSize = ftell(file);
-    thread_local long max_dump_file_size = 0;
-    if (max_dump_file_size == 0) {
-      string opt = "0";
-      // Can not check return value
-      (void)GetContext().GetOption(OPTION_GE_MAX_DUMP_FILE_SIZE, opt);
-      max_dump_file_size = std::strtol(opt.c_str(), nullptr, kBaseOfIntegerValue);
-    }
-    if (max_dump_file_size != 0 && fileSize != -1 && fileSize > max_dump_file_size) {
-      GELOGW("dump graph file size > maxDumpFileSize, maxDumpFileSize=%ld.", max_dump_file_size);
-      GE_IF_BOOL_EXEC(remove(real_path) != 0, GELOGW("remove %s failed", real_path));
-      GE_CHK_BOOL_EXEC(fclose(file) == 0, return, "Fclose %s failed", real_path);
-      return;
-    }
-  }
-  GE_CHK_BOOL_EXEC(fclose(file) == 0, return, "Fclose fileoutputstream failed");
+  WriteProtoToTextFileWithLimit(proto, real_path, GetMaxDumpFileSize());
 #else
   GELOGW("Need to define FMK_SUPPORT_DUMP for dump graph.");
 #endif
@@ -807,10 +966,8 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY bool GraphUtils::ReadProtoFromTex
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY void GraphUtils::DumpGEGraphToOnnx(const ge::ComputeGraph &compute_graph,
                                                                                   const std::string &suffix) {
 #ifdef FMK_SUPPORT_DUMP
-  char dump_ge_graph[MMPA_MAX_PATH] = { 0x00 };
-  INT32 res = mmGetEnv(kDumpGeGraph, dump_ge_graph, MMPA_MAX_PATH);
-  int64_t dump_ge_graph_level =
-      (res == EN_OK) ? std::strtol(dump_ge_graph, nullptr, kBaseOfIntegerValue) : OnnxUtils::NO_DUMP;
+  const auto &policy = GetDumpGraphPolicy();
+  int64_t dump_ge_graph_level = policy.dump_ge_graph_level;
   if ((dump_ge_graph_level == OnnxUtils::NO_DUMP) || (dump_ge_graph_level >= OnnxUtils::DUMP_LEVEL_END)) {
     GELOGD("Skip DumpGEGraphToOnnx with dump_ge_graph_level %ld.", dump_ge_graph_level);
     return;
@@ -822,12 +979,8 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY void GraphUtils::DumpGEGraphToOnn
   }
 
   // 1.Get ge::onnx::ModelProto from ge::Model
-  ge::Model model("GE", "");
-  std::shared_ptr<ge::ComputeGraph> compute_graph_ptr = ComGraphMakeShared<ge::ComputeGraph>(compute_graph);
-  model.SetGraph(GraphUtils::CreateGraphFromComputeGraph(std::const_pointer_cast<ComputeGraph>(compute_graph_ptr)));
-  onnx::ModelProto model_proto;
-  if (!OnnxUtils::ConvertGeModelToModelProto(model, model_proto)) {
-    GELOGE(GRAPH_FAILED, "DumpGEGraphToOnnx failed.");
+  auto model_proto = SnapshotOnnxGraph(compute_graph);
+  if (model_proto == nullptr) {
     return;
   }
 
@@ -835,54 +988,22 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY void GraphUtils::DumpGEGraphToOnn
   static std::atomic_long atomic_file_index(0);
   auto file_index = atomic_file_index.fetch_add(1);
   GELOGD("Start to dump ge onnx file: %ld", file_index);
-
-  thread_local long max_dump_file_num = 0;
-  if (max_dump_file_num == 0) {
-    string opt = "0";
-    (void)GetContext().GetOption(OPTION_GE_MAX_DUMP_FILE_NUM, opt);
-    max_dump_file_num = std::strtol(opt.c_str(), nullptr, kBaseOfIntegerValue);
-  }
-  if (max_dump_file_num != 0 && file_index > max_dump_file_num) {
-    GELOGW("dump graph file cnt > maxDumpFileNum, maxDumpFileNum=%ld.", max_dump_file_num);
+  if (IsOverMaxDumpFileNum(file_index)) {
     return;
   }
 
   std::stringstream stream_file_name;
-  char *dump_graph_path = std::getenv(kDumpGraphPath);
-  if (dump_graph_path != nullptr) {
-    std::string dump_graph_path_str(dump_graph_path);
-    stream_file_name << (dump_graph_path_str.empty() ? "" : dump_graph_path_str + "/");
-  }
+  stream_file_name << policy.dump_graph_path;
   stream_file_name << "ge_onnx_" << std::setw(kDumpGraphIndexWidth) << std::setfill('0') << file_index;
   stream_file_name << "_graph_" << compute_graph.GetGraphID();
   stream_file_name << "_" << suffix << ".pbtxt";
-  std::string proto_file = stream_file_name.str();
-  if ((proto_file.length()) >= kNameMax) {
-    GELOGE(GRAPH_FAILED, "File name is too longer!");
-    return;
-  }
-  std::unique_ptr<char[]> real_path(new (std::nothrow) char[MMPA_MAX_PATH]{0});
-  if (real_path == nullptr) {
-    GELOGE(GRAPH_FAILED, "New real_path failed.");
+  std::string real_path = GetDumpRealPath(stream_file_name.str());
+  if (real_path.empty()) {
     return;
   }
-  /// Returning nullptr means 3 case as follows:
-  /// a.path is MMPA_MAX_PATH chars or more
-  /// b.the file does not exist
-  /// c.the path has no permissions
-  /// Distinguish between last the two cases in the function WriteProtoToTextFile call open()
-  if (mmRealPath(proto_file.c_str(), real_path.get(), MMPA_MAX_PATH) != EN_OK) {
-    // For case a
-    int err_num = errno;
-    // linux: ENAMETOOLONG windows: ERANGE
-    if (err_num == ENAMETOOLONG || err_num == ERANGE) {
-      GELOGE(GRAPH_FAILED, "Call realpath failed: path is MMPA_MAX_PATH chars or more.");
-      return;
-    }
-  }
 
   // 3. Serialize to file in current path
-  GraphUtils::WriteProtoToTextFile(model_proto, real_path.get());
+  GraphDumpWorker::Instance().Commit(model_proto, real_path, GetMaxDumpFileSize());
 #else
   GELOGW("need to define FMK_SUPPORT_DUMP for dump graph.");
 #endif
@@ -891,13 +1012,10 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY void GraphUtils::DumpGEGraphToOnn
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY void GraphUtils::DumpGrphToOnnx(const ge::ComputeGraph &compute_graph,
                                                                                const std::string &path,
                                                                                const std::string &suffix) {
+#ifdef FMK_SUPPORT_DUMP
   // 1.Get ge::onnx::ModelProto from ge::Model
-  ge::Model model("GE", "");
-  std::shared_ptr<ge::ComputeGraph> compute_graph_ptr = ComGraphMakeShared<ge::ComputeGraph>(compute_graph);
-  model.SetGraph(GraphUtils::CreateGraphFromComputeGraph(std::const_pointer_cast<ComputeGraph>(compute_graph_ptr)));
-  onnx::ModelProto model_proto;
-  if (!OnnxUtils::ConvertGeModelToModelProto(model, model_proto)) {
-    GELOGE(GRAPH_FAILED, "DumpGEGraphToOnnx failed.");
+  auto model_proto = SnapshotOnnxGraph(compute_graph);
+  if (model_proto == nullptr) {
     return;
   }
 
@@ -905,15 +1023,7 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY void GraphUtils::DumpGrphToOnnx(c
   static std::atomic_long atomic_file_index(0);
   auto file_index = atomic_file_index.fetch_add(1);
   GELOGD("Start to dump ge onnx file: %ld", file_index);
-
-  thread_local long max_dump_file_num = 0;
-  if (max_dump_file_num == 0) {
-    string opt = "0";
-    (void)GetContext().GetOption(OPTION_GE_MAX_DUMP_FILE_NUM, opt);
-    max_dump_file_num = std::strtol(opt.c_str(), nullptr, kBaseOfIntegerValue);
-  }
-  if (max_dump_file_num != 0 && file_index > max_dump_file_num) {
-    GELOGW("Dump graph file cnt > maxDumpFileNum, maxDumpFileNum=%ld.", max_dump_file_num);
+  if (IsOverMaxDumpFileNum(file_index)) {
     return;
   }
 
@@ -921,31 +1031,16 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY void GraphUtils::DumpGrphToOnnx(c
   stream_file_name << path.c_str() << "/ge_onnx_" << std::setw(5) << std::setfill('0') << file_index;
   stream_file_name << "_graph_" << compute_graph.GetGraphID();
   stream_file_name << "_" << suffix << ".pbtxt";
-  std::string proto_file = stream_file_name.str();
-  if ((proto_file.length()) >= kNameMax) {
-    GELOGE(GRAPH_FAILED, "File name is too longer!");
+  std::string real_path = GetDumpRealPath(stream_file_name.str());
+  if (real_path.empty()) {
     return;
   }
-  std::unique_ptr<char[]> real_path(new (std::nothrow) char[MMPA_MAX_PATH]{0});
-  if (real_path == nullptr) {
-    GELOGE(GRAPH_FAILED, "New real_path failed.");
-    return;
-  }
-  /// Returning nullptr means 3 case as follows:
-  /// a.path is PATH_MAX chars or more
-  /// b.the file does not exist
-  /// c.the path has no permissions
-  /// Distinguish between last the two cases in the function WriteProtoToTextFile call open()
-  if (mmRealPath(proto_file.c_str(), real_path.get(), MMPA_MAX_PATH) != EN_OK) {
-    // For case a
-    if (errno == ENAMETOOLONG) {
-      GELOGE(GRAPH_FAILED, "Call realpath failed: path is PATH_MAX chars or more.");
-      return;
-    }
-  }
 
   // 3. Serialize to file in current path
-  GraphUtils::WriteProtoToTextFile(model_proto, real_path.get());
+  WriteProtoToTextFileWithLimit(*model_proto, real_path.c_str(), GetMaxDumpFileSize());
+#else
+  GELOGW("need to define FMK_SUPPORT_DUMP for dump graph.");
+#endif
 }
 
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY bool GraphUtils::LoadGEGraphFromOnnx(const char *file,
@@ -154,6 +154,7 @@ graphStatus NodeUtils::ClearInDataAnchor(const NodePtr &node_ptr, const InDataAn
       auto iter = node_ptr->in_data_anchors_.begin() + index;
       if (iter != node_ptr->in_data_anchors_.end()) {
         it = node_ptr->in_data_anchors_.erase(iter);
+        node_ptr->IncreaseAnchorsVersion();
       }
       break;
     }
@@ -178,6 +179,7 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY graphStatus NodeUtils::SetAllAnch
 
 graphStatus NodeUtils::SetAllAnchorStatus(Node &node) {
   node.anchor_status_updated_ = true;
+  node.IncreaseAnchorsVersion();
   return GRAPH_SUCCESS;
 }
 
@@ -393,6 +395,7 @@ graphStatus NodeUtils::AppendInputAnchor(const NodePtr &node, uint32_t num) {
     }
     node->in_data_anchors_.push_back(anchor);
   }
+  node->IncreaseAnchorsVersion();
 
   return GRAPH_SUCCESS;
 }
@@ -420,6 +423,7 @@ graphStatus NodeUtils::RemoveInputAnchor(const NodePtr &node, uint32_t num) {
   while (node->in_data_anchors_.size() > num) {
     node->in_data_anchors_.pop_back();
   }
+  node->IncreaseAnchorsVersion();
 
   return GRAPH_SUCCESS;
 }
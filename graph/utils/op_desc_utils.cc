@@ -16,6 +16,7 @@
 
 #include "utils/op_desc_utils.h"
 #include <algorithm>
+#include <atomic>
 #include "debug/ge_attr_define.h"
 #include "debug/ge_op_types.h"
 #include "debug/ge_util.h"
@@ -250,26 +251,97 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY vector<ConstGeTensorPtr> OpDescUt
 
   return ret;
 }
-size_t OpDescUtils::GetNonConstInputsSize(const ge::Node &node) {
-  if (NodeUtils::IsAnchorStatusSet(node)) {
-    size_t input_num = 0;
-    for (const auto &anchor : node.GetAllInDataAnchors()) {
-      if (ge::AnchorUtils::GetStatus(anchor) == ANCHOR_DATA) {
-        input_num++;
-        continue;
+// What the const/non-const queries below need to know about the inputs of one node. Peers are held weakly and the
+// parent of a subgraph Data is looked up on use, so the info never keeps other nodes alive. It depends on the links
+// and on the types of the node and its peers, OpDesc::SetType moves the anchors version of the nodes concerned.
+class NodeInputsInfo {
+ public:
+  enum ConstPeerKind { kConstPeer, kSwitchPeer, kDataPeer };
+  struct ConstPeer {
+    std::weak_ptr<Node> node;
+    ConstPeerKind kind;
+  };
+
+  uint64_t anchors_version = 0;
+  bool anchor_status_set = false;
+  size_t in_data_nodes_size = 0;
+  // anchor index of each non-const input, in input order
+  std::vector<size_t> non_const_indexes;
+  std::vector<bool> is_non_const;
+  // peers that are, or may lead to, const inputs, in input order
+  std::vector<ConstPeer> const_peers;
+};
+
+std::shared_ptr<const NodeInputsInfo> OpDescUtils::BuildInputsInfo(const ge::Node &node, uint64_t anchors_version) {
+  auto info = ComGraphMakeShared<NodeInputsInfo>();
+  GE_CHK_BOOL_EXEC(info != nullptr, return nullptr, "make inputs info for %s failed", node.GetName().c_str());
+  info->anchors_version = anchors_version;
+  info->anchor_status_set = NodeUtils::IsAnchorStatusSet(node);
+  const auto &in_anchors = node.GetAllInDataAnchors();
+  info->is_non_const.resize(in_anchors.size(), false);
+  bool is_matmul = (node.GetType() == MATMUL);
+  for (const auto &anchor : in_anchors) {
+    GE_CHK_BOOL_EXEC(anchor != nullptr, continue, "in_data_anchor is nullptr");
+    auto idx = static_cast<size_t>(anchor->GetIdx());
+    auto peer_anchor = anchor->GetPeerOutAnchor();
+    auto owner_node = (peer_anchor == nullptr) ? nullptr : peer_anchor->GetOwnerNode();
+    bool is_non_const = false;
+    if (info->anchor_status_set) {
+      is_non_const = (AnchorUtils::GetStatus(anchor) == ANCHOR_DATA);
+    } else {
+      is_non_const = (owner_node != nullptr) && (owner_node->GetType() != CONSTANT);
+    }
+    if (is_non_const) {
+      info->non_const_indexes.push_back(idx);
+      if (idx < info->is_non_const.size()) {
+        info->is_non_const[idx] = true;
       }
     }
-    return input_num;  // lint !e712
-  } else {
-    GE_IF_BOOL_EXEC(
-        node.GetInDataNodes().size() < GetConstInputs(node).size(),
-        ErrorManager::GetInstance().ATCReportErrMessage("E19012", {"function", "reason"},
-            {"GetNonConstInputsSize", "InDataNodes size[" + std::to_string(node.GetInDataNodes().size()) +
-            "] is smaller than ConstInputs[" + std::to_string(GetConstInputs(node).size()) + "]"});
-        GELOGE(GRAPH_FAILED, "%zu is smaller than %zu", node.GetInDataNodes().size(), GetConstInputs(node).size());
-        return 0);
-    return node.GetInDataNodes().size() - GetConstInputs(node).size();
+    if (owner_node == nullptr) {
+      continue;
+    }
+    ++info->in_data_nodes_size;
+    const auto &type = owner_node->GetType();
+    if (type == CONSTANT) {
+      info->const_peers.push_back({owner_node, NodeInputsInfo::kConstPeer});
+    } else if ((type == SWITCH) && is_matmul) {
+      info->const_peers.push_back({owner_node, NodeInputsInfo::kSwitchPeer});
+    } else if (type == DATA) {
+      info->const_peers.push_back({owner_node, NodeInputsInfo::kDataPeer});
+    }
   }
+  return info;
+}
+
+std::shared_ptr<const NodeInputsInfo> OpDescUtils::GetInputsInfo(const ge::Node &node) {
+  // read before building, so a change made meanwhile drops the info on the next call
+  uint64_t anchors_version = node.GetAnchorsVersion();
+  auto info = std::atomic_load(&node.inputs_info_);
+  if ((info != nullptr) && (info->anchors_version == anchors_version)) {
+    return info;
+  }
+  info = BuildInputsInfo(node, anchors_version);
+  if (info != nullptr) {
+    std::atomic_store(&node.inputs_info_, info);
+  }
+  return info;
+}
+
+size_t OpDescUtils::GetNonConstInputsSize(const ge::Node &node) {
+  auto info = GetInputsInfo(node);
+  GE_CHK_BOOL_EXEC(info != nullptr, return 0, "get inputs info of %s failed", node.GetName().c_str());
+  if (info->anchor_status_set) {
+    return info->non_const_indexes.size();
+  }
+  size_t const_inputs_size = GetConstInputs(node).size();
+  GE_IF_BOOL_EXEC(
+      info->in_data_nodes_size < const_inputs_size,
+      ErrorManager::GetInstance().ATCReportErrMessage("E19012", {"function", "reason"},
+          {"GetNonConstInputsSize", "InDataNodes size[" + std::to_string(info->in_data_nodes_size) +
+          "] is smaller than ConstInputs[" + std::to_string(const_inputs_size) + "]"});
+      GELOGE(GRAPH_FAILED, "%zu is smaller than %zu", info->in_data_nodes_size, const_inputs_size);
+      return 0);
+  return info->in_data_nodes_size - const_inputs_size;
 }
 
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY size_t OpDescUtils::GetNonConstInputsSize(const ge::ConstNodePtr node) {
@@ -282,36 +354,11 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY size_t OpDescUtils::GetNonConstIn
 
 GeTensorDesc OpDescUtils::GetNonConstInputTensorDesc(const ge::Node &node, size_t index_non_const) {
   GE_CHK_BOOL_EXEC(node.GetOpDesc() != nullptr, return GeTensorDesc(), "node.GetOpDesc() is nullptr!");
-  size_t i = 0;
-  if (NodeUtils::IsAnchorStatusSet(node)) {
-    for (const auto &anchor : node.GetAllInDataAnchors()) {
-      if (ge::AnchorUtils::GetStatus(anchor) == ANCHOR_DATA) {
-        if (index_non_const == i) {
-          return node.GetOpDesc()->GetInputDesc(static_cast<uint32_t>(anchor->GetIdx()));
-        }
-        ++i;
-      }
-    }
-  } else {
-    for (const auto &anchor : node.GetAllInDataAnchors()) {
-      auto peer_anchor = anchor->GetPeerOutAnchor();
-      if (peer_anchor == nullptr) {
-        continue;
-      }
-      auto owner_node = peer_anchor->GetOwnerNode();
-      if (owner_node == nullptr) {
-        continue;
-      }
-      if (owner_node->GetType() == CONSTANT) {
-        continue;
-      }
-      if (index_non_const == i) {
-        return node.GetOpDesc()->GetInputDesc(anchor->GetIdx());
-      }
-      ++i;
-    }
+  size_t index = 0;
+  if (!GetNonConstInputIndex(node, index_non_const, index)) {
+    return GeTensorDesc();
   }
-  return GeTensorDesc();
+  return node.GetOpDesc()->GetInputDesc(static_cast<uint32_t>(index));
 }
 
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY GeTensorDesc
@@ -321,39 +368,12 @@ OpDescUtils::GetNonConstInputTensorDesc(const ge::ConstNodePtr &node, size_t ind
 }
 
 bool OpDescUtils::GetNonConstInputIndex(const ge::Node &node, const size_t index_non_const, size_t &index) {
-  bool ret = false;
-  size_t i = 0;
-  if (NodeUtils::IsAnchorStatusSet(node)) {
-    for (const auto &anchor : node.GetAllInDataAnchors()) {
-      if (ge::AnchorUtils::GetStatus(anchor) == ANCHOR_DATA) {
-        if (index_non_const == i) {
-          index = static_cast<size_t>(anchor->GetIdx());
-          ret = true;
-        }
-        ++i;
-      }
-    }
-  } else {
-    for (const auto &anchor : node.GetAllInDataAnchors()) {
-      auto peer_anchor = anchor->GetPeerOutAnchor();
-      if (peer_anchor == nullptr) {
-        continue;
-      }
-      auto owner_node = peer_anchor->GetOwnerNode();
-      if (owner_node == nullptr) {
-        continue;
-      }
-      if (owner_node->GetType() == CONSTANT) {
-        continue;
-      }
-      if (index_non_const == i) {
-        index = static_cast<size_t>(anchor->GetIdx());
-        ret = true;
-      }
-      ++i;
-    }
+  auto info = GetInputsInfo(node);
+  if ((info == nullptr) || (index_non_const >= info->non_const_indexes.size())) {
+    return false;
   }
-  return ret;
+  index = info->non_const_indexes[index_non_const];
+  return true;
 }
 
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY bool OpDescUtils::GetNonConstInputIndex(const ge::ConstNodePtr &node,
@@ -364,29 +384,8 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY bool OpDescUtils::GetNonConstInpu
 }
 
 bool OpDescUtils::IsNonConstInput(const ge::Node &node, const size_t index) {
-  bool ret = false;
-  if (index < node.GetAllInDataAnchors().size()) {
-    if (NodeUtils::IsAnchorStatusSet(node)) {
-      ret = (ge::AnchorUtils::GetStatus(node.GetInDataAnchor(static_cast<int>(index))) == ANCHOR_DATA);  // lint !e712
-    } else {
-      for (const auto &anchor : node.GetAllInDataAnchors()) {
-        if (anchor->GetIdx() != static_cast<int>(index)) {
-          continue;
-        }
-        auto peer_anchor = anchor->GetPeerOutAnchor();
-        if (peer_anchor == nullptr) {
-          break;
-        }
-        auto owner_node = peer_anchor->GetOwnerNode();
-        if (owner_node == nullptr) {
-          break;
-        }
-        ret = (owner_node->GetType() != CONSTANT);
-      }
-    }
-  }
-
-  return ret;
+  auto info = GetInputsInfo(node);
+  return (info != nullptr) && (index < info->is_non_const.size()) && info->is_non_const[index];
 }
 
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY bool OpDescUtils::IsNonConstInput(const ge::ConstNodePtr &node,
@@ -408,44 +407,38 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY vector<ge::GeTensorDesc> OpDescUt
   if (node == nullptr || node->GetOpDesc() == nullptr) {
     return vector<ge::GeTensorDesc>();
   }
+  auto info = GetInputsInfo(*node);
+  if (info == nullptr) {
+    return vector<ge::GeTensorDesc>();
+  }
   vector<ge::GeTensorDesc> ret;
-  if (NodeUtils::IsAnchorStatusSet(*node)) {
-    for (const auto &in_anchor : node->GetAllInDataAnchors()) {
-      if (ge::AnchorUtils::GetStatus(in_anchor) == ANCHOR_DATA) {
-        ret.push_back(node->GetOpDesc()->GetInputDesc(in_anchor->GetIdx()));
-      }
-    }
-  } else {
-    for (const auto &in_anchor : node->GetAllInDataAnchors()) {
-      auto out_anchor = in_anchor->GetPeerOutAnchor();
-      if (out_anchor == nullptr || out_anchor->GetOwnerNode()->GetOpDesc() == nullptr) {
-        continue;
-      }
-      if (out_anchor->GetOwnerNode()->GetOpDesc()->GetType() != CONSTANT) {
-        ret.push_back(node->GetOpDesc()->GetInputDesc(in_anchor->GetIdx()));
-      }
-    }
+  ret.reserve(info->non_const_indexes.size());
+  for (auto index : info->non_const_indexes) {
+    ret.push_back(node->GetOpDesc()->GetInputDesc(static_cast<uint32_t>(index)));
   }
   return ret;
 }
 
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY vector<ge::NodePtr> OpDescUtils::GetConstInputs(const ge::Node &node) {
   vector<ge::NodePtr> ret;
-  auto in_anchors = node.GetAllInDataAnchors();
-  for (const auto &in_anchor : in_anchors) {
-    auto out_anchor = in_anchor->GetPeerOutAnchor();
-    if (out_anchor == nullptr) continue;
-
-    auto in_node = out_anchor->GetOwnerNode();
-    if (in_node->GetType() == CONSTANT) {
+  auto info = GetInputsInfo(node);
+  if (info == nullptr) {
+    return ret;
+  }
+  for (const auto &const_peer : info->const_peers) {
+    auto in_node = const_peer.node.lock();
+    if (in_node == nullptr) {
+      continue;
+    }
+    if (const_peer.kind == NodeInputsInfo::kConstPeer) {
       ret.push_back(in_node);
-    } else if (in_node->GetType() == SWITCH && node.GetType() == MATMUL) {
+    } else if (const_peer.kind == NodeInputsInfo::kSwitchPeer) {
       // const --> switch --> matmul
       auto switch_input = GetConstInputs(*in_node);
       if (switch_input.size() > 0) {
         ret.insert(ret.end(), switch_input.begin(), switch_input.end());
       }
-    } else if (in_node->GetType() == DATA) {
+    } else {
       auto parent = NodeUtils::GetParentInput(in_node);
       if ((parent != nullptr) && (parent->GetType() == CONSTANT)) {
         ret.push_back(parent);
@@ -0,0 +1,81 @@
+/**
+ * Copyright 2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "graph/utils/thread_pool.h"
+#include <algorithm>
+#include "framework/common/debug/ge_log.h"
+
+namespace ge {
+namespace {
+const uint32_t kMaxThreadNum = 16U;
+}  // namespace
+
+ThreadPool::ThreadPool(uint32_t size) : is_stoped_(false) {
+  idle_thrd_num_ = size < 1U ? 1U : size;
+
+  for (uint32_t i = 0U; i < idle_thrd_num_; ++i) {
+    pool_.emplace_back(ThreadFunc, this);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  is_stoped_.store(true);
+  {
+    std::unique_lock<std::mutex> lock{m_lock_};
+    cond_var_.notify_all();
+  }
+
+  for (std::thread &thd : pool_) {
+    if (thd.joinable()) {
+      try {
+        thd.join();
+      } catch (const std::system_error &) {
+        GELOGW("system_error");
+      } catch (...) {
+        GELOGW("exception");
+      }
+    }
+  }
+}
+
+uint32_t ThreadPool::GetThreadNum(size_t num_tasks) {
+  uint32_t hardware_num = std::thread::hardware_concurrency();
+  uint32_t thread_num = std::min(std::max(hardware_num, 1U), kMaxThreadNum);
+  return static_cast<uint32_t>(std::min(static_cast<size_t>(thread_num), std::max(num_tasks, static_cast<size_t>(1))));
+}
+
+void ThreadPool::ThreadFunc(ThreadPool *thread_pool) {
+  if (thread_pool == nullptr) {
+    return;
+  }
+  while (!thread_pool->is_stoped_) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock{thread_pool->m_lock_};
+      thread_pool->cond_var_.wait(
+          lock, [thread_pool] { return thread_pool->is_stoped_.load() || !thread_pool->tasks_.empty(); });
+      if (thread_pool->is_stoped_ && thread_pool->tasks_.empty()) {
+        return;
+      }
+      task = std::move(thread_pool->tasks_.front());
+      thread_pool->tasks_.pop();
+    }
+    --thread_pool->idle_thrd_num_;
+    task();
+    ++thread_pool->idle_thrd_num_;
+  }
+}
+}  // namespace ge
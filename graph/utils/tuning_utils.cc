@@ -17,7 +17,8 @@
 #include "graph/tuning_utils.h"
 #include "../debug/ge_util.h"
 #include "../debug/ge_op_types.h"
-#include "graph/utils/scope_guard.h"
+#include "graph/ge_local_context.h"
+#include "graph/utils/thread_pool.h"
 
 namespace ge {
 namespace {
@@ -30,25 +31,48 @@ const std::string tuning_subgraph_prefix = "/aicore_subgraph_";
 const std::string non_tuning_subgraph_prefix = "/subgraph_";
 const std::set<std::string> kPartitionOpTypes = {PLACEHOLDER, END};
 const std::set<std::string> kExeTypes = {DATA, NETOUTPUT};
+
+// Runs func(0) ... func(num - 1) on a pool, the workers see the options of the calling thread
+graphStatus ParallelFor(size_t num, const std::function<graphStatus(size_t)> &func) {
+  uint32_t thread_num = ThreadPool::GetThreadNum(num);
+  if (thread_num <= 1U) {
+    for (size_t i = 0U; i < num; ++i) {
+      if (func(i) != GRAPH_SUCCESS) {
+        return GRAPH_FAILED;
+      }
+    }
+    return GRAPH_SUCCESS;
+  }
+  const GEThreadLocalContext &context = GetThreadLocalContext();
+  ThreadPool pool(thread_num);
+  std::vector<std::future<graphStatus>> futures;
+  futures.reserve(num);
+  for (size_t i = 0U; i < num; ++i) {
+    futures.emplace_back(pool.Commit([&func, &context, i]() -> graphStatus {
+      GetThreadLocalContext() = context;
+      return func(i);
+    }));
+  }
+  graphStatus ret = GRAPH_SUCCESS;
+  for (auto &future : futures) {
+    if (!future.valid() || (future.get() != GRAPH_SUCCESS)) {
+      ret = GRAPH_FAILED;
+    }
+  }
+  return ret;
+}
 }
-NodeNametoNodeNameMap TuningUtils::data_2_netoutput_;
-NodetoNodeNameMap TuningUtils::data_node_2_netoutput_ ;
-NodetoNodeMap TuningUtils::data_node_2_netoutput_node_;
-NodeVec TuningUtils::netoutput_nodes_;
-NodeVec TuningUtils::merged_graph_nodes_;
-SubgraphCreateOutNode TuningUtils::create_output_;
-std::mutex TuningUtils::mutex_;
-
-std::string TuningUtils::PrintCheckLog() {
+
+std::string TuningUtils::PrintCheckLog(const MergeContext &context) {
   std::stringstream ss;
   ss << "d2n:{";
-  for (const auto &pair : data_2_netoutput_) {
+  for (const auto &pair : context.data_2_netoutput) {
     ss << "data:" << pair.first << "-" << "netoutput:" << pair.second;
     ss << " | ";
   }
   ss << "}";
   ss << "netoutputs:{";
-  for (const auto &node : netoutput_nodes_) {
+  for (const auto &node : context.netoutput_nodes) {
     ss << "netoutput:" << node->GetName();
     ss << " | ";
   }
@@ -69,29 +93,50 @@ std::string TuningUtils::GetNodeNameByAnchor(const Anchor *anchor) {
 graphStatus TuningUtils::ConvertGraphToFile(std::vector<ComputeGraphPtr> tuning_subgraphs,
                                             std::vector<ComputeGraphPtr> non_tuning_subgraphs,
                                             bool exe_flag, const std::string &path, const std::string &user_path) {
-  int64_t i = 0;
-  int64_t j = 0;
-  std::lock_guard<std::mutex> lock(mutex_);
-  for (auto &subgraph : tuning_subgraphs) {
-    create_output_.emplace(subgraph, nullptr);
-    auto help_info = HelpInfo{i, exe_flag, true, path, user_path};
-    if (MakeExeGraph(subgraph, help_info) != SUCCESS) {
-      GELOGE(GRAPH_FAILED, "TUU:subgraph %zu generate exe graph failed", i);
-      return GRAPH_FAILED;
+  // every subgraph is converted on its own, the index decides the file name whatever the finishing order
+  std::vector<ComputeGraphPtr> subgraphs;
+  std::vector<HelpInfo> help_infos;
+  subgraphs.reserve(tuning_subgraphs.size() + non_tuning_subgraphs.size());
+  help_infos.reserve(tuning_subgraphs.size() + non_tuning_subgraphs.size());
+  for (size_t i = 0U; i < tuning_subgraphs.size(); ++i) {
+    subgraphs.push_back(tuning_subgraphs[i]);
+    help_infos.push_back(HelpInfo{static_cast<int64_t>(i), exe_flag, true, path, user_path});
+  }
+  for (size_t j = 0U; j < non_tuning_subgraphs.size(); ++j) {
+    subgraphs.push_back(non_tuning_subgraphs[j]);
+    help_infos.push_back(HelpInfo{static_cast<int64_t>(j), true, false, path, user_path});
+  }
+  return MakeExeGraphs(subgraphs, help_infos);
+}
+
+graphStatus TuningUtils::MakeExeGraphs(std::vector<ComputeGraphPtr> &subgraphs,
+                                       const std::vector<HelpInfo> &help_infos) {
+  std::vector<graphStatus> results(subgraphs.size(), GRAPH_SUCCESS);
+  auto make_exe_graph = [&subgraphs, &help_infos, &results](size_t idx) -> graphStatus {
+    results[idx] = MakeExeGraph(subgraphs[idx], help_infos[idx]);
+    return results[idx];
+  };
+  // all executable subgraphs go to the one user file, so keep them in order to let the last one win as before
+  bool to_user_path = std::any_of(help_infos.begin(), help_infos.end(), [](const HelpInfo &help_info) {
+    return help_info.exe_flag && !help_info.user_path.empty();
+  });
+  if (to_user_path) {
+    for (size_t idx = 0U; idx < subgraphs.size(); ++idx) {
+      if (make_exe_graph(idx) != SUCCESS) {
+        break;
+      }
     }
-    i++;
+  } else {
+    (void)ParallelFor(subgraphs.size(), make_exe_graph);
   }
 
-  for (auto &subgraph : non_tuning_subgraphs) {
-    create_output_.emplace(subgraph, nullptr);
-    auto help_info = HelpInfo{j, true, false, path, user_path};
-    if (MakeExeGraph(subgraph, help_info) != SUCCESS) {
-      GELOGE(GRAPH_FAILED, "TUU:non tuning_subgraph %zu generate exe graph failed", j);
+  for (size_t idx = 0U; idx < results.size(); ++idx) {
+    if (results[idx] != SUCCESS) {
+      GELOGE(GRAPH_FAILED, "TUU:%s %ld generate exe graph failed",
+             help_infos[idx].is_tuning_graph ? "subgraph" : "non tuning_subgraph", help_infos[idx].index);
       return GRAPH_FAILED;
     }
-    j++;
   }
-  create_output_.clear();
   return SUCCESS;
 }
 
@@ -136,6 +181,7 @@ graphStatus TuningUtils::MakeExeGraph(ComputeGraphPtr &exe_graph,
     return SUCCESS;
   }
   // modify sub graph
+  NodePtr out_node = nullptr;
   for (NodePtr &node : exe_graph->GetDirectNode()) {
     // 1.handle pld
     if (node->GetType() == PLACEHOLDER) {
@@ -147,7 +193,7 @@ graphStatus TuningUtils::MakeExeGraph(ComputeGraphPtr &exe_graph,
     }
     // 2.handle end
     if (node->GetType() == END) {
-      if (HandleEnd(node) != SUCCESS) {
+      if (HandleEnd(node, out_node) != SUCCESS) {
         GELOGE(FAILED, "TUU:Failed to handle node %s from graph %s", node->GetName().c_str(),
                exe_graph->GetName().c_str());
         return FAILED;
@@ -332,16 +378,7 @@ graphStatus TuningUtils::CreateNetOutput(NodePtr &node, NodePtr &out_node) {
   GE_CHECK_NOTNULL(node);
   auto graph = node->GetOwnerComputeGraph();
   GE_CHECK_NOTNULL(graph);
-  auto search = create_output_.find(graph);
-  if (search == create_output_.end()) {
-    GELOGE(FAILED,
-           "TUU:node %s's owner sub graph %s not exist in create_output map",
-           node->GetName().c_str(),
-           graph->GetName().c_str());
-    return FAILED;
-  }
-  if (search->second != nullptr) {
-    out_node = search->second;
+  if (out_node != nullptr) {
     GELOGD("TUU:sub graph %s has created output node, just return", graph->GetName().c_str());
     return SUCCESS;
   }
@@ -353,7 +390,6 @@ graphStatus TuningUtils::CreateNetOutput(NodePtr &node, NodePtr &out_node) {
     GELOGE(FAILED, "TUU:SetOwnerComputeGraph failed");
     return FAILED;
   }
-  create_output_[graph] = out_node;
   return SUCCESS;
 }
 
@@ -452,11 +488,10 @@ graphStatus TuningUtils::ChangeEnd2NetOutput(NodePtr &end_node, NodePtr &out_nod
   return SUCCESS;
 }
 
-graphStatus TuningUtils::HandleEnd(NodePtr &node) {
+graphStatus TuningUtils::HandleEnd(NodePtr &node, NodePtr &out_node) {
   GE_CHECK_NOTNULL(node);
   auto graph = node->GetOwnerComputeGraph();
   GE_CHECK_NOTNULL(graph);
-  NodePtr out_node = nullptr;
 
   // 1. create net_output node , add only one NetOutput node to one subgraph
   if (CreateNetOutput(node, out_node) != SUCCESS) {
@@ -488,28 +523,16 @@ graphStatus TuningUtils::HandleEnd(NodePtr &node) {
 
 // part 2
 graphStatus TuningUtils::ConvertFileToGraph(const map<int64_t, string> &options, ge::Graph &graph) {
-  std::function<void()> callback = [&]() {
-    data_2_netoutput_.clear();
-    data_node_2_netoutput_.clear();
-    data_node_2_netoutput_node_.clear();
-    netoutput_nodes_.clear();
-    merged_graph_nodes_.clear();
-  };
-  GE_MAKE_GUARD(release, callback);
   // 1. get all subgraph object
   std::vector<ComputeGraphPtr> graphs;
-  // options format like {index:"subgraph_path"}
-  for (const auto &pair : options) {
-    ComputeGraphPtr compute_graph = ComGraphMakeShared<ComputeGraph>(std::to_string(pair.first));
-    if (!ge::GraphUtils::LoadGEGraph(pair.second.c_str(), *compute_graph)) {
-      GELOGE(FAILED, "TUU:load graph from file failed");
-    }
-    graphs.push_back(compute_graph);
+  if (LoadSubGraphs(options, graphs) != SUCCESS) {
+    return FAILED;
   }
   // 2. merge graph
   ComputeGraphPtr merged_graph = ComGraphMakeShared<ComputeGraph>("whole_graph_after_tune");
   GE_CHECK_NOTNULL(merged_graph);
-  if (MergeAllSubGraph(graphs, merged_graph) != SUCCESS) {
+  MergeContext context;
+  if (MergeAllSubGraph(graphs, merged_graph, context) != SUCCESS) {
     GELOGE(FAILED, "TUU:MergeGraph failed");
     return FAILED;
   }
@@ -525,6 +548,25 @@ graphStatus TuningUtils::ConvertFileToGraph(const map<int64_t, string> &options,
   return SUCCESS;
 }
 
+graphStatus TuningUtils::LoadSubGraphs(const map<int64_t, string> &options, std::vector<ComputeGraphPtr> &graphs) {
+  // options format like {index:"subgraph_path"}, the graphs keep the index order whoever loads first
+  std::vector<const std::pair<const int64_t, string> *> files;
+  files.reserve(options.size());
+  for (const auto &pair : options) {
+    ComputeGraphPtr compute_graph = ComGraphMakeShared<ComputeGraph>(std::to_string(pair.first));
+    GE_CHECK_NOTNULL(compute_graph);
+    graphs.push_back(compute_graph);
+    files.push_back(&pair);
+  }
+  (void)ParallelFor(files.size(), [&graphs, &files](size_t idx) -> graphStatus {
+    if (!ge::GraphUtils::LoadGEGraph(files[idx]->second.c_str(), *graphs[idx])) {
+      GELOGE(FAILED, "TUU:load graph from file failed");
+    }
+    return GRAPH_SUCCESS;
+  });
+  return SUCCESS;
+}
+
 // +----------------------------------+
 // | const const                      |
 // |  \     /                         |
@@ -561,18 +603,19 @@ graphStatus TuningUtils::ConvertFileToGraph(const map<int64_t, string> &options,
 // |  netoutput                       |
 // +----------------------------------+
 graphStatus TuningUtils::MergeAllSubGraph(std::vector<ComputeGraphPtr> &subgraphs,
-                                          ComputeGraphPtr &output_merged_compute_graph) {
+                                          ComputeGraphPtr &output_merged_compute_graph,
+                                          MergeContext &context) {
   GE_CHECK_NOTNULL(output_merged_compute_graph);
   // 1. handle all subgraphs
   for (auto &subgraph : subgraphs) {
-    Status ret_status = MergeSubGraph(subgraph);
+    Status ret_status = MergeSubGraph(subgraph, context);
     if (ret_status != SUCCESS) {
       GELOGE(ret_status, "TUU:subgraph %s merge failed", subgraph->GetName().c_str());
       return ret_status;
     }
   }
 
-  for (const auto &node: merged_graph_nodes_) {
+  for (const auto &node: context.merged_graph_nodes) {
     (void) output_merged_compute_graph->AddNode(node);
     GELOGD("TUU:graph %s add node %s success", output_merged_compute_graph->GetName().c_str(), node->GetName().c_str());
 
@@ -589,7 +632,7 @@ graphStatus TuningUtils::MergeAllSubGraph(std::vector<ComputeGraphPtr> &subgraph
   }
 
   // 2. remove data and output node added by us
-  if (RemoveDataNetoutputEdge(output_merged_compute_graph) != SUCCESS) {
+  if (RemoveDataNetoutputEdge(output_merged_compute_graph, context) != SUCCESS) {
     GELOGE(FAILED, "TUU:Failed to merge graph %s", output_merged_compute_graph->GetName().c_str());
     return FAILED;
   }
@@ -598,12 +641,12 @@ graphStatus TuningUtils::MergeAllSubGraph(std::vector<ComputeGraphPtr> &subgraph
     GELOGE(ret, "Graph[%s] topological sort failed, ret:%d.", output_merged_compute_graph->GetName().c_str(), ret);
     return ret;
   }
-  GELOGD("TUU:Print-%s", PrintCheckLog().c_str());
+  GELOGD("TUU:Print-%s", PrintCheckLog(context).c_str());
   GELOGI("TUU:output_merged_compute_graph %s success", output_merged_compute_graph->GetName().c_str());
   return SUCCESS;
 }
 
-graphStatus TuningUtils::MergeSubGraph(ComputeGraphPtr &subgraph) {
+graphStatus TuningUtils::MergeSubGraph(ComputeGraphPtr &subgraph, MergeContext &context) {
   for (auto &node : subgraph->GetDirectNode()) {
     if (kPartitionOpTypes.count(node->GetType()) > 0) {
       GELOGE(FAILED, "TUU:subgraph passed in should not contain nodes of end or pld type");
@@ -617,9 +660,8 @@ graphStatus TuningUtils::MergeSubGraph(ComputeGraphPtr &subgraph) {
       bool has_valid_str =
           (AttrUtils::GetStr(op_desc, peer_node_name_attr, peer_out_name)) && (!peer_out_name.empty());
       if (has_valid_str) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        data_2_netoutput_.emplace(op_desc->GetName(), peer_out_name);
-        data_node_2_netoutput_.emplace(node, peer_out_name);
+        context.data_2_netoutput.emplace(op_desc->GetName(), peer_out_name);
+        context.data_node_2_netoutput.emplace_back(node, peer_out_name);
         continue;
       }
     }
@@ -631,30 +673,26 @@ graphStatus TuningUtils::MergeSubGraph(ComputeGraphPtr &subgraph) {
       bool has_valid_str =
           (AttrUtils::GetListStr(op_desc, alias_name_attr, out_alias_name)) && (!out_alias_name.empty());
       if (has_valid_str) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        netoutput_nodes_.emplace_back(node);
+        context.netoutput_nodes.emplace_back(node);
       }
     }
-    {
-      std::lock_guard<std::mutex> lock(mutex_);
-      merged_graph_nodes_.emplace_back(node);
-    }
+    context.merged_graph_nodes.emplace_back(node);
     GELOGD("TUU:subgraph %s add node %s success", subgraph->GetName().c_str(), node->GetName().c_str());
   }
   GELOGI("TUU:merge subgraph %s success", subgraph->GetName().c_str());
   return SUCCESS;
 }
 
-graphStatus TuningUtils::RemoveDataNetoutputEdge(ComputeGraphPtr &graph) {
+graphStatus TuningUtils::RemoveDataNetoutputEdge(ComputeGraphPtr &graph, MergeContext &context) {
   GE_CHECK_NOTNULL(graph);
   // 1. traverse
-  for (auto &pair: data_node_2_netoutput_) {
+  for (auto &pair: context.data_node_2_netoutput) {
     auto data_node = pair.first;
     GE_CHECK_NOTNULL(data_node);
     auto netoutput_name = pair.second;
     auto netoutput_node = graph->FindNode(netoutput_name);
     GE_CHECK_NOTNULL(netoutput_node);
-    data_node_2_netoutput_node_.emplace(data_node, netoutput_node);
+    context.data_node_2_netoutput_node.emplace(data_node, netoutput_node);
     // 2. get `data out anchor` and `net output in anchor` and `net output in node's out anchor`
     AnchorPtr data_out_anchor = (data_node->GetOutDataAnchor(0)->GetFirstPeerAnchor() == nullptr)
                                 ? Anchor::DynamicAnchorCast<Anchor>(data_node->GetOutControlAnchor())
@@ -687,7 +725,7 @@ graphStatus TuningUtils::RemoveDataNetoutputEdge(ComputeGraphPtr &graph) {
     }
   }
   // 4. remove out nodes added by us
-  for (auto &node: netoutput_nodes_) {
+  for (auto &node: context.netoutput_nodes) {
     NodeUtils::UnlinkAll(*node);
     if (GraphUtils::RemoveNodeWithoutRelink(graph, node) != GRAPH_SUCCESS) {
       GELOGE(FAILED, "TUU:Failed to remove node %s from graph", node->GetName().c_str());
@@ -0,0 +1,372 @@
+/**
+ * Copyright 2020 Huawei Technologies Co., Ltd
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ * http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef INC_COMMON_RING_QUEUE_H_
+#define INC_COMMON_RING_QUEUE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+static const uint32_t kDefaultRingQueueSize = 2048;
+static const uint32_t kRingQueueSpinCount = 64;
+
+// Bounded multi-producer multi-consumer queue over a preallocated ring.
+// Push/Pop/Stop/Restart follow BlockingQueue: a stopped queue rejects both ends
+// until Restart. Each slot carries a sequence number, so producers and consumers
+// only contend on their own position counter. Blocking calls spin a little and
+// then park on a condition variable that is signalled only when someone waits.
+template <typename T>
+class RingQueue {
+ public:
+  // holds at most max_size items, the ring behind it is rounded up to a power of two
+  explicit RingQueue(uint32_t max_size = kDefaultRingQueueSize)
+      : max_size_(max_size), capacity_(RoundUpCapacity(max_size)), mask_(capacity_ - 1), is_stoped_(false) {
+    slots_.reset(new (std::nothrow) Slot[capacity_]);
+    if (slots_ == nullptr) {
+      max_size_ = 0;
+      capacity_ = 0;
+      mask_ = 0;
+      return;
+    }
+    for (size_t i = 0; i < capacity_; ++i) {
+      slots_[i].seq.store(i, std::memory_order_relaxed);
+    }
+    enqueue_pos_.store(0, std::memory_order_relaxed);
+    dequeue_pos_.store(0, std::memory_order_relaxed);
+  }
+
+  ~RingQueue() {
+    if (slots_ == nullptr) {
+      return;
+    }
+    const size_t tail = enqueue_pos_.load(std::memory_order_relaxed);
+    for (size_t pos = dequeue_pos_.load(std::memory_order_relaxed); pos != tail; ++pos) {
+      reinterpret_cast<T *>(&slots_[pos & mask_].storage)->~T();
+    }
+  }
+
+  RingQueue(const RingQueue &) = delete;
+  RingQueue &operator=(const RingQueue &) = delete;
+
+  bool TryPush(const T &item) {
+    T copy(item);
+    return TryPush(std::move(copy));
+  }
+
+  bool TryPush(T &&item) {
+    if (IsStoped()) {
+      return false;
+    }
+    if (!TryPushItem(std::move(item))) {
+      return false;
+    }
+    WakeWaiters(pop_waiters_, empty_cond_);
+    return true;
+  }
+
+  bool TryPop(T &item) {
+    if (IsStoped()) {
+      return false;
+    }
+    if (!TryPopItem(item)) {
+      return false;
+    }
+    WakeWaiters(push_waiters_, full_cond_);
+    return true;
+  }
+
+  bool Push(const T &item, bool is_wait = true) {
+    T copy(item);
+    return Push(std::move(copy), is_wait);
+  }
+
+  bool Push(T &&item, bool is_wait = true) {
+    if (!WaitForPush(item, is_wait)) {
+      return false;
+    }
+    WakeWaiters(pop_waiters_, empty_cond_);
+    return true;
+  }
+
+  bool Pop(T &item) {
+    if (!WaitForPop(item)) {
+      return false;
+    }
+    WakeWaiters(push_waiters_, full_cond_);
+    return true;
+  }
+
+  // Moves items from the front of the vector into the queue and erases the pushed ones.
+  // Returns the number pushed, which is short only when stopped or full without is_wait.
+  size_t PushBatch(std::vector<T> &items, bool is_wait = true) {
+    size_t pushed = 0;
+    while ((pushed < items.size()) && !IsStoped()) {
+      if (!TryPushItem(std::move(items[pushed]))) {
+        // consumers must see what is already in before we park on a full ring
+        if (pushed > 0) {
+          WakeWaiters(pop_waiters_, empty_cond_, true);
+        }
+        if (!WaitForPush(items[pushed], is_wait)) {
+          break;
+        }
+      }
+      ++pushed;
+    }
+    items.erase(items.begin(), items.begin() + pushed);
+    if (pushed > 0) {
+      WakeWaiters(pop_waiters_, empty_cond_, true);
+    }
+    return pushed;
+  }
+
+  // Waits for at least one item, then appends up to max_num items without further waiting.
+  size_t PopBatch(std::vector<T> &items, size_t max_num) {
+    if (max_num == 0) {
+      return 0;
+    }
+    T item;
+    if (!WaitForPop(item)) {
+      return 0;
+    }
+    items.emplace_back(std::move(item));
+    size_t popped = 1;
+    while (popped < max_num && TryPopItem(item)) {
+      items.emplace_back(std::move(item));
+      ++popped;
+    }
+    WakeWaiters(push_waiters_, full_cond_, true);
+    return popped;
+  }
+
+  void Stop() {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      is_stoped_.store(true, std::memory_order_seq_cst);
+    }
+    full_cond_.notify_all();
+    empty_cond_.notify_all();
+  }
+
+  void Restart() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    is_stoped_.store(false, std::memory_order_seq_cst);
+  }
+
+  // if the queue is stoped, need call this function to take out the unprocessed items
+  std::vector<T> GetRemainItems() {
+    std::vector<T> items;
+    if (!IsStoped()) {
+      return items;
+    }
+    T item;
+    while (TryPopItem(item)) {
+      items.emplace_back(std::move(item));
+    }
+    return items;
+  }
+
+  bool IsFull() const {
+    return Size() >= max_size_;
+  }
+
+  bool IsEmpty() const {
+    return Size() == 0;
+  }
+
+  // approximate while producers or consumers are running
+  size_t Size() const {
+    const size_t tail = enqueue_pos_.load(std::memory_order_acquire);
+    const size_t head = dequeue_pos_.load(std::memory_order_acquire);
+    return (tail > head) ? (tail - head) : 0;
+  }
+
+  size_t Capacity() const {
+    return max_size_;
+  }
+
+  void Clear() {
+    T item;
+    while (TryPopItem(item)) {
+    }
+    WakeWaiters(push_waiters_, full_cond_, true);
+  }
+
+ private:
+  struct Slot {
+    std::atomic<size_t> seq;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+  };
+
+  static size_t RoundUpCapacity(uint32_t max_size) {
+    size_t capacity = 1;
+    while (capacity < max_size) {
+      capacity <<= 1;
+    }
+    return capacity;
+  }
+
+  bool IsStoped() const {
+    return is_stoped_.load(std::memory_order_acquire);
+  }
+
+  bool TryPushItem(T &&item) {
+    if (max_size_ == 0) {
+      return false;
+    }
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+      Slot &slot = slots_[pos & mask_];
+      const size_t seq = slot.seq.load(std::memory_order_acquire);
+      const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        // the ring may be larger than max_size, dequeue_pos_ only grows so a stale read never lets it overflow
+        if ((max_size_ < capacity_) && (pos - dequeue_pos_.load(std::memory_order_acquire) >= max_size_)) {
+          return false;
+        }
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          new (&slot.storage) T(std::move(item));
+          slot.seq.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  bool TryPopItem(T &item) {
+    if (capacity_ == 0) {
+      return false;
+    }
+    size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+      Slot &slot = slots_[pos & mask_];
+      const size_t seq = slot.seq.load(std::memory_order_acquire);
+      const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+      if (diff == 0) {
+        if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          T *stored = reinterpret_cast<T *>(&slot.storage);
+          item = std::move(*stored);
+          stored->~T();
+          slot.seq.store(pos + capacity_, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  bool WaitForPush(T &item, bool is_wait) {
+    for (uint32_t i = 0; i < kRingQueueSpinCount; ++i) {
+      if (IsStoped()) {
+        return false;
+      }
+      if (TryPushItem(std::move(item))) {
+        return true;
+      }
+      if (!is_wait) {
+        return false;
+      }
+      std::this_thread::yield();
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    push_waiters_.fetch_add(1, std::memory_order_seq_cst);
+    bool ret = false;
+    while (!IsStoped()) {
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (TryPushItem(std::move(item))) {
+        ret = true;
+        break;
+      }
+      full_cond_.wait(lock);
+    }
+    push_waiters_.fetch_sub(1, std::memory_order_relaxed);
+    return ret;
+  }
+
+  bool WaitForPop(T &item) {
+    for (uint32_t i = 0; i < kRingQueueSpinCount; ++i) {
+      if (IsStoped()) {
+        return false;
+      }
+      if (TryPopItem(item)) {
+        return true;
+      }
+      std::this_thread::yield();
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    pop_waiters_.fetch_add(1, std::memory_order_seq_cst);
+    bool ret = false;
+    while (!IsStoped()) {
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (TryPopItem(item)) {
+        ret = true;
+        break;
+      }
+      empty_cond_.wait(lock);
+    }
+    pop_waiters_.fetch_sub(1, std::memory_order_relaxed);
+    return ret;
+  }
+
+  // Pairs with the fence in WaitFor*: either the waiter sees the new item or we see the waiter.
+  void WakeWaiters(std::atomic<uint32_t> &waiters, std::condition_variable &cond, bool wake_all = false) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters.load(std::memory_order_relaxed) == 0) {
+      return;
+    }
+    { std::lock_guard<std::mutex> lock(mutex_); }
+    if (wake_all) {
+      cond.notify_all();
+    } else {
+      cond.notify_one();
+    }
+  }
+
+  static const size_t kCacheLineSize = 64;
+
+  size_t max_size_;
+  size_t capacity_;
+  size_t mask_;
+  std::unique_ptr<Slot[]> slots_;
+  char pad0_[kCacheLineSize];
+  std::atomic<size_t> enqueue_pos_;
+  char pad1_[kCacheLineSize - sizeof(std::atomic<size_t>)];
+  std::atomic<size_t> dequeue_pos_;
+  char pad2_[kCacheLineSize - sizeof(std::atomic<size_t>)];
+  std::atomic<uint32_t> push_waiters_{0};
+  std::atomic<uint32_t> pop_waiters_{0};
+  std::atomic<bool> is_stoped_;
+  std::mutex mutex_;
+  std::condition_variable empty_cond_;
+  std::condition_variable full_cond_;
+};
+
+#endif  // INC_COMMON_RING_QUEUE_H_
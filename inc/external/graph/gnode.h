@@ -17,8 +17,9 @@
 #ifndef INC_EXTERNAL_GRAPH_NODE_H_
 #define INC_EXTERNAL_GRAPH_NODE_H_
 
-#include <vector>
 #include <cstdint>
+#include <functional>
+#include <vector>
 
 #include "./ge_error_codes.h"
 #include "./types.h"
@@ -56,6 +57,16 @@ class GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY GNode {
 
   std::vector<GNodePtr> GetOutControlNodes() const;
 
+  // Visit the peers without building a vector. node is the cached handle of the peer, port_index is its
+  // data port index or -1 for a control edge. Stops at the first status other than GRAPH_SUCCESS and returns it.
+  // The visitor must not add or remove edges of the visited ports, doing so stops the walk with GRAPH_FAILED.
+  using NodeVisitor = std::function<graphStatus(const GNode &node, int32_t port_index)>;
+  // peers feeding the inputs, in input order
+  graphStatus VisitInDataNodes(const NodeVisitor &visitor) const;
+  graphStatus VisitOutDataNodes(const int32_t index, const NodeVisitor &visitor) const;
+  graphStatus VisitInControlNodes(const NodeVisitor &visitor) const;
+  graphStatus VisitOutControlNodes(const NodeVisitor &visitor) const;
+
   graphStatus GetInputConstData(const int32_t index, Tensor &data) const;
 
   graphStatus GetInputIndexByName(const AscendString &name, int32_t &index);
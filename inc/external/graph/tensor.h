@@ -18,6 +18,7 @@
 #define INC_EXTERNAL_GRAPH_TENSOR_H_
 
 #include <atomic>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -99,11 +100,13 @@ class GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY TensorDesc {
 
  private:
   std::shared_ptr<TensorDescImpl> impl;
+  friend class TensorAdapter;
 };
 
 class TensorImpl;
 class GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY Tensor {
  public:
+  using DeleteFunc = std::function<void(uint8_t *)>;
   Tensor();
   ~Tensor() = default;
   explicit Tensor(const TensorDesc &tensorDesc);
@@ -121,6 +124,8 @@ class GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY Tensor {
   graphStatus SetData(std::vector<uint8_t> &&data);
   graphStatus SetData(const std::vector<uint8_t> &data);
   graphStatus SetData(const uint8_t *data, size_t size);
+  // The tensor takes over data, deleter_func releases it
+  graphStatus SetData(uint8_t *data, size_t size, const Tensor::DeleteFunc &deleter_func);
   ATTRIBUTED_DEPRECATED(graphStatus SetData(const char *data))
   graphStatus SetData(const std::string &data);
   graphStatus SetData(const char *data);
@@ -40,9 +40,13 @@ class FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY PassRegistrationData {
 
   PassRegistrationData &CustomPassFn(const CustomPassFunc &);
 
+  // A read-only pass only inspects the graph, so it may run at the same time as its read-only neighbours
+  PassRegistrationData &ReadOnly(bool read_only);
+
   std::string GetPassName() const;
   int32_t GetPriority() const;
   CustomPassFunc GetCustomPassFn() const;
+  bool IsReadOnly() const;
 
  private:
   std::shared_ptr<PassRegistrationDataImpl> impl_;
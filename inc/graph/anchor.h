@@ -19,8 +19,11 @@
 
 #include "graph/compiler_options.h"
 
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include "graph/ge_error_codes.h"
 #include "graph/range_vistor.h"
@@ -74,6 +77,72 @@ using OutControlAnchorPtr = std::shared_ptr<OutControlAnchor>;
 
 using ConstAnchor = const Anchor;
 
+// Peer links of an anchor in link order. Once an anchor has many peers, the links are also indexed by peer and
+// unlinked slots are left empty until enough of them pile up, so lookup and unlink do not scan the peers.
+class GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY AnchorLinks {
+ public:
+  explicit AnchorLinks(const Anchor *owner = nullptr) : owner_(owner) {}
+
+  bool empty() const { return size_ == 0U; }
+  size_t size() const { return size_; }
+  // The first peer, nullptr if it has expired
+  AnchorPtr front() const;
+
+  void push_back(const AnchorPtr &peer);
+  bool Contains(const AnchorPtr &peer) const { return Find(peer) != kNoSlot; }
+  // Remove the first link with peer
+  bool Erase(const AnchorPtr &peer);
+  void EraseFront();
+  // Link new_peer at the place of the first link with old_peer
+  bool Replace(const AnchorPtr &old_peer, const AnchorPtr &new_peer);
+
+  // Visit the peers in link order. func must not link or unlink these peers: the walk stops at the first change
+  // and returns false instead of skipping or repeating peers.
+  template <typename Func>
+  bool ForEach(Func &&func) const {
+    const uint64_t version = version_;
+    for (size_t i = head_; i < slots_.size(); ++i) {
+      if (slots_[i].anchor != nullptr) {
+        func(slots_[i].peer.lock());
+        if (version_ != version) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+ private:
+  static constexpr size_t kNoSlot = static_cast<size_t>(-1);
+  static constexpr size_t kIndexMinSize = 16U;
+
+  struct Slot {
+    const Anchor *anchor;
+    std::weak_ptr<Anchor> peer;
+    // Next slot linked with the same peer
+    size_t next;
+  };
+
+  size_t Find(const AnchorPtr &peer) const;
+  void EraseSlot(size_t pos);
+  void AddToIndex(size_t pos);
+  void RemoveFromIndex(size_t pos);
+  void BuildIndex();
+  void Compact();
+  void IncreaseVersion();
+
+  // the anchor holding these links
+  const Anchor *owner_;
+  std::vector<Slot> slots_;
+  // peer -> first and last slot linked with it, only kept when indexed_
+  std::unordered_map<const Anchor *, std::pair<size_t, size_t>> index_;
+  bool indexed_ = false;
+  size_t size_ = 0U;
+  size_t head_ = 0U;
+  // bumped on every link change, so a walk can tell it was modified
+  uint64_t version_ = 0U;
+};
+
 class GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY Anchor : public std::enable_shared_from_this<Anchor> {
   friend class AnchorUtils;
 
@@ -98,6 +167,16 @@ class GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY Anchor : public std::enable
   size_t GetPeerAnchorsSize() const;
   // Get first peer anchor
   AnchorPtr GetFirstPeerAnchor() const;
+  // Visit the peer anchors in link order without building a vector, expired peers are skipped.
+  // Returns false if func linked or unlinked this anchor, the walk stops there.
+  template <typename Func>
+  bool ForEachPeerAnchor(Func &&func) const {
+    return peer_anchors_.ForEach([&func](const AnchorPtr &peer) {
+      if (peer != nullptr) {
+        func(peer);
+      }
+    });
+  }
 
   // Get the anchor belong to which node
   NodePtr GetOwnerNode() const;
@@ -122,7 +201,7 @@ class GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY Anchor : public std::enable
 
  protected:
   // All peer anchors connected to current anchor
-  vector<std::weak_ptr<Anchor>> peer_anchors_;
+  AnchorLinks peer_anchors_;
   // The owner node of anchor
   std::weak_ptr<Node> owner_node_;
   // The index of current anchor
@@ -27,14 +27,23 @@
 namespace ge {
 
 using std::shared_ptr;
+class AlignedPtr;
 
 class GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY Buffer {
  public:
+  // Holds nothing until data is given, so a buffer declared only to be assigned allocates nothing.
+  // GetData() of such a buffer is nullptr, also through the const overload
   Buffer();
   Buffer(const Buffer &other);
 
   explicit Buffer(std::size_t bufferSize, std::uint8_t defualtVal = 0);
 
+  // Wraps memory owned elsewhere (mmap, AlignedPtr, arena) without copying. Putting the buffer into an attribute
+  // copies the bytes: attributes keep their bytes in the proto, and keeping external bytes there until the
+  // model is serialized would need a side table that every attr reader and serializer has to consult.
+  Buffer(const std::shared_ptr<std::uint8_t> &data, std::size_t bufferSize);
+  static Buffer FromAlignedPtr(const std::shared_ptr<AlignedPtr> &alignedPtr, std::size_t bufferSize);
+
   ~Buffer() = default;
 
   Buffer &operator=(const Buffer &other);
@@ -45,6 +54,7 @@ class GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY Buffer {
   std::uint8_t *GetData();
   std::size_t GetSize() const;
   void ClearBuffer();
+  bool IsExternal() const { return ext_data_ != nullptr; }
 
   // For compatibility
   inline const std::uint8_t *data() const { return GetData(); }
@@ -52,8 +62,8 @@ class GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY Buffer {
   inline std::size_t size() const { return GetSize(); }
   inline void clear() { return ClearBuffer(); }
   uint8_t operator[](size_t index) const {                // lint !e1022 !e1042
-    if (buffer_ != nullptr && index < buffer_->size()) {  // lint !e574
-      return (uint8_t)(*buffer_)[index];
+    if (index < GetSize()) {                              // lint !e574
+      return GetData()[index];
     }
     return 0xff;
   }
@@ -61,6 +71,12 @@ class GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY Buffer {
  private:
   GeIrProtoHelper<proto::AttrDef> data_;
   std::string *buffer_ = nullptr;
+  // external bytes, used instead of the proto until MutableProtoBytes
+  std::shared_ptr<std::uint8_t> ext_data_;
+  std::size_t ext_size_ = 0;
+
+  // The proto string holding the bytes, copying external bytes in first
+  std::string *MutableProtoBytes();
 
   // Create from protobuf obj
   Buffer(const ProtoMsgOwner &protoOnwer, proto::AttrDef *buffer);
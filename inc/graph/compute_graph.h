@@ -196,6 +196,7 @@ class ComputeGraph : public std::enable_shared_from_this<ComputeGraph>, public A
   const std::map<OperatorImplPtr, NodePtr> &GetAllNodesInfo() const;
 
   void SetAllNodesInfo(const std::map<OperatorImplPtr, NodePtr> &nodes) { all_nodes_infos_ = nodes; }
+  void SetAllNodesInfo(std::map<OperatorImplPtr, NodePtr> &&nodes) { all_nodes_infos_ = std::move(nodes); }
 
   void SetGraphOutNodesInfo(std::vector<std::pair<NodePtr, int32_t>> &out_nodes_info) {
     output_nodes_info_ = out_nodes_info;
@@ -20,6 +20,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include "graph/anchor.h"
 #include "graph/detail/attributes_holder.h"
@@ -42,6 +43,7 @@ struct NodeNameNodeReq {
     NodePtr dst_node;
     int32_t dst_in_index;
     string dst_node_name;
+    int64_t src_node_index;
 };
 
 class ModelSerializeImp {
@@ -58,6 +60,13 @@ class ModelSerializeImp {
 
   bool SerializeTensor(const ConstGeTensorPtr &tensor, proto::TensorDef *tensorProto);
 
+  // Encoded size of what SerializeModel would produce, computed from the graph without building the ModelDef
+  bool GetModelSize(const Model &model, size_t &size);
+
+  bool GetGraphSize(const ConstComputeGraphPtr &graph, size_t &size);
+
+  bool GetNodeSize(const NodePtr &node, size_t &size);
+
   bool UnserializeModel(Model &model, proto::ModelDef &modeProto);
 
   bool UnserializeGraphWithoutEdge(ComputeGraphPtr &graph, proto::GraphDef &graphProto);
@@ -79,14 +88,30 @@ class ModelSerializeImp {
 
   void SetProtobufOwner(const ProtoMsgOwner &bufferProtobufOnwer) { protobuf_owner_ = bufferProtobufOnwer; }
 
+  // 0 means decided by the hardware concurrency, 1 unserializes everything on the calling thread
+  void SetParallelNum(uint32_t parallel_num) { parallel_num_ = parallel_num; }
+
  private:
   bool RebuildOwnership(ComputeGraphPtr &compute_graph, std::map<std::string, ComputeGraphPtr> &subgraphs);
 
+  bool UnserializeOpDescs(proto::GraphDef &graph_proto, std::vector<OpDescPtr> &op_descs, uint32_t thread_num);
+
+  bool AddNode(ComputeGraphPtr &graph, const OpDescPtr &op_desc, const proto::OpDef &op_def_proto);
+
+  ComputeGraphPtr UnserializeSubgraph(proto::GraphDef &graph_proto);
+
+  bool UnserializeSubgraphs(proto::ModelDef &model_proto, std::map<std::string, ComputeGraphPtr> &subgraphs);
+
+  NodePtr FindNode(const string &node_name) const;
+
   std::vector<NodeNameGraphReq> graph_input_node_names_;
   std::vector<NodeNameGraphReq> graph_output_node_names_;
   std::vector<NodeNameNodeReq> node_input_node_names_;
-  std::map<string, NodePtr> node_map_;
+  std::vector<NodePtr> nodes_;
+  std::unordered_map<string, size_t> node_map_;
+  bool has_duplicate_name_ = false;
   ProtoMsgOwner protobuf_owner_;
+  uint32_t parallel_num_ = 0U;
 };
 }  // namespace ge
 
@@ -0,0 +1,95 @@
+/**
+ * Copyright 2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INC_GRAPH_DETAIL_WEIGHTS_MAPPING_H_
+#define INC_GRAPH_DETAIL_WEIGHTS_MAPPING_H_
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include "graph/detail/attributes_holder.h"
+
+namespace ge {
+// Read-only memory mapping of a serialized model file. When a model is loaded through it, const weights
+// whose size reaches kLazyWeightMinSize are not parsed into the proto; the TensorDef only keeps an
+// (offset, length) view into the mapping, and the bytes are copied in the first time they are touched.
+class WeightsMapping {
+ public:
+  static constexpr size_t kLazyWeightMinSize = 4096U;
+
+  static std::shared_ptr<WeightsMapping> Create(const std::string &real_path);
+
+  ~WeightsMapping();
+  WeightsMapping(const WeightsMapping &) = delete;
+  WeightsMapping &operator=(const WeightsMapping &) = delete;
+
+  const uint8_t *GetData() const { return addr_; }
+  size_t GetSize() const { return size_; }
+
+  // Copy the mapped ModelDef without the large op weights, their positions are remembered for AddViews
+  bool Prune(std::string &pruned);
+  // Bind the remembered weights to the tensors of model_def, which was parsed from the pruned bytes
+  bool AddViews(proto::ModelDef &model_def);
+
+  // Forget every view created by this mapping, views which were not touched yet stay empty
+  void Release();
+
+  static bool HasLazyWeights() { return lazy_weights_count_.load(std::memory_order_acquire) > 0U; }
+
+  // Copy the viewed bytes into the tensor, return true if the tensor was lazy
+  static bool Materialize(const proto::TensorDef *tensor_def);
+  static void Materialize(const proto::AttrDef &attr_def);
+  static void Materialize(const ProtoAttrMap &attr_map);
+  // Length of the viewed bytes, 0 if the tensor is not lazy
+  static size_t GetLazySize(const proto::TensorDef *tensor_def);
+
+  // The tensor data is going to be overwritten or freed, the view is not needed any more.
+  // A view left behind would match a TensorDef created later at the same address
+  static void Drop(const proto::TensorDef *tensor_def);
+  static void Drop(const proto::AttrDef &attr_def);
+  static void Drop(const ProtoAttrMap &attr_map);
+
+ private:
+  struct WeightPath {
+    int32_t graph_index;
+    int32_t op_index;
+    std::string attr_name;
+    int32_t list_index;
+    size_t offset;
+    size_t length;
+  };
+
+  WeightsMapping(uint8_t *addr, size_t size) : addr_(addr), size_(size) {}
+
+  bool PruneModelDef(const uint8_t *begin, const uint8_t *end, std::string &pruned);
+  bool PruneGraphDef(const uint8_t *begin, const uint8_t *end, int32_t graph_index, std::string &pruned);
+  bool PruneOpDef(const uint8_t *begin, const uint8_t *end, WeightPath &path, std::string &pruned);
+  bool PruneAttrEntry(const uint8_t *begin, const uint8_t *end, WeightPath &path, std::string &pruned);
+  bool PruneAttrDef(const uint8_t *begin, const uint8_t *end, WeightPath &path, std::string &pruned);
+  bool PruneTensorDef(const uint8_t *begin, const uint8_t *end, WeightPath &path, std::string &pruned);
+  bool AddView(proto::ModelDef &model_def, const WeightPath &path);
+
+  uint8_t *addr_;
+  size_t size_;
+  std::vector<WeightPath> weight_paths_;
+  std::vector<const proto::TensorDef *> views_;
+
+  static std::atomic<size_t> lazy_weights_count_;
+};
+}  // namespace ge
+
+#endif  // INC_GRAPH_DETAIL_WEIGHTS_MAPPING_H_
@@ -18,11 +18,13 @@
 
 #include <string>
 #include "graph/ge_error_codes.h"
+#include "graph/ge_local_context.h"
 
 namespace ge {
 class GEContext {
  public:
   graphStatus GetOption(const std::string &key, std::string &option);
+  graphStatus GetOption(IntOption key, int64_t &value);
   bool GetHostExecFlag();
   uint64_t SessionId();
   uint32_t DeviceId();
@@ -16,6 +16,7 @@
 #ifndef INC_GRAPH_GE_LOCAL_CONTEXT_H_
 #define INC_GRAPH_GE_LOCAL_CONTEXT_H_
 
+#include <cstdint>
 #include <map>
 #include <string>
 #include <vector>
@@ -25,9 +26,23 @@ using std::string;
 using std::map;
 
 namespace ge {
+// Options read on hot paths, each one is parsed once into a typed slot of the context
+enum class IntOption : uint32_t {
+  kSessionId = 0U,
+  kDeviceId,
+  kGraphRunMode,
+  kMaxDumpFileNum,
+  kMaxDumpFileSize,
+  kIntOptionEnd
+};
+
 class GEThreadLocalContext {
  public:
   graphStatus GetOption(const string &key, string &option);
+  graphStatus GetOption(IntOption key, int64_t &value);
+  // Changes whenever options are set, so caches derived from options can tell they are stale.
+  // Contexts without any option set share version 0
+  uint64_t GetOptionVersion() const { return version_; }
   void SetGraphOption(map<std::string, string> options_map);
   void SetSessionOption(map<std::string, string> options_map);
   void SetGlobalOption(map<std::string, string> options_map);
@@ -38,9 +53,18 @@ class GEThreadLocalContext {
   map<string, string> GetAllOptions() const;
 
  private:
+  struct IntOptionSlot {
+    bool parsed = false;
+    graphStatus status = GRAPH_PARAM_INVALID;
+    int64_t value = 0;
+  };
+  void ResetTypedOptions();
+
   map<string, string> graph_options_;
   map<string, string> session_options_;
   map<string, string> global_options_;
+  IntOptionSlot int_options_[static_cast<size_t>(IntOption::kIntOptionEnd)];
+  uint64_t version_ = 0U;
 };  // class GEThreadLocalContext
 
 GEThreadLocalContext &GetThreadLocalContext();
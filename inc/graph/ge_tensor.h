@@ -142,6 +142,7 @@ class GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY GeTensorDesc : public AttrH
   friend class GeAttrValueImp;
   friend class ModelSerializeImp;
   friend class OnnxUtils;
+  friend class TensorAdapter;
 
   GeIrProtoHelper<proto::TensorDescriptor> tensor_descriptor_;
   // Reference from tensorDescriptor_, do not direct use
@@ -159,6 +160,7 @@ class GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY TensorData {
 
   TensorData &operator=(const TensorData &other);
 
+  // Takes over the buffer of data if it is aligned, otherwise copies it
   graphStatus SetData(std::vector<uint8_t> &&data);
   graphStatus SetData(const std::vector<uint8_t> &data);
   graphStatus SetData(const Buffer &data);
@@ -166,6 +168,8 @@ class GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY TensorData {
   graphStatus SetData(const uint8_t *data, size_t size);
   // zero copy SetData
   void SetData(std::shared_ptr<AlignedPtr> aligned_ptr, size_t size);
+  // Takes over data, delete_func is called once no tensor refers to it any more
+  graphStatus SetData(uint8_t *data, size_t size, const std::function<void(uint8_t *)> &delete_func);
 
   const uint8_t *MallocAlignedPtr(size_t size);
 
@@ -199,6 +203,9 @@ class GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY TensorData {
   // functions data() & mutable_data() return address of invalid_data_ when length_ is 0
   // defined for coding convenience
   static uint32_t invalid_data_;
+
+  bool CanAdopt(const uint8_t *data, size_t size) const;
+  graphStatus AdoptData(uint8_t *data, size_t size, const std::function<void(uint8_t *)> &delete_func);
 };
 
 class GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY GeTensor {
@@ -220,8 +227,8 @@ class GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY GeTensor {
 
   std::shared_ptr<AlignedPtr> GetAlignedPtr() { return tensor_data_.aligned_ptr_; }
 
-  const TensorData &GetData() const { return tensor_data_; }
-  TensorData &MutableData() { return tensor_data_; }
+  const TensorData &GetData() const;
+  TensorData &MutableData();
 
   graphStatus SetData(std::vector<uint8_t> &&data);
   graphStatus SetData(const std::vector<uint8_t> &data);
@@ -233,6 +240,7 @@ class GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY GeTensor {
   void SetData(std::shared_ptr<AlignedPtr> aligned_ptr, size_t size) {
     tensor_data_.SetData(std::move(aligned_ptr), size);
   }
+  graphStatus SetData(uint8_t *data, size_t size, const std::function<void(uint8_t *)> &delete_func);
 
   void ClearData();
 
@@ -251,6 +259,8 @@ class GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY GeTensor {
   // Create from proto obj
   GeTensor(const ProtoMsgOwner &protoOnwer, proto::TensorDef *protoMsg);
   void BuildAlignerPtrWithProtoData();
+  // Copy in the weight which is still in the model file mapping
+  void MaterializeLazyData() const;
   GeIrProtoHelper<proto::TensorDef> tensor_def_;
   // Reference from tensor_data_, do not direct use
   mutable GeTensorDesc __desc_;
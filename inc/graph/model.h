@@ -67,7 +67,7 @@ class GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY Model : public AttrHolder {
   // Model will be rewrite
   static graphStatus Load(const uint8_t *data, size_t len, Model &model);
   graphStatus Load(ge::proto::ModelDef &model_def);
-  graphStatus LoadFromFile(const string& file_name);
+  graphStatus LoadFromFile(const string& file_name, bool lazy_load_weights = false);
 
   bool IsValid() const;
 
@@ -24,6 +24,7 @@
 #include "graph/model.h"
 
 namespace ge {
+class WeightsMapping;
 class ModelSerialize {
  public:
   Buffer SerializeModel(const Model &model, bool is_dump = false);
@@ -33,6 +34,8 @@ class ModelSerialize {
 
   bool UnserializeModel(const uint8_t *data, size_t len, Model &model);
   bool UnserializeModel(ge::proto::ModelDef &model_def, Model &model);
+  // Large const weights are kept in weights_mapping and copied in when they are touched
+  bool UnserializeModel(const std::shared_ptr<WeightsMapping> &weights_mapping, Model &model);
 
   Buffer SerializeGraph(const ComputeGraphPtr &graph);
 
@@ -17,6 +17,7 @@
 #ifndef INC_GRAPH_NODE_H_
 #define INC_GRAPH_NODE_H_
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <string>
@@ -34,6 +35,9 @@ class ComputeGraph;
 
 using ComputeGraphPtr = std::shared_ptr<ComputeGraph>;
 
+class GNode;
+class NodeInputsInfo;
+
 class Node;
 
 using NodePtr = std::shared_ptr<Node>;
@@ -182,6 +186,9 @@ class Node : public std::enable_shared_from_this<Node> {
 
   NodePtr GetOrigNode() { return orig_node_; }
 
+  // Changes with the links, indexes and statuses of the anchors of this node, and when anchors are added or removed
+  uint64_t GetAnchorsVersion() const { return anchors_version_.load(std::memory_order_acquire); }
+
  private:
   bool NodeMembersAreEqual(const Node &r_node) const;
   bool NodeAttrsAreEqual(const Node &r_node) const;
@@ -205,8 +212,20 @@ class Node : public std::enable_shared_from_this<Node> {
   kFusionDataFlowVec_t fusion_output_dataflow_list_;
 
   NodePtr orig_node_;
+  // external handle of this node, made by NodeAdapter on first use
+  std::shared_ptr<GNode> gnode_;
+  // const/data split of the inputs, made by OpDescUtils on first use
+  mutable std::shared_ptr<const NodeInputsInfo> inputs_info_;
+  void IncreaseAnchorsVersion() { (void)anchors_version_.fetch_add(1U, std::memory_order_acq_rel); }
+  std::atomic<uint64_t> anchors_version_{0U};
+  friend class Anchor;
+  friend class AnchorLinks;
+  friend class AnchorUtils;
+  friend class NodeAdapter;
+  friend class OpDescUtils;
   friend class NodeUtils;
   friend class OnnxUtils;
+  friend class OpDesc;
   friend class TuningUtils;
 };
 }  // namespace ge
@@ -39,6 +39,7 @@ using std::vector;
 
 class Operator;
 class GeTensorDesc;
+class Node;
 
 using GeTensorDescPtr = shared_ptr<GeTensorDesc>;
 using ConstGeTensorDescPtr = shared_ptr<const GeTensorDesc>;
@@ -298,6 +299,7 @@ class OpDesc : public std::enable_shared_from_this<OpDesc>, public AttrHolder {
   bool OpDescMembersAreEqual(const OpDesc &r_op_desc) const;
   bool OpDescAttrsAreEqual(const OpDesc &r_op_desc) const;
   bool OpDescGenTensorDescsAreEqual(const OpDesc &r_op_desc) const;
+  int32_t GetRegisteredOpTypeId();
 
   GeIrProtoHelper<ge::proto::OpDef> op_def_;
   std::vector<std::string> subgraph_instance_names_;
@@ -329,6 +331,10 @@ class OpDesc : public std::enable_shared_from_this<OpDesc>, public AttrHolder {
   std::function<graphStatus(Operator &)> infer_format_func_ = nullptr;
   std::function<graphStatus(Operator &)> verifier_func_ = nullptr;
   std::function<graphStatus(Operator &)> infer_data_slice_func_ = nullptr;
+  // interned id of the op type, resolved on the first lookup of registered functions
+  int32_t op_type_id_ = -1;
+  // node made from this OpDesc, a type change invalidates what it and its consumers cached about their inputs
+  std::weak_ptr<Node> owner_node_;
   string op_kernel_lib_name_;
   string engine_name_;
   friend class OpDescUtils;
@@ -337,6 +343,7 @@ class OpDesc : public std::enable_shared_from_this<OpDesc>, public AttrHolder {
   friend class GeAttrValueImp;
   friend class OnnxUtils;
   friend class GraphUtils;
+  friend class Node;
 };
 }  // namespace ge
 #endif  // INC_GRAPH_OP_DESC_H_
@@ -25,8 +25,23 @@
 #include "register/infer_data_slice_registry.h"
 
 namespace ge {
+// Dense id of a registered op type, ids are never reused
+using OpTypeId = int32_t;
+const OpTypeId kInvalidOpTypeId = -1;
+
+// Lookups and registrations may run on any thread. A deferred ops proto library is loaded before the id of
+// one of its types is returned, so the functions found for an id are complete.
 class GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY OperatorFactoryImpl {
  public:
+  // kInvalidOpTypeId if nothing has been registered for operator_type
+  static OpTypeId GetOpTypeId(const std::string &operator_type);
+
+  // Empty for kInvalidOpTypeId
+  static std::string GetOpType(OpTypeId type_id);
+
+  // Number of interned op types, ids of types registered later are not less than it
+  static size_t GetOpTypeNum();
+
   static Operator CreateOperator(const std::string &operator_name, const std::string &operator_type);
 
   static graphStatus GetOpsTypeList(std::vector<std::string> &all_ops);
@@ -41,6 +56,15 @@ class GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY OperatorFactoryImpl {
 
   static InferDataSliceFunc GetInferDataSliceFunc(const std::string &operator_type);
 
+  // The functions registered for type_id, returned by value so a later registration can not change them
+  static InferShapeFunc GetInferShapeFunc(OpTypeId type_id);
+
+  static InferFormatFunc GetInferFormatFunc(OpTypeId type_id);
+
+  static VerifyFunc GetVerifyFunc(OpTypeId type_id);
+
+  static InferDataSliceFunc GetInferDataSliceFunc(OpTypeId type_id);
+
   static graphStatus RegisterOperatorCreator(const std::string &operator_type, OpCreator const &op_creator);
 
   static graphStatus RegisterOperatorCreator(const std::string &operator_type, OpCreatorV2 const &op_creator);
@@ -54,12 +78,15 @@ class GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY OperatorFactoryImpl {
   static graphStatus RegisterInferDataSliceFunc(const std::string &operator_type,
                                                 InferDataSliceFunc const infer_data_slice_func);
 
+  // Views by op type kept for existing users. Lookups go through the interned records first, entries written
+  // here directly are still found after them
   static shared_ptr<std::map<string, OpCreator>> operator_creators_;
   static shared_ptr<std::map<string, OpCreatorV2>> operator_creators_v2_;
   static shared_ptr<std::map<string, InferShapeFunc>> operator_infershape_funcs_;
   static shared_ptr<std::map<string, InferFormatFunc>> operator_inferformat_funcs_;
   static shared_ptr<std::map<string, VerifyFunc>> operator_verify_funcs_;
   static shared_ptr<std::map<string, InferDataSliceFunc>> operator_infer_data_slice_funcs_;
+
 };
 }  // namespace ge
 
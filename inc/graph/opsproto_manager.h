@@ -18,8 +18,10 @@
 #define INC_GRAPH_OPSPROTO_MANAGER_H_
 
 #include <string.h>
+#include <atomic>
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <mutex>
 
@@ -28,16 +30,41 @@ class OpsProtoManager {
  public:
   static OpsProtoManager *Instance();
 
+  // Besides ge.opsProtoLibPath, ge.opsProtoManifestPath names a file caching which op types each library
+  // registers, and ge.opsProtoLazyLoad=1 defers loading the libraries the manifest knows to LoadOpsProto
   bool Initialize(const std::map<std::string, std::string> &options);
   void Finalize();
 
+  // Load the deferred library registering op_type, returns true if a library was loaded
+  bool LoadOpsProto(const std::string &op_type);
+  // Load all deferred libraries
+  void LoadAllOpsProto();
+
  private:
+  struct PluginInfo {
+    std::string path;
+    int64_t mtime = 0;
+    int64_t size = 0;
+    std::vector<std::string> op_types;
+  };
+
   void LoadOpsProtoPluginSo(std::string &path);
+  bool LoadPlugin(const std::string &path, std::vector<std::string> *op_types);
+  void LoadPendingPlugin(size_t index);
+  void ReadManifest(std::map<std::string, PluginInfo> &manifest) const;
+  void WriteManifest(const std::vector<PluginInfo> &plugins) const;
 
   std::string pluginPath_;
+  std::string manifestPath_;
+  bool lazyLoad_ = false;
   std::vector<void *> handles_;
+  // plugins known by the manifest but not loaded yet, indexed by the op types they register
+  std::vector<PluginInfo> pendingPlugins_;
+  std::unordered_map<std::string, size_t> pendingOpTypes_;
+  std::atomic<bool> hasPending_{false};
   bool is_init_ = false;
-  std::mutex mutex_;
+  // recursive since library initializers may look up op types while a library is being loaded
+  std::recursive_mutex mutex_;
 };
 }  // namespace ge
 
@@ -17,13 +17,23 @@
 #ifndef INC_GRAPH_SHAPE_REFINER_H_
 #define INC_GRAPH_SHAPE_REFINER_H_
 
+#include <cstdint>
 #include <string>
+#include <unordered_map>
 #include "external/graph/inference_context.h"
 
 #include "external/graph/ge_error_codes.h"
 #include "graph/node.h"
 
 namespace ge {
+// Counters of the infershape result cache, see ShapeRefiner::SetInferCacheCapacity
+struct InferCacheStats {
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  uint64_t bypasses = 0;
+  size_t entries = 0;
+};
+
 // ShapeRefiner performs shape inference for compute graphs
 class ShapeRefiner {
  public:
@@ -35,7 +45,24 @@ class ShapeRefiner {
   static graphStatus InferShapeAndTypeForRunning(const NodePtr &node, bool before_subgraph);
   static void ClearContextMap();
 
+  // Infer the nodes of a topologically sorted graph and their subgraphs. With thread_num > 1 the nodes
+  // of the same depth are inferred concurrently on at most ThreadPool::GetThreadNum threads, the result is
+  // identical to the serial run.
+  static graphStatus InferShapeAndTypeForGraph(const ComputeGraphPtr &graph, uint32_t thread_num);
+
+  // Memoize output descs of infer functions keyed by op type, attrs and in/out descs.
+  // Capacity 0 (default) disables the cache, otherwise the least recently used entries are evicted.
+  // Only enable it when infer functions are pure functions of those inputs.
+  static void SetInferCacheCapacity(size_t capacity);
+  static void ClearInferCache();
+  static InferCacheStats GetInferCacheStats();
+
  private:
+  using ContextMap = std::unordered_map<NodePtr, InferenceContextPtr>;
+  static graphStatus InferShapeAndType(const NodePtr &node, bool before_subgraph, const ContextMap &contexts,
+                                       InferenceContextPtr &output_context);
+  static graphStatus InferNodeAndSubgraphs(const NodePtr &node, const ContextMap &contexts, ContextMap &produced);
+  static graphStatus InferGraph(const ComputeGraphPtr &graph, ContextMap &contexts);
   static void PrintInOutTensorShape(const ge::NodePtr &node, const std::string &phase);
 };
 }  // namespace ge
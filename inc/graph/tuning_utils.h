@@ -95,8 +95,11 @@ class TuningUtils {
   };
   static graphStatus MakeExeGraph(ComputeGraphPtr &exe_graph,
                                   const HelpInfo& help_info);
+  static graphStatus MakeExeGraphs(std::vector<ComputeGraphPtr> &subgraphs,
+                                   const std::vector<HelpInfo> &help_infos);
   static graphStatus HandlePld(NodePtr &node);
-  static graphStatus HandleEnd(NodePtr &node);
+  // `out_node` is the NetOutput of the subgraph, it is created by the first end node
+  static graphStatus HandleEnd(NodePtr &node, NodePtr &out_node);
   static graphStatus ChangePld2Data(NodePtr &node, NodePtr &data_node);
   static graphStatus ChangeEnd2NetOutput(NodePtr &node, NodePtr &out_node);
   static graphStatus LinkEnd2NetOutput(NodePtr &node, NodePtr &out_node);
@@ -107,26 +110,30 @@ class TuningUtils {
   static void DumpGraphToPath(ComputeGraphPtr &exe_graph, int64_t index,
                               bool is_tuning_graph, std::string path);
 
-  static SubgraphCreateOutNode create_output_;
   // part 2
+  // State of one ConvertFileToGraph call, kept off the class so that calls do not share anything
+  struct MergeContext {
+    NodeNametoNodeNameMap data_2_netoutput;
+    // in subgraph order, so that the merged graph is linked the same way every time
+    std::vector<std::pair<NodePtr, std::string>> data_node_2_netoutput;
+    NodetoNodeMap data_node_2_netoutput_node;
+    NodeVec netoutput_nodes;
+    NodeVec merged_graph_nodes;
+  };
+  static graphStatus LoadSubGraphs(const map<int64_t, string> &options, std::vector<ComputeGraphPtr> &graphs);
   static graphStatus MergeAllSubGraph(std::vector<ComputeGraphPtr> &graphs,
-                                      ComputeGraphPtr &graph);
-  static graphStatus MergeSubGraph(ComputeGraphPtr &graph);
+                                      ComputeGraphPtr &graph,
+                                      MergeContext &context);
+  static graphStatus MergeSubGraph(ComputeGraphPtr &graph, MergeContext &context);
   // Deletes new data and output nodes added by call `MakeExeGraph()` func in part 1
-  static graphStatus RemoveDataNetoutputEdge(ComputeGraphPtr &graph);
+  static graphStatus RemoveDataNetoutputEdge(ComputeGraphPtr &graph, MergeContext &context);
   static graphStatus GetInAndOutAnchorPair(NodePtr &data_node,
                                            NodePtr &out_node,
                                            AnchorPtr &dest_in_anchor,
                                            AnchorPtr &src_out_anchor);
   static graphStatus HandleContinuousInputNodeNextData(NodePtr &node);
-  static NodeNametoNodeNameMap data_2_netoutput_;
-  static NodetoNodeNameMap data_node_2_netoutput_;
-  static NodetoNodeMap data_node_2_netoutput_node_;
-  static NodeVec netoutput_nodes_;
-  static NodeVec merged_graph_nodes_;
-  static std::mutex mutex_;
   // for debug
-  static std::string PrintCheckLog();
+  static std::string PrintCheckLog(const MergeContext &context);
   static std::string GetNodeNameByAnchor(const Anchor *anchor);
 };
 }
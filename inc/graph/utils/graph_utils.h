@@ -230,6 +230,9 @@ class GraphUtils {
                                   const std::string &path,
                                   const std::string &suffix);
 
+  // DumpGEGraph and DumpGEGraphToOnnx write debug dumps in the background, this waits until they are on disk
+  static void FlushGraphDump();
+
   static bool LoadGEGraph(const char *file, ge::ComputeGraph &compute_graph);
 
   static bool LoadGEGraph(const char *file, ge::ComputeGraphPtr &compute_graph);
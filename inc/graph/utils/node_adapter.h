@@ -26,6 +26,7 @@ class GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY NodeAdapter {
  public:
   static GNode Node2GNode(const NodePtr &node);
   static NodePtr GNode2Node(const GNode &node);
+  // The handle is made once per node and shared by every caller
   static GNodePtr Node2GNodePtr(const NodePtr &node);
 };
 }  // namespace ge
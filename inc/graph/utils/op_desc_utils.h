@@ -92,6 +92,9 @@ class OpDescUtils {
       const std::string &subgraph_instance_name, OpDescPtr &op_desc);
 
  private:
+  // Cached on the node until its anchors version changes
+  static std::shared_ptr<const NodeInputsInfo> GetInputsInfo(const ge::Node &node);
+  static std::shared_ptr<const NodeInputsInfo> BuildInputsInfo(const ge::Node &node, uint64_t anchors_version);
   static GeTensorPtr MutableWeights(ge::OpDesc& op_desc);
   static GeTensorPtr MutableWeights(ge::OpDescPtr op_desc);
   static graphStatus SetWeights(ge::OpDesc& op_desc, const GeTensorPtr weight);
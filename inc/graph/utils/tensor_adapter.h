@@ -24,11 +24,15 @@
 namespace ge {
 using GeTensorPtr = std::shared_ptr<GeTensor>;
 using ConstGeTensorPtr = std::shared_ptr<const GeTensor>;
+using ConstGeTensorDescPtr = std::shared_ptr<const GeTensorDesc>;
 
 class GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY TensorAdapter {
  public:
   static GeTensorDesc TensorDesc2GeTensorDesc(const TensorDesc &tensorDesc);
   static TensorDesc GeTensorDesc2TensorDesc(const GeTensorDesc &geTensorDesc);
+  // Fills tensorDesc with the fields of geTensorDesc without copying its attrs. Converting it back with
+  // TensorDesc2GeTensorDesc starts from geTensorDesc, so the attrs TensorDesc does not carry are kept
+  static void AsTensorDesc(const ConstGeTensorDescPtr &geTensorDesc, TensorDesc &tensorDesc);
   static GeTensorPtr Tensor2GeTensor(const Tensor &tensor);
   static Tensor GeTensor2Tensor(const ConstGeTensorPtr &geTensor);
 
@@ -0,0 +1,78 @@
+/**
+ * Copyright 2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INC_GRAPH_UTILS_THREAD_POOL_H_
+#define INC_GRAPH_UTILS_THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+#include "graph/types.h"
+
+namespace ge {
+using ThreadTask = std::function<void()>;
+
+class GE_FUNC_HOST_VISIBILITY GE_FUNC_DEV_VISIBILITY ThreadPool {
+ public:
+  explicit ThreadPool(uint32_t size = 4U);
+  ~ThreadPool();
+
+  // Number of workers to use for num_tasks independent tasks, bounded by the hardware concurrency
+  static uint32_t GetThreadNum(size_t num_tasks);
+
+  // The returned future is invalid if the pool has been stopped
+  template <class Func, class... Args>
+  auto Commit(Func &&func, Args &&... args) -> std::future<decltype(func(args...))> {
+    using RetType = decltype(func(args...));
+    std::future<RetType> fail_future;
+    if (is_stoped_.load()) {
+      return fail_future;
+    }
+
+    auto bind_func = std::bind(std::forward<Func>(func), std::forward<Args>(args)...);
+    auto task = std::shared_ptr<std::packaged_task<RetType()>>(new (std::nothrow)
+                                                                   std::packaged_task<RetType()>(bind_func));
+    if (task == nullptr) {
+      return fail_future;
+    }
+    std::future<RetType> future = task->get_future();
+    {
+      std::lock_guard<std::mutex> lock{m_lock_};
+      tasks_.emplace([task]() { (*task)(); });
+    }
+    cond_var_.notify_one();
+    return future;
+  }
+
+  static void ThreadFunc(ThreadPool *thread_pool);
+
+ private:
+  std::vector<std::thread> pool_;
+  std::queue<ThreadTask> tasks_;
+  std::mutex m_lock_;
+  std::condition_variable cond_var_;
+  std::atomic<bool> is_stoped_;
+  std::atomic<uint32_t> idle_thrd_num_;
+};
+}  // namespace ge
+
+#endif  // INC_GRAPH_UTILS_THREAD_POOL_H_
@@ -17,7 +17,9 @@
 #ifndef INC_REGISTER_CUSTOM_PASS_HELPER_H_
 #define INC_REGISTER_CUSTOM_PASS_HELPER_H_
 
-#include <set>
+#include <cstdint>
+#include <string>
+#include <vector>
 #include "external/ge/ge_api_error_codes.h"
 #include "external/register/register_pass.h"
 #include "external/register/register_types.h"
@@ -30,19 +32,50 @@ class CustomPassGreater : std::greater<PassRegistrationData> {
   }
 };
 
+struct CustomPassStat {
+  std::string pass_name;
+  int32_t priority;
+  bool read_only;
+  // not run because the time budget was used up
+  bool skipped;
+  Status status;
+  uint64_t cost_us;
+};
+
 class CustomPassHelper {
  public:
   static CustomPassHelper &Instance();
 
   void Insert(const PassRegistrationData &);
 
+  // Runs the passes in priority order. Consecutive read-only passes run in parallel.
   Status Run(ge::GraphPtr &);
 
+  // Same as Run, pass_stats gets one entry per registered pass in run order
+  Status Run(ge::GraphPtr &graph, std::vector<CustomPassStat> &pass_stats);
+
+  // Once budget_us is used up, the remaining passes with priority greater than keep_priority are skipped.
+  // A budget of 0 means no limit.
+  void SetTimeBudget(uint64_t budget_us, int32_t keep_priority = 0);
+
   ~CustomPassHelper() = default;
 
  private:
+  struct PassEntry {
+    PassRegistrationData reg_data;
+    CustomPassFunc custom_pass_fn;
+    bool read_only;
+  };
+
   CustomPassHelper() = default;
-  std::multiset<PassRegistrationData, CustomPassGreater> registration_datas_;
+  bool IsOverBudget(uint64_t cost_us, const PassEntry &entry) const;
+  Status RunPass(const PassEntry &entry, ge::GraphPtr &graph, CustomPassStat &stat) const;
+  Status RunParallel(size_t begin, size_t end, ge::GraphPtr &graph, std::vector<CustomPassStat> &pass_stats) const;
+
+  // sorted by priority, passes of equal priority keep their registration order
+  std::vector<PassEntry> registration_datas_;
+  uint64_t time_budget_us_ = 0U;
+  int32_t keep_priority_ = 0;
 };
 } // namespace ge
 
@@ -19,6 +19,7 @@
 
 #include <functional>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "external/graph/types.h"
@@ -55,9 +56,23 @@ class FormatTransfer {
 
 using FormatTransferBuilder = std::function<std::shared_ptr<FormatTransfer>()>;
 
+// CPU features a format transfer implementation may require, checked at runtime
+enum CpuFeature {
+  kCpuFeatureNone = 0,
+  kCpuFeatureSse2,
+  kCpuFeatureAvx2,
+  kCpuFeatureNeon,
+};
+
+bool CpuFeatureSupported(CpuFeature feature);
+
 class FormatTransferRegister {
  public:
   FormatTransferRegister(FormatTransferBuilder builder, Format src, Format dst);
+  // A format pair may have several implementations, the supported one with the highest priority is built.
+  // Registering the same impl_name again for a pair replaces it.
+  FormatTransferRegister(FormatTransferBuilder builder, Format src, Format dst, const std::string &impl_name,
+                         CpuFeature feature, int32_t priority);
   ~FormatTransferRegister() = default;
 };
 
@@ -67,13 +82,25 @@ class FormatTransferRegister {
       []() { return std::make_shared<TransferClass>(); }, format1, format2);         \
   }
 
+#define REGISTER_FORMAT_TRANSFER_IMPL(TransferClass, format1, format2, impl_name, feature, priority)       \
+  namespace {                                                                                              \
+  FormatTransferRegister format_transfer_register_##TransferClass##format1##format2(                       \
+      []() { return std::make_shared<TransferClass>(); }, format1, format2, impl_name, feature, priority); \
+  }
+
 /// Build a formattransfer according to 'args'
 /// @param args
 /// @param result
 /// @return
 std::shared_ptr<FormatTransfer> BuildFormatTransfer(const TransArgs &args);
 
+/// Build the implementation named 'impl_name', nullptr if it is not registered or the CPU lacks its feature
+std::shared_ptr<FormatTransfer> BuildFormatTransfer(const TransArgs &args, const std::string &impl_name);
+
 bool FormatTransferExists(const TransArgs &args);
+
+/// Names of the implementations registered for a format pair, best first
+std::vector<std::string> GetFormatTransferImpls(Format src_format, Format dst_format);
 }  // namespace formats
 }  // namespace ge
 #endif  // INC_REGISTER_REGISTER_FORMAT_TRANSFER_H_
\ No newline at end of file
@@ -77,27 +77,12 @@ class TensorAssign {
 
   template <typename T>
   static Status GetVal(int32_t val_size, const google::protobuf::RepeatedField<T> &val_vector, int count,
-                       GeTensorPtr &weight) {
-    bool zerosLike = (count != val_size && val_size == 1);
-    T *addr = new (std::nothrow) T[count]();
-    GE_CHECK_NOTNULL(addr);
-    int minCount = (count > val_size) ? val_size : count;
-    if (!zerosLike) {
-      for (int32_t i = 0; i < minCount; i++) {
-        *(addr + i) = val_vector.Get(i);
-      }
-      for (int32_t i = minCount; i < count; i++) {
-        *(addr + i) = val_vector.Get(minCount - 1);
-      }
-    } else {
-      for (int32_t i = 0; i < count; i++) {
-        *(addr + i) = val_vector.Get(0);
-      }
-    }
-    (void)weight->SetData(reinterpret_cast<uint8_t *>(addr), count * sizeof(T));
-    GE_DELETE_NEW_ARRAY(addr);
-    return SUCCESS;
-  }
+                       GeTensorPtr &weight);
+
+  // Writes val_vector converted to T straight into the weight buffer, the last value fills up to count
+  template <typename T, typename V>
+  static Status FillWeightVal(int32_t val_size, const google::protobuf::RepeatedField<V> &val_vector, int count,
+                              GeTensorPtr &weight);
 };
 }  // namespace domi
 #endif  // TENSOR_ASSIGN_H_
@@ -0,0 +1,711 @@
+/**
+ * Copyright 2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+#include <algorithm>
+#include <memory>
+#include <new>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#include "framework/common/debug/ge_log.h"
+#include "register/register_format_transfer.h"
+
+namespace ge {
+namespace formats {
+namespace {
+const int64_t kCubeSize = 16;
+const int64_t kInt8CubeSize = 32;
+const int64_t kTileSize = 32;
+const size_t kNchwDimNum = 4;
+const size_t kNhwcDimNum = 4;
+const size_t kNc1hwc0DimNum = 5;
+
+const char *const kReferenceImpl = "reference";
+const char *const kBlockedImpl = "blocked";
+const char *const kSse2Impl = "sse2";
+const char *const kAvx2Impl = "avx2";
+const char *const kNeonImpl = "neon";
+// All below the priority 0 of REGISTER_FORMAT_TRANSFER, so a transfer registered by the framework keeps being
+// used whatever the static initialization order, these only serve pairs nobody else registers
+const int32_t kReferencePriority = -40;
+const int32_t kBlockedPriority = -30;
+const int32_t kSimdPriority = -10;
+// the 8x8 AVX2 block measured no faster than the 4x4 SSE2 one for these memory bound moves, keep it opt-in by name
+const int32_t kAvx2Priority = -20;
+
+// dst[j * dst_stride + i] = src[i * src_stride + j] for i < rows and j < cols, strides are in elements
+template <typename T>
+using TransposeFunc = void (*)(const T *src, int64_t src_stride, int64_t rows, int64_t cols, T *dst,
+                               int64_t dst_stride);
+// copies rows of row_bytes between strided buffers, strides are in bytes
+using CopyRowsFunc = void (*)(const uint8_t *src, int64_t src_stride, int64_t rows, int64_t row_bytes, uint8_t *dst,
+                              int64_t dst_stride);
+
+// One implementation of the data movement shared by all C0 format pairs
+struct FormatKernels {
+  CopyRowsFunc copy_rows;
+  TransposeFunc<uint8_t> transpose8;
+  TransposeFunc<uint16_t> transpose16;
+  TransposeFunc<uint32_t> transpose32;
+  TransposeFunc<uint64_t> transpose64;
+};
+
+void CopyRowsReference(const uint8_t *src, int64_t src_stride, int64_t rows, int64_t row_bytes, uint8_t *dst,
+                       int64_t dst_stride) {
+  for (int64_t i = 0; i < rows; ++i) {
+    for (int64_t j = 0; j < row_bytes; ++j) {
+      dst[i * dst_stride + j] = src[i * src_stride + j];
+    }
+  }
+}
+
+void CopyRowsMemcpy(const uint8_t *src, int64_t src_stride, int64_t rows, int64_t row_bytes, uint8_t *dst,
+                    int64_t dst_stride) {
+  for (int64_t i = 0; i < rows; ++i) {
+    (void)memcpy(dst + i * dst_stride, src + i * src_stride, static_cast<size_t>(row_bytes));
+  }
+}
+
+// Walks the destination in order, the way the transfers in GE are usually written
+template <typename T>
+void TransposeReference(const T *src, int64_t src_stride, int64_t rows, int64_t cols, T *dst, int64_t dst_stride) {
+  for (int64_t j = 0; j < cols; ++j) {
+    for (int64_t i = 0; i < rows; ++i) {
+      dst[j * dst_stride + i] = src[i * src_stride + j];
+    }
+  }
+}
+
+template <typename T>
+inline void TransposeRange(const T *src, int64_t src_stride, int64_t i_begin, int64_t i_end, int64_t j_begin,
+                           int64_t j_end, T *dst, int64_t dst_stride) {
+  for (int64_t j = j_begin; j < j_end; ++j) {
+    for (int64_t i = i_begin; i < i_end; ++i) {
+      dst[j * dst_stride + i] = src[i * src_stride + j];
+    }
+  }
+}
+
+// Square tiles keep both the strided reads and the strided writes inside L1
+template <typename T>
+void TransposeBlocked(const T *src, int64_t src_stride, int64_t rows, int64_t cols, T *dst, int64_t dst_stride) {
+  for (int64_t i0 = 0; i0 < rows; i0 += kTileSize) {
+    const int64_t i_end = std::min(i0 + kTileSize, rows);
+    for (int64_t j0 = 0; j0 < cols; j0 += kTileSize) {
+      TransposeRange(src, src_stride, i0, i_end, j0, std::min(j0 + kTileSize, cols), dst, dst_stride);
+    }
+  }
+}
+
+// Tiles like TransposeBlocked and moves kBlock x kBlock squares with BlockFn, the edges are done one by one
+template <typename T, int64_t kBlock, void (*BlockFn)(const T *, int64_t, T *, int64_t)>
+void TransposeSimd(const T *src, int64_t src_stride, int64_t rows, int64_t cols, T *dst, int64_t dst_stride) {
+  const int64_t rows_end = rows - (rows % kBlock);
+  const int64_t cols_end = cols - (cols % kBlock);
+  for (int64_t i0 = 0; i0 < rows_end; i0 += kTileSize) {
+    const int64_t i_end = std::min(i0 + kTileSize, rows_end);
+    for (int64_t j0 = 0; j0 < cols_end; j0 += kTileSize) {
+      const int64_t j_end = std::min(j0 + kTileSize, cols_end);
+      for (int64_t j = j0; j < j_end; j += kBlock) {
+        for (int64_t i = i0; i < i_end; i += kBlock) {
+          BlockFn(src + i * src_stride + j, src_stride, dst + j * dst_stride + i, dst_stride);
+        }
+      }
+    }
+  }
+  TransposeRange(src, src_stride, 0, rows_end, cols_end, cols, dst, dst_stride);
+  TransposeRange(src, src_stride, rows_end, rows, 0, cols, dst, dst_stride);
+}
+
+#if defined(__x86_64__)
+inline void Transpose4x4Sse2(const uint32_t *src, int64_t src_stride, uint32_t *dst, int64_t dst_stride) {
+  __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+  __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + src_stride));
+  __m128i a2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 2 * src_stride));
+  __m128i a3 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 3 * src_stride));
+  __m128i t0 = _mm_unpacklo_epi32(a0, a1);
+  __m128i t1 = _mm_unpacklo_epi32(a2, a3);
+  __m128i t2 = _mm_unpackhi_epi32(a0, a1);
+  __m128i t3 = _mm_unpackhi_epi32(a2, a3);
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_unpacklo_epi64(t0, t1));
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + dst_stride), _mm_unpackhi_epi64(t0, t1));
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 2 * dst_stride), _mm_unpacklo_epi64(t2, t3));
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 3 * dst_stride), _mm_unpackhi_epi64(t2, t3));
+}
+
+inline void Transpose8x8Sse2(const uint16_t *src, int64_t src_stride, uint16_t *dst, int64_t dst_stride) {
+  // written out so the whole block stays in registers
+  __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+  __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + src_stride));
+  __m128i a2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 2 * src_stride));
+  __m128i a3 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 3 * src_stride));
+  __m128i a4 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 4 * src_stride));
+  __m128i a5 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 5 * src_stride));
+  __m128i a6 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 6 * src_stride));
+  __m128i a7 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 7 * src_stride));
+  __m128i t0 = _mm_unpacklo_epi16(a0, a1);
+  __m128i t1 = _mm_unpackhi_epi16(a0, a1);
+  __m128i t2 = _mm_unpacklo_epi16(a2, a3);
+  __m128i t3 = _mm_unpackhi_epi16(a2, a3);
+  __m128i t4 = _mm_unpacklo_epi16(a4, a5);
+  __m128i t5 = _mm_unpackhi_epi16(a4, a5);
+  __m128i t6 = _mm_unpacklo_epi16(a6, a7);
+  __m128i t7 = _mm_unpackhi_epi16(a6, a7);
+  // uk holds columns 2k and 2k+1 of rows 0-3, uk+4 the same of rows 4-7
+  __m128i u0 = _mm_unpacklo_epi32(t0, t2);
+  __m128i u1 = _mm_unpackhi_epi32(t0, t2);
+  __m128i u2 = _mm_unpacklo_epi32(t1, t3);
+  __m128i u3 = _mm_unpackhi_epi32(t1, t3);
+  __m128i u4 = _mm_unpacklo_epi32(t4, t6);
+  __m128i u5 = _mm_unpackhi_epi32(t4, t6);
+  __m128i u6 = _mm_unpacklo_epi32(t5, t7);
+  __m128i u7 = _mm_unpackhi_epi32(t5, t7);
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_unpacklo_epi64(u0, u4));
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + dst_stride), _mm_unpackhi_epi64(u0, u4));
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 2 * dst_stride), _mm_unpacklo_epi64(u1, u5));
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 3 * dst_stride), _mm_unpackhi_epi64(u1, u5));
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 4 * dst_stride), _mm_unpacklo_epi64(u2, u6));
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 5 * dst_stride), _mm_unpackhi_epi64(u2, u6));
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 6 * dst_stride), _mm_unpacklo_epi64(u3, u7));
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 7 * dst_stride), _mm_unpackhi_epi64(u3, u7));
+}
+
+__attribute__((target("avx2"), always_inline)) inline void Transpose8x8Avx2(const uint32_t *src,
+                                                                            int64_t src_stride, uint32_t *dst,
+                                                                            int64_t dst_stride) {
+  __m256i a0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+  __m256i a1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + src_stride));
+  __m256i a2 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 2 * src_stride));
+  __m256i a3 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 3 * src_stride));
+  __m256i a4 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 4 * src_stride));
+  __m256i a5 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 5 * src_stride));
+  __m256i a6 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 6 * src_stride));
+  __m256i a7 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 7 * src_stride));
+  __m256i t0 = _mm256_unpacklo_epi32(a0, a1);
+  __m256i t1 = _mm256_unpackhi_epi32(a0, a1);
+  __m256i t2 = _mm256_unpacklo_epi32(a2, a3);
+  __m256i t3 = _mm256_unpackhi_epi32(a2, a3);
+  __m256i t4 = _mm256_unpacklo_epi32(a4, a5);
+  __m256i t5 = _mm256_unpackhi_epi32(a4, a5);
+  __m256i t6 = _mm256_unpacklo_epi32(a6, a7);
+  __m256i t7 = _mm256_unpackhi_epi32(a6, a7);
+  // per 128-bit lane uk holds column k of rows 0-3 and column k + 4, uk+4 the same of rows 4-7
+  __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+  __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+  __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+  __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+  __m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+  __m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+  __m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+  __m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), _mm256_permute2x128_si256(u0, u4, 0x20));
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + dst_stride), _mm256_permute2x128_si256(u1, u5, 0x20));
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 2 * dst_stride), _mm256_permute2x128_si256(u2, u6, 0x20));
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 3 * dst_stride), _mm256_permute2x128_si256(u3, u7, 0x20));
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 4 * dst_stride), _mm256_permute2x128_si256(u0, u4, 0x31));
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 5 * dst_stride), _mm256_permute2x128_si256(u1, u5, 0x31));
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 6 * dst_stride), _mm256_permute2x128_si256(u2, u6, 0x31));
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 7 * dst_stride), _mm256_permute2x128_si256(u3, u7, 0x31));
+}
+
+// Same tiling as TransposeSimd, compiled for AVX2 so the 8x8 blocks are inlined
+__attribute__((target("avx2"))) void TransposeAvx2(const uint32_t *src, int64_t src_stride, int64_t rows,
+                                                    int64_t cols, uint32_t *dst, int64_t dst_stride) {
+  const int64_t kBlock = 8;
+  const int64_t rows_end = rows - (rows % kBlock);
+  const int64_t cols_end = cols - (cols % kBlock);
+  for (int64_t i0 = 0; i0 < rows_end; i0 += kTileSize) {
+    const int64_t i_end = std::min(i0 + kTileSize, rows_end);
+    for (int64_t j0 = 0; j0 < cols_end; j0 += kTileSize) {
+      const int64_t j_end = std::min(j0 + kTileSize, cols_end);
+      for (int64_t j = j0; j < j_end; j += kBlock) {
+        for (int64_t i = i0; i < i_end; i += kBlock) {
+          Transpose8x8Avx2(src + i * src_stride + j, src_stride, dst + j * dst_stride + i, dst_stride);
+        }
+      }
+    }
+  }
+  TransposeRange(src, src_stride, 0, rows_end, cols_end, cols, dst, dst_stride);
+  TransposeRange(src, src_stride, rows_end, rows, 0, cols, dst, dst_stride);
+}
+#endif
+
+#if defined(__aarch64__)
+inline void Transpose4x4Neon(const uint32_t *src, int64_t src_stride, uint32_t *dst, int64_t dst_stride) {
+  uint32x4x2_t t01 = vtrnq_u32(vld1q_u32(src), vld1q_u32(src + src_stride));
+  uint32x4x2_t t23 = vtrnq_u32(vld1q_u32(src + 2 * src_stride), vld1q_u32(src + 3 * src_stride));
+  vst1q_u32(dst, vcombine_u32(vget_low_u32(t01.val[0]), vget_low_u32(t23.val[0])));
+  vst1q_u32(dst + dst_stride, vcombine_u32(vget_low_u32(t01.val[1]), vget_low_u32(t23.val[1])));
+  vst1q_u32(dst + 2 * dst_stride, vcombine_u32(vget_high_u32(t01.val[0]), vget_high_u32(t23.val[0])));
+  vst1q_u32(dst + 3 * dst_stride, vcombine_u32(vget_high_u32(t01.val[1]), vget_high_u32(t23.val[1])));
+}
+
+inline void Transpose8x8Neon(const uint16_t *src, int64_t src_stride, uint16_t *dst, int64_t dst_stride) {
+  uint16x8x2_t b[4];
+  for (int64_t i = 0; i < 4; ++i) {
+    b[i] = vtrnq_u16(vld1q_u16(src + 2 * i * src_stride), vld1q_u16(src + (2 * i + 1) * src_stride));
+  }
+  // c[0]/c[2] hold columns 0,4 and 2,6, c[1]/c[3] hold columns 1,5 and 3,7, of rows 0-3 and rows 4-7
+  uint32x4x2_t c[4];
+  c[0] = vtrnq_u32(vreinterpretq_u32_u16(b[0].val[0]), vreinterpretq_u32_u16(b[1].val[0]));
+  c[1] = vtrnq_u32(vreinterpretq_u32_u16(b[0].val[1]), vreinterpretq_u32_u16(b[1].val[1]));
+  c[2] = vtrnq_u32(vreinterpretq_u32_u16(b[2].val[0]), vreinterpretq_u32_u16(b[3].val[0]));
+  c[3] = vtrnq_u32(vreinterpretq_u32_u16(b[2].val[1]), vreinterpretq_u32_u16(b[3].val[1]));
+  for (int64_t k = 0; k < 2; ++k) {
+    for (int64_t odd = 0; odd < 2; ++odd) {
+      const uint32x4_t &top = c[odd].val[k];
+      const uint32x4_t &bottom = c[odd + 2].val[k];
+      const int64_t col = 2 * k + odd;
+      vst1q_u16(dst + col * dst_stride,
+                vreinterpretq_u16_u32(vcombine_u32(vget_low_u32(top), vget_low_u32(bottom))));
+      vst1q_u16(dst + (col + 4) * dst_stride,
+                vreinterpretq_u16_u32(vcombine_u32(vget_high_u32(top), vget_high_u32(bottom))));
+    }
+  }
+}
+#endif
+
+const FormatKernels kReferenceKernels = {CopyRowsReference, TransposeReference<uint8_t>, TransposeReference<uint16_t>,
+                                         TransposeReference<uint32_t>, TransposeReference<uint64_t>};
+const FormatKernels kBlockedKernels = {CopyRowsMemcpy, TransposeBlocked<uint8_t>, TransposeBlocked<uint16_t>,
+                                       TransposeBlocked<uint32_t>, TransposeBlocked<uint64_t>};
+#if defined(__x86_64__)
+const FormatKernels kSse2Kernels = {CopyRowsMemcpy, TransposeBlocked<uint8_t>,
+                                    TransposeSimd<uint16_t, 8, Transpose8x8Sse2>,
+                                    TransposeSimd<uint32_t, 4, Transpose4x4Sse2>, TransposeBlocked<uint64_t>};
+const FormatKernels kAvx2Kernels = {CopyRowsMemcpy, TransposeBlocked<uint8_t>,
+                                    TransposeSimd<uint16_t, 8, Transpose8x8Sse2>, TransposeAvx2,
+                                    TransposeBlocked<uint64_t>};
+#endif
+#if defined(__aarch64__)
+const FormatKernels kNeonKernels = {CopyRowsMemcpy, TransposeBlocked<uint8_t>,
+                                    TransposeSimd<uint16_t, 8, Transpose8x8Neon>,
+                                    TransposeSimd<uint32_t, 4, Transpose4x4Neon>, TransposeBlocked<uint64_t>};
+#endif
+
+int64_t CeilDiv(int64_t value, int64_t divisor) {
+  return (value + divisor - 1) / divisor;
+}
+
+int64_t GetC0(DataType data_type) {
+  return (GetSizeByDataType(data_type) == 1) ? kInt8CubeSize : kCubeSize;
+}
+
+bool CheckDataType(DataType data_type) {
+  const int size = GetSizeByDataType(data_type);
+  return (size == 1) || (size == 2) || (size == 4) || (size == 8);
+}
+
+bool CheckShape(const std::vector<int64_t> &shape, size_t dim_num) {
+  if (shape.size() != dim_num) {
+    return false;
+  }
+  return std::all_of(shape.begin(), shape.end(), [](int64_t dim) { return dim > 0; });
+}
+
+// Element count of the shape, -1 when it does not fit in int64 bytes of element_size
+int64_t GetShapeSize(const std::vector<int64_t> &shape, int64_t element_size) {
+  int64_t size = element_size;
+  for (auto dim : shape) {
+    if ((dim <= 0) || (size > INT64_MAX / dim)) {
+      return -1;
+    }
+    size *= dim;
+  }
+  return size / element_size;
+}
+
+class C0FormatTransfer : public FormatTransfer {
+ public:
+  explicit C0FormatTransfer(const FormatKernels &kernels) : kernels_(kernels) {}
+  ~C0FormatTransfer() override = default;
+
+  Status TransFormat(const TransArgs &args, TransResult &result) override {
+    // groups and other sub formats change the layout, they are left to the transfers of the framework
+    if (HasSubFormat(args.src_format) || HasSubFormat(args.dst_format)) {
+      GELOGE(ACL_ERROR_GE_PARAM_INVALID, "Trans format from %d to %d, sub format is not supported",
+             args.src_format, args.dst_format);
+      return ACL_ERROR_GE_PARAM_INVALID;
+    }
+    if (!CheckDataType(args.src_data_type)) {
+      GELOGE(ACL_ERROR_GE_PARAM_INVALID, "Trans format from %d to %d, data type %d is not supported",
+             args.src_format, args.dst_format, args.src_data_type);
+      return ACL_ERROR_GE_PARAM_INVALID;
+    }
+    const int64_t element_size = GetSizeByDataType(args.src_data_type);
+    Status ret = CheckArgs(args);
+    if (ret != SUCCESS) {
+      return ret;
+    }
+    const int64_t dst_num = GetShapeSize(args.dst_shape, element_size);
+    if ((dst_num < 0) || (GetShapeSize(args.src_shape, element_size) < 0) || (args.data == nullptr)) {
+      GELOGE(ACL_ERROR_GE_PARAM_INVALID, "Trans format from %d to %d, invalid data or shape size", args.src_format,
+             args.dst_format);
+      return ACL_ERROR_GE_PARAM_INVALID;
+    }
+    const size_t length = static_cast<size_t>(dst_num * element_size);
+    // padded lanes are never written by the kernels, they have to start as zero
+    uint8_t *buffer = NeedZeroPadding(args) ? new (std::nothrow) uint8_t[length]() : new (std::nothrow) uint8_t[length];
+    if (buffer == nullptr) {
+      GELOGE(ACL_ERROR_GE_MEMORY_ALLOCATION, "Trans format from %d to %d, failed to alloc %zu bytes",
+             args.src_format, args.dst_format, length);
+      return ACL_ERROR_GE_MEMORY_ALLOCATION;
+    }
+    result.data = std::shared_ptr<uint8_t>(buffer, std::default_delete<uint8_t[]>());
+    result.length = length;
+    Move(args, element_size, buffer);
+    return SUCCESS;
+  }
+
+  Status TransShape(Format src_format, const std::vector<int64_t> &src_shape, DataType data_type, Format dst_format,
+                    std::vector<int64_t> &dst_shape) override {
+    if (HasSubFormat(src_format) || HasSubFormat(dst_format)) {
+      return ACL_ERROR_GE_TRANSSHAPE_FORMAT_INVALID;
+    }
+    if (!CheckDataType(data_type)) {
+      return ACL_ERROR_GE_TRANSSHAPE_DATATYPE_INVALID;
+    }
+    return GetDstShape(src_format, src_shape, GetC0(data_type), dst_format, dst_shape);
+  }
+
+ protected:
+  // Checks src_shape and dst_shape against each other
+  virtual Status CheckArgs(const TransArgs &args) = 0;
+  virtual bool NeedZeroPadding(const TransArgs &args) const = 0;
+  virtual void Move(const TransArgs &args, int64_t element_size, uint8_t *dst) const = 0;
+  virtual Status GetDstShape(Format src_format, const std::vector<int64_t> &src_shape, int64_t c0, Format dst_format,
+                             std::vector<int64_t> &dst_shape) = 0;
+
+  Status CheckExpectedShape(const TransArgs &args, const std::vector<int64_t> &shape,
+                            const std::vector<int64_t> &expect_shape) const {
+    if (shape != expect_shape) {
+      GELOGE(ACL_ERROR_GE_PARAM_INVALID, "Trans format from %d to %d, src shape and dst shape do not match",
+             args.src_format, args.dst_format);
+      return ACL_ERROR_GE_PARAM_INVALID;
+    }
+    return SUCCESS;
+  }
+
+  void Transpose(int64_t element_size, const uint8_t *src, int64_t src_stride, int64_t rows, int64_t cols,
+                 uint8_t *dst, int64_t dst_stride) const {
+    if (element_size == sizeof(uint64_t)) {
+      kernels_.transpose64(reinterpret_cast<const uint64_t *>(src), src_stride, rows, cols,
+                           reinterpret_cast<uint64_t *>(dst), dst_stride);
+    } else if (element_size == sizeof(uint32_t)) {
+      kernels_.transpose32(reinterpret_cast<const uint32_t *>(src), src_stride, rows, cols,
+                           reinterpret_cast<uint32_t *>(dst), dst_stride);
+    } else if (element_size == sizeof(uint16_t)) {
+      kernels_.transpose16(reinterpret_cast<const uint16_t *>(src), src_stride, rows, cols,
+                           reinterpret_cast<uint16_t *>(dst), dst_stride);
+    } else {
+      kernels_.transpose8(src, src_stride, rows, cols, dst, dst_stride);
+    }
+  }
+
+  FormatKernels kernels_;
+};
+
+// NCHW to NC1HWC0 transposes each C0 x HW panel
+class FormatTransferNchwNc1hwc0 : public C0FormatTransfer {
+ public:
+  using C0FormatTransfer::C0FormatTransfer;
+
+ protected:
+  Status CheckArgs(const TransArgs &args) override {
+    if (!CheckShape(args.src_shape, kNchwDimNum)) {
+      GELOGE(ACL_ERROR_GE_PARAM_INVALID, "Trans format from NCHW to NC1HWC0, invalid src shape");
+      return ACL_ERROR_GE_PARAM_INVALID;
+    }
+    std::vector<int64_t> expect_shape;
+    (void)GetDstShape(args.src_format, args.src_shape, GetC0(args.src_data_type), args.dst_format, expect_shape);
+    return CheckExpectedShape(args, args.dst_shape, expect_shape);
+  }
+
+  bool NeedZeroPadding(const TransArgs &args) const override {
+    return (args.src_shape[1] % GetC0(args.src_data_type)) != 0;
+  }
+
+  void Move(const TransArgs &args, int64_t element_size, uint8_t *dst) const override {
+    const int64_t n = args.src_shape[0];
+    const int64_t c = args.src_shape[1];
+    const int64_t hw = args.src_shape[2] * args.src_shape[3];
+    const int64_t c0 = GetC0(args.src_data_type);
+    const int64_t c1 = CeilDiv(c, c0);
+    for (int64_t n_idx = 0; n_idx < n; ++n_idx) {
+      for (int64_t c1_idx = 0; c1_idx < c1; ++c1_idx) {
+        const int64_t c_num = std::min(c0, c - c1_idx * c0);
+        const uint8_t *src_panel = args.data + (n_idx * c + c1_idx * c0) * hw * element_size;
+        uint8_t *dst_panel = dst + (n_idx * c1 + c1_idx) * hw * c0 * element_size;
+        Transpose(element_size, src_panel, hw, c_num, hw, dst_panel, c0);
+      }
+    }
+  }
+
+  Status GetDstShape(Format src_format, const std::vector<int64_t> &src_shape, int64_t c0, Format dst_format,
+                     std::vector<int64_t> &dst_shape) override {
+    (void)src_format;
+    (void)dst_format;
+    if (!CheckShape(src_shape, kNchwDimNum)) {
+      return ACL_ERROR_GE_TRANSSHAPE_SHAPE_INVALID;
+    }
+    dst_shape = {src_shape[0], CeilDiv(src_shape[1], c0), src_shape[2], src_shape[3], c0};
+    return SUCCESS;
+  }
+};
+
+// NHWC to NC1HWC0 copies the C0 lanes of every pixel
+class FormatTransferNhwcNc1hwc0 : public C0FormatTransfer {
+ public:
+  using C0FormatTransfer::C0FormatTransfer;
+
+ protected:
+  Status CheckArgs(const TransArgs &args) override {
+    if (!CheckShape(args.src_shape, kNhwcDimNum)) {
+      GELOGE(ACL_ERROR_GE_PARAM_INVALID, "Trans format from NHWC to NC1HWC0, invalid src shape");
+      return ACL_ERROR_GE_PARAM_INVALID;
+    }
+    std::vector<int64_t> expect_shape;
+    (void)GetDstShape(args.src_format, args.src_shape, GetC0(args.src_data_type), args.dst_format, expect_shape);
+    return CheckExpectedShape(args, args.dst_shape, expect_shape);
+  }
+
+  bool NeedZeroPadding(const TransArgs &args) const override {
+    return (args.src_shape[3] % GetC0(args.src_data_type)) != 0;
+  }
+
+  void Move(const TransArgs &args, int64_t element_size, uint8_t *dst) const override {
+    const int64_t n = args.src_shape[0];
+    const int64_t hw = args.src_shape[1] * args.src_shape[2];
+    const int64_t c = args.src_shape[3];
+    const int64_t c0 = GetC0(args.src_data_type);
+    const int64_t c1 = CeilDiv(c, c0);
+    for (int64_t n_idx = 0; n_idx < n; ++n_idx) {
+      for (int64_t c1_idx = 0; c1_idx < c1; ++c1_idx) {
+        const int64_t c_num = std::min(c0, c - c1_idx * c0);
+        const uint8_t *src_panel = args.data + (n_idx * hw * c + c1_idx * c0) * element_size;
+        uint8_t *dst_panel = dst + (n_idx * c1 + c1_idx) * hw * c0 * element_size;
+        kernels_.copy_rows(src_panel, c * element_size, hw, c_num * element_size, dst_panel, c0 * element_size);
+      }
+    }
+  }
+
+  Status GetDstShape(Format src_format, const std::vector<int64_t> &src_shape, int64_t c0, Format dst_format,
+                     std::vector<int64_t> &dst_shape) override {
+    (void)src_format;
+    (void)dst_format;
+    if (!CheckShape(src_shape, kNhwcDimNum)) {
+      return ACL_ERROR_GE_TRANSSHAPE_SHAPE_INVALID;
+    }
+    dst_shape = {src_shape[0], CeilDiv(src_shape[3], c0), src_shape[1], src_shape[2], c0};
+    return SUCCESS;
+  }
+};
+
+// NC1HWC0 to NCHW transposes each HW x C0 panel back and drops the padded lanes
+class FormatTransferNc1hwc0Nchw : public C0FormatTransfer {
+ public:
+  using C0FormatTransfer::C0FormatTransfer;
+
+ protected:
+  Status CheckArgs(const TransArgs &args) override {
+    if (!CheckShape(args.src_shape, kNc1hwc0DimNum) || !CheckShape(args.dst_shape, kNchwDimNum)) {
+      GELOGE(ACL_ERROR_GE_PARAM_INVALID, "Trans format from NC1HWC0 to NCHW, invalid src or dst shape");
+      return ACL_ERROR_GE_PARAM_INVALID;
+    }
+    const auto &dst_shape = args.dst_shape;
+    const int64_t c0 = GetC0(args.src_data_type);
+    return CheckExpectedShape(args, args.src_shape,
+                              {dst_shape[0], CeilDiv(dst_shape[1], c0), dst_shape[2], dst_shape[3], c0});
+  }
+
+  bool NeedZeroPadding(const TransArgs &args) const override {
+    (void)args;
+    return false;
+  }
+
+  void Move(const TransArgs &args, int64_t element_size, uint8_t *dst) const override {
+    const int64_t n = args.dst_shape[0];
+    const int64_t c = args.dst_shape[1];
+    const int64_t hw = args.dst_shape[2] * args.dst_shape[3];
+    const int64_t c0 = GetC0(args.src_data_type);
+    const int64_t c1 = CeilDiv(c, c0);
+    for (int64_t n_idx = 0; n_idx < n; ++n_idx) {
+      for (int64_t c1_idx = 0; c1_idx < c1; ++c1_idx) {
+        const int64_t c_num = std::min(c0, c - c1_idx * c0);
+        const uint8_t *src_panel = args.data + (n_idx * c1 + c1_idx) * hw * c0 * element_size;
+        uint8_t *dst_panel = dst + (n_idx * c + c1_idx * c0) * hw * element_size;
+        Transpose(element_size, src_panel, c0, hw, c_num, dst_panel, hw);
+      }
+    }
+  }
+
+  Status GetDstShape(Format src_format, const std::vector<int64_t> &src_shape, int64_t c0, Format dst_format,
+                     std::vector<int64_t> &dst_shape) override {
+    (void)src_format;
+    (void)src_shape;
+    (void)c0;
+    (void)dst_format;
+    (void)dst_shape;
+    // the channel count is lost in C1 * C0
+    return ACL_ERROR_GE_TRANSSHAPE_FORMAT_INVALID;
+  }
+};
+
+// NC1HWC0 to NHWC copies the valid lanes of every pixel back
+class FormatTransferNc1hwc0Nhwc : public C0FormatTransfer {
+ public:
+  using C0FormatTransfer::C0FormatTransfer;
+
+ protected:
+  Status CheckArgs(const TransArgs &args) override {
+    if (!CheckShape(args.src_shape, kNc1hwc0DimNum) || !CheckShape(args.dst_shape, kNhwcDimNum)) {
+      GELOGE(ACL_ERROR_GE_PARAM_INVALID, "Trans format from NC1HWC0 to NHWC, invalid src or dst shape");
+      return ACL_ERROR_GE_PARAM_INVALID;
+    }
+    const auto &dst_shape = args.dst_shape;
+    const int64_t c0 = GetC0(args.src_data_type);
+    return CheckExpectedShape(args, args.src_shape,
+                              {dst_shape[0], CeilDiv(dst_shape[3], c0), dst_shape[1], dst_shape[2], c0});
+  }
+
+  bool NeedZeroPadding(const TransArgs &args) const override {
+    (void)args;
+    return false;
+  }
+
+  void Move(const TransArgs &args, int64_t element_size, uint8_t *dst) const override {
+    const int64_t n = args.dst_shape[0];
+    const int64_t hw = args.dst_shape[1] * args.dst_shape[2];
+    const int64_t c = args.dst_shape[3];
+    const int64_t c0 = GetC0(args.src_data_type);
+    const int64_t c1 = CeilDiv(c, c0);
+    for (int64_t n_idx = 0; n_idx < n; ++n_idx) {
+      for (int64_t c1_idx = 0; c1_idx < c1; ++c1_idx) {
+        const int64_t c_num = std::min(c0, c - c1_idx * c0);
+        const uint8_t *src_panel = args.data + (n_idx * c1 + c1_idx) * hw * c0 * element_size;
+        uint8_t *dst_panel = dst + (n_idx * hw * c + c1_idx * c0) * element_size;
+        kernels_.copy_rows(src_panel, c0 * element_size, hw, c_num * element_size, dst_panel, c * element_size);
+      }
+    }
+  }
+
+  Status GetDstShape(Format src_format, const std::vector<int64_t> &src_shape, int64_t c0, Format dst_format,
+                     std::vector<int64_t> &dst_shape) override {
+    (void)src_format;
+    (void)src_shape;
+    (void)c0;
+    (void)dst_format;
+    (void)dst_shape;
+    // the channel count is lost in C1 * C0
+    return ACL_ERROR_GE_TRANSSHAPE_FORMAT_INVALID;
+  }
+};
+
+// NCHW to FRACTAL_Z [C1 * H * W, N1, N0, C0], the C0 x HW panel of every n is spread with a stride of N1 * N0 * C0
+class FormatTransferNchwFractalZ : public C0FormatTransfer {
+ public:
+  using C0FormatTransfer::C0FormatTransfer;
+
+ protected:
+  Status CheckArgs(const TransArgs &args) override {
+    if (!CheckShape(args.src_shape, kNchwDimNum)) {
+      GELOGE(ACL_ERROR_GE_PARAM_INVALID, "Trans format from NCHW to FRACTAL_Z, invalid src shape");
+      return ACL_ERROR_GE_PARAM_INVALID;
+    }
+    std::vector<int64_t> expect_shape;
+    (void)GetDstShape(args.src_format, args.src_shape, GetC0(args.src_data_type), args.dst_format, expect_shape);
+    return CheckExpectedShape(args, args.dst_shape, expect_shape);
+  }
+
+  bool NeedZeroPadding(const TransArgs &args) const override {
+    return ((args.src_shape[0] % kCubeSize) != 0) || ((args.src_shape[1] % GetC0(args.src_data_type)) != 0);
+  }
+
+  void Move(const TransArgs &args, int64_t element_size, uint8_t *dst) const override {
+    const int64_t n = args.src_shape[0];
+    const int64_t c = args.src_shape[1];
+    const int64_t hw = args.src_shape[2] * args.src_shape[3];
+    const int64_t c0 = GetC0(args.src_data_type);
+    const int64_t c1 = CeilDiv(c, c0);
+    const int64_t n_pad = CeilDiv(n, kCubeSize) * kCubeSize;
+    for (int64_t n_idx = 0; n_idx < n; ++n_idx) {
+      for (int64_t c1_idx = 0; c1_idx < c1; ++c1_idx) {
+        const int64_t c_num = std::min(c0, c - c1_idx * c0);
+        const uint8_t *src_panel = args.data + (n_idx * c + c1_idx * c0) * hw * element_size;
+        uint8_t *dst_panel = dst + (c1_idx * hw * n_pad + n_idx) * c0 * element_size;
+        Transpose(element_size, src_panel, hw, c_num, hw, dst_panel, n_pad * c0);
+      }
+    }
+  }
+
+  Status GetDstShape(Format src_format, const std::vector<int64_t> &src_shape, int64_t c0, Format dst_format,
+                     std::vector<int64_t> &dst_shape) override {
+    (void)src_format;
+    (void)dst_format;
+    if (!CheckShape(src_shape, kNchwDimNum)) {
+      return ACL_ERROR_GE_TRANSSHAPE_SHAPE_INVALID;
+    }
+    dst_shape = {CeilDiv(src_shape[1], c0) * src_shape[2] * src_shape[3], CeilDiv(src_shape[0], kCubeSize), kCubeSize,
+                 c0};
+    return SUCCESS;
+  }
+};
+
+template <typename Transfer>
+FormatTransferBuilder MakeBuilder(const FormatKernels &kernels) {
+  return [kernels]() { return std::make_shared<Transfer>(kernels); };
+}
+
+template <typename Transfer>
+void RegisterKernels(Format src, Format dst, bool transpose) {
+  (void)FormatTransferRegister(MakeBuilder<Transfer>(kReferenceKernels), src, dst, kReferenceImpl, kCpuFeatureNone,
+                               kReferencePriority);
+  (void)FormatTransferRegister(MakeBuilder<Transfer>(kBlockedKernels), src, dst, kBlockedImpl, kCpuFeatureNone,
+                               kBlockedPriority);
+  // the pixel copies are memcpy bound, only the transposing pairs get SIMD kernels
+  if (!transpose) {
+    return;
+  }
+#if defined(__x86_64__)
+  (void)FormatTransferRegister(MakeBuilder<Transfer>(kSse2Kernels), src, dst, kSse2Impl, kCpuFeatureSse2,
+                               kSimdPriority);
+  (void)FormatTransferRegister(MakeBuilder<Transfer>(kAvx2Kernels), src, dst, kAvx2Impl, kCpuFeatureAvx2,
+                               kAvx2Priority);
+#endif
+#if defined(__aarch64__)
+  (void)FormatTransferRegister(MakeBuilder<Transfer>(kNeonKernels), src, dst, kNeonImpl, kCpuFeatureNeon,
+                               kSimdPriority);
+#endif
+}
+
+bool RegisterFormatTransferKernels() {
+  RegisterKernels<FormatTransferNchwNc1hwc0>(FORMAT_NCHW, FORMAT_NC1HWC0, true);
+  RegisterKernels<FormatTransferNc1hwc0Nchw>(FORMAT_NC1HWC0, FORMAT_NCHW, true);
+  RegisterKernels<FormatTransferNchwFractalZ>(FORMAT_NCHW, FORMAT_FRACTAL_Z, true);
+  RegisterKernels<FormatTransferNhwcNc1hwc0>(FORMAT_NHWC, FORMAT_NC1HWC0, false);
+  RegisterKernels<FormatTransferNc1hwc0Nhwc>(FORMAT_NC1HWC0, FORMAT_NHWC, false);
+  return true;
+}
+
+const bool g_format_transfer_kernels_registered = RegisterFormatTransferKernels();
+}  // namespace
+}  // namespace formats
+}  // namespace ge
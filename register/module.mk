@@ -15,6 +15,7 @@ local_lib_src_files :=  register.cpp \
                         graph_optimizer/buffer_fusion/buffer_fusion_pattern.cc \
                         graph_optimizer/fusion_statistic/fusion_statistic_recorder.cc \
                         register_format_transfer.cc \
+                        format_transfer_kernels.cc \
                         op_kernel_registry.cpp \
                         auto_mapping_util.cpp \
                         host_cpu_context.cc \
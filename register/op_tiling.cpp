@@ -28,7 +28,7 @@
 #include "graph/utils/tensor_utils.h"
 #include <nlohmann/json.hpp>
 
-#define LOG_ENABLED(loglvl) CheckLogLevel(GE_MODULE_NAME, loglvl)
+#define LOG_ENABLED(loglvl) IsLogEnable(GE_MODULE_NAME, loglvl)
 
 namespace optiling {
 
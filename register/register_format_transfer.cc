@@ -16,49 +16,146 @@
 
 #include "register/register_format_transfer.h"
 
+#include <algorithm>
+#include <unordered_map>
+
 namespace ge {
 namespace formats {
 namespace {
+const char *const kDefaultImplName = "default";
+
+struct FormatTransferImpl {
+  std::string name;
+  CpuFeature feature;
+  int32_t priority;
+  FormatTransferBuilder builder;
+};
+
 struct FormatTransferRegistry {
-  Status RegisterBuilder(Format src, Format dst, FormatTransferBuilder builder) {
-    src_dst_builder[src][dst] = std::move(builder);
+  Status RegisterBuilder(Format src, Format dst, const std::string &impl_name, CpuFeature feature, int32_t priority,
+                         FormatTransferBuilder builder) {
+    auto &impls = src_dst_impls[GetKey(src, dst)];
+    auto iter = std::find_if(impls.begin(), impls.end(),
+                             [&impl_name](const FormatTransferImpl &impl) { return impl.name == impl_name; });
+    if (iter != impls.end()) {
+      impls.erase(iter);
+    }
+    FormatTransferImpl impl = {impl_name, feature, priority, std::move(builder)};
+    // kept sorted by priority, the first supported one is the best
+    auto pos = std::upper_bound(impls.begin(), impls.end(), priority,
+                                [](int32_t value, const FormatTransferImpl &item) { return value > item.priority; });
+    (void)impls.insert(pos, std::move(impl));
     return SUCCESS;
   }
-  std::map<Format, std::map<Format, FormatTransferBuilder>> src_dst_builder;
+
+  const std::vector<FormatTransferImpl> *FindImpls(const TransArgs &args) const {
+    auto iter = src_dst_impls.find(GetKey(static_cast<Format>(GetPrimaryFormat(args.src_format)),
+                                          static_cast<Format>(GetPrimaryFormat(args.dst_format))));
+    return (iter == src_dst_impls.end()) ? nullptr : &iter->second;
+  }
+
+  static uint64_t GetKey(Format src, Format dst) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(src)) << 32U) | static_cast<uint32_t>(dst);
+  }
+
+  std::unordered_map<uint64_t, std::vector<FormatTransferImpl>> src_dst_impls;
 };
 
 FormatTransferRegistry &GetFormatTransferRegistry() {
   static FormatTransferRegistry registry;
   return registry;
 }
+
+bool DetectCpuFeature(CpuFeature feature) {
+  switch (feature) {
+    case kCpuFeatureNone:
+      return true;
+#if defined(__x86_64__) || defined(__i386__)
+    case kCpuFeatureSse2:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("sse2");
+    case kCpuFeatureAvx2:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx2");
+#endif
+#if defined(__aarch64__) || defined(__ARM_NEON)
+    case kCpuFeatureNeon:
+      return true;
+#endif
+    default:
+      return false;
+  }
+}
 }  // namespace
 
+bool CpuFeatureSupported(CpuFeature feature) {
+  static const bool supported[] = {DetectCpuFeature(kCpuFeatureNone), DetectCpuFeature(kCpuFeatureSse2),
+                                   DetectCpuFeature(kCpuFeatureAvx2), DetectCpuFeature(kCpuFeatureNeon)};
+  auto index = static_cast<size_t>(feature);
+  return (index < sizeof(supported) / sizeof(supported[0])) && supported[index];
+}
+
 FormatTransferRegister::FormatTransferRegister(FormatTransferBuilder builder, Format src, Format dst) {
-  (void)GetFormatTransferRegistry().RegisterBuilder(src, dst, std::move(builder));
+  (void)GetFormatTransferRegistry().RegisterBuilder(src, dst, kDefaultImplName, kCpuFeatureNone, 0,
+                                                    std::move(builder));
   // RegisterBuilder() always return success, no need to check value
 }
 
+FormatTransferRegister::FormatTransferRegister(FormatTransferBuilder builder, Format src, Format dst,
+                                               const std::string &impl_name, CpuFeature feature, int32_t priority) {
+  (void)GetFormatTransferRegistry().RegisterBuilder(src, dst, impl_name, feature, priority, std::move(builder));
+}
+
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY std::shared_ptr<FormatTransfer> BuildFormatTransfer(
     const TransArgs &args) {
-  auto &registry = GetFormatTransferRegistry();
-  auto dst_builder = registry.src_dst_builder.find(static_cast<Format>(GetPrimaryFormat(args.src_format)));
-  if (dst_builder == registry.src_dst_builder.end()) {
+  auto impls = GetFormatTransferRegistry().FindImpls(args);
+  if (impls == nullptr) {
     return nullptr;
   }
-  auto builder_iter = dst_builder->second.find(static_cast<Format>(GetPrimaryFormat(args.dst_format)));
-  if (builder_iter == dst_builder->second.end()) {
+  for (const auto &impl : *impls) {
+    if (CpuFeatureSupported(impl.feature)) {
+      return impl.builder();
+    }
+  }
+  return nullptr;
+}
+
+GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY std::shared_ptr<FormatTransfer> BuildFormatTransfer(
+    const TransArgs &args, const std::string &impl_name) {
+  auto impls = GetFormatTransferRegistry().FindImpls(args);
+  if (impls == nullptr) {
     return nullptr;
   }
-  return builder_iter->second();
+  for (const auto &impl : *impls) {
+    if (impl.name == impl_name) {
+      return CpuFeatureSupported(impl.feature) ? impl.builder() : nullptr;
+    }
+  }
+  return nullptr;
 }
 
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY bool FormatTransferExists(const TransArgs &args) {
-  auto &registry = GetFormatTransferRegistry();
-  auto dst_builder = registry.src_dst_builder.find(static_cast<Format>(GetPrimaryFormat(args.src_format)));
-  if (dst_builder == registry.src_dst_builder.end()) {
+  auto impls = GetFormatTransferRegistry().FindImpls(args);
+  if (impls == nullptr) {
     return false;
   }
-  return dst_builder->second.count(static_cast<Format>(GetPrimaryFormat(args.dst_format))) > 0;
+  return std::any_of(impls->begin(), impls->end(),
+                     [](const FormatTransferImpl &impl) { return CpuFeatureSupported(impl.feature); });
+}
+
+GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY std::vector<std::string> GetFormatTransferImpls(Format src_format,
+                                                                                               Format dst_format) {
+  TransArgs args{};
+  args.src_format = src_format;
+  args.dst_format = dst_format;
+  std::vector<std::string> names;
+  auto impls = GetFormatTransferRegistry().FindImpls(args);
+  if (impls != nullptr) {
+    for (const auto &impl : *impls) {
+      names.emplace_back(impl.name);
+    }
+  }
+  return names;
 }
 }  // namespace formats
 }  // namespace ge
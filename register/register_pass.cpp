@@ -17,10 +17,23 @@
 #include "external/register/register_pass.h"
 #include "register/custom_pass_helper.h"
 #include <algorithm>
+#include <chrono>
+#include <cinttypes>
 #include <climits>
+#include <future>
 #include "graph/debug/ge_log.h"
+#include "graph/ge_context.h"
+#include "graph/ge_local_context.h"
+#include "graph/utils/thread_pool.h"
 
 namespace ge {
+namespace {
+uint64_t GetElapsedUs(const std::chrono::steady_clock::time_point &start) {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+}
+}  // namespace
+
 PassReceiver::PassReceiver(PassRegistrationData &reg_data) {
   CustomPassHelper::Instance().Insert(reg_data);
 }
@@ -35,12 +48,14 @@ class PassRegistrationDataImpl {
   std::string pass_name_;
   int32_t priority_ = INT_MAX;
   CustomPassFunc custom_pass_fn_ = nullptr;
+  bool read_only_ = false;
 };
 
 PassRegistrationDataImpl::PassRegistrationDataImpl(const std::string &pass_name)
     : pass_name_(pass_name),
       priority_(INT_MAX),
-      custom_pass_fn_(nullptr) {}
+      custom_pass_fn_(nullptr),
+      read_only_(false) {}
 
 PassRegistrationData::PassRegistrationData(std::string pass_name) {
   impl_ = std::shared_ptr<PassRegistrationDataImpl>(new (std::nothrow) PassRegistrationDataImpl(pass_name));
@@ -89,29 +104,135 @@ CustomPassFunc PassRegistrationData::GetCustomPassFn() const {
   return impl_->custom_pass_fn_;
 }
 
+PassRegistrationData &PassRegistrationData::ReadOnly(bool read_only) {
+  if (impl_ != nullptr) {
+    impl_->read_only_ = read_only;
+  }
+  return *this;
+}
+
+bool PassRegistrationData::IsReadOnly() const {
+  if (impl_ == nullptr) {
+    return false;
+  }
+  return impl_->read_only_;
+}
+
 CustomPassHelper &CustomPassHelper::Instance() {
   static CustomPassHelper instance;
   return instance;
 }
 
 void CustomPassHelper::Insert(const PassRegistrationData &reg_data) {
-  registration_datas_.insert(reg_data);
+  // the pass function is taken once here instead of through the impl on every run
+  PassEntry entry = {reg_data, reg_data.GetCustomPassFn(), reg_data.IsReadOnly()};
+  auto iter = std::upper_bound(registration_datas_.begin(), registration_datas_.end(), entry,
+                               [](const PassEntry &a, const PassEntry &b) {
+                                 return CustomPassGreater()(a.reg_data, b.reg_data);
+                               });
+  (void)registration_datas_.insert(iter, entry);
 }
 
-Status CustomPassHelper::Run(ge::GraphPtr &graph) {
-  for (auto &item : registration_datas_) {
-    GELOGD("Start to run custom pass [%s]!", item.GetPassName().c_str());
-    auto custom_pass_fn = item.GetCustomPassFn();
-    if (custom_pass_fn == nullptr) {
-      GELOGW("Custom pass [%s] doesn't have custom_pass_fn!", item.GetPassName().c_str());
+void CustomPassHelper::SetTimeBudget(uint64_t budget_us, int32_t keep_priority) {
+  time_budget_us_ = budget_us;
+  keep_priority_ = keep_priority;
+}
+
+bool CustomPassHelper::IsOverBudget(uint64_t cost_us, const PassEntry &entry) const {
+  return (time_budget_us_ != 0U) && (cost_us >= time_budget_us_) && (entry.reg_data.GetPriority() > keep_priority_);
+}
+
+Status CustomPassHelper::RunPass(const PassEntry &entry, ge::GraphPtr &graph, CustomPassStat &stat) const {
+  GELOGD("Start to run custom pass [%s]!", stat.pass_name.c_str());
+  if (entry.custom_pass_fn == nullptr) {
+    GELOGW("Custom pass [%s] doesn't have custom_pass_fn!", stat.pass_name.c_str());
+    return SUCCESS;
+  }
+  auto start = std::chrono::steady_clock::now();
+  stat.status = entry.custom_pass_fn(graph);
+  stat.cost_us = GetElapsedUs(start);
+  if (stat.status != SUCCESS) {
+    GE_LOGE("Custom pass [%s] run failed!", stat.pass_name.c_str());
+    return FAILED;
+  }
+  GELOGD("Run custom pass [%s] success, cost %" PRIu64 " us!", stat.pass_name.c_str(), stat.cost_us);
+  return SUCCESS;
+}
+
+Status CustomPassHelper::RunParallel(size_t begin, size_t end, ge::GraphPtr &graph,
+                                     std::vector<CustomPassStat> &pass_stats) const {
+  // passes read the options and the session of the calling thread, both are thread local
+  const GEThreadLocalContext &thread_context = GetThreadLocalContext();
+  const uint64_t session_id = GetContext().SessionId();
+  ThreadPool pool(ThreadPool::GetThreadNum(end - begin));
+  std::vector<std::future<Status>> futures;
+  for (size_t i = begin; i < end; ++i) {
+    if (pass_stats[i].skipped) {
       continue;
     }
-    if (custom_pass_fn(graph) != SUCCESS) {
-      GE_LOGE("Custom pass [%s] run failed!", item.GetPassName().c_str());
+    // every task writes only its own stat
+    futures.emplace_back(pool.Commit([this, &graph, &pass_stats, &thread_context, session_id, i]() -> Status {
+      GetThreadLocalContext() = thread_context;
+      GetContext().SetSessionId(session_id);
+      return RunPass(registration_datas_[i], graph, pass_stats[i]);
+    }));
+  }
+  Status ret = SUCCESS;
+  for (auto &future : futures) {
+    if (!future.valid() || (future.get() != SUCCESS)) {
+      ret = FAILED;
+    }
+  }
+  return ret;
+}
+
+Status CustomPassHelper::Run(ge::GraphPtr &graph) {
+  std::vector<CustomPassStat> pass_stats;
+  return Run(graph, pass_stats);
+}
+
+Status CustomPassHelper::Run(ge::GraphPtr &graph, std::vector<CustomPassStat> &pass_stats) {
+  pass_stats.clear();
+  pass_stats.reserve(registration_datas_.size());
+  for (const auto &entry : registration_datas_) {
+    pass_stats.push_back({entry.reg_data.GetPassName(), entry.reg_data.GetPriority(), entry.read_only, false, SUCCESS,
+                           0U});
+  }
+  auto start = std::chrono::steady_clock::now();
+  size_t begin = 0U;
+  while (begin < registration_datas_.size()) {
+    size_t end = begin + 1U;
+    while (registration_datas_[begin].read_only && (end < registration_datas_.size()) &&
+           registration_datas_[end].read_only) {
+      ++end;
+    }
+    uint64_t cost_us = GetElapsedUs(start);
+    size_t run_num = 0U;
+    for (size_t i = begin; i < end; ++i) {
+      if (IsOverBudget(cost_us, registration_datas_[i])) {
+        GELOGW("Custom pass [%s] skipped, %" PRIu64 " us of the %" PRIu64 " us budget used!",
+               pass_stats[i].pass_name.c_str(), cost_us, time_budget_us_);
+        pass_stats[i].skipped = true;
+      } else {
+        ++run_num;
+      }
+    }
+    Status ret = SUCCESS;
+    if ((run_num > 1U) && (ThreadPool::GetThreadNum(run_num) > 1U)) {
+      ret = RunParallel(begin, end, graph, pass_stats);
+    } else {
+      for (size_t i = begin; (i < end) && (ret == SUCCESS); ++i) {
+        if (!pass_stats[i].skipped) {
+          ret = RunPass(registration_datas_[i], graph, pass_stats[i]);
+        }
+      }
+    }
+    if (ret != SUCCESS) {
       return FAILED;
     }
-    GELOGD("Run custom pass [%s] success!", item.GetPassName().c_str());
+    begin = end;
   }
+  GELOGI("Run %zu custom passes cost %" PRIu64 " us.", registration_datas_.size(), GetElapsedUs(start));
   return SUCCESS;
 }
 }  // namespace ge
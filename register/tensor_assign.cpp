@@ -14,12 +14,14 @@
  * limitations under the License.
 */
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include "securec.h"
 #include "framework/common/debug/ge_log.h"
 #include "graph/debug/ge_log.h"
 #include "graph/debug/ge_util.h"
+#include "graph/aligned_ptr.h"
 #include "graph/utils/op_desc_utils.h"
 #include "graph/utils/type_utils.h"
 #include "graph/utils/attr_utils.h"
@@ -80,6 +82,105 @@ const std::map<uint32_t, ge::DataType> data_type_map = {
     {domi::tensorflow::DataType::DT_STRING_REF, ge::DataType::DT_STRING},
     {domi::tensorflow::DataType::DT_VARIANT, ge::DataType::DT_VARIANT},
 };
+
+// number of typed values carried in the repeated *_val field matching data_type
+bool GetDataTypeValSize(const domi::TensorProto &tensor, int32_t &val_size) {
+  switch (tensor.dtype()) {
+    case domi::tensorflow::DT_FLOAT:
+    case domi::tensorflow::DT_FLOAT_REF:
+      val_size = tensor.float_val().size();
+      break;
+    case domi::tensorflow::DT_INT32:
+    case domi::tensorflow::DT_INT8:
+    case domi::tensorflow::DT_UINT8:
+    case domi::tensorflow::DT_INT16:
+    case domi::tensorflow::DT_UINT16:
+    case domi::tensorflow::DT_QINT8:
+    case domi::tensorflow::DT_QINT16:
+    case domi::tensorflow::DT_QINT32:
+    case domi::tensorflow::DT_QUINT8:
+    case domi::tensorflow::DT_QUINT16:
+    case domi::tensorflow::DT_INT32_REF:
+    case domi::tensorflow::DT_INT8_REF:
+    case domi::tensorflow::DT_UINT8_REF:
+    case domi::tensorflow::DT_INT16_REF:
+    case domi::tensorflow::DT_UINT16_REF:
+    case domi::tensorflow::DT_QINT8_REF:
+    case domi::tensorflow::DT_QINT16_REF:
+    case domi::tensorflow::DT_QINT32_REF:
+    case domi::tensorflow::DT_QUINT8_REF:
+    case domi::tensorflow::DT_QUINT16_REF:
+      val_size = tensor.int_val().size();
+      break;
+    case domi::tensorflow::DT_INT64:
+    case domi::tensorflow::DT_INT64_REF:
+      val_size = tensor.int64_val().size();
+      break;
+    case domi::tensorflow::DT_BOOL:
+    case domi::tensorflow::DT_BOOL_REF:
+      val_size = tensor.bool_val().size();
+      break;
+    case domi::tensorflow::DT_HALF:
+    case domi::tensorflow::DT_BFLOAT16:
+    case domi::tensorflow::DT_HALF_REF:
+    case domi::tensorflow::DT_BFLOAT16_REF:
+      val_size = tensor.half_val().size();
+      break;
+    case domi::tensorflow::DT_DOUBLE:
+    case domi::tensorflow::DT_DOUBLE_REF:
+      val_size = tensor.double_val().size();
+      break;
+    case domi::tensorflow::DT_STRING:
+    case domi::tensorflow::DT_STRING_REF:
+      val_size = tensor.string_val().size();
+      break;
+    case domi::tensorflow::DT_COMPLEX64:
+    case domi::tensorflow::DT_COMPLEX64_REF:
+      val_size = tensor.scomplex_val().size();
+      break;
+    case domi::tensorflow::DT_COMPLEX128:
+    case domi::tensorflow::DT_COMPLEX128_REF:
+      val_size = tensor.dcomplex_val().size();
+      break;
+    case domi::tensorflow::DT_UINT32:
+    case domi::tensorflow::DT_UINT32_REF:
+      val_size = tensor.uint32_val().size();
+      break;
+    case domi::tensorflow::DT_UINT64:
+    case domi::tensorflow::DT_UINT64_REF:
+      val_size = tensor.uint64_val().size();
+      break;
+    case domi::tensorflow::DT_RESOURCE:
+    case domi::tensorflow::DT_RESOURCE_REF:
+      val_size = tensor.resource_handle_val().size();
+      break;
+    case domi::tensorflow::DT_VARIANT:
+    case domi::tensorflow::DT_VARIANT_REF:
+      val_size = tensor.variant_val().size();
+      break;
+    default:
+      return false;
+  }
+  return true;
+}
+
+// Weight memory is allocated aligned up front and handed to the tensor without another copy
+std::shared_ptr<ge::AlignedPtr> MallocWeight(size_t size) {
+  auto aligned_ptr = ComGraphMakeShared<ge::AlignedPtr>(size);
+  if ((aligned_ptr == nullptr) || (aligned_ptr->MutableGet() == nullptr)) {
+    GELOGE(ge::MEMALLOC_FAILED, "Malloc weight failed, size=%zu", size);
+    return nullptr;
+  }
+  return aligned_ptr;
+}
+
+// The tensor adopts the buffer, a proto backed tensor copies it into its proto instead
+void SetWeightBuffer(domi::GeTensorPtr &weight, const std::shared_ptr<ge::AlignedPtr> &aligned_ptr, size_t size) {
+  if (weight->SetData(aligned_ptr->MutableGet(), size, [aligned_ptr](uint8_t *ptr) { (void)ptr; }) !=
+      ge::GRAPH_SUCCESS) {
+    GELOGW("Set weight data failed, size=%zu", size);
+  }
+}
 }  // namespace
 
 ge::DataType TensorAssign::ConvertTensorflowDataType(uint32_t tf_data_type) {
@@ -151,52 +252,43 @@ bool TensorAssign::CheckUnsignedEightByte(tensorflow::DataType data_type) {
   return ((data_type == tensorflow::DT_UINT64) || (data_type == tensorflow::DT_UINT64_REF));
 }
 
-Status TensorAssign::GetDoubleByteVal(int32_t val_size, const google::protobuf::RepeatedField<int32> &val_vector,
-                                      int count, GeTensorPtr &weight) {
+template <typename T, typename V>
+Status TensorAssign::FillWeightVal(int32_t val_size, const google::protobuf::RepeatedField<V> &val_vector, int count,
+                                   GeTensorPtr &weight) {
   GE_CHECK_NOTNULL(weight);
-  bool zerosLike = (count != val_size && val_size == 1);
-  uint16_t *addr = new (std::nothrow) uint16_t[count]();
-  GE_CHECK_NOTNULL(addr);
-  int minCount = (count > val_size) ? val_size : count;
-  if (!zerosLike) {
-    for (int32_t i = 0; i < minCount; i++) {
-      *(addr + i) = static_cast<uint16_t>(val_vector.Get(i));
-    }
-    for (int32_t i = minCount; i < count; i++) {
-      *(addr + i) = static_cast<uint16_t>(val_vector.Get(minCount - 1));
-    }
-  } else {
-    for (int32_t i = 0; i < count; i++) {
-      *(addr + i) = static_cast<uint16_t>(val_vector.Get(0));
-    }
+  if (count <= 0) {
+    (void)weight->SetData(static_cast<const uint8_t *>(nullptr), 0);
+    return SUCCESS;
+  }
+  size_t size = static_cast<size_t>(count) * sizeof(T);
+  auto aligned_ptr = MallocWeight(size);
+  GE_CHECK_NOTNULL(aligned_ptr);
+  T *addr = reinterpret_cast<T *>(aligned_ptr->MutableGet());
+  int min_count = (count > val_size) ? val_size : count;
+  const V *vals = val_vector.data();
+  for (int32_t i = 0; i < min_count; i++) {
+    addr[i] = static_cast<T>(vals[i]);
   }
-  weight->SetData(reinterpret_cast<uint8_t *>(addr), count * sizeof(uint16_t));
-  GE_DELETE_NEW_ARRAY(addr);
+  // a splat constant carries one value for the whole shape, fill the rest in one pass
+  std::fill_n(addr + min_count, count - min_count, static_cast<T>(vals[min_count - 1]));
+  SetWeightBuffer(weight, aligned_ptr, size);
   return SUCCESS;
 }
 
+template <typename T>
+Status TensorAssign::GetVal(int32_t val_size, const google::protobuf::RepeatedField<T> &val_vector, int count,
+                            GeTensorPtr &weight) {
+  return FillWeightVal<T>(val_size, val_vector, count, weight);
+}
+
+Status TensorAssign::GetDoubleByteVal(int32_t val_size, const google::protobuf::RepeatedField<int32> &val_vector,
+                                      int count, GeTensorPtr &weight) {
+  return FillWeightVal<uint16_t>(val_size, val_vector, count, weight);
+}
+
 Status TensorAssign::GetByteVal(int32_t val_size, const google::protobuf::RepeatedField<int32> &val_vector, int count,
                                 GeTensorPtr &weight) {
-  GE_CHECK_NOTNULL(weight);
-  bool zerosLike = (count != val_size && val_size == 1);
-  uint8_t *addr = new (std::nothrow) uint8_t[count]();
-  GE_CHECK_NOTNULL(addr);
-  int minCount = (count > val_size) ? val_size : count;
-  if (!zerosLike) {
-    for (int32_t i = 0; i < minCount; i++) {
-      *(addr + i) = static_cast<uint8_t>(val_vector.Get(i));
-    }
-    for (int32_t i = minCount; i < count; i++) {
-      *(addr + i) = static_cast<uint8_t>(val_vector.Get(minCount - 1));
-    }
-  } else {
-    for (int32_t i = 0; i < count; i++) {
-      *(addr + i) = static_cast<uint8_t>(val_vector.Get(0));
-    }
-  }
-  weight->SetData(addr, count * sizeof(uint8_t));
-  GE_DELETE_NEW_ARRAY(addr);
-  return SUCCESS;
+  return FillWeightVal<uint8_t>(val_size, val_vector, count, weight);
 }
 
 Status TensorAssign::GetStringVal(int32_t val_size, const google::protobuf::RepeatedPtrField<std::string> &val_vector,
@@ -212,41 +304,32 @@ Status TensorAssign::GetStringVal(int32_t val_size, const google::protobuf::Repe
       total_size += (val_vector[i].size() + kExtraBytesForString);
     }
     total_size += (count - min_count) * kExtraBytesForString;
-    std::unique_ptr<char[]> addr(new (std::nothrow) char[total_size]());
-    GE_CHECK_NOTNULL(addr);
-    uint64_t *p = reinterpret_cast<uint64_t *>(addr.get());
-    // front some bytes store pointer of each string
-    char *raw_data = addr.get() + count * sizeof(uint64_t);
-    for (int32_t i = 0; i < count; ++i) {
-      p[i] = reinterpret_cast<uintptr_t>(raw_data);
-      if (i < val_size) {
-        const string &str = val_vector.Get(i);
-        CHECK_FALSE_EXEC(memcpy_s(raw_data, str.size() + 1, str.c_str(), str.size() + 1) == EOK,
-                         GELOGW("call memcpy_s fail!"));
-        raw_data += (str.size() + 1);
-      } else {
-        raw_data += 1;
-      }
-    }
-    weight->SetData(reinterpret_cast<const uint8_t *>(addr.get()), total_size);
   } else {
-    const string &str = val_vector.Get(0);
-    // extra 8 bytes store pointer of string
-    // extra 1 byte store '\0'
-    total_size = (str.size() + kExtraBytesForString) * count;
-    std::unique_ptr<char[]> addr(new (std::nothrow) char[total_size]());
-    GE_CHECK_NOTNULL(addr);
-    uint64_t *p = reinterpret_cast<uint64_t *>(addr.get());
-    // front some bytes store pointer of each string
-    char *raw_data = addr.get() + count * sizeof(uint64_t);
-    for (int32_t i = 0; i < count; ++i) {
-      p[i] = reinterpret_cast<uintptr_t>(raw_data);
+    total_size = (val_vector.Get(0).size() + kExtraBytesForString) * count;
+  }
+  if (total_size == 0) {
+    (void)weight->SetData(static_cast<const uint8_t *>(nullptr), 0);
+    return SUCCESS;
+  }
+  auto aligned_ptr = MallocWeight(total_size);
+  GE_CHECK_NOTNULL(aligned_ptr);
+  char *addr = reinterpret_cast<char *>(aligned_ptr->MutableGet());
+  uint64_t *p = reinterpret_cast<uint64_t *>(addr);
+  // front some bytes store pointer of each string
+  char *raw_data = addr + count * sizeof(uint64_t);
+  for (int32_t i = 0; i < count; ++i) {
+    p[i] = reinterpret_cast<uintptr_t>(raw_data);
+    if (flag || (i < val_size)) {
+      const string &str = flag ? val_vector.Get(0) : val_vector.Get(i);
       CHECK_FALSE_EXEC(memcpy_s(raw_data, str.size() + 1, str.c_str(), str.size() + 1) == EOK,
                        GELOGW("call memcpy_s fail!"));
       raw_data += (str.size() + 1);
+    } else {
+      *raw_data = '\0';
+      raw_data += 1;
     }
-    weight->SetData(reinterpret_cast<const uint8_t *>(addr.get()), total_size);
   }
+  SetWeightBuffer(weight, aligned_ptr, total_size);
   return SUCCESS;
 }
 
@@ -289,96 +372,59 @@ void TensorAssign::SetWeightData(tensorflow::DataType data_type, int count, cons
     GE_LOGE("weight is nullptr.");
     return;
   }
-  GELOGD("Set data from tensor_content %s, count = %d, data_type = %s.", tensor_content.c_str(),
+  GELOGD("Set data from tensor_content, size = %zu, count = %d, data_type = %s.", tensor_content.size(),
          count, DataType_Name(data_type).c_str());
+  size_t elem_size = sizeof(float);
   if (CheckByte(data_type)) {
-    weight->SetData(reinterpret_cast<const uint8_t *>(tensor_content.data()), count * sizeof(uint8_t));
+    elem_size = sizeof(uint8_t);
   } else if (CheckBoolVal(data_type)) {
-    weight->SetData(reinterpret_cast<const uint8_t *>(tensor_content.data()), count * sizeof(bool));
+    elem_size = sizeof(bool);
   } else if (CheckHalfVal(data_type) || CheckDoubleByte(data_type)) {
-    weight->SetData(reinterpret_cast<const uint8_t *>(tensor_content.data()), count * sizeof(uint16_t));
+    elem_size = sizeof(uint16_t);
   } else if (CheckSignedFourByte(data_type) || CheckUnsignedFourByte(data_type)) {
-    weight->SetData(reinterpret_cast<const uint8_t *>(tensor_content.data()), count * sizeof(uint32_t));
+    elem_size = sizeof(uint32_t);
   } else if (CheckSignedEightByte(data_type) || CheckUnsignedEightByte(data_type)) {
-    weight->SetData(reinterpret_cast<const uint8_t *>(tensor_content.data()), count * sizeof(uint64_t));
+    elem_size = sizeof(uint64_t);
   } else if (CheckDoubleVal(data_type) || CheckComplex128Val(data_type)) {
-    weight->SetData(reinterpret_cast<const uint8_t *>(tensor_content.data()), count * sizeof(double));
+    elem_size = sizeof(double);
   } else if (CheckStringVal(data_type)) {
-    std::string weight_content;
-    if (tensor_content.size() > 1) {
-      weight_content = tensor_content.substr(1);  // first byte is tensor length
+    // first byte is tensor length
+    size_t str_size = (tensor_content.size() > 1) ? (tensor_content.size() - 1) : 0;
+    size_t total_size = str_size + kExtraBytesForString;
+    auto aligned_ptr = MallocWeight(total_size);
+    GE_CHECK_NOTNULL_EXEC(aligned_ptr, return);
+    char *addr = reinterpret_cast<char *>(aligned_ptr->MutableGet());
+    char *raw_data = addr + sizeof(uint64_t);
+    reinterpret_cast<uint64_t *>(addr)[0] = reinterpret_cast<uintptr_t>(raw_data);
+    if (str_size > 0) {
+      CHECK_FALSE_EXEC(memcpy_s(raw_data, str_size, tensor_content.data() + 1, str_size) == EOK,
+                       GELOGW("call memcpy_s fail!"));
     }
-    size_t total_size = weight_content.size() + kExtraBytesForString;
-    std::unique_ptr<char[]> addr(new (std::nothrow) char[total_size]());
-    GE_CHECK_NOTNULL_EXEC(addr, return);
-    uint64_t *p = reinterpret_cast<uint64_t *>(addr.get());
-    char *raw_data = addr.get() + sizeof(uint64_t);
-    p[0] = reinterpret_cast<uintptr_t>(raw_data);
-    CHECK_FALSE_EXEC(memcpy_s(raw_data, weight_content.size() + 1, weight_content.c_str(),
-		     weight_content.size() + 1) == EOK, GELOGW("call memcpy_s fail!"));
-    weight->SetData(reinterpret_cast<const uint8_t *>(addr.get()), total_size);
-  } else {
-    weight->SetData(reinterpret_cast<const uint8_t *>(tensor_content.data()), count * sizeof(float));
+    raw_data[str_size] = '\0';
+    SetWeightBuffer(weight, aligned_ptr, total_size);
+    return;
+  }
+
+  size_t size = static_cast<size_t>(count) * elem_size;
+  if (tensor_content.size() >= size) {
+    // the content is owned by the proto, copy it once into the aligned weight buffer
+    (void)weight->SetData(reinterpret_cast<const uint8_t *>(tensor_content.data()), size);
+    return;
   }
+  GELOGW("tensor_content size %zu is less than %zu, the tail is zero filled.", tensor_content.size(), size);
+  auto aligned_ptr = MallocWeight(size);
+  GE_CHECK_NOTNULL_EXEC(aligned_ptr, return);
+  uint8_t *addr = aligned_ptr->MutableGet();
+  std::copy(tensor_content.begin(), tensor_content.end(), addr);
+  std::fill(addr + tensor_content.size(), addr + size, 0);
+  SetWeightBuffer(weight, aligned_ptr, size);
 }
 
 Status TensorAssign::SetGeTensor(const TensorProto &tensor, GeTensorPtr &weight) {
   GE_CHECK_NOTNULL(weight);
-  std::map<tensorflow::DataType, int32_t> datatype_val_size_map = {
-      {tensorflow::DT_FLOAT, tensor.float_val().size()},
-      {tensorflow::DT_INT32, tensor.int_val().size()},
-      {tensorflow::DT_INT64, tensor.int64_val().size()},
-      {tensorflow::DT_BOOL, tensor.bool_val().size()},
-      {tensorflow::DT_HALF, tensor.half_val().size()},
-      {tensorflow::DT_INT8, tensor.int_val().size()},
-      {tensorflow::DT_UINT8, tensor.int_val().size()},
-      {tensorflow::DT_INT16, tensor.int_val().size()},
-      {tensorflow::DT_UINT16, tensor.int_val().size()},
-      {tensorflow::DT_DOUBLE, tensor.double_val().size()},
-      {tensorflow::DT_STRING, tensor.string_val().size()},
-      {tensorflow::DT_QINT8, tensor.int_val().size()},
-      {tensorflow::DT_QINT16, tensor.int_val().size()},
-      {tensorflow::DT_QINT32, tensor.int_val().size()},
-      {tensorflow::DT_QUINT8, tensor.int_val().size()},
-      {tensorflow::DT_QUINT16, tensor.int_val().size()},
-      {tensorflow::DT_COMPLEX64, tensor.scomplex_val().size()},
-      {tensorflow::DT_COMPLEX128, tensor.dcomplex_val().size()},
-      {tensorflow::DT_BFLOAT16, tensor.half_val().size()},
-      {tensorflow::DT_UINT32, tensor.uint32_val().size()},
-      {tensorflow::DT_UINT64, tensor.uint64_val().size()},
-      {tensorflow::DT_RESOURCE, tensor.resource_handle_val().size()},
-      {tensorflow::DT_VARIANT, tensor.variant_val().size()},
-      {tensorflow::DT_FLOAT_REF, tensor.float_val().size()},
-      {tensorflow::DT_INT32_REF, tensor.int_val().size()},
-      {tensorflow::DT_INT64_REF, tensor.int64_val().size()},
-      {tensorflow::DT_BOOL_REF, tensor.bool_val().size()},
-      {tensorflow::DT_HALF_REF, tensor.half_val().size()},
-      {tensorflow::DT_INT8_REF, tensor.int_val().size()},
-      {tensorflow::DT_UINT8_REF, tensor.int_val().size()},
-      {tensorflow::DT_INT16_REF, tensor.int_val().size()},
-      {tensorflow::DT_UINT16_REF, tensor.int_val().size()},
-      {tensorflow::DT_DOUBLE_REF, tensor.double_val().size()},
-      {tensorflow::DT_STRING_REF, tensor.string_val().size()},
-      {tensorflow::DT_QINT8_REF, tensor.int_val().size()},
-      {tensorflow::DT_QINT16_REF, tensor.int_val().size()},
-      {tensorflow::DT_QINT32_REF, tensor.int_val().size()},
-      {tensorflow::DT_QUINT8_REF, tensor.int_val().size()},
-      {tensorflow::DT_QUINT16_REF, tensor.int_val().size()},
-      {tensorflow::DT_COMPLEX64_REF, tensor.scomplex_val().size()},
-      {tensorflow::DT_COMPLEX128_REF, tensor.dcomplex_val().size()},
-      {tensorflow::DT_BFLOAT16_REF, tensor.half_val().size()},
-      {tensorflow::DT_UINT32_REF, tensor.uint32_val().size()},
-      {tensorflow::DT_UINT64_REF, tensor.uint64_val().size()},
-      {tensorflow::DT_RESOURCE_REF, tensor.resource_handle_val().size()},
-      {tensorflow::DT_VARIANT_REF, tensor.variant_val().size()},
-  };
   tensorflow::DataType data_type = tensor.dtype();
   int32_t datatype_val_size = 0;
-
-  auto iter = datatype_val_size_map.find(data_type);
-  if (iter != datatype_val_size_map.end()) {
-    datatype_val_size = iter->second;
-  } else {
+  if (!GetDataTypeValSize(tensor, datatype_val_size)) {
     GE_CHECK_GE(data_type, 0);
     GE_LOGE("datatype:%s not support.", DataType_Name(data_type).c_str());
     return FAILED;
@@ -399,15 +445,12 @@ Status TensorAssign::SetGeTensor(const TensorProto &tensor, GeTensorPtr &weight)
                                        "Dim size exceeds INT64_MAX");
         count *= dim;
       });
-  GeShape shape(shape_vec);
-  GeTensorDesc tmp_desc = weight->GetTensorDesc();
-  tmp_desc.SetShape(shape);
+  GeTensorDesc &weight_desc = weight->MutableTensorDesc();
+  weight_desc.SetShape(GeShape(std::move(shape_vec)));
 
   // Fixed input ND
-  tmp_desc.SetFormat(ge::Format::FORMAT_ND);
-  tmp_desc.SetOriginFormat(ge::Format::FORMAT_ND);
-
-  weight->SetTensorDesc(tmp_desc);
+  weight_desc.SetFormat(ge::Format::FORMAT_ND);
+  weight_desc.SetOriginFormat(ge::Format::FORMAT_ND);
 
   if (datatype_val_size > 0) {
     SetGeTensorWeightData(tensor, datatype_val_size, count, weight);
@@ -431,9 +474,7 @@ Status TensorAssign::SetGeTensor(const TensorProto &tensor, GeTensorPtr &weight)
 
 Status TensorAssign::SetGeTensorDataType(int64_t data_type, GeTensorPtr &weight) {
   GE_CHECK_NOTNULL(weight);
-  GeTensorDesc tmp_desc = weight->GetTensorDesc();
-  tmp_desc.SetDataType(ge::DataType(data_type));
-  weight->SetTensorDesc(tmp_desc);
+  weight->MutableTensorDesc().SetDataType(ge::DataType(data_type));
   return SUCCESS;
 }
 }  // namespace domi
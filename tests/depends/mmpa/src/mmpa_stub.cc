@@ -24,7 +24,7 @@ INT32 mmOpen(const CHAR *path_name, INT32 flags) {
     syslog(LOG_ERR, "The path name pointer is null.\r\n");
     return EN_INVALID_PARAM;
   }
-  if (0 == (flags & (O_RDONLY | O_WRONLY | O_RDWR | O_CREAT))) {
+  if ((flags != O_RDONLY) && (0 == (flags & (O_WRONLY | O_RDWR | O_CREAT)))) {
     syslog(LOG_ERR, "The file open mode is error.\r\n");
     return EN_INVALID_PARAM;
   }
@@ -207,11 +207,22 @@ INT32 mmGetFileSize(const CHAR *file_name, ULONGLONG *length) {
 
 INT32 mmScandir(const CHAR *path, mmDirent ***entryList, mmFilter filterFunc,  mmSort sort)
 {
-  return 0;
+  if ((path == NULL) || (entryList == NULL)) {
+    return EN_INVALID_PARAM;
+  }
+  INT32 count = scandir(path, entryList, filterFunc, sort);
+  return (count < 0) ? EN_ERROR : count;
 }
 
 VOID mmScandirFree(mmDirent **entryList, INT32 count)
 {
+  if (entryList == NULL) {
+    return;
+  }
+  for (INT32 i = 0; i < count; ++i) {
+    free(entryList[i]);
+  }
+  free(entryList);
 }
 
 INT32 mmAccess2(const CHAR *pathName, INT32 mode)
@@ -226,7 +237,10 @@ INT32 mmGetTimeOfDay(mmTimeval *timeVal, mmTimezone *timeZone)
 
 INT32 mmRealPath(const CHAR *path, CHAR *realPath, INT32 realPathLen)
 {
-  return 0;
+  if ((path == NULL) || (realPath == NULL) || (realPathLen < PATH_MAX)) {
+    return EN_INVALID_PARAM;
+  }
+  return (realpath(path, realPath) == NULL) ? EN_ERROR : EN_OK;
 }
 
 INT32 mmGetErrorCode()
@@ -236,22 +250,34 @@ INT32 mmGetErrorCode()
 
 INT32 mmIsDir(const CHAR *fileName)
 {
-  return 0;
+  struct stat fileStat;
+  if ((fileName == NULL) || (lstat(fileName, &fileStat) != 0)) {
+    return EN_ERROR;
+  }
+  return S_ISDIR(fileStat.st_mode) ? EN_OK : EN_ERROR;
 }
 
 INT32 mmGetEnv(const CHAR *name, CHAR *value, UINT32 len)
 {
-  return 0;
+  if ((name == NULL) || (value == NULL) || (len == 0)) {
+    return EN_INVALID_PARAM;
+  }
+  const CHAR *env = getenv(name);
+  if ((env == NULL) || (strlen(env) >= len)) {
+    return EN_ERROR;
+  }
+  (void)strcpy(value, env);
+  return EN_OK;
 }
 
 INT32 mmDlclose(VOID *handle)
 {
-  return 0;
+  return dlclose(handle);
 }
 
 CHAR *mmDlerror()
 {
-  return "";
+  return dlerror();
 }
 
 INT32 mmDladdr(VOID *addr, mmDlInfo *info)
@@ -261,15 +287,55 @@ INT32 mmDladdr(VOID *addr, mmDlInfo *info)
 
 VOID *mmDlopen(const CHAR *fileName, INT32 mode)
 {
-  return NULL;
+  return dlopen(fileName, mode);
 }
 
 VOID *mmDlsym(VOID *handle, const CHAR *funcName)
 {
-  return NULL;
+  return dlsym(handle, funcName);
 }
 
 INT32 mmGetPid()
 {
   return (INT32)getpid();
 }
+
+VOID *mmMmap(mmFd_t fd, mmSize_t size, mmOfft_t offset, mmFd_t *extra, INT32 prot, INT32 flags)
+{
+  return mmap(NULL, size, prot, flags, fd, offset);
+}
+
+INT32 mmMunMap(VOID *data, mmSize_t size, mmFd_t *extra)
+{
+  return munmap(data, size);
+}
+
+INT32 mmRWLockInit(mmRWLock_t *rwLock)
+{
+  return pthread_rwlock_init(rwLock, NULL);
+}
+
+INT32 mmRWLockRDLock(mmRWLock_t *rwLock)
+{
+  return pthread_rwlock_rdlock(rwLock);
+}
+
+INT32 mmRWLockWRLock(mmRWLock_t *rwLock)
+{
+  return pthread_rwlock_wrlock(rwLock);
+}
+
+INT32 mmRDLockUnLock(mmRWLock_t *rwLock)
+{
+  return pthread_rwlock_unlock(rwLock);
+}
+
+INT32 mmWRLockUnLock(mmRWLock_t *rwLock)
+{
+  return pthread_rwlock_unlock(rwLock);
+}
+
+INT32 mmRWLockDestroy(mmRWLock_t *rwLock)
+{
+  return pthread_rwlock_destroy(rwLock);
+}
@@ -0,0 +1,89 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "graph/anchor.h"
+#include "graph/compute_graph.h"
+#include "graph/node.h"
+#include "graph/utils/graph_utils.h"
+#include "common/graph_builder_utils.h"
+
+using namespace ge;
+
+namespace {
+const int kRepeatTimes = 5;
+
+double ElapsedMs(const std::chrono::steady_clock::time_point &start) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Links a const to fan_out consumers by data and control edges, then looks every link up and unlinks them from the
+// middle outwards, so that neither end of the peer list is cheap. Best of kRepeatTimes runs in ms, negative on error
+bool Run(int fan_out, double &link_ms, double &unlink_ms) {
+  link_ms = -1.0;
+  unlink_ms = -1.0;
+  for (int round = 0; round < kRepeatTimes; ++round) {
+    auto graph = std::make_shared<ComputeGraph>("graph");
+    auto src = ut::AddNode(graph, "const", "Op", 0, 1);
+    std::vector<NodePtr> dsts;
+    for (int i = 0; i < fan_out; ++i) {
+      dsts.push_back(ut::AddNode(graph, "dst" + std::to_string(i), "Op", 1, 0));
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (const auto &dst : dsts) {
+      if ((GraphUtils::AddEdge(src->GetOutDataAnchor(0), dst->GetInDataAnchor(0)) != GRAPH_SUCCESS) ||
+          (GraphUtils::AddEdge(src->GetOutControlAnchor(), dst->GetInControlAnchor()) != GRAPH_SUCCESS)) {
+        return false;
+      }
+    }
+    double link_cost = ElapsedMs(start);
+    start = std::chrono::steady_clock::now();
+    for (const auto &dst : dsts) {
+      if (!src->GetOutDataAnchor(0)->IsLinkedWith(dst->GetInDataAnchor(0))) {
+        return false;
+      }
+    }
+    for (int i = 0; i < fan_out; ++i) {
+      int index = (i % 2 == 0) ? (fan_out / 2 + i / 2) : (fan_out / 2 - 1 - i / 2);
+      if ((GraphUtils::RemoveEdge(src->GetOutDataAnchor(0), dsts[index]->GetInDataAnchor(0)) != GRAPH_SUCCESS) ||
+          (GraphUtils::RemoveEdge(src->GetOutControlAnchor(), dsts[index]->GetInControlAnchor()) != GRAPH_SUCCESS)) {
+        return false;
+      }
+    }
+    double unlink_cost = ElapsedMs(start);
+    link_ms = (link_ms < 0.0) ? link_cost : std::min(link_ms, link_cost);
+    unlink_ms = (unlink_ms < 0.0) ? unlink_cost : std::min(unlink_ms, unlink_cost);
+  }
+  return true;
+}
+}  // namespace
+
+int main() {
+  for (int fan_out : {1000, 20000, 100000}) {
+    double link_ms = 0.0;
+    double unlink_ms = 0.0;
+    if (!Run(fan_out, link_ms, unlink_ms)) {
+      printf("%d consumers: failed\n", fan_out);
+      return 1;
+    }
+    printf("%d consumers  link: %.2fms  lookup and unlink: %.2fms\n", fan_out, link_ms, unlink_ms);
+  }
+  return 0;
+}
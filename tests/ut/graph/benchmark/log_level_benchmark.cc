@@ -0,0 +1,110 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "framework/common/debug/ge_log.h"
+
+// slog is replaced here, so the level can be changed and the calls into it counted
+namespace {
+const int kRepeatTimes = 5;
+const int kCallNum = 10000000;
+std::atomic<int> g_level(DLOG_INFO);
+std::atomic<int> g_check_num(0);
+}  // namespace
+
+int dlog_setlevel(int module_id, int level, int enable_event) {
+  (void)module_id;
+  (void)enable_event;
+  g_level = level;
+  return 0;
+}
+
+__attribute__((noinline)) int CheckLogLevel(int moduleId, int logLevel) {
+  (void)moduleId;
+  ++g_check_num;
+  return (logLevel >= g_level) ? 1 : 0;
+}
+
+void DlogDebugInner(int module_id, const char *fmt, ...) {
+  (void)module_id;
+  (void)fmt;
+}
+
+void DlogInfoInner(int module_id, const char *fmt, ...) {
+  (void)module_id;
+  (void)fmt;
+}
+
+void DlogWarnInner(int module_id, const char *fmt, ...) {
+  (void)module_id;
+  (void)fmt;
+}
+
+namespace {
+// Best of kRepeatTimes runs in ns per call
+template <typename Func>
+double Run(const Func &func) {
+  double best = -1.0;
+  for (int i = 0; i < kRepeatTimes; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    for (int n = 0; n < kCallNum; ++n) {
+      func(n);
+    }
+    double cost = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    best = (best < 0.0) ? (cost / kCallNum) : std::min(best, cost / kCallNum);
+  }
+  return best;
+}
+
+// Calls until the level is seen, a change is picked up on the first check after the cache expired
+bool WaitForLevel(bool debug_on) {
+  for (int n = 0; n < 2 * 1024; ++n) {
+    if (IsLogEnable(GE_MODULE_NAME, DLOG_DEBUG) == debug_on) {
+      return true;
+    }
+  }
+  return false;
+}
+}  // namespace
+
+int main() {
+  double cached = Run([](int n) { GELOGD("disabled %d", n); });
+  double direct = Run([](int n) {
+    if (CheckLogLevel(GE_MODULE_NAME, DLOG_DEBUG) == 1) {
+      dlog_debug(GE_MODULE_NAME, "disabled %d", n);
+    }
+  });
+  printf("disabled GELOGD: cached %.2fns  CheckLogLevel %.2fns\n", cached, direct);
+
+  g_check_num = 0;
+  (void)Run([](int n) { GELOGD("disabled %d", n); });
+  printf("slog level checks for %d disabled GELOGD: %d\n", kRepeatTimes * kCallNum, g_check_num.load());
+
+  (void)dlog_setlevel(GE_MODULE_NAME, DLOG_DEBUG, 0);
+  GeLog::RefreshLogLevel();
+  printf("debug on after RefreshLogLevel: %s\n", IsLogEnable(GE_MODULE_NAME, DLOG_DEBUG) ? "yes" : "no");
+  (void)dlog_setlevel(GE_MODULE_NAME, DLOG_INFO, 0);
+  bool seen = WaitForLevel(false);
+  printf("debug off seen without waiting: %s\n", seen ? "yes" : "no");
+  std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+  seen = WaitForLevel(false);
+  printf("debug off seen after 1.1s: %s\n", seen ? "yes" : "no");
+  return 0;
+}
@@ -0,0 +1,90 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "graph/compute_graph.h"
+#include "graph/operator_reg.h"
+#include "graph/utils/graph_utils.h"
+
+namespace ge {
+REG_OP(BenchConst)
+    .OUTPUT(y, TensorType::ALL())
+    .OP_END_FACTORY_REG(BenchConst)
+
+REG_OP(BenchAdd)
+    .INPUT(x1, TensorType::ALL())
+    .INPUT(x2, TensorType::ALL())
+    .OUTPUT(y, TensorType::ALL())
+    .OP_END_FACTORY_REG(BenchAdd)
+}  // namespace ge
+
+using namespace ge;
+
+namespace {
+const int kRepeatTimes = 5;
+
+// const -> add_0 -> add_1 -> ... with every add also reading const, and add_i control depending on add_{i-2}
+std::vector<op::BenchAdd> BuildChain(op::BenchConst &const_op, int add_num) {
+  std::vector<op::BenchAdd> adds;
+  adds.reserve(add_num);
+  for (int i = 0; i < add_num; ++i) {
+    adds.emplace_back("add_" + std::to_string(i));
+    if (i == 0) {
+      adds[i].set_input_x1(const_op);
+    } else {
+      adds[i].set_input_x1(adds[i - 1]);
+    }
+    adds[i].set_input_x2(const_op);
+    if (i >= 2) {
+      adds[i].AddControlInput(adds[i - 2]);
+    }
+  }
+  return adds;
+}
+
+// Best of kRepeatTimes builds in ms, negative when the graph is not built
+double Run(int add_num) {
+  op::BenchConst const_op("const");
+  auto adds = BuildChain(const_op, add_num);
+  double best = -1.0;
+  for (int i = 0; i < kRepeatTimes; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    auto graph = GraphUtils::CreateGraphFromOperator("graph", {const_op});
+    double cost = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if ((graph == nullptr) || (graph->GetDirectNodesSize() != static_cast<size_t>(add_num + 1))) {
+      return -1.0;
+    }
+    best = (best < 0.0) ? cost : std::min(best, cost);
+  }
+  return best;
+}
+}  // namespace
+
+int main() {
+  for (int add_num : {1000, 20000, 100000}) {
+    double cost = Run(add_num);
+    if (cost < 0.0) {
+      printf("%d operators: failed\n", add_num);
+      return 1;
+    }
+    printf("%d operators  build: %.2fms\n", add_num, cost);
+  }
+  return 0;
+}
@@ -0,0 +1,135 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "common/blocking_queue.h"
+#include "common/ring_queue.h"
+
+namespace {
+const int kRepeatTimes = 5;
+const int kProducerNum = 2;
+const int kConsumerNum = 2;
+const int64_t kItemsPerProducer = 200000;
+const int64_t kLatencySamples = 20000;
+
+int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Producers push [1, kItemsPerProducer] each, consumers sum until every item is received; returns elapsed ns
+template <typename Queue>
+int64_t RunThroughput(Queue &queue, int64_t &sum) {
+  std::atomic<int64_t> total(0);
+  std::atomic<int64_t> received(0);
+  const int64_t expect_num = kProducerNum * kItemsPerProducer;
+  const int64_t start = NowNs();
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kConsumerNum; ++i) {
+    threads.emplace_back([&queue, &total, &received, expect_num]() {
+      int64_t item = 0;
+      while (received.load() < expect_num && queue.Pop(item)) {
+        total += item;
+        if (++received == expect_num) {
+          queue.Stop();
+        }
+      }
+    });
+  }
+  for (int i = 0; i < kProducerNum; ++i) {
+    threads.emplace_back([&queue]() {
+      for (int64_t item = 1; item <= kItemsPerProducer; ++item) {
+        if (!queue.Push(item)) {
+          break;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  sum = total.load();
+  return NowNs() - start;
+}
+
+// Ping-pong between two threads; returns the median round trip in ns
+template <typename Queue>
+int64_t RunLatency(Queue &ping, Queue &pong) {
+  std::thread echo([&ping, &pong]() {
+    int64_t item = 0;
+    while (ping.Pop(item) && item >= 0) {
+      pong.Push(item);
+    }
+  });
+  std::vector<int64_t> samples;
+  samples.reserve(kLatencySamples);
+  int64_t item = 0;
+  for (int64_t i = 0; i < kLatencySamples; ++i) {
+    const int64_t start = NowNs();
+    ping.Push(i);
+    pong.Pop(item);
+    samples.push_back(NowNs() - start);
+  }
+  ping.Push(-1);
+  echo.join();
+  std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+  return samples[samples.size() / 2];
+}
+
+// Best of kRepeatTimes runs in ns per item and ns per round trip, false when an item is lost
+template <typename Queue>
+bool Run(double &item_ns, int64_t &round_trip_ns) {
+  const int64_t item_num = kProducerNum * kItemsPerProducer;
+  const int64_t expect_sum = kProducerNum * kItemsPerProducer * (kItemsPerProducer + 1) / 2;
+  item_ns = -1.0;
+  round_trip_ns = -1;
+  for (int i = 0; i < kRepeatTimes; ++i) {
+    Queue queue(256);
+    int64_t sum = 0;
+    double cost = static_cast<double>(RunThroughput(queue, sum)) / item_num;
+    if (sum != expect_sum) {
+      return false;
+    }
+    Queue ping(16);
+    Queue pong(16);
+    int64_t latency = RunLatency(ping, pong);
+    item_ns = (item_ns < 0.0) ? cost : std::min(item_ns, cost);
+    round_trip_ns = (round_trip_ns < 0) ? latency : std::min(round_trip_ns, latency);
+  }
+  return true;
+}
+}  // namespace
+
+int main() {
+  double item_ns = 0.0;
+  int64_t round_trip_ns = 0;
+  if (!Run<RingQueue<int64_t>>(item_ns, round_trip_ns)) {
+    printf("RingQueue: failed\n");
+    return 1;
+  }
+  printf("RingQueue      %.2fns/item  round trip: %ldns\n", item_ns, static_cast<long>(round_trip_ns));
+  if (!Run<BlockingQueue<int64_t>>(item_ns, round_trip_ns)) {
+    printf("BlockingQueue: failed\n");
+    return 1;
+  }
+  printf("BlockingQueue  %.2fns/item  round trip: %ldns\n", item_ns, static_cast<long>(round_trip_ns));
+  return 0;
+}
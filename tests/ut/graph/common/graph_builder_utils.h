@@ -0,0 +1,44 @@
+/**
+ * Copyright 2020 Huawei Technologies Co., Ltd
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ * http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef UT_GRAPH_COMMON_GRAPH_BUILDER_UTILS_H_
+#define UT_GRAPH_COMMON_GRAPH_BUILDER_UTILS_H_
+
+#include <memory>
+#include <string>
+#include "graph/compute_graph.h"
+#include "graph/ge_tensor.h"
+#include "graph/node.h"
+#include "graph/op_desc.h"
+
+namespace ge {
+namespace ut {
+// Adds a node with inputs x0, x1, ... and outputs y0, y1, ..., all described by desc
+inline NodePtr AddNode(const ComputeGraphPtr &graph, const std::string &name, const std::string &type, int in_num,
+                       int out_num, const GeTensorDesc &desc = GeTensorDesc()) {
+  auto op_desc = std::make_shared<OpDesc>(name, type);
+  for (int i = 0; i < in_num; ++i) {
+    (void)op_desc->AddInputDesc("x" + std::to_string(i), desc);
+  }
+  for (int i = 0; i < out_num; ++i) {
+    (void)op_desc->AddOutputDesc("y" + std::to_string(i), desc);
+  }
+  return graph->AddNode(op_desc);
+}
+}  // namespace ut
+}  // namespace ge
+
+#endif  // UT_GRAPH_COMMON_GRAPH_BUILDER_UTILS_H_
@@ -0,0 +1,28 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "graph/operator_factory.h"
+
+// An ops proto library registering OPS_PROTO_STUB_OP_TYPE from its initializers, as REG_OP does
+namespace {
+const char *const kOpType = OPS_PROTO_STUB_OP_TYPE;
+
+ge::OperatorCreatorRegister g_creator_register(kOpType, [](const ge::AscendString &name) {
+  return ge::Operator(name.GetString(), kOpType);
+});
+
+ge::InferShapeFuncRegister g_infer_shape_register(kOpType, [](ge::Operator &) { return ge::GRAPH_SUCCESS; });
+}  // namespace
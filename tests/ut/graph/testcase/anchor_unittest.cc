@@ -0,0 +1,134 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "graph/anchor.h"
+#include "graph/compute_graph.h"
+#include "graph/node.h"
+#include "graph/utils/graph_utils.h"
+#include "common/graph_builder_utils.h"
+
+namespace ge {
+namespace {
+// well past AnchorLinks::kIndexMinSize, so the links are indexed
+const int kFanOutNum = 200;
+
+std::vector<std::string> PeerNames(const AnchorPtr &anchor) {
+  std::vector<std::string> names;
+  (void)anchor->ForEachPeerAnchor([&names](const AnchorPtr &peer) {
+    names.push_back(peer->GetOwnerNode()->GetName() + ":" + std::to_string(peer->GetIdx()));
+  });
+  return names;
+}
+}  // namespace
+
+class UtestAnchor : public testing::Test {
+ protected:
+  void SetUp() {}
+  void TearDown() {}
+};
+
+TEST_F(UtestAnchor, unlink_keeps_link_order) {
+  auto graph = std::make_shared<ComputeGraph>("graph");
+  auto src = ut::AddNode(graph, "src", "Op", 0, 1);
+  std::vector<NodePtr> dsts;
+  std::vector<std::string> expect;
+  for (int i = 0; i < 40; ++i) {
+    dsts.push_back(ut::AddNode(graph, "dst" + std::to_string(i), "Op", 1, 0));
+    ASSERT_EQ(src->GetOutDataAnchor(0)->LinkTo(dsts.back()->GetInDataAnchor(0)), GRAPH_SUCCESS);
+  }
+  for (int i = 0; i < 40; ++i) {
+    if (i % 3 == 0) {
+      ASSERT_EQ(src->GetOutDataAnchor(0)->Unlink(dsts[i]->GetInDataAnchor(0)), GRAPH_SUCCESS);
+    } else {
+      expect.push_back("dst" + std::to_string(i) + ":0");
+    }
+  }
+  auto out_anchor = src->GetOutDataAnchor(0);
+  EXPECT_EQ(PeerNames(out_anchor), expect);
+  EXPECT_EQ(out_anchor->GetPeerAnchorsSize(), expect.size());
+  EXPECT_EQ(out_anchor->GetPeerInDataAnchors().size(), expect.size());
+  EXPECT_EQ(out_anchor->GetFirstPeerAnchor(), dsts[1]->GetInDataAnchor(0));
+  EXPECT_FALSE(out_anchor->IsLinkedWith(dsts[0]->GetInDataAnchor(0)));
+  EXPECT_TRUE(out_anchor->IsLinkedWith(dsts[1]->GetInDataAnchor(0)));
+  EXPECT_NE(out_anchor->Unlink(dsts[0]->GetInDataAnchor(0)), GRAPH_SUCCESS);
+  EXPECT_EQ(dsts[0]->GetInDataAnchor(0)->GetPeerOutAnchor(), nullptr);
+  EXPECT_EQ(dsts[1]->GetInDataAnchor(0)->GetPeerOutAnchor(), out_anchor);
+
+  // the replacement takes the place of the old peer
+  auto mid = ut::AddNode(graph, "mid", "Op", 1, 1);
+  ASSERT_EQ(out_anchor->ReplacePeer(dsts[2]->GetInDataAnchor(0), mid->GetInDataAnchor(0), mid->GetOutDataAnchor(0)),
+            GRAPH_SUCCESS);
+  expect[1] = "mid:0";
+  EXPECT_EQ(PeerNames(out_anchor), expect);
+  EXPECT_EQ(dsts[2]->GetInDataAnchor(0)->GetPeerOutAnchor(), mid->GetOutDataAnchor(0));
+
+  out_anchor->UnlinkAll();
+  EXPECT_EQ(out_anchor->GetPeerAnchorsSize(), 0U);
+  EXPECT_EQ(out_anchor->GetFirstPeerAnchor(), nullptr);
+  EXPECT_EQ(dsts[1]->GetInDataAnchor(0)->GetPeerOutAnchor(), nullptr);
+}
+
+TEST_F(UtestAnchor, unlink_repeated_control_links) {
+  auto graph = std::make_shared<ComputeGraph>("graph");
+  auto src = ut::AddNode(graph, "src", "Op", 0, 0);
+  std::vector<NodePtr> dsts;
+  for (int i = 0; i < 20; ++i) {
+    dsts.push_back(ut::AddNode(graph, "dst" + std::to_string(i), "Op", 0, 0));
+    ASSERT_EQ(src->GetOutControlAnchor()->LinkTo(dsts.back()->GetInControlAnchor()), GRAPH_SUCCESS);
+  }
+  ASSERT_EQ(src->GetOutControlAnchor()->LinkTo(dsts[5]->GetInControlAnchor()), GRAPH_SUCCESS);
+  EXPECT_EQ(src->GetOutControlAnchor()->GetPeerAnchorsSize(), 21U);
+  ASSERT_EQ(src->GetOutControlAnchor()->Unlink(dsts[5]->GetInControlAnchor()), GRAPH_SUCCESS);
+  EXPECT_TRUE(src->GetOutControlAnchor()->IsLinkedWith(dsts[5]->GetInControlAnchor()));
+  EXPECT_EQ(PeerNames(src->GetOutControlAnchor()).back(), "dst5:-1");
+  ASSERT_EQ(src->GetOutControlAnchor()->Unlink(dsts[5]->GetInControlAnchor()), GRAPH_SUCCESS);
+  EXPECT_FALSE(src->GetOutControlAnchor()->IsLinkedWith(dsts[5]->GetInControlAnchor()));
+  EXPECT_EQ(dsts[5]->GetInControlAnchor()->GetPeerAnchorsSize(), 0U);
+}
+
+TEST_F(UtestAnchor, fan_out_link_unlink) {
+  auto graph = std::make_shared<ComputeGraph>("graph");
+  auto src = ut::AddNode(graph, "const", "Op", 0, 1);
+  std::vector<NodePtr> dsts;
+  for (int i = 0; i < kFanOutNum; ++i) {
+    dsts.push_back(ut::AddNode(graph, "dst" + std::to_string(i), "Op", 1, 0));
+  }
+  for (const auto &dst : dsts) {
+    ASSERT_EQ(GraphUtils::AddEdge(src->GetOutDataAnchor(0), dst->GetInDataAnchor(0)), GRAPH_SUCCESS);
+    ASSERT_EQ(GraphUtils::AddEdge(src->GetOutControlAnchor(), dst->GetInControlAnchor()), GRAPH_SUCCESS);
+  }
+  size_t visited = 0U;
+  EXPECT_TRUE(src->GetOutDataAnchor(0)->ForEachPeerAnchor([&visited](const AnchorPtr &peer) {
+    visited += (peer != nullptr);
+  }));
+  EXPECT_EQ(visited, static_cast<size_t>(kFanOutNum));
+  for (const auto &dst : dsts) {
+    ASSERT_TRUE(src->GetOutDataAnchor(0)->IsLinkedWith(dst->GetInDataAnchor(0)));
+  }
+  // unlink from the middle outwards so that neither end is cheap
+  for (int i = 0; i < kFanOutNum; ++i) {
+    int index = (i % 2 == 0) ? (kFanOutNum / 2 + i / 2) : (kFanOutNum / 2 - 1 - i / 2);
+    ASSERT_EQ(GraphUtils::RemoveEdge(src->GetOutDataAnchor(0), dsts[index]->GetInDataAnchor(0)), GRAPH_SUCCESS);
+    ASSERT_EQ(GraphUtils::RemoveEdge(src->GetOutControlAnchor(), dsts[index]->GetInControlAnchor()), GRAPH_SUCCESS);
+    EXPECT_FALSE(src->GetOutDataAnchor(0)->IsLinkedWith(dsts[index]->GetInDataAnchor(0)));
+  }
+  EXPECT_EQ(src->GetOutDataAnchor(0)->GetPeerAnchorsSize(), 0U);
+  EXPECT_EQ(src->GetOutControlAnchor()->GetPeerAnchorsSize(), 0U);
+}
+}  // namespace ge
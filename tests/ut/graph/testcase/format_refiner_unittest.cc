@@ -0,0 +1,77 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "graph/compute_graph.h"
+#include "graph/utils/graph_utils.h"
+#include "common/graph_builder_utils.h"
+
+namespace ge {
+namespace {
+GeTensorDesc OriginDesc(Format format, const std::vector<int64_t> &dims) {
+  GeTensorDesc desc(GeShape(dims), format, DT_FLOAT);
+  desc.SetOriginFormat(format);
+  return desc;
+}
+
+Format OriginInputFormat(const NodePtr &node, uint32_t index) {
+  return node->GetOpDesc()->GetInputDesc(index).GetOriginFormat();
+}
+
+Format OriginOutputFormat(const NodePtr &node, uint32_t index) {
+  return node->GetOpDesc()->GetOutputDesc(index).GetOriginFormat();
+}
+}  // namespace
+
+class UtestFormatRefiner : public testing::Test {
+ protected:
+  void SetUp() {}
+  void TearDown() {}
+};
+
+// data -> relu -> conv(NCHW) -> add -> netoutput, scalar -> add, data -> squeeze(3d)
+TEST_F(UtestFormatRefiner, propagate_anchor_format_both_ways) {
+  auto graph = std::make_shared<ComputeGraph>("graph");
+  std::vector<int64_t> dims = {1, 3, 16, 16};
+  auto data = ut::AddNode(graph, "data", "Data", 1, 1, OriginDesc(FORMAT_ND, dims));
+  auto relu = ut::AddNode(graph, "relu", "Relu", 1, 1, OriginDesc(FORMAT_ND, dims));
+  auto conv = ut::AddNode(graph, "conv", "Conv2D", 1, 1, OriginDesc(FORMAT_NCHW, dims));
+  auto scalar = ut::AddNode(graph, "scalar", "Data", 1, 1, OriginDesc(FORMAT_ND, {}));
+  auto add = ut::AddNode(graph, "add", "Add", 2, 1, OriginDesc(FORMAT_ND, dims));
+  add->GetOpDesc()->MutableInputDesc(1)->SetShape(GeShape());
+  auto squeeze = ut::AddNode(graph, "squeeze", "Squeeze", 1, 1, OriginDesc(FORMAT_ND, {3, 16, 16}));
+  auto output = ut::AddNode(graph, "output", "NetOutput", 1, 0, OriginDesc(FORMAT_ND, dims));
+  GraphUtils::AddEdge(data->GetOutDataAnchor(0), relu->GetInDataAnchor(0));
+  GraphUtils::AddEdge(data->GetOutDataAnchor(0), squeeze->GetInDataAnchor(0));
+  GraphUtils::AddEdge(relu->GetOutDataAnchor(0), conv->GetInDataAnchor(0));
+  GraphUtils::AddEdge(conv->GetOutDataAnchor(0), add->GetInDataAnchor(0));
+  GraphUtils::AddEdge(scalar->GetOutDataAnchor(0), add->GetInDataAnchor(1));
+  GraphUtils::AddEdge(add->GetOutDataAnchor(0), output->GetInDataAnchor(0));
+
+  ASSERT_EQ(graph->InferOriginFormat(), GRAPH_SUCCESS);
+  EXPECT_EQ(OriginOutputFormat(data, 0), FORMAT_NCHW);
+  EXPECT_EQ(OriginInputFormat(relu, 0), FORMAT_NCHW);
+  EXPECT_EQ(OriginOutputFormat(relu, 0), FORMAT_NCHW);
+  EXPECT_EQ(OriginInputFormat(add, 0), FORMAT_NCHW);
+  EXPECT_EQ(OriginOutputFormat(add, 0), FORMAT_NCHW);
+  EXPECT_EQ(OriginInputFormat(output, 0), FORMAT_NCHW);
+  EXPECT_EQ(OriginInputFormat(add, 1), FORMAT_NCHW);
+  EXPECT_EQ(OriginOutputFormat(scalar, 0), FORMAT_ND);
+  EXPECT_EQ(OriginInputFormat(squeeze, 0), FORMAT_ND);
+  EXPECT_EQ(relu->GetOpDesc()->GetOutputDesc(0).GetFormat(), FORMAT_NCHW);
+}
+}  // namespace ge
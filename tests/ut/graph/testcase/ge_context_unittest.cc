@@ -0,0 +1,65 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <thread>
+#include "graph/ge_context.h"
+#include "graph/ge_local_context.h"
+
+namespace ge {
+class UtestGeContext : public testing::Test {
+ protected:
+  void SetUp() {}
+  void TearDown() {}
+};
+
+// every case runs on a thread of its own, so the options of other tests do not leak in
+TEST_F(UtestGeContext, int_option_follows_option_change) {
+  std::thread([]() {
+    GEThreadLocalContext &context = GetThreadLocalContext();
+    int64_t value = 0;
+    EXPECT_EQ(context.GetOptionVersion(), 0U);
+    EXPECT_EQ(context.GetOption(IntOption::kGraphRunMode, value), GRAPH_PARAM_INVALID);
+
+    context.SetSessionOption({{"ge.graphRunMode", "1"}, {"ge.exec.deviceId", "dev"}});
+    uint64_t version = context.GetOptionVersion();
+    EXPECT_NE(version, 0U);
+    ASSERT_EQ(GetContext().GetOption(IntOption::kGraphRunMode, value), GRAPH_SUCCESS);
+    EXPECT_EQ(value, 1);
+    EXPECT_EQ(context.GetOption(IntOption::kDeviceId, value), GRAPH_PARAM_INVALID);
+
+    // the graph options take precedence, and the slot is parsed again
+    context.SetGraphOption({{"ge.graphRunMode", "0"}});
+    EXPECT_NE(context.GetOptionVersion(), version);
+    ASSERT_EQ(context.GetOption(IntOption::kGraphRunMode, value), GRAPH_SUCCESS);
+    EXPECT_EQ(value, 0);
+
+    std::string str_value;
+    ASSERT_EQ(GetContext().GetOption("ge.graphRunMode", str_value), GRAPH_SUCCESS);
+    EXPECT_EQ(str_value, "0");
+  }).join();
+}
+
+TEST_F(UtestGeContext, host_exec_flag_follows_option_change) {
+  std::thread([]() {
+    EXPECT_FALSE(GetContext().GetHostExecFlag());
+    GetThreadLocalContext().SetGraphOption({{"ge.exec.placement", "HOST"}});
+    EXPECT_TRUE(GetContext().GetHostExecFlag());
+    GetThreadLocalContext().SetGraphOption({{"ge.exec.placement", "DEVICE"}});
+    EXPECT_FALSE(GetContext().GetHostExecFlag());
+  }).join();
+}
+}  // namespace ge
@@ -0,0 +1,134 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <set>
+#include <string>
+#include "graph/utils/ge_ir_utils.h"
+#include "graph/utils/attr_utils.h"
+#include "common/graph_builder_utils.h"
+
+namespace ge {
+namespace {
+// The attributes give the dump something to filter
+NodePtr AddNodeWithAttrs(const ComputeGraphPtr &graph, const std::string &name, const std::string &type) {
+  auto node = ut::AddNode(graph, name, type, 1, 1, GeTensorDesc(GeShape({1, 16}), FORMAT_ND, DT_FLOAT));
+  (void)AttrUtils::SetInt(node->GetOpDesc(), "index", 1);
+  (void)AttrUtils::SetListStr(node->GetOpDesc(), "names", {"a", "b"});
+  return node;
+}
+
+// root: data -> case, every branch of the case is a subgraph of its own
+ComputeGraphPtr BuildGraphWithSubgraphs(size_t branch_num) {
+  auto root = std::make_shared<ComputeGraph>("root");
+  auto data = AddNodeWithAttrs(root, "data", "Data");
+  auto case_node = AddNodeWithAttrs(root, "case", "Case");
+  (void)GraphUtils::AddEdge(data->GetOutDataAnchor(0), case_node->GetInDataAnchor(0));
+  for (size_t i = 0U; i < branch_num; ++i) {
+    auto branch = std::make_shared<ComputeGraph>("branch_" + std::to_string(i));
+    auto branch_data = AddNodeWithAttrs(branch, branch->GetName() + "_data", "Data");
+    auto relu = AddNodeWithAttrs(branch, branch->GetName() + "_relu", "Relu");
+    (void)GraphUtils::AddEdge(branch_data->GetOutDataAnchor(0), relu->GetInDataAnchor(0));
+    branch->SetParentGraph(root);
+    branch->SetParentNode(case_node);
+    case_node->GetOpDesc()->AddSubgraphName(branch->GetName());
+    case_node->GetOpDesc()->SetSubgraphInstanceName(i, branch->GetName());
+    (void)root->AddSubgraph(branch);
+  }
+  return root;
+}
+
+// Attribute names of the data node, which comes first
+std::set<std::string> GetDataNodeAttrNames(const Model &model) {
+  std::set<std::string> names;
+  onnx::ModelProto model_proto;
+  if (OnnxUtils::ConvertGeModelToModelProto(model, model_proto) && (model_proto.graph().node_size() > 0)) {
+    for (const auto &attr : model_proto.graph().node(0).attribute()) {
+      (void)names.insert(attr.name());
+    }
+  }
+  return names;
+}
+}  // namespace
+
+class UtestOnnxUtils : public testing::Test {
+ protected:
+  void SetUp() {}
+  void TearDown() {}
+};
+
+TEST_F(UtestOnnxUtils, arena_model_matches_heap_model) {
+  const size_t kBranchNum = 6U;
+  Model model("GE", "");
+  model.SetGraph(GraphUtils::CreateGraphFromComputeGraph(BuildGraphWithSubgraphs(kBranchNum)));
+
+  onnx::ModelProto heap_proto;
+  ASSERT_TRUE(OnnxUtils::ConvertGeModelToModelProto(model, heap_proto));
+  // the subgraph nodes follow the root nodes in subgraph order, whichever thread encoded them
+  ASSERT_EQ(heap_proto.graph().node_size(), static_cast<int>(2U + kBranchNum));
+  for (size_t i = 0U; i < kBranchNum; ++i) {
+    const auto &node_proto = heap_proto.graph().node(static_cast<int>(2U + i));
+    EXPECT_EQ(node_proto.name(), "branch_" + std::to_string(i));
+    ASSERT_EQ(node_proto.attribute_size(), 1);
+    EXPECT_EQ(node_proto.attribute(0).g().node_size(), 2);
+  }
+
+  // the second model is encoded into the block the first one left behind
+  for (int round = 0; round < 2; ++round) {
+    auto arena_proto = OnnxUtils::ConvertGeModelToModelProto(model);
+    ASSERT_NE(arena_proto, nullptr);
+    EXPECT_NE(arena_proto->GetArena(), nullptr);
+    EXPECT_EQ(arena_proto->SerializeAsString(), heap_proto.SerializeAsString());
+  }
+
+  Model loaded;
+  ASSERT_TRUE(OnnxUtils::ConvertModelProtoToGeModel(heap_proto, loaded));
+  auto loaded_graph = GraphUtils::GetComputeGraph(loaded.GetGraph());
+  ASSERT_NE(loaded_graph, nullptr);
+  EXPECT_NE(loaded_graph->FindNode("case"), nullptr);
+}
+
+// DUMP_GE_GRAPH is read once per process, so every level is encoded by a fresh copy of the test binary
+TEST_F(UtestOnnxUtils, dump_level_without_desc_attr) {
+  Model model("GE", "");
+  model.SetGraph(GraphUtils::CreateGraphFromComputeGraph(BuildGraphWithSubgraphs(1U)));
+  const char *env = getenv("DUMP_GE_GRAPH");
+  std::string old_level = (env == nullptr) ? "" : env;
+  testing::GTEST_FLAG(death_test_style) = "threadsafe";
+  ASSERT_EQ(setenv("DUMP_GE_GRAPH", "1", 1), 0);
+  EXPECT_EXIT({
+    auto names = GetDataNodeAttrNames(model);
+    bool full = (names.count("input_desc_layout:0") == 1U) && (names.count("input_desc_origin_dtype:0") == 1U) &&
+                (names.count("output_desc_origin_shape:0") == 1U);
+    exit(full ? 0 : 1);
+  }, testing::ExitedWithCode(0), "");
+
+  ASSERT_EQ(setenv("DUMP_GE_GRAPH", "4", 1), 0);
+  EXPECT_EXIT({
+    auto names = GetDataNodeAttrNames(model);
+    bool reduced = (names.count("input_desc_dtype:0") == 1U) && (names.count("input_desc_shape:0") == 1U) &&
+                   (names.count("input_desc_layout:0") == 1U) && (names.count("output_desc_layout:0") == 1U) &&
+                   (names.count("input_desc_origin_dtype:0") == 0U) && (names.count("output_desc_origin_shape:0") == 0U);
+    exit(reduced ? 0 : 1);
+  }, testing::ExitedWithCode(0), "");
+  if (env == nullptr) {
+    (void)unsetenv("DUMP_GE_GRAPH");
+  } else {
+    (void)setenv("DUMP_GE_GRAPH", old_level.c_str(), 1);
+  }
+}
+}  // namespace ge
@@ -0,0 +1,224 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "graph/compute_graph.h"
+#include "graph/ge_tensor.h"
+#include "graph/gnode.h"
+#include "graph/tensor.h"
+#include "graph/utils/attr_utils.h"
+#include "graph/utils/node_adapter.h"
+#include "graph/utils/tensor_adapter.h"
+#include "graph/utils/tensor_utils.h"
+
+namespace ge {
+namespace {
+const size_t kDataSize = 1024U;
+
+bool IsAligned(const uint8_t *data) {
+  return (reinterpret_cast<uintptr_t>(data) % kAlignmentBytes) == 0U;
+}
+}  // namespace
+
+class UtestGeTensor : public testing::Test {
+ protected:
+  void SetUp() {}
+  void TearDown() {}
+};
+
+TEST_F(UtestGeTensor, set_moved_data_without_copy) {
+  std::vector<uint8_t> data(kDataSize, 3U);
+  const uint8_t *addr = data.data();
+  ASSERT_TRUE(IsAligned(addr));
+  TensorData tensor_data;
+  ASSERT_EQ(tensor_data.SetData(std::move(data)), GRAPH_SUCCESS);
+  EXPECT_EQ(tensor_data.data(), addr);
+  EXPECT_EQ(tensor_data.size(), kDataSize);
+
+  std::vector<uint8_t> ctor_data(kDataSize, 4U);
+  addr = ctor_data.data();
+  GeTensor ge_tensor(GeTensorDesc(GeShape({1024}), FORMAT_ND, DT_UINT8), std::move(ctor_data));
+  EXPECT_EQ(ge_tensor.GetData().data(), addr);
+
+  std::vector<uint8_t> set_data(kDataSize * 2U, 5U);
+  addr = set_data.data();
+  ASSERT_EQ(ge_tensor.SetData(std::move(set_data)), GRAPH_SUCCESS);
+  EXPECT_EQ(ge_tensor.GetData().data(), addr);
+  EXPECT_EQ(ge_tensor.GetData().size(), kDataSize * 2U);
+  EXPECT_EQ(ge_tensor.GetData()[kDataSize], 5U);
+
+  Tensor tensor;
+  std::vector<uint8_t> api_data(kDataSize, 6U);
+  addr = api_data.data();
+  ASSERT_EQ(tensor.SetData(std::move(api_data)), GRAPH_SUCCESS);
+  EXPECT_EQ(tensor.GetData(), addr);
+  EXPECT_EQ(tensor.GetSize(), kDataSize);
+}
+
+TEST_F(UtestGeTensor, set_data_with_deleter) {
+  int delete_count = 0;
+  auto deleter = [&delete_count](uint8_t *ptr) {
+    delete[] ptr;
+    ++delete_count;
+  };
+  uint8_t *buffer = new uint8_t[kDataSize + kAlignmentBytes];
+  uint8_t *aligned = buffer;
+  while (!IsAligned(aligned)) {
+    ++aligned;
+  }
+  {
+    Tensor tensor;
+    ASSERT_EQ(tensor.SetData(aligned, kDataSize, [&deleter, buffer](uint8_t *ptr) {
+      (void)ptr;
+      deleter(buffer);
+    }), GRAPH_SUCCESS);
+    EXPECT_EQ(tensor.GetData(), aligned);
+    GeTensor shared = TensorAdapter::AsGeTensor(tensor);
+    EXPECT_EQ(shared.GetData().data(), aligned);
+    EXPECT_EQ(delete_count, 0);
+  }
+  EXPECT_EQ(delete_count, 1);
+
+  // a misaligned buffer is copied and released right away
+  buffer = new uint8_t[kDataSize + 1U]();
+  uint8_t *misaligned = IsAligned(buffer) ? buffer + 1 : buffer;
+  GeTensor ge_tensor;
+  ASSERT_EQ(ge_tensor.SetData(misaligned, kDataSize, [&deleter, buffer](uint8_t *ptr) {
+    (void)ptr;
+    deleter(buffer);
+  }), GRAPH_SUCCESS);
+  EXPECT_EQ(delete_count, 2);
+  EXPECT_NE(ge_tensor.GetData().data(), misaligned);
+  EXPECT_EQ(ge_tensor.GetData().size(), kDataSize);
+}
+
+TEST_F(UtestGeTensor, set_moved_data_to_shared_buffer) {
+  GeTensor tensor(GeTensorDesc(), std::vector<uint8_t>(kDataSize, 1U));
+  GeTensor shared(tensor);
+  std::vector<uint8_t> data(kDataSize, 2U);
+  const uint8_t *addr = data.data();
+  ASSERT_EQ(shared.SetData(std::move(data)), GRAPH_SUCCESS);
+  // tensors sharing an equal sized buffer keep seeing the same data
+  EXPECT_NE(shared.GetData().data(), addr);
+  EXPECT_EQ(tensor.GetData().data(), shared.GetData().data());
+  EXPECT_EQ(tensor.GetData()[0], 2U);
+}
+
+TEST_F(UtestGeTensor, buffer_passes_through_attr_without_copy) {
+  Buffer empty;
+  EXPECT_EQ(empty.GetSize(), 0U);
+  EXPECT_EQ(empty.GetData(), nullptr);
+  const Buffer &const_empty = empty;
+  EXPECT_EQ(const_empty.GetData(), nullptr);
+  // a buffer without data still sets empty bytes
+  auto empty_holder = std::make_shared<OpDesc>("empty", "Op");
+  ASSERT_TRUE(AttrUtils::SetBytes(empty_holder, "empty", empty));
+  ASSERT_TRUE(AttrUtils::SetListBytes(empty_holder, "empty_list", std::vector<Buffer>({empty})));
+  Buffer empty_got(1U);
+  ASSERT_TRUE(AttrUtils::GetBytes(empty_holder, "empty", empty_got));
+  EXPECT_EQ(empty_got.GetSize(), 0U);
+  std::vector<Buffer> empty_list;
+  ASSERT_TRUE(AttrUtils::GetListBytes(empty_holder, "empty_list", empty_list));
+  ASSERT_EQ(empty_list.size(), 1U);
+  EXPECT_EQ(empty_list[0].GetSize(), 0U);
+  GeTensor empty_tensor;
+  EXPECT_EQ(empty_tensor.SetData(const_empty), GRAPH_SUCCESS);
+  EXPECT_EQ(empty_tensor.GetData().size(), 0U);
+
+  auto op_desc = std::make_shared<OpDesc>("op", "Op");
+  Buffer kernel(kDataSize * kDataSize, 7U);
+  const uint8_t *kernel_data = kernel.GetData();
+  ASSERT_TRUE(AttrUtils::SetZeroCopyBytes(op_desc, "kernel", std::move(kernel)));
+  Buffer got;
+  ASSERT_TRUE(AttrUtils::GetZeroCopyBytes(op_desc, "kernel", got));
+  EXPECT_EQ(got.GetData(), kernel_data);
+  EXPECT_EQ(got.GetSize(), kDataSize * kDataSize);
+
+  auto aligned_ptr = std::make_shared<AlignedPtr>(kDataSize);
+  for (size_t i = 0U; i < kDataSize; ++i) {
+    aligned_ptr->MutableGet()[i] = static_cast<uint8_t>(i);
+  }
+  Buffer tiling = Buffer::FromAlignedPtr(aligned_ptr, kDataSize);
+  EXPECT_TRUE(tiling.IsExternal());
+  EXPECT_EQ(tiling.GetData(), aligned_ptr->Get());
+  EXPECT_EQ(tiling[3], 3U);
+  Buffer shared = tiling;
+  EXPECT_EQ(shared.GetData(), aligned_ptr->Get());
+  GeTensor tensor(GeTensorDesc(GeShape({static_cast<int64_t>(kDataSize)}), FORMAT_ND, DT_UINT8), tiling);
+  EXPECT_EQ(tensor.GetData().size(), kDataSize);
+
+  // attributes keep their bytes in the proto, so external bytes are copied in
+  ASSERT_TRUE(AttrUtils::SetZeroCopyBytes(op_desc, "tiling", std::move(tiling)));
+  ASSERT_TRUE(AttrUtils::GetZeroCopyBytes(op_desc, "tiling", got));
+  EXPECT_NE(got.GetData(), aligned_ptr->Get());
+  ASSERT_EQ(got.GetSize(), kDataSize);
+  EXPECT_EQ(memcmp(got.GetData(), aligned_ptr->Get(), kDataSize), 0);
+  EXPECT_EQ(shared.GetData(), aligned_ptr->Get());
+}
+
+TEST_F(UtestGeTensor, gnode_desc_is_a_snapshot_view) {
+  auto op_desc = std::make_shared<OpDesc>("conv", "Conv2D");
+  GeTensorDesc input_desc(GeShape({1, 3, 224, 224}), FORMAT_NCHW, DT_FLOAT16);
+  input_desc.SetName("x");
+  input_desc.SetOriginShape(GeShape({1, 224, 224, 3}));
+  TensorUtils::SetSize(input_desc, 301056);
+  ASSERT_EQ(AttrUtils::SetStr(input_desc, "extra_attr", "kept"), true);
+  ASSERT_EQ(op_desc->AddInputDesc(input_desc), GRAPH_SUCCESS);
+  ASSERT_EQ(op_desc->AddOutputDesc(input_desc), GRAPH_SUCCESS);
+  auto graph = std::make_shared<ComputeGraph>("graph");
+  GNode gnode = NodeAdapter::Node2GNode(graph->AddNode(op_desc));
+
+  TensorDesc tensor_desc;
+  ASSERT_EQ(gnode.GetInputDesc(0, tensor_desc), GRAPH_SUCCESS);
+  EXPECT_EQ(tensor_desc.GetShape().GetDims(), std::vector<int64_t>({1, 3, 224, 224}));
+  EXPECT_EQ(tensor_desc.GetOriginShape().GetDims(), std::vector<int64_t>({1, 224, 224, 3}));
+  EXPECT_EQ(tensor_desc.GetFormat(), FORMAT_NCHW);
+  EXPECT_EQ(tensor_desc.GetDataType(), DT_FLOAT16);
+  EXPECT_EQ(tensor_desc.GetName(), "x");
+  EXPECT_EQ(tensor_desc.GetSize(), 301056);
+
+  // an in place edit of the node does not reach a desc handed out before, and writing it back restores it
+  op_desc->MutableInputDesc(0)->SetDataType(DT_INT8);
+  EXPECT_EQ(tensor_desc.GetDataType(), DT_FLOAT16);
+  ASSERT_EQ(gnode.UpdateInputDesc(0, tensor_desc), GRAPH_SUCCESS);
+  EXPECT_EQ(op_desc->GetInputDescPtr(0)->GetDataType(), DT_FLOAT16);
+
+  // a copy of the view changes alone, and the attrs TensorDesc does not carry are kept
+  TensorDesc changed(tensor_desc);
+  changed.SetDataType(DT_FLOAT);
+  EXPECT_EQ(tensor_desc.GetDataType(), DT_FLOAT16);
+  ASSERT_EQ(gnode.UpdateInputDesc(0, changed), GRAPH_SUCCESS);
+  auto after = op_desc->GetInputDescPtr(0);
+  EXPECT_EQ(after->GetDataType(), DT_FLOAT);
+  EXPECT_EQ(after->GetShape().GetDims(), std::vector<int64_t>({1, 3, 224, 224}));
+  EXPECT_EQ(after->GetName(), "x");
+  std::string extra_attr;
+  EXPECT_TRUE(AttrUtils::GetStr(after, "extra_attr", extra_attr));
+  EXPECT_EQ(extra_attr, "kept");
+  // a range the view neither had nor set is not added
+  EXPECT_FALSE(AttrUtils::HasAttr(after, "shape_range"));
+  // the first view still shows the desc it was taken from
+  EXPECT_EQ(tensor_desc.GetDataType(), DT_FLOAT16);
+
+  TensorDesc output_desc(Shape({8}), FORMAT_ND, DT_INT32);
+  ASSERT_EQ(gnode.GetOutputDesc(0, output_desc), GRAPH_SUCCESS);
+  output_desc.SetShape(Shape({2, 3}));
+  ASSERT_EQ(gnode.UpdateOutputDesc(0, output_desc), GRAPH_SUCCESS);
+  EXPECT_EQ(op_desc->GetOutputDescPtr(0)->GetShape().GetDims(), std::vector<int64_t>({2, 3}));
+  EXPECT_EQ(op_desc->GetOutputDescPtr(0)->GetFormat(), FORMAT_NCHW);
+}
+}  // namespace ge
@@ -0,0 +1,127 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <dirent.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "graph/compute_graph.h"
+#include "graph/ge_local_context.h"
+#include "graph/utils/graph_utils.h"
+
+namespace ge {
+namespace {
+std::string g_dump_dir;
+
+std::vector<std::string> ListDumpFiles(const std::string &suffix) {
+  std::vector<std::string> files;
+  DIR *dir = opendir(g_dump_dir.c_str());
+  if (dir == nullptr) {
+    return files;
+  }
+  struct dirent *entry = nullptr;
+  while ((entry = readdir(dir)) != nullptr) {
+    std::string name = entry->d_name;
+    if ((name[0] != '.') && (name.size() > suffix.size()) &&
+        (name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0)) {
+      files.push_back(g_dump_dir + "/" + name);
+    }
+  }
+  closedir(dir);
+  return files;
+}
+
+// The dump switches are read once per process, so they have to be in place before the first test
+class GraphDumpEnvironment : public testing::Environment {
+ public:
+  void SetUp() override {
+    char dir_template[] = "/tmp/ge_dump_ut_XXXXXX";
+    if (mkdtemp(dir_template) != nullptr) {
+      g_dump_dir = dir_template;
+      setenv("DUMP_GRAPH_PATH", g_dump_dir.c_str(), 1);
+      setenv("DUMP_GE_GRAPH", "2", 1);
+    }
+  }
+  void TearDown() override {
+    if (g_dump_dir.empty()) {
+      return;
+    }
+    GraphUtils::FlushGraphDump();
+    for (const auto &file : ListDumpFiles("")) {
+      (void)unlink(file.c_str());
+    }
+    (void)rmdir(g_dump_dir.c_str());
+  }
+};
+
+testing::Environment *const g_dump_env = testing::AddGlobalTestEnvironment(new GraphDumpEnvironment());
+
+ComputeGraphPtr BuildGraph() {
+  auto graph = std::make_shared<ComputeGraph>("dump_graph");
+  auto data_desc = std::make_shared<OpDesc>("data", "Data");
+  data_desc->AddOutputDesc(GeTensorDesc());
+  auto relu_desc = std::make_shared<OpDesc>("relu", "Relu");
+  relu_desc->AddInputDesc(GeTensorDesc());
+  auto data = graph->AddNode(data_desc);
+  auto relu = graph->AddNode(relu_desc);
+  (void)GraphUtils::AddEdge(data->GetOutDataAnchor(0), relu->GetInDataAnchor(0));
+  return graph;
+}
+}  // namespace
+
+class UtestGraphDump : public testing::Test {
+ protected:
+  void SetUp() {
+    ASSERT_FALSE(g_dump_dir.empty());
+  }
+  void TearDown() {}
+};
+
+TEST_F(UtestGraphDump, dump_is_written_in_background) {
+  auto graph = BuildGraph();
+  GraphUtils::DumpGEGraph(graph, "async_dump");
+  GraphUtils::FlushGraphDump();
+
+  auto files = ListDumpFiles("_async_dump.txt");
+  ASSERT_EQ(files.size(), 1U);
+  ComputeGraphPtr load_graph;
+  ASSERT_TRUE(GraphUtils::LoadGEGraph(files[0].c_str(), load_graph));
+  ASSERT_NE(load_graph, nullptr);
+  EXPECT_EQ(load_graph->GetDirectNodesSize(), 2U);
+  EXPECT_NE(load_graph->FindNode("relu"), nullptr);
+}
+
+TEST_F(UtestGraphDump, oversized_dump_is_dropped) {
+  auto graph = BuildGraph();
+  std::string small_file = g_dump_dir + "/small_dump.txt";
+  std::string limited_file = g_dump_dir + "/limited_dump.txt";
+  // the size limit is a thread local option, so each case runs on a thread of its own
+  std::thread([&graph, &small_file]() {
+    GetThreadLocalContext().SetGraphOption({{"ge.maxDumpFileSize", "1048576"}});
+    GraphUtils::DumpGEGraph(graph, "small", true, small_file);
+  }).join();
+  std::thread([&graph, &limited_file]() {
+    GetThreadLocalContext().SetGraphOption({{"ge.maxDumpFileSize", "64"}});
+    GraphUtils::DumpGEGraph(graph, "limited", true, limited_file);
+  }).join();
+
+  EXPECT_EQ(access(small_file.c_str(), F_OK), 0);
+  EXPECT_NE(access(limited_file.c_str(), F_OK), 0);
+}
+}  // namespace ge
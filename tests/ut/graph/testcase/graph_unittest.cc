@@ -16,7 +16,25 @@
 
 #include <gtest/gtest.h>
 #include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "graph/compute_graph.h"
+#include "graph/gnode.h"
+#include "graph/graph.h"
+#include "graph/utils/graph_utils.h"
+#include "graph/utils/node_adapter.h"
+#include "common/graph_builder_utils.h"
 
+using namespace ge;
+
+namespace {
+std::string GetName(const GNode &node) {
+  AscendString name;
+  (void)node.GetName(name);
+  return name.GetString();
+}
+}  // namespace
 
 class UtestGraph : public testing::Test {
  protected:
@@ -28,3 +46,69 @@ class UtestGraph : public testing::Test {
 TEST_F(UtestGraph, base) {
  
 }
+
+TEST_F(UtestGraph, gnode_handles_are_cached_and_neighbours_visited_in_place) {
+  auto compute_graph = std::make_shared<ComputeGraph>("graph");
+  auto a = ut::AddNode(compute_graph, "a", "Relu", 0, 2);
+  auto b = ut::AddNode(compute_graph, "b", "Relu", 2, 1);
+  auto c = ut::AddNode(compute_graph, "c", "Relu", 1, 0);
+  ASSERT_EQ(GraphUtils::AddEdge(a->GetOutDataAnchor(0), b->GetInDataAnchor(1)), GRAPH_SUCCESS);
+  ASSERT_EQ(GraphUtils::AddEdge(a->GetOutDataAnchor(1), b->GetInDataAnchor(0)), GRAPH_SUCCESS);
+  ASSERT_EQ(GraphUtils::AddEdge(a->GetOutDataAnchor(0), c->GetInDataAnchor(0)), GRAPH_SUCCESS);
+  ASSERT_EQ(GraphUtils::AddEdge(b->GetOutControlAnchor(), c->GetInControlAnchor()), GRAPH_SUCCESS);
+
+  GNodePtr gnode_a = NodeAdapter::Node2GNodePtr(a);
+  ASSERT_NE(gnode_a, nullptr);
+  EXPECT_EQ(NodeAdapter::Node2GNodePtr(a), gnode_a);
+  auto in_data = NodeAdapter::Node2GNode(b).GetInDataNodesAndPortIndexs(1);
+  EXPECT_EQ(in_data.first, gnode_a);
+  EXPECT_EQ(in_data.second, 0);
+
+  Graph graph = GraphUtils::CreateGraphFromComputeGraph(compute_graph);
+  auto all_nodes = graph.GetAllNodes();
+  ASSERT_EQ(all_nodes.size(), 3U);
+  EXPECT_EQ(NodeAdapter::GNode2Node(all_nodes[0]), a);
+
+  std::vector<std::pair<std::string, int32_t>> visited;
+  auto visitor = [&visited](const GNode &node, int32_t port_index) {
+    visited.emplace_back(GetName(node), port_index);
+    return GRAPH_SUCCESS;
+  };
+  GNode gnode_b = NodeAdapter::Node2GNode(b);
+  ASSERT_EQ(gnode_b.VisitInDataNodes(visitor), GRAPH_SUCCESS);
+  ASSERT_EQ(gnode_a->VisitOutDataNodes(0, visitor), GRAPH_SUCCESS);
+  ASSERT_EQ(gnode_b.VisitOutControlNodes(visitor), GRAPH_SUCCESS);
+  ASSERT_EQ(NodeAdapter::Node2GNode(c).VisitInControlNodes(visitor), GRAPH_SUCCESS);
+  std::vector<std::pair<std::string, int32_t>> expect = {{"a", 1}, {"a", 0}, {"b", 1}, {"c", 0}, {"c", -1}, {"b", -1}};
+  EXPECT_EQ(visited, expect);
+
+  // the visitor status stops the walk
+  int count = 0;
+  EXPECT_EQ(gnode_a->VisitOutDataNodes(0, [&count](const GNode &, int32_t) {
+    ++count;
+    return GRAPH_FAILED;
+  }), GRAPH_FAILED);
+  EXPECT_EQ(count, 1);
+  EXPECT_NE(gnode_a->VisitOutDataNodes(5, visitor), GRAPH_SUCCESS);
+}
+
+TEST_F(UtestGraph, gnode_visitor_modifying_edges_stops_the_walk) {
+  // 3 peers are kept in plain link order, 40 are indexed
+  for (int peer_num : {3, 40}) {
+    auto compute_graph = std::make_shared<ComputeGraph>("graph");
+    auto src = ut::AddNode(compute_graph, "src", "Relu", 0, 1);
+    for (int i = 0; i < peer_num; ++i) {
+      auto dst = ut::AddNode(compute_graph, "dst" + std::to_string(i), "Relu", 1, 0);
+      ASSERT_EQ(GraphUtils::AddEdge(src->GetOutDataAnchor(0), dst->GetInDataAnchor(0)), GRAPH_SUCCESS);
+    }
+    int count = 0;
+    auto unlink_visitor = [&src, &count](const GNode &node, int32_t port_index) {
+      ++count;
+      NodePtr peer = NodeAdapter::GNode2Node(node);
+      return GraphUtils::RemoveEdge(src->GetOutDataAnchor(0), peer->GetInDataAnchor(port_index));
+    };
+    EXPECT_EQ(NodeAdapter::Node2GNode(src).VisitOutDataNodes(0, unlink_visitor), GRAPH_FAILED);
+    EXPECT_EQ(count, 1);
+    EXPECT_EQ(src->GetOutDataAnchor(0)->GetPeerInDataNodesSize(), static_cast<uint32_t>(peer_num - 1));
+  }
+}
@@ -0,0 +1,209 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "graph/model.h"
+#include "graph/compute_graph.h"
+#include "graph/detail/model_serialize_imp.h"
+#include "graph/model_serialize.h"
+#include "graph/utils/attr_utils.h"
+#include "graph/utils/graph_utils.h"
+#include "proto/ge_ir.pb.h"
+#include "common/graph_builder_utils.h"
+
+namespace ge {
+namespace {
+const int kRootOpNum = 2000;
+const int kSubgraphNum = 16;
+
+GeTensorDesc TensorDesc() {
+  return GeTensorDesc(GeShape({1, 16}), FORMAT_ND, DT_FLOAT);
+}
+
+ComputeGraphPtr BuildSubgraph(const std::string &name) {
+  auto graph = std::make_shared<ComputeGraph>(name);
+  auto data = ut::AddNode(graph, name + "_data", "Data", 1, 1, TensorDesc());
+  auto relu = ut::AddNode(graph, name + "_relu", "Relu", 1, 1, TensorDesc());
+  auto output = ut::AddNode(graph, name + "_output", "NetOutput", 1, 0, TensorDesc());
+  GraphUtils::AddEdge(data->GetOutDataAnchor(0), relu->GetInDataAnchor(0));
+  GraphUtils::AddEdge(relu->GetOutDataAnchor(0), output->GetInDataAnchor(0));
+  graph->AddInputNode(data);
+  graph->AddOutputNode(relu);
+  return graph;
+}
+
+// A wide root graph whose edges point both backward and forward in the op list, plus one subgraph per If node
+Model BuildModel() {
+  auto root = std::make_shared<ComputeGraph>("root");
+  auto data = ut::AddNode(root, "data", "Data", 1, 1, TensorDesc());
+  root->AddInputNode(data);
+  std::vector<NodePtr> adds;
+  for (int i = 0; i < kRootOpNum; ++i) {
+    adds.push_back(ut::AddNode(root, "add_" + std::to_string(i), "Add", 2, 1, TensorDesc()));
+  }
+  for (int i = 0; i < kRootOpNum; ++i) {
+    auto src0 = (i == 0) ? data : adds[i - 1];
+    GraphUtils::AddEdge(src0->GetOutDataAnchor(0), adds[i]->GetInDataAnchor(0));
+    GraphUtils::AddEdge(data->GetOutDataAnchor(0), adds[i]->GetInDataAnchor(1));
+    if (i + 7 < kRootOpNum) {
+      GraphUtils::AddEdge(adds[i + 7]->GetOutControlAnchor(), adds[i]->GetInControlAnchor());
+    }
+  }
+  for (int i = 0; i < kSubgraphNum; ++i) {
+    auto if_node = ut::AddNode(root, "if_" + std::to_string(i), "If", 1, 1, TensorDesc());
+    GraphUtils::AddEdge(adds[i * 10]->GetOutDataAnchor(0), if_node->GetInDataAnchor(0));
+    auto subgraph = BuildSubgraph("then_" + std::to_string(i));
+    if_node->GetOpDesc()->AddSubgraphName("then_branch");
+    if_node->GetOpDesc()->SetSubgraphInstanceName(0, subgraph->GetName());
+    subgraph->SetParentNode(if_node);
+    subgraph->SetParentGraph(root);
+    root->AddSubgraph(subgraph->GetName(), subgraph);
+  }
+  root->AddOutputNode(adds.back());
+
+  Model model("model", "1");
+  model.SetGraph(GraphUtils::CreateGraphFromComputeGraph(root));
+  return model;
+}
+
+void DumpGraph(const ComputeGraphPtr &graph, std::vector<std::string> &lines) {
+  lines.push_back("graph " + graph->GetName());
+  auto parent = graph->GetParentNode();
+  lines.push_back("parent " + (parent == nullptr ? std::string() : parent->GetName()));
+  for (const auto &node : graph->GetDirectNode()) {
+    std::string line = node->GetName() + " " + node->GetType() + " <-";
+    for (const auto &in_anchor : node->GetAllInDataAnchors()) {
+      auto peer = in_anchor->GetPeerOutAnchor();
+      line += " " + (peer == nullptr ? std::string("-") :
+                     peer->GetOwnerNode()->GetName() + ":" + std::to_string(peer->GetIdx()));
+    }
+    for (const auto &in_node : node->GetInControlNodes()) {
+      line += " ^" + in_node->GetName();
+    }
+    for (const auto &name : node->GetOpDesc()->GetSubgraphInstanceNames()) {
+      line += " @" + name;
+    }
+    lines.push_back(line);
+  }
+  for (const auto &node : graph->GetInputNodes()) {
+    lines.push_back("input " + node->GetName());
+  }
+  for (const auto &item : graph->GetGraphOutNodesInfo()) {
+    lines.push_back("output " + item.first->GetName() + ":" + std::to_string(item.second));
+  }
+}
+
+std::vector<std::string> Unserialize(const proto::ModelDef &model_def, uint32_t parallel_num) {
+  auto model_proto = std::make_shared<proto::ModelDef>(model_def);
+  ModelSerializeImp imp;
+  imp.SetProtobufOwner(model_proto);
+  imp.SetParallelNum(parallel_num);
+  Model model;
+  std::vector<std::string> lines;
+  if (!imp.UnserializeModel(model, *model_proto)) {
+    return lines;
+  }
+  auto root = GraphUtils::GetComputeGraph(model.GetGraph());
+  DumpGraph(root, lines);
+  for (const auto &subgraph : root->GetAllSubgraphs()) {
+    DumpGraph(subgraph, lines);
+  }
+  return lines;
+}
+
+// Covers the fields GetSerializeModelSize has to account for besides the plain graph structure
+void DecorateModel(Model &model) {
+  auto root = GraphUtils::GetComputeGraph(model.GetGraph());
+  auto op_desc = std::make_shared<OpDesc>("named", "Custom");
+  op_desc->AddInputDesc("x", GeTensorDesc(GeShape({-1, 3}), FORMAT_NCHW, DT_INT8));
+  op_desc->AddInputDesc("y", GeTensorDesc());
+  op_desc->AddOutputDesc("z", GeTensorDesc());
+  op_desc->AddOptionalInputDesc("bias", GeTensorDesc());
+  op_desc->SetId(-5);
+  (void)AttrUtils::SetListInt(op_desc, "_input_name_value", {7});
+  std::vector<uint8_t> weight(300, 1U);
+  GeTensorPtr tensor = std::make_shared<GeTensor>(GeTensorDesc(GeShape({300}), FORMAT_ND, DT_UINT8), weight);
+  (void)AttrUtils::SetTensor(op_desc, "value", tensor);
+  auto named = root->AddNode(op_desc);
+  GraphUtils::AddEdge(root->FindNode("add_1999")->GetOutDataAnchor(0), named->GetInDataAnchor(0));
+  root->AddOutputNodeByIndex(named, 12);
+  (void)AttrUtils::SetStr(root, "graph_attr", "value");
+  (void)AttrUtils::SetInt(model, "model_attr", 12345);
+  model.SetVersion(300U);
+}
+}  // namespace
+
+class UtestModelSerialize : public testing::Test {
+ protected:
+  void SetUp() {}
+  void TearDown() {}
+};
+
+TEST_F(UtestModelSerialize, parallel_unserialize_same_as_sequential) {
+  Model model = BuildModel();
+  proto::ModelDef model_def;
+  ModelSerializeImp imp;
+  ASSERT_TRUE(imp.SerializeModel(model, &model_def));
+  ASSERT_EQ(model_def.graph_size(), kSubgraphNum + 1);
+
+  auto expect = Unserialize(model_def, 1U);
+  ASSERT_FALSE(expect.empty());
+  std::vector<std::string> origin;
+  auto root = GraphUtils::GetComputeGraph(model.GetGraph());
+  DumpGraph(root, origin);
+  for (const auto &subgraph : root->GetAllSubgraphs()) {
+    DumpGraph(subgraph, origin);
+  }
+  EXPECT_EQ(expect, origin);
+
+  EXPECT_EQ(Unserialize(model_def, 4U), expect);
+  EXPECT_EQ(Unserialize(model_def, 0U), expect);
+}
+
+TEST_F(UtestModelSerialize, unserialize_missing_peer_fail) {
+  Model model = BuildModel();
+  proto::ModelDef model_def;
+  ModelSerializeImp imp;
+  ASSERT_TRUE(imp.SerializeModel(model, &model_def));
+  model_def.mutable_graph(kSubgraphNum)->mutable_op(1)->set_input(0, "not_exist:0");
+
+  EXPECT_TRUE(Unserialize(model_def, 1U).empty());
+  EXPECT_TRUE(Unserialize(model_def, 4U).empty());
+}
+
+TEST_F(UtestModelSerialize, serialize_model_size_same_as_serialize) {
+  Model model = BuildModel();
+  DecorateModel(model);
+  ModelSerialize serialize;
+  Buffer buffer = serialize.SerializeModel(model);
+  ASSERT_NE(buffer.GetSize(), 0U);
+  EXPECT_EQ(serialize.GetSerializeModelSize(model), buffer.GetSize());
+
+  // A loaded model keeps inputs, descs and subgraph names in the protos of its op descs
+  Model loaded;
+  ASSERT_TRUE(serialize.UnserializeModel(buffer.GetData(), buffer.GetSize(), loaded));
+  auto root = GraphUtils::GetComputeGraph(loaded.GetGraph());
+  GraphUtils::RemoveEdge(root->FindNode("add_10")->GetOutControlAnchor(), root->FindNode("add_3")->GetInControlAnchor());
+  root->FindNode("add_5")->GetOpDesc()->SetId(0);
+  Buffer loaded_buffer = serialize.SerializeModel(loaded);
+  ASSERT_NE(loaded_buffer.GetSize(), 0U);
+  EXPECT_EQ(serialize.GetSerializeModelSize(loaded), loaded_buffer.GetSize());
+
+  EXPECT_EQ(serialize.GetSerializeModelSize(Model()), 0U);
+}
+}  // namespace ge
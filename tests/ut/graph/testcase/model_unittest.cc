@@ -0,0 +1,231 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include "graph/model.h"
+#include "graph/model_serialize.h"
+#include "graph/compute_graph.h"
+#include "graph/debug/ge_attr_define.h"
+#include "graph/detail/weights_mapping.h"
+#include "graph/utils/attr_utils.h"
+#include "graph/utils/graph_utils.h"
+
+namespace ge {
+namespace {
+const char *const kModelFile = "./ut_lazy_weights_model.om";
+const size_t kLargeWeightSize = 64U * 1024U;
+const size_t kSmallWeightSize = 16U;
+
+std::vector<uint8_t> MakeWeight(size_t size, uint8_t seed) {
+  std::vector<uint8_t> weight(size);
+  for (size_t i = 0U; i < size; ++i) {
+    weight[i] = static_cast<uint8_t>(seed + i);
+  }
+  return weight;
+}
+
+void AddConst(ComputeGraphPtr &graph, const std::string &name, const std::vector<uint8_t> &weight) {
+  auto op_desc = std::make_shared<OpDesc>(name, "Const");
+  GeTensorDesc tensor_desc(GeShape({static_cast<int64_t>(weight.size())}), FORMAT_ND, DT_UINT8);
+  op_desc->AddOutputDesc(tensor_desc);
+  GeTensorPtr tensor = std::make_shared<GeTensor>(tensor_desc, weight);
+  AttrUtils::SetTensor(op_desc, ATTR_NAME_WEIGHTS, tensor);
+  graph->AddNode(op_desc);
+}
+
+Model BuildModel() {
+  auto graph = std::make_shared<ComputeGraph>("lazy_graph");
+  AddConst(graph, "large", MakeWeight(kLargeWeightSize, 1U));
+  AddConst(graph, "small", MakeWeight(kSmallWeightSize, 7U));
+  Model model("lazy_model", "1");
+  model.SetGraph(GraphUtils::CreateGraphFromComputeGraph(graph));
+  return model;
+}
+
+ConstGeTensorPtr GetWeight(const Model &model, const std::string &name) {
+  auto graph = GraphUtils::GetComputeGraph(model.GetGraph());
+  ConstGeTensorPtr weight;
+  if (graph != nullptr) {
+    auto node = graph->FindNode(name);
+    if (node != nullptr) {
+      (void)AttrUtils::GetTensor(node->GetOpDesc(), ATTR_NAME_WEIGHTS, weight);
+    }
+  }
+  return weight;
+}
+}  // namespace
+
+class UtestModel : public testing::Test {
+ protected:
+  void SetUp() {
+    std::ofstream file(kModelFile);
+  }
+
+  void TearDown() {
+    (void)remove(kModelFile);
+  }
+};
+
+TEST_F(UtestModel, load_from_file_lazy_weights) {
+  Model model = BuildModel();
+  ASSERT_EQ(model.SaveToFile(kModelFile), GRAPH_SUCCESS);
+
+  Model lazy_model;
+  ASSERT_EQ(lazy_model.LoadFromFile(kModelFile, true), GRAPH_SUCCESS);
+  EXPECT_TRUE(WeightsMapping::HasLazyWeights());
+
+  auto small = GetWeight(lazy_model, "small");
+  ASSERT_NE(small, nullptr);
+  EXPECT_EQ(small->GetData().size(), kSmallWeightSize);
+  EXPECT_TRUE(WeightsMapping::HasLazyWeights());
+
+  auto large = GetWeight(lazy_model, "large");
+  ASSERT_NE(large, nullptr);
+  auto expect = MakeWeight(kLargeWeightSize, 1U);
+  ASSERT_EQ(large->GetData().size(), kLargeWeightSize);
+  EXPECT_EQ(memcmp(large->GetData().data(), expect.data(), kLargeWeightSize), 0);
+  EXPECT_FALSE(WeightsMapping::HasLazyWeights());
+}
+
+TEST_F(UtestModel, save_lazy_model_same_as_eager) {
+  Model model = BuildModel();
+  ASSERT_EQ(model.SaveToFile(kModelFile), GRAPH_SUCCESS);
+
+  Model eager_model;
+  ASSERT_EQ(eager_model.LoadFromFile(kModelFile), GRAPH_SUCCESS);
+  Buffer eager_buffer;
+  ASSERT_EQ(eager_model.Save(eager_buffer), GRAPH_SUCCESS);
+
+  {
+    Model lazy_model;
+    ASSERT_EQ(lazy_model.LoadFromFile(kModelFile, true), GRAPH_SUCCESS);
+    Buffer lazy_buffer;
+    ASSERT_EQ(lazy_model.Save(lazy_buffer), GRAPH_SUCCESS);
+    ASSERT_EQ(lazy_buffer.GetSize(), eager_buffer.GetSize());
+  }
+  EXPECT_FALSE(WeightsMapping::HasLazyWeights());
+}
+
+TEST_F(UtestModel, release_untouched_lazy_weights) {
+  Model model = BuildModel();
+  ASSERT_EQ(model.SaveToFile(kModelFile), GRAPH_SUCCESS);
+  {
+    Model lazy_model;
+    ASSERT_EQ(lazy_model.LoadFromFile(kModelFile, true), GRAPH_SUCCESS);
+    EXPECT_TRUE(WeightsMapping::HasLazyWeights());
+  }
+  EXPECT_FALSE(WeightsMapping::HasLazyWeights());
+}
+
+TEST_F(UtestModel, overwrite_lazy_weight) {
+  Model model = BuildModel();
+  ASSERT_EQ(model.SaveToFile(kModelFile), GRAPH_SUCCESS);
+  Model lazy_model;
+  ASSERT_EQ(lazy_model.LoadFromFile(kModelFile, true), GRAPH_SUCCESS);
+  auto node = GraphUtils::GetComputeGraph(lazy_model.GetGraph())->FindNode("large");
+  ASSERT_NE(node, nullptr);
+
+  auto expect = MakeWeight(8U, 3U);
+  GeTensorDesc tensor_desc(GeShape({8}), FORMAT_ND, DT_UINT8);
+  GeTensorPtr tensor = std::make_shared<GeTensor>(tensor_desc, expect);
+  ASSERT_TRUE(AttrUtils::SetTensor(node->GetOpDesc(), ATTR_NAME_WEIGHTS, tensor));
+  EXPECT_FALSE(WeightsMapping::HasLazyWeights());
+  auto weight = GetWeight(lazy_model, "large");
+  ASSERT_NE(weight, nullptr);
+  ASSERT_EQ(weight->GetData().size(), expect.size());
+  EXPECT_EQ(memcmp(weight->GetData().data(), expect.data(), expect.size()), 0);
+}
+
+TEST_F(UtestModel, delete_lazy_weight) {
+  Model model = BuildModel();
+  ASSERT_EQ(model.SaveToFile(kModelFile), GRAPH_SUCCESS);
+  Model lazy_model;
+  ASSERT_EQ(lazy_model.LoadFromFile(kModelFile, true), GRAPH_SUCCESS);
+  auto node = GraphUtils::GetComputeGraph(lazy_model.GetGraph())->FindNode("large");
+  ASSERT_NE(node, nullptr);
+
+  ASSERT_EQ(node->GetOpDesc()->DelAttr(ATTR_NAME_WEIGHTS), GRAPH_SUCCESS);
+  EXPECT_FALSE(WeightsMapping::HasLazyWeights());
+  // an empty tensor set in its place is not mistaken for the deleted one
+  GeTensorDesc tensor_desc(GeShape({0}), FORMAT_ND, DT_UINT8);
+  ASSERT_TRUE(AttrUtils::SetTensor(node->GetOpDesc(), ATTR_NAME_WEIGHTS, std::make_shared<GeTensor>(tensor_desc)));
+  auto weight = GetWeight(lazy_model, "large");
+  ASSERT_NE(weight, nullptr);
+  EXPECT_EQ(weight->GetData().size(), 0U);
+}
+
+TEST_F(UtestModel, lazy_model_size_without_copying_weights) {
+  Model model = BuildModel();
+  auto graph = GraphUtils::GetComputeGraph(model.GetGraph());
+  auto op_desc = std::make_shared<OpDesc>("list", "Const");
+  std::vector<GeTensorPtr> tensors;
+  for (size_t size : {kLargeWeightSize, kSmallWeightSize, 2U * kLargeWeightSize}) {
+    GeTensorDesc tensor_desc(GeShape({static_cast<int64_t>(size)}), FORMAT_ND, DT_UINT8);
+    tensors.push_back(std::make_shared<GeTensor>(tensor_desc, MakeWeight(size, 3U)));
+  }
+  ASSERT_TRUE(AttrUtils::SetListTensor(op_desc, "list_weights", tensors));
+  graph->AddNode(op_desc);
+  ASSERT_EQ(model.SaveToFile(kModelFile), GRAPH_SUCCESS);
+
+  Model lazy_model;
+  ASSERT_EQ(lazy_model.LoadFromFile(kModelFile, true), GRAPH_SUCCESS);
+  EXPECT_TRUE(WeightsMapping::HasLazyWeights());
+  ModelSerialize serialize;
+  size_t size = serialize.GetSerializeModelSize(lazy_model);
+  EXPECT_TRUE(WeightsMapping::HasLazyWeights());
+  Buffer buffer;
+  ASSERT_EQ(lazy_model.Save(buffer), GRAPH_SUCCESS);
+  EXPECT_EQ(size, buffer.GetSize());
+  EXPECT_FALSE(WeightsMapping::HasLazyWeights());
+}
+
+TEST_F(UtestModel, attrs_str_of_lazy_weights) {
+  Model model = BuildModel();
+  ASSERT_EQ(model.SaveToFile(kModelFile), GRAPH_SUCCESS);
+  Model eager_model;
+  ASSERT_EQ(eager_model.LoadFromFile(kModelFile), GRAPH_SUCCESS);
+  auto eager_op_desc = GraphUtils::GetComputeGraph(eager_model.GetGraph())->FindNode("large")->GetOpDesc();
+
+  Model lazy_model;
+  ASSERT_EQ(lazy_model.LoadFromFile(kModelFile, true), GRAPH_SUCCESS);
+  auto lazy_op_desc = GraphUtils::GetComputeGraph(lazy_model.GetGraph())->FindNode("large")->GetOpDesc();
+  EXPECT_EQ(AttrUtils::GetAttrsStrAfterRid(lazy_op_desc, {}), AttrUtils::GetAttrsStrAfterRid(eager_op_desc, {}));
+  EXPECT_FALSE(WeightsMapping::HasLazyWeights());
+  EXPECT_EQ(AttrUtils::GetAllAttrsStr(lazy_op_desc), AttrUtils::GetAllAttrsStr(eager_op_desc));
+}
+
+TEST_F(UtestModel, set_attr_from_lazy_weight) {
+  Model model = BuildModel();
+  ASSERT_EQ(model.SaveToFile(kModelFile), GRAPH_SUCCESS);
+  auto op_desc = std::make_shared<OpDesc>("copy", "Const");
+  {
+    Model lazy_model;
+    ASSERT_EQ(lazy_model.LoadFromFile(kModelFile, true), GRAPH_SUCCESS);
+    auto node = GraphUtils::GetComputeGraph(lazy_model.GetGraph())->FindNode("large");
+    ASSERT_NE(node, nullptr);
+    auto attrs = node->GetOpDesc()->GetAllAttrs();
+    ASSERT_EQ(op_desc->SetAttr(ATTR_NAME_WEIGHTS, attrs[ATTR_NAME_WEIGHTS]), GRAPH_SUCCESS);
+  }
+  EXPECT_FALSE(WeightsMapping::HasLazyWeights());
+  ConstGeTensorPtr weight;
+  ASSERT_TRUE(AttrUtils::GetTensor(op_desc, ATTR_NAME_WEIGHTS, weight));
+  auto expect = MakeWeight(kLargeWeightSize, 1U);
+  ASSERT_EQ(weight->GetData().size(), kLargeWeightSize);
+  EXPECT_EQ(memcmp(weight->GetData().data(), expect.data(), kLargeWeightSize), 0);
+}
+}  // namespace ge
@@ -0,0 +1,135 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "graph/anchor.h"
+#include "graph/compute_graph.h"
+#include "graph/node.h"
+#include "graph/utils/anchor_utils.h"
+#include "graph/utils/graph_utils.h"
+#include "graph/utils/node_utils.h"
+#include "graph/utils/op_desc_utils.h"
+#include "common/graph_builder_utils.h"
+
+namespace ge {
+class UtestOpDescUtils : public testing::Test {
+ protected:
+  void SetUp() {}
+  void TearDown() {}
+};
+
+TEST_F(UtestOpDescUtils, non_const_inputs_follow_link_changes) {
+  auto graph = std::make_shared<ComputeGraph>("graph");
+  auto data = ut::AddNode(graph, "data", "Data", 0, 1);
+  auto weight = ut::AddNode(graph, "weight", "Const", 0, 1);
+  auto bias = ut::AddNode(graph, "bias", "Const", 0, 1);
+  auto conv = ut::AddNode(graph, "conv", "Conv2D", 3, 1);
+  conv->GetOpDesc()->MutableInputDesc(1)->SetShape(GeShape({2}));
+  ASSERT_EQ(GraphUtils::AddEdge(data->GetOutDataAnchor(0), conv->GetInDataAnchor(0)), GRAPH_SUCCESS);
+  ASSERT_EQ(GraphUtils::AddEdge(weight->GetOutDataAnchor(0), conv->GetInDataAnchor(1)), GRAPH_SUCCESS);
+
+  EXPECT_EQ(OpDescUtils::GetNonConstInputsSize(*conv), 1U);
+  EXPECT_TRUE(OpDescUtils::IsNonConstInput(*conv, 0));
+  EXPECT_FALSE(OpDescUtils::IsNonConstInput(*conv, 1));
+  EXPECT_FALSE(OpDescUtils::IsNonConstInput(*conv, 2));
+  EXPECT_FALSE(OpDescUtils::IsNonConstInput(*conv, 3));
+  auto const_inputs = OpDescUtils::GetConstInputs(*conv);
+  ASSERT_EQ(const_inputs.size(), 1U);
+  EXPECT_EQ(const_inputs[0], weight);
+  // queries leave the links alone, so the cached info stays valid
+  auto version = conv->GetAnchorsVersion();
+  EXPECT_EQ(OpDescUtils::GetConstInputs(*conv).size(), 1U);
+  EXPECT_EQ(conv->GetAnchorsVersion(), version);
+
+  ASSERT_EQ(GraphUtils::AddEdge(bias->GetOutDataAnchor(0), conv->GetInDataAnchor(2)), GRAPH_SUCCESS);
+  EXPECT_NE(conv->GetAnchorsVersion(), version);
+  EXPECT_EQ(OpDescUtils::GetConstInputs(*conv).size(), 2U);
+
+  // swapping the weight for a computed input turns input 1 into data
+  ASSERT_EQ(GraphUtils::RemoveEdge(weight->GetOutDataAnchor(0), conv->GetInDataAnchor(1)), GRAPH_SUCCESS);
+  ASSERT_EQ(GraphUtils::AddEdge(data->GetOutDataAnchor(0), conv->GetInDataAnchor(1)), GRAPH_SUCCESS);
+  EXPECT_EQ(OpDescUtils::GetNonConstInputsSize(*conv), 2U);
+  EXPECT_TRUE(OpDescUtils::IsNonConstInput(*conv, 1));
+  size_t index = 0;
+  EXPECT_TRUE(OpDescUtils::GetNonConstInputIndex(*conv, 1, index));
+  EXPECT_EQ(index, 1U);
+  EXPECT_FALSE(OpDescUtils::GetNonConstInputIndex(*conv, 2, index));
+  EXPECT_EQ(OpDescUtils::GetNonConstInputTensorDesc(*conv, 1).GetShape().GetDims(), std::vector<int64_t>({2}));
+  EXPECT_EQ(OpDescUtils::GetNonConstTensorDesc(conv).size(), 2U);
+  const_inputs = OpDescUtils::GetConstInputs(*conv);
+  ASSERT_EQ(const_inputs.size(), 1U);
+  EXPECT_EQ(const_inputs[0], bias);
+
+  // once anchor status is set it decides alone
+  EXPECT_EQ(NodeUtils::SetAllAnchorStatus(conv), GRAPH_SUCCESS);
+  EXPECT_EQ(AnchorUtils::SetStatus(conv->GetInDataAnchor(0), ANCHOR_DATA), GRAPH_SUCCESS);
+  EXPECT_EQ(AnchorUtils::SetStatus(conv->GetInDataAnchor(1), ANCHOR_CONST), GRAPH_SUCCESS);
+  EXPECT_EQ(OpDescUtils::GetNonConstInputsSize(*conv), 1U);
+  EXPECT_FALSE(OpDescUtils::IsNonConstInput(*conv, 1));
+  EXPECT_TRUE(OpDescUtils::GetNonConstInputIndex(*conv, 0, index));
+  EXPECT_EQ(index, 0U);
+}
+
+TEST_F(UtestOpDescUtils, const_inputs_follow_peer_type_changes) {
+  auto graph = std::make_shared<ComputeGraph>("graph");
+  auto data = ut::AddNode(graph, "data", "Data", 0, 1);
+  auto weight = ut::AddNode(graph, "weight", "Const", 0, 1);
+  auto conv = ut::AddNode(graph, "conv", "Conv2D", 2, 1);
+  auto other = ut::AddNode(graph, "other", "Relu", 1, 1);
+  ASSERT_EQ(GraphUtils::AddEdge(data->GetOutDataAnchor(0), conv->GetInDataAnchor(0)), GRAPH_SUCCESS);
+  ASSERT_EQ(GraphUtils::AddEdge(weight->GetOutDataAnchor(0), conv->GetInDataAnchor(1)), GRAPH_SUCCESS);
+  EXPECT_EQ(OpDescUtils::GetNonConstInputsSize(*conv), 1U);
+
+  // links elsewhere in the graph keep the info of conv cached
+  auto version = conv->GetAnchorsVersion();
+  ASSERT_EQ(GraphUtils::AddEdge(data->GetOutDataAnchor(0), other->GetInDataAnchor(0)), GRAPH_SUCCESS);
+  EXPECT_NE(data->GetAnchorsVersion(), 0U);
+  EXPECT_EQ(conv->GetAnchorsVersion(), version);
+  EXPECT_EQ(OpDescUtils::GetNonConstInputsSize(*conv), 1U);
+
+  // the weight becoming data reaches its consumers only
+  auto data_version = data->GetAnchorsVersion();
+  weight->GetOpDesc()->SetType("Data");
+  EXPECT_NE(conv->GetAnchorsVersion(), version);
+  EXPECT_EQ(data->GetAnchorsVersion(), data_version);
+  EXPECT_EQ(OpDescUtils::GetNonConstInputsSize(*conv), 2U);
+  EXPECT_TRUE(OpDescUtils::GetConstInputs(*conv).empty());
+  version = conv->GetAnchorsVersion();
+  weight->GetOpDesc()->SetType("Data");
+  EXPECT_EQ(conv->GetAnchorsVersion(), version);
+  weight->GetOpDesc()->SetType("Const");
+  EXPECT_EQ(OpDescUtils::GetNonConstInputsSize(*conv), 1U);
+}
+
+TEST_F(UtestOpDescUtils, unrelated_op_descs_keep_cached_inputs) {
+  auto graph = std::make_shared<ComputeGraph>("graph");
+  auto weight = ut::AddNode(graph, "weight", "Const", 0, 1);
+  auto conv = ut::AddNode(graph, "conv", "Conv2D", 1, 1);
+  ASSERT_EQ(GraphUtils::AddEdge(weight->GetOutDataAnchor(0), conv->GetInDataAnchor(0)), GRAPH_SUCCESS);
+  EXPECT_EQ(OpDescUtils::GetConstInputs(*conv).size(), 1U);
+
+  // the cached info of conv is used as long as its anchors version stays
+  auto version = conv->GetAnchorsVersion();
+  auto op_desc = std::make_shared<OpDesc>("other", "Const");
+  op_desc->SetType("Data");
+  auto other = ut::AddNode(graph, "other_node", "Relu", 1, 1);
+  other->GetOpDesc()->SetType("Const");
+  EXPECT_EQ(conv->GetAnchorsVersion(), version);
+  EXPECT_EQ(OpDescUtils::GetConstInputs(*conv).size(), 1U);
+}
+}  // namespace ge
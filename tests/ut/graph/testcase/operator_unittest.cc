@@ -0,0 +1,192 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "graph/compute_graph.h"
+#include "graph/node.h"
+#include "graph/operator_factory_impl.h"
+#include "graph/operator_reg.h"
+#include "graph/utils/graph_utils.h"
+
+namespace ge {
+REG_OP(BuilderConst)
+    .OUTPUT(y, TensorType::ALL())
+    .OP_END_FACTORY_REG(BuilderConst)
+
+REG_OP(BuilderAdd)
+    .INPUT(x1, TensorType::ALL())
+    .INPUT(x2, TensorType::ALL())
+    .OUTPUT(y, TensorType::ALL())
+    .OP_END_FACTORY_REG(BuilderAdd)
+
+namespace {
+// const -> add_0 -> add_1 -> ... with every add also reading const, and add_i control depending on add_{i-2}
+std::vector<op::BuilderAdd> BuildChain(op::BuilderConst &const_op, int add_num) {
+  std::vector<op::BuilderAdd> adds;
+  adds.reserve(add_num);
+  for (int i = 0; i < add_num; ++i) {
+    adds.emplace_back("add_" + std::to_string(i));
+    if (i == 0) {
+      adds[i].set_input_x1(const_op);
+    } else {
+      adds[i].set_input_x1(adds[i - 1]);
+    }
+    adds[i].set_input_x2(const_op);
+    if (i >= 2) {
+      adds[i].AddControlInput(adds[i - 2]);
+    }
+  }
+  return adds;
+}
+}  // namespace
+
+class UtestOperator : public testing::Test {
+ protected:
+  void SetUp() {}
+  void TearDown() {}
+};
+
+TEST_F(UtestOperator, create_graph_from_operator) {
+  const int add_num = 50;
+  op::BuilderConst const_op("const");
+  auto adds = BuildChain(const_op, add_num);
+  auto graph = GraphUtils::CreateGraphFromOperator("graph", {const_op});
+  ASSERT_NE(graph, nullptr);
+  ASSERT_EQ(graph->GetDirectNodesSize(), static_cast<size_t>(add_num + 1));
+  EXPECT_EQ(graph->GetAllNodesInfo().size(), static_cast<size_t>(add_num + 1));
+
+  // nodes are added breadth first from the inputs, edges in the same order
+  std::vector<std::string> names;
+  for (const auto &node : graph->GetDirectNode()) {
+    names.push_back(node->GetName());
+  }
+  EXPECT_EQ(names[0], "const");
+  EXPECT_EQ(names[1], "add_0");
+  auto const_node = graph->FindNode("const");
+  std::vector<std::string> peers;
+  for (const auto &peer : const_node->GetOutDataAnchor(0)->GetPeerInDataAnchors()) {
+    peers.push_back(peer->GetOwnerNode()->GetName() + ":" + std::to_string(peer->GetIdx()));
+  }
+  ASSERT_EQ(peers.size(), static_cast<size_t>(add_num + 1));
+  EXPECT_EQ(peers[0], "add_0:0");
+  EXPECT_EQ(peers[1], "add_0:1");
+
+  for (int i = 1; i < add_num; ++i) {
+    auto node = graph->FindNode("add_" + std::to_string(i));
+    ASSERT_NE(node, nullptr);
+    EXPECT_EQ(node->GetInDataAnchor(0)->GetPeerOutAnchor()->GetOwnerNode()->GetName(), "add_" + std::to_string(i - 1));
+    EXPECT_EQ(node->GetInDataAnchor(1)->GetPeerOutAnchor()->GetOwnerNode(), const_node);
+    EXPECT_EQ(node->GetInControlNodes().size(), (i >= 2) ? 1U : 0U);
+  }
+}
+
+TEST_F(UtestOperator, create_large_graph_from_operator) {
+  const int add_num = 2000;
+  op::BuilderConst const_op("const");
+  auto adds = BuildChain(const_op, add_num);
+  auto graph = GraphUtils::CreateGraphFromOperator("graph", {const_op});
+  ASSERT_NE(graph, nullptr);
+  EXPECT_EQ(graph->GetDirectNodesSize(), static_cast<size_t>(add_num + 1));
+  EXPECT_EQ(graph->FindNode("const")->GetOutDataNodesSize(), static_cast<uint32_t>(add_num + 1));
+  EXPECT_EQ(graph->FindNode("add_" + std::to_string(add_num - 1))->GetInControlNodes().size(), 1U);
+}
+
+TEST_F(UtestOperator, op_type_interned_with_all_funcs) {
+  // the registry lives as long as the process, so a repeated run registers a new type
+  static int run_index = 0;
+  const std::string infer_only_type = "InternedOnlyInfer" + std::to_string(run_index++);
+  auto type_id = OperatorFactoryImpl::GetOpTypeId("BuilderAdd");
+  ASSERT_NE(type_id, kInvalidOpTypeId);
+  EXPECT_EQ(OperatorFactoryImpl::GetOpTypeId("BuilderAdd"), type_id);
+  EXPECT_EQ(OperatorFactoryImpl::GetOpTypeId("NotRegisteredOp"), kInvalidOpTypeId);
+  EXPECT_EQ(OperatorFactoryImpl::GetOpType(kInvalidOpTypeId), "");
+  EXPECT_EQ(OperatorFactoryImpl::GetOpType(type_id), "BuilderAdd");
+  EXPECT_TRUE(OperatorFactoryImpl::IsExistOp("BuilderAdd"));
+
+  auto type_num = OperatorFactoryImpl::GetOpTypeNum();
+  InferShapeFunc infer_func = [](Operator &) { return GRAPH_SUCCESS; };
+  EXPECT_EQ(OperatorFactoryImpl::RegisterInferShapeFunc(infer_only_type, infer_func), GRAPH_SUCCESS);
+  EXPECT_NE(OperatorFactoryImpl::RegisterInferShapeFunc(infer_only_type, infer_func), GRAPH_SUCCESS);
+  auto new_id = OperatorFactoryImpl::GetOpTypeId(infer_only_type);
+  EXPECT_EQ(static_cast<size_t>(new_id), type_num);
+  EXPECT_EQ(OperatorFactoryImpl::GetOpType(type_id), "BuilderAdd");
+  EXPECT_NE(OperatorFactoryImpl::GetInferShapeFunc(infer_only_type), nullptr);
+  EXPECT_NE(OperatorFactoryImpl::GetInferShapeFunc(new_id), nullptr);
+  EXPECT_FALSE(OperatorFactoryImpl::IsExistOp(infer_only_type));
+
+  auto op_desc = std::make_shared<OpDesc>("add", "BuilderAdd");
+  op_desc->SetType(infer_only_type);
+  Operator op;
+  EXPECT_EQ(op_desc->CallInferFunc(op), GRAPH_SUCCESS);
+}
+
+TEST_F(UtestOperator, legacy_func_maps_still_consulted) {
+  static int run_index = 0;
+  const std::string legacy_type = "LegacyOnlyVerify" + std::to_string(run_index++);
+  if (OperatorFactoryImpl::operator_verify_funcs_ == nullptr) {
+    OperatorFactoryImpl::operator_verify_funcs_ = std::make_shared<std::map<std::string, VerifyFunc>>();
+  }
+  VerifyFunc verify_func = [](Operator &) { return GRAPH_FAILED; };
+  (*OperatorFactoryImpl::operator_verify_funcs_)[legacy_type] = verify_func;
+  EXPECT_NE(OperatorFactoryImpl::GetVerifyFunc(legacy_type), nullptr);
+  auto op_desc = std::make_shared<OpDesc>("verify", legacy_type);
+  EXPECT_EQ(op_desc->OpVerify(), GRAPH_FAILED);
+
+  // a direct write for an interned type fills the gap in its record
+  const std::string interned_type = legacy_type + "Interned";
+  InferShapeFunc infer_func = [](Operator &) { return GRAPH_SUCCESS; };
+  ASSERT_EQ(OperatorFactoryImpl::RegisterInferShapeFunc(interned_type, infer_func), GRAPH_SUCCESS);
+  auto type_id = OperatorFactoryImpl::GetOpTypeId(interned_type);
+  EXPECT_EQ(OperatorFactoryImpl::GetVerifyFunc(type_id), nullptr);
+  (*OperatorFactoryImpl::operator_verify_funcs_)[interned_type] = verify_func;
+  EXPECT_NE(OperatorFactoryImpl::GetVerifyFunc(type_id), nullptr);
+  (void)OperatorFactoryImpl::operator_verify_funcs_->erase(interned_type);
+  (void)OperatorFactoryImpl::operator_verify_funcs_->erase(legacy_type);
+  EXPECT_EQ(OperatorFactoryImpl::GetVerifyFunc(legacy_type), nullptr);
+}
+
+TEST_F(UtestOperator, op_type_registered_while_looked_up) {
+  static int run_index = 0;
+  const std::string prefix = "ConcurrentType" + std::to_string(run_index++) + "_";
+  const int type_num = 200;
+  auto builder_id = OperatorFactoryImpl::GetOpTypeId("BuilderAdd");
+  std::atomic<bool> lookup_failed(false);
+  std::thread reader([&]() {
+    for (int i = 0; i < type_num; ++i) {
+      if (OperatorFactoryImpl::GetOpTypeId("BuilderAdd") != builder_id ||
+          OperatorFactoryImpl::GetOpType(builder_id) != "BuilderAdd") {
+        lookup_failed = true;
+      }
+      (void)OperatorFactoryImpl::GetInferShapeFunc(prefix + std::to_string(i));
+    }
+  });
+  InferShapeFunc infer_func = [](Operator &) { return GRAPH_SUCCESS; };
+  for (int i = 0; i < type_num; ++i) {
+    EXPECT_EQ(OperatorFactoryImpl::RegisterInferShapeFunc(prefix + std::to_string(i), infer_func), GRAPH_SUCCESS);
+  }
+  reader.join();
+  EXPECT_FALSE(lookup_failed);
+  for (int i = 0; i < type_num; ++i) {
+    auto type_id = OperatorFactoryImpl::GetOpTypeId(prefix + std::to_string(i));
+    ASSERT_NE(type_id, kInvalidOpTypeId);
+    EXPECT_EQ(OperatorFactoryImpl::GetOpType(type_id), prefix + std::to_string(i));
+  }
+}
+}  // namespace ge
@@ -0,0 +1,131 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <sys/stat.h>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "graph/operator_factory_impl.h"
+#include "graph/opsproto_manager.h"
+
+namespace ge {
+namespace {
+// Built next to ut_graph, libops_proto_stub_a.so registers StubOpA and libops_proto_stub_b.so StubOpB
+const std::string kStubDir = OPS_PROTO_STUB_DIR;
+const std::string kStubA = kStubDir + "/libops_proto_stub_a.so";
+const std::string kStubB = kStubDir + "/libops_proto_stub_b.so";
+const std::string kManifest = kStubDir + "/ops_proto_manifest";
+
+std::map<std::string, std::string> GetOptions(bool lazy_load) {
+  std::map<std::string, std::string> options = {{"ge.opsProtoLibPath", kStubDir},
+                                                {"ge.opsProtoManifestPath", kManifest}};
+  if (lazy_load) {
+    options["ge.opsProtoLazyLoad"] = "1";
+  }
+  return options;
+}
+
+std::string ReadManifest() {
+  std::ifstream fs(kManifest);
+  std::stringstream ss;
+  ss << fs.rdbuf();
+  return ss.str();
+}
+
+std::string ManifestLine(const std::string &path, int64_t size_delta, const std::string &op_types) {
+  struct stat stat_buf;
+  if (stat(path.c_str(), &stat_buf) != 0) {
+    return path + "\t0\t0\t" + op_types + "\n";
+  }
+  return path + "\t" + std::to_string(static_cast<int64_t>(stat_buf.st_mtime)) + "\t" +
+         std::to_string(static_cast<int64_t>(stat_buf.st_size) + size_delta) + "\t" + op_types + "\n";
+}
+}  // namespace
+
+class UtestOpsProtoManager : public testing::Test {
+ protected:
+  void SetUp() { (void)std::remove(kManifest.c_str()); }
+  void TearDown() {
+    OpsProtoManager::Instance()->Finalize();
+    (void)std::remove(kManifest.c_str());
+  }
+};
+
+TEST_F(UtestOpsProtoManager, load_libraries_then_defer_them_by_manifest) {
+  ASSERT_TRUE(OpsProtoManager::Instance()->Initialize(GetOptions(false)));
+  EXPECT_TRUE(OperatorFactoryImpl::IsExistOp("StubOpA"));
+  EXPECT_NE(OperatorFactoryImpl::GetInferShapeFunc("StubOpB"), nullptr);
+  auto manifest = ReadManifest();
+  EXPECT_NE(manifest.find(kStubA), std::string::npos);
+  EXPECT_NE(manifest.find(kStubB), std::string::npos);
+  EXPECT_NE(manifest.find("StubOpA"), std::string::npos);
+  EXPECT_NE(manifest.find("StubOpB"), std::string::npos);
+  OpsProtoManager::Instance()->Finalize();
+
+  // the manifest is up to date, so each library waits for the first lookup of its op types
+  ASSERT_TRUE(OpsProtoManager::Instance()->Initialize(GetOptions(true)));
+  EXPECT_TRUE(OpsProtoManager::Instance()->LoadOpsProto("StubOpA"));
+  EXPECT_FALSE(OpsProtoManager::Instance()->LoadOpsProto("StubOpA"));
+  EXPECT_FALSE(OpsProtoManager::Instance()->LoadOpsProto("NotInAnyPlugin"));
+  EXPECT_EQ(ReadManifest(), manifest);
+
+  // concurrent lookups of a deferred op type all find it complete
+  std::atomic<int> found(0);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&found]() {
+      if (OperatorFactoryImpl::GetOpTypeId("StubOpB") != kInvalidOpTypeId &&
+          OperatorFactoryImpl::GetInferShapeFunc("StubOpB") != nullptr) {
+        ++found;
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(found, 4);
+  EXPECT_FALSE(OpsProtoManager::Instance()->LoadOpsProto("StubOpB"));
+}
+
+TEST_F(UtestOpsProtoManager, lookup_of_op_type_missing_from_library) {
+  {
+    std::ofstream fs(kManifest);
+    // StubOpMissing is not registered by the library, libops_proto_stub_b.so changed since the manifest was written
+    fs << ManifestLine(kStubA, 0, "StubOpA,StubOpMissing") << ManifestLine(kStubB, 1, "StubOpB")
+       << ManifestLine(kStubDir + "/libremoved.so", 0, "StubOpRemoved");
+  }
+  ASSERT_TRUE(OpsProtoManager::Instance()->Initialize(GetOptions(true)));
+  EXPECT_FALSE(OpsProtoManager::Instance()->LoadOpsProto("StubOpRemoved"));
+  EXPECT_FALSE(OpsProtoManager::Instance()->LoadOpsProto("StubOpB"));
+  EXPECT_EQ(OperatorFactoryImpl::GetOpTypeId("StubOpMissing"), kInvalidOpTypeId);
+  // the library was loaded for the missing op type
+  EXPECT_FALSE(OpsProtoManager::Instance()->LoadOpsProto("StubOpA"));
+  EXPECT_NE(OperatorFactoryImpl::GetOpTypeId("StubOpA"), kInvalidOpTypeId);
+
+  // the removed library is dropped and the changed one recorded again
+  auto manifest = ReadManifest();
+  EXPECT_EQ(manifest.find("libremoved.so"), std::string::npos);
+  auto stub_b_line = ManifestLine(kStubB, 0, "");
+  EXPECT_NE(manifest.find(stub_b_line.substr(0, stub_b_line.size() - 1)), std::string::npos);
+  EXPECT_NE(manifest.find("StubOpMissing"), std::string::npos);
+}
+}  // namespace ge
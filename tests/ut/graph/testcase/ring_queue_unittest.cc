@@ -0,0 +1,144 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "common/blocking_queue.h"
+#include "common/ring_queue.h"
+
+namespace {
+const int kProducerNum = 2;
+const int kConsumerNum = 2;
+const int64_t kItemsPerProducer = 20000;
+
+// Producers push [1, kItemsPerProducer] each, consumers sum until every item is received
+template <typename Queue>
+int64_t RunMpmc(Queue &queue) {
+  std::atomic<int64_t> total(0);
+  std::atomic<int64_t> received(0);
+  const int64_t expect_num = kProducerNum * kItemsPerProducer;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kConsumerNum; ++i) {
+    threads.emplace_back([&queue, &total, &received, expect_num]() {
+      int64_t item = 0;
+      while (received.load() < expect_num && queue.Pop(item)) {
+        total += item;
+        if (++received == expect_num) {
+          queue.Stop();
+        }
+      }
+    });
+  }
+  for (int i = 0; i < kProducerNum; ++i) {
+    threads.emplace_back([&queue]() {
+      for (int64_t item = 1; item <= kItemsPerProducer; ++item) {
+        if (!queue.Push(item)) {
+          break;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  return total.load();
+}
+}  // namespace
+
+class UtestRingQueue : public testing::Test {
+ protected:
+  void SetUp() {}
+  void TearDown() {}
+};
+
+TEST_F(UtestRingQueue, fifo_and_bounded) {
+  // max_size is kept even though the ring behind it is 4 slots
+  RingQueue<int> queue(3);
+  EXPECT_EQ(queue.Capacity(), 3U);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_TRUE(queue.Push(i, false));
+  }
+  EXPECT_TRUE(queue.IsFull());
+  EXPECT_FALSE(queue.Push(3, false));
+  EXPECT_FALSE(queue.TryPush(3));
+
+  int item = -1;
+  ASSERT_TRUE(queue.TryPop(item));
+  EXPECT_EQ(item, 0);
+  EXPECT_TRUE(queue.TryPush(3));
+  EXPECT_FALSE(queue.TryPush(4));
+  std::vector<int> items = {4, 5};
+  EXPECT_EQ(queue.PushBatch(items, false), 0U);
+  for (int i = 1; i < 4; ++i) {
+    ASSERT_TRUE(queue.TryPop(item));
+    EXPECT_EQ(item, i);
+  }
+  EXPECT_TRUE(queue.IsEmpty());
+  EXPECT_FALSE(queue.TryPop(item));
+}
+
+TEST_F(UtestRingQueue, stop_releases_waiters_and_keeps_remain_items) {
+  RingQueue<std::shared_ptr<std::string>> queue(2);
+  std::thread consumer([&queue]() {
+    std::shared_ptr<std::string> item;
+    while (queue.Pop(item)) {
+    }
+  });
+  queue.Stop();
+  consumer.join();
+
+  EXPECT_FALSE(queue.Push(std::make_shared<std::string>("dropped")));
+  queue.Restart();
+  EXPECT_TRUE(queue.Push(std::make_shared<std::string>("a")));
+  EXPECT_TRUE(queue.Push(std::make_shared<std::string>("b")));
+  EXPECT_TRUE(queue.GetRemainItems().empty());
+
+  std::thread producer([&queue]() { EXPECT_FALSE(queue.Push(std::make_shared<std::string>("c"))); });
+  queue.Stop();
+  producer.join();
+  auto remain = queue.GetRemainItems();
+  ASSERT_EQ(remain.size(), 2U);
+  EXPECT_EQ(*remain[0], "a");
+  EXPECT_EQ(*remain[1], "b");
+}
+
+TEST_F(UtestRingQueue, batch_push_and_pop) {
+  RingQueue<int> queue(4);
+  std::vector<int> items = {0, 1, 2, 3, 4, 5};
+  EXPECT_EQ(queue.PushBatch(items, false), 4U);
+  ASSERT_EQ(items.size(), 2U);
+  EXPECT_EQ(items[0], 4);
+
+  std::vector<int> popped;
+  EXPECT_EQ(queue.PopBatch(popped, 3), 3U);
+  EXPECT_EQ(queue.PushBatch(items), 2U);
+  EXPECT_TRUE(items.empty());
+  EXPECT_EQ(queue.PopBatch(popped, 8), 3U);
+  EXPECT_EQ(popped, std::vector<int>({0, 1, 2, 3, 4, 5}));
+}
+
+TEST_F(UtestRingQueue, mpmc_sum_matches_blocking_queue) {
+  const int64_t expect_sum = kProducerNum * kItemsPerProducer * (kItemsPerProducer + 1) / 2;
+  RingQueue<int64_t> ring_queue(256);
+  EXPECT_EQ(RunMpmc(ring_queue), expect_sum);
+  EXPECT_TRUE(ring_queue.IsEmpty());
+  BlockingQueue<int64_t> blocking_queue(256);
+  EXPECT_EQ(RunMpmc(blocking_queue), expect_sum);
+}
@@ -0,0 +1,218 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <map>
+#include <string>
+#include <vector>
+#include "graph/shape_refiner.h"
+#include "graph/compute_graph.h"
+#include "graph/ge_context.h"
+#include "graph/ge_local_context.h"
+#include "graph/operator.h"
+#include "graph/utils/graph_utils.h"
+#include "common/graph_builder_utils.h"
+
+namespace ge {
+namespace {
+std::atomic<int> g_infer_count(0);
+
+graphStatus DoubleInfer(Operator &op) {
+  ++g_infer_count;
+  auto desc = op.GetInputDesc("x0");
+  auto dims = desc.GetShape().GetDims();
+  dims[0] *= 2;
+  desc.SetShape(Shape(dims));
+  return op.UpdateOutputDesc("y0", desc);
+}
+
+// Concatenates all inputs along dim 0
+graphStatus ConcatInfer(Operator &op) {
+  auto desc = op.GetInputDesc(0);
+  auto dims = desc.GetShape().GetDims();
+  for (size_t i = 1; i < op.GetInputsSize(); ++i) {
+    dims[0] += op.GetInputDesc(i).GetShape().GetDims()[0];
+  }
+  desc.SetShape(Shape(dims));
+  return op.UpdateOutputDesc("y0", desc);
+}
+
+// Output shape is {session id, value of option ge.test.inferScale}
+graphStatus ContextInfer(Operator &op) {
+  std::string scale;
+  if (GetContext().GetOption("ge.test.inferScale", scale) != GRAPH_SUCCESS) {
+    return GRAPH_FAILED;
+  }
+  auto desc = op.GetInputDesc("x0");
+  desc.SetShape(Shape({static_cast<int64_t>(GetContext().SessionId()), std::stoll(scale)}));
+  return op.UpdateOutputDesc("y0", desc);
+}
+
+NodePtr AddConcatNode(const ComputeGraphPtr &graph, const std::string &name, size_t input_num) {
+  auto node = ut::AddNode(graph, name, "Concat", static_cast<int>(input_num), 1);
+  node->GetOpDesc()->AddInferFunc(ConcatInfer);
+  return node;
+}
+
+NodePtr AddDoubleNode(const ComputeGraphPtr &graph, const std::string &name) {
+  auto node = ut::AddNode(graph, name, "Double", 1, 1);
+  node->GetOpDesc()->AddInferFunc(DoubleInfer);
+  return node;
+}
+
+GeTensorDesc SourceDesc() {
+  return GeTensorDesc(GeShape({2, 3}), FORMAT_ND, DT_FLOAT);
+}
+
+// data feeds branches of different depth, every fourth branch joins the previous ones through a concat
+ComputeGraphPtr BuildWideGraph(size_t branch_num) {
+  auto graph = std::make_shared<ComputeGraph>("wide");
+  auto data = ut::AddNode(graph, "data", "Data", 0, 1, SourceDesc());
+  std::vector<NodePtr> tails;
+  for (size_t i = 0; i < branch_num; ++i) {
+    auto prev = data;
+    for (size_t j = 0; j <= i % 3; ++j) {
+      auto node = AddDoubleNode(graph, "double_" + std::to_string(i) + "_" + std::to_string(j));
+      GraphUtils::AddEdge(prev->GetOutDataAnchor(0), node->GetInDataAnchor(0));
+      prev = node;
+    }
+    if (i % 4 == 3) {
+      auto concat = AddConcatNode(graph, "concat_" + std::to_string(i), tails.size() + 1);
+      for (size_t k = 0; k < tails.size(); ++k) {
+        GraphUtils::AddEdge(tails[k]->GetOutDataAnchor(0), concat->GetInDataAnchor(k));
+      }
+      GraphUtils::AddEdge(prev->GetOutDataAnchor(0), concat->GetInDataAnchor(tails.size()));
+      GraphUtils::AddEdge(data->GetOutControlAnchor(), concat->GetInControlAnchor());
+      tails.clear();
+      prev = concat;
+    }
+    tails.push_back(prev);
+  }
+  graph->TopologicalSorting();
+  return graph;
+}
+}  // namespace
+
+class UtestShapeRefiner : public testing::Test {
+ protected:
+  void SetUp() {
+    g_infer_count = 0;
+    ShapeRefiner::ClearInferCache();
+    ShapeRefiner::SetInferCacheCapacity(16);
+  }
+  void TearDown() {
+    ShapeRefiner::SetInferCacheCapacity(0);
+    ShapeRefiner::ClearInferCache();
+  }
+};
+
+TEST_F(UtestShapeRefiner, infer_cache_replays_same_signature) {
+  auto graph = std::make_shared<ComputeGraph>("graph");
+  auto data = ut::AddNode(graph, "data", "Data", 0, 1, SourceDesc());
+  std::vector<NodePtr> doubles;
+  for (int i = 0; i < 4; ++i) {
+    auto node = AddDoubleNode(graph, "double_" + std::to_string(i));
+    GraphUtils::AddEdge(data->GetOutDataAnchor(0), node->GetInDataAnchor(0));
+    doubles.push_back(node);
+  }
+  auto tail = AddDoubleNode(graph, "tail");
+  GraphUtils::AddEdge(doubles[0]->GetOutDataAnchor(0), tail->GetInDataAnchor(0));
+
+  for (const auto &node : doubles) {
+    ASSERT_EQ(ShapeRefiner::InferShapeAndType(node), GRAPH_SUCCESS);
+    EXPECT_EQ(node->GetOpDesc()->GetOutputDesc(0).GetShape().GetDims(), std::vector<int64_t>({4, 3}));
+  }
+  ASSERT_EQ(ShapeRefiner::InferShapeAndType(tail), GRAPH_SUCCESS);
+  EXPECT_EQ(tail->GetOpDesc()->GetOutputDesc(0).GetShape().GetDims(), std::vector<int64_t>({8, 3}));
+  EXPECT_EQ(tail->GetOpDesc()->GetOutputDesc(0).GetDataType(), DT_FLOAT);
+
+  EXPECT_EQ(g_infer_count, 2);
+  auto stats = ShapeRefiner::GetInferCacheStats();
+  EXPECT_EQ(stats.hits, 3U);
+  EXPECT_EQ(stats.misses, 2U);
+  EXPECT_EQ(stats.entries, 2U);
+
+  ShapeRefiner::SetInferCacheCapacity(1);
+  EXPECT_EQ(ShapeRefiner::GetInferCacheStats().entries, 1U);
+}
+
+TEST_F(UtestShapeRefiner, infer_cache_bypassed_for_const_input) {
+  auto graph = std::make_shared<ComputeGraph>("graph");
+  auto weight = ut::AddNode(graph, "weight", "Const", 0, 1, SourceDesc());
+  for (int i = 0; i < 2; ++i) {
+    auto node = AddDoubleNode(graph, "double_" + std::to_string(i));
+    GraphUtils::AddEdge(weight->GetOutDataAnchor(0), node->GetInDataAnchor(0));
+    ASSERT_EQ(ShapeRefiner::InferShapeAndType(node), GRAPH_SUCCESS);
+  }
+  EXPECT_EQ(g_infer_count, 2);
+  auto stats = ShapeRefiner::GetInferCacheStats();
+  EXPECT_EQ(stats.bypasses, 2U);
+  EXPECT_EQ(stats.hits, 0U);
+  EXPECT_EQ(stats.entries, 0U);
+}
+
+TEST_F(UtestShapeRefiner, parallel_graph_infer_same_as_serial) {
+  ShapeRefiner::SetInferCacheCapacity(0);
+  auto serial_graph = BuildWideGraph(64);
+  auto parallel_graph = BuildWideGraph(64);
+  ASSERT_EQ(ShapeRefiner::InferShapeAndTypeForGraph(serial_graph, 1), GRAPH_SUCCESS);
+  ASSERT_EQ(ShapeRefiner::InferShapeAndTypeForGraph(parallel_graph, 4), GRAPH_SUCCESS);
+
+  ASSERT_EQ(serial_graph->GetDirectNodesSize(), parallel_graph->GetDirectNodesSize());
+  for (const auto &node : serial_graph->GetDirectNode()) {
+    auto peer = parallel_graph->FindNode(node->GetName());
+    ASSERT_NE(peer, nullptr);
+    auto &op_desc = *node->GetOpDesc();
+    auto &peer_op_desc = *peer->GetOpDesc();
+    for (size_t i = 0; i < op_desc.GetInputsSize(); ++i) {
+      EXPECT_EQ(op_desc.GetInputDesc(i), peer_op_desc.GetInputDesc(i));
+    }
+    ASSERT_EQ(op_desc.GetOutputsSize(), peer_op_desc.GetOutputsSize());
+    for (size_t i = 0; i < op_desc.GetOutputsSize(); ++i) {
+      EXPECT_EQ(op_desc.GetOutputDesc(i), peer_op_desc.GetOutputDesc(i));
+    }
+  }
+  auto concat = parallel_graph->FindNode("concat_63");
+  ASSERT_NE(concat, nullptr);
+  EXPECT_FALSE(concat->GetOpDesc()->GetOutputDesc(0).GetShape().GetDims().empty());
+}
+
+TEST_F(UtestShapeRefiner, parallel_graph_infer_sees_caller_context) {
+  ShapeRefiner::SetInferCacheCapacity(0);
+  auto graph = std::make_shared<ComputeGraph>("graph");
+  auto data = ut::AddNode(graph, "data", "Data", 0, 1, SourceDesc());
+  std::vector<NodePtr> nodes;
+  for (int i = 0; i < 16; ++i) {
+    auto node = ut::AddNode(graph, "context_" + std::to_string(i), "Context", 1, 1);
+    node->GetOpDesc()->AddInferFunc(ContextInfer);
+    GraphUtils::AddEdge(data->GetOutDataAnchor(0), node->GetInDataAnchor(0));
+    nodes.push_back(node);
+  }
+  auto graph_options = GetThreadLocalContext().GetAllGraphOptions();
+  auto session_id = GetContext().SessionId();
+  std::map<std::string, std::string> options = {{"ge.test.inferScale", "7"}};
+  GetThreadLocalContext().SetGraphOption(options);
+  GetContext().SetSessionId(12);
+
+  EXPECT_EQ(ShapeRefiner::InferShapeAndTypeForGraph(graph, 4), GRAPH_SUCCESS);
+  for (const auto &node : nodes) {
+    EXPECT_EQ(node->GetOpDesc()->GetOutputDesc(0).GetShape().GetDims(), std::vector<int64_t>({12, 7}));
+  }
+  GetThreadLocalContext().SetGraphOption(graph_options);
+  GetContext().SetSessionId(session_id);
+}
+}  // namespace ge
@@ -0,0 +1,107 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "graph/tuning_utils.h"
+#include "common/graph_builder_utils.h"
+
+namespace ge {
+namespace {
+// const -> end
+ComputeGraphPtr BuildProducer(const std::string &name) {
+  auto graph = std::make_shared<ComputeGraph>(name);
+  auto weight = ut::AddNode(graph, name + "_weight", "Const", 0, 1);
+  auto end = ut::AddNode(graph, name + "_end", "End", 1, 0);
+  (void)GraphUtils::AddEdge(weight->GetOutDataAnchor(0), end->GetInDataAnchor(0));
+  return graph;
+}
+
+// pld -> relu -> end, the pld stands for the end of the producer
+ComputeGraphPtr BuildConsumer(const std::string &name, const std::string &producer) {
+  auto graph = std::make_shared<ComputeGraph>(name);
+  auto pld = ut::AddNode(graph, name + "_pld", "PlaceHolder", 0, 1);
+  (void)AttrUtils::SetStr(pld->GetOpDesc(), "parentOpType", "Const");
+  (void)AttrUtils::SetStr(pld->GetOpDesc(), "_parentNodeName", producer + "_weight");
+  (void)AttrUtils::SetInt(pld->GetOpDesc(), "anchorIndex", 0);
+  (void)AttrUtils::SetStr(pld->GetOpDesc(), "_peerNodeName", producer + "_end");
+  auto relu = ut::AddNode(graph, name + "_relu", "Relu", 1, 1);
+  auto end = ut::AddNode(graph, name + "_end", "End", 1, 0);
+  (void)GraphUtils::AddEdge(pld->GetOutDataAnchor(0), relu->GetInDataAnchor(0));
+  (void)GraphUtils::AddEdge(relu->GetOutDataAnchor(0), end->GetInDataAnchor(0));
+  return graph;
+}
+}  // namespace
+
+class UtestTuningUtils : public testing::Test {
+ protected:
+  void SetUp() {
+    char dir_template[] = "/tmp/ge_tuning_ut_XXXXXX";
+    ASSERT_NE(mkdtemp(dir_template), nullptr);
+    dir_ = dir_template;
+  }
+  void TearDown() {
+    for (const auto &file : files_) {
+      (void)unlink(file.c_str());
+    }
+    (void)rmdir(dir_.c_str());
+  }
+  std::string dir_;
+  std::vector<std::string> files_;
+};
+
+TEST_F(UtestTuningUtils, convert_subgraphs_and_merge_back) {
+  const size_t kPairNum = 4U;
+  std::vector<ComputeGraphPtr> tuning_subgraphs;
+  for (size_t i = 0U; i < kPairNum; ++i) {
+    tuning_subgraphs.push_back(BuildProducer("p" + std::to_string(i)));
+    tuning_subgraphs.push_back(BuildConsumer("c" + std::to_string(i), "p" + std::to_string(i)));
+  }
+  std::vector<ComputeGraphPtr> non_tuning_subgraphs = {BuildProducer("n0")};
+  ASSERT_EQ(TuningUtils::ConvertGraphToFile(tuning_subgraphs, non_tuning_subgraphs, true, dir_), GRAPH_SUCCESS);
+
+  // the file name follows the position in the input, not the order the workers finish in
+  std::map<int64_t, std::string> options;
+  for (size_t i = 0U; i < tuning_subgraphs.size(); ++i) {
+    std::string file = dir_ + "/aicore_subgraph_" + std::to_string(i) + ".txt";
+    files_.push_back(file);
+    ComputeGraphPtr loaded;
+    ASSERT_TRUE(GraphUtils::LoadGEGraph(file.c_str(), loaded));
+    EXPECT_NE(loaded->FindNode(tuning_subgraphs[i]->GetName() + "_end"), nullptr);
+    options[static_cast<int64_t>(i)] = file;
+  }
+  files_.push_back(dir_ + "/subgraph_0.txt");
+  EXPECT_EQ(access(files_.back().c_str(), F_OK), 0);
+
+  Graph graph;
+  ASSERT_EQ(TuningUtils::ConvertFileToGraph(options, graph), GRAPH_SUCCESS);
+  auto merged = GraphUtils::GetComputeGraph(graph);
+  ASSERT_NE(merged, nullptr);
+  // the added data and netoutput nodes are gone and every weight feeds its relu again
+  EXPECT_EQ(merged->GetDirectNodesSize(), 2U * kPairNum);
+  for (size_t i = 0U; i < kPairNum; ++i) {
+    auto relu = merged->FindNode("c" + std::to_string(i) + "_relu");
+    ASSERT_NE(relu, nullptr);
+    auto in_nodes = relu->GetInDataNodes();
+    ASSERT_EQ(in_nodes.size(), 1U);
+    EXPECT_EQ(in_nodes.at(0)->GetName(), "p" + std::to_string(i) + "_weight");
+  }
+}
+}  // namespace ge
@@ -0,0 +1,92 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "register/register_format_transfer.h"
+
+using namespace ge;
+using namespace ge::formats;
+
+namespace {
+const int kRepeatTimes = 5;
+
+struct BenchCase {
+  const char *name;
+  Format src_format;
+  Format dst_format;
+  std::vector<int64_t> src_shape;
+  std::vector<int64_t> dst_shape;
+  DataType data_type;
+};
+
+// Best of kRepeatTimes runs in ms, negative when the implementation is not usable here
+double Run(const BenchCase &bench_case, const std::vector<uint8_t> &data, const std::string &impl_name) {
+  TransArgs args{data.data(), bench_case.src_format, bench_case.dst_format, bench_case.src_shape,
+                 bench_case.dst_shape, bench_case.data_type};
+  auto transfer = BuildFormatTransfer(args, impl_name);
+  if (transfer == nullptr) {
+    return -1.0;
+  }
+  double best = -1.0;
+  for (int i = 0; i < kRepeatTimes; ++i) {
+    TransResult result;
+    auto start = std::chrono::steady_clock::now();
+    if (transfer->TransFormat(args, result) != SUCCESS) {
+      return -1.0;
+    }
+    double cost = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    best = (best < 0.0) ? cost : std::min(best, cost);
+  }
+  return best;
+}
+}  // namespace
+
+int main() {
+  // weights and feature maps sized like the middle layers of a ResNet-50
+  const std::vector<BenchCase> cases = {
+      {"fp32 NCHW->NC1HWC0", FORMAT_NCHW, FORMAT_NC1HWC0, {8, 256, 56, 56}, {8, 16, 56, 56, 16}, DT_FLOAT},
+      {"fp16 NCHW->NC1HWC0", FORMAT_NCHW, FORMAT_NC1HWC0, {8, 256, 56, 56}, {8, 16, 56, 56, 16}, DT_FLOAT16},
+      {"fp32 NC1HWC0->NCHW", FORMAT_NC1HWC0, FORMAT_NCHW, {8, 16, 56, 56, 16}, {8, 256, 56, 56}, DT_FLOAT},
+      {"fp16 NC1HWC0->NCHW", FORMAT_NC1HWC0, FORMAT_NCHW, {8, 16, 56, 56, 16}, {8, 256, 56, 56}, DT_FLOAT16},
+      {"fp16 NHWC->NC1HWC0", FORMAT_NHWC, FORMAT_NC1HWC0, {8, 56, 56, 256}, {8, 16, 56, 56, 16}, DT_FLOAT16},
+      {"fp16 NC1HWC0->NHWC", FORMAT_NC1HWC0, FORMAT_NHWC, {8, 16, 56, 56, 16}, {8, 56, 56, 256}, DT_FLOAT16},
+      {"fp32 NCHW->FRACTAL_Z", FORMAT_NCHW, FORMAT_FRACTAL_Z, {512, 256, 3, 3}, {144, 32, 16, 16}, DT_FLOAT},
+      {"fp16 NCHW->FRACTAL_Z", FORMAT_NCHW, FORMAT_FRACTAL_Z, {512, 256, 3, 3}, {144, 32, 16, 16}, DT_FLOAT16},
+      {"int8 NCHW->FRACTAL_Z", FORMAT_NCHW, FORMAT_FRACTAL_Z, {512, 256, 3, 3}, {72, 32, 16, 32}, DT_INT8},
+  };
+  for (const auto &bench_case : cases) {
+    int64_t size = GetSizeByDataType(bench_case.data_type);
+    for (auto dim : bench_case.src_shape) {
+      size *= dim;
+    }
+    std::vector<uint8_t> data(static_cast<size_t>(size), 1);
+    printf("%-24s", bench_case.name);
+    for (const auto &impl : GetFormatTransferImpls(bench_case.src_format, bench_case.dst_format)) {
+      double cost = Run(bench_case, data, impl);
+      if (cost < 0.0) {
+        printf("  %s: n/a", impl.c_str());
+      } else {
+        printf("  %s: %.2fms", impl.c_str(), cost);
+      }
+    }
+    printf("\n");
+  }
+  return 0;
+}
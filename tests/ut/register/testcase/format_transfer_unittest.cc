@@ -0,0 +1,199 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <string>
+#include <utility>
+#include <vector>
+#include "register/register_format_transfer.h"
+
+namespace ge {
+namespace formats {
+namespace {
+struct TransCase {
+  Format src_format;
+  Format dst_format;
+  // NCHW or NHWC shape on the 4D side of the transfer
+  std::vector<int64_t> origin_shape;
+};
+
+std::vector<uint8_t> MakeData(int64_t size) {
+  std::vector<uint8_t> data(static_cast<size_t>(size));
+  uint32_t seed = 12345U;
+  for (auto &byte : data) {
+    seed = seed * 1103515245U + 12345U;
+    byte = static_cast<uint8_t>(seed >> 16U);
+  }
+  return data;
+}
+
+int64_t GetSize(const std::vector<int64_t> &shape, DataType data_type) {
+  int64_t size = GetSizeByDataType(data_type);
+  for (auto dim : shape) {
+    size *= dim;
+  }
+  return size;
+}
+
+TransArgs MakeArgs(const TransCase &trans_case, DataType data_type) {
+  bool to_origin = (trans_case.dst_format == FORMAT_NCHW) || (trans_case.dst_format == FORMAT_NHWC);
+  TransArgs args{nullptr, trans_case.src_format, trans_case.dst_format, trans_case.origin_shape, {}, data_type};
+  if (to_origin) {
+    std::swap(args.src_format, args.dst_format);
+  }
+  auto transfer = BuildFormatTransfer(args);
+  if (transfer != nullptr) {
+    (void)transfer->TransShape(args.src_format, args.src_shape, data_type, args.dst_format, args.dst_shape);
+  }
+  if (to_origin) {
+    std::swap(args.src_format, args.dst_format);
+    std::swap(args.src_shape, args.dst_shape);
+  }
+  return args;
+}
+
+TransResult Trans(TransArgs args, const std::vector<uint8_t> &data, const std::string &impl_name) {
+  args.data = data.data();
+  TransResult result{nullptr, 0};
+  auto transfer = BuildFormatTransfer(args, impl_name);
+  if ((transfer != nullptr) && (transfer->TransFormat(args, result) != SUCCESS)) {
+    result.data = nullptr;
+  }
+  return result;
+}
+
+int g_registered_transfer_count = 0;
+
+// Stands for a transfer registered by the framework, it moves the data like the reference kernels
+class RegisteredTransfer : public FormatTransfer {
+ public:
+  Status TransFormat(const TransArgs &args, TransResult &result) override {
+    ++g_registered_transfer_count;
+    auto transfer = BuildFormatTransfer(args, "reference");
+    return (transfer == nullptr) ? FAILED : transfer->TransFormat(args, result);
+  }
+  Status TransShape(Format src_format, const std::vector<int64_t> &src_shape, DataType data_type, Format dst_format,
+                    std::vector<int64_t> &dst_shape) override {
+    TransArgs args{nullptr, src_format, dst_format, src_shape, {}, data_type};
+    auto transfer = BuildFormatTransfer(args, "reference");
+    return (transfer == nullptr) ? FAILED : transfer->TransShape(src_format, src_shape, data_type, dst_format,
+                                                                  dst_shape);
+  }
+};
+}  // namespace
+
+REGISTER_FORMAT_TRANSFER(RegisteredTransfer, FORMAT_NC1HWC0, FORMAT_NHWC)
+
+class UtestFormatTransfer : public testing::Test {
+ protected:
+  void SetUp() {}
+  void TearDown() {}
+};
+
+TEST_F(UtestFormatTransfer, nchw_to_nc1hwc0_layout) {
+  // N=1 C=2 H=1 W=3 fp16, values are c * 10 + w
+  std::vector<uint16_t> src = {0, 1, 2, 10, 11, 12};
+  TransArgs args{reinterpret_cast<const uint8_t *>(src.data()), FORMAT_NCHW, FORMAT_NC1HWC0, {1, 2, 1, 3},
+                 {1, 1, 1, 3, 16}, DT_FLOAT16};
+  auto transfer = BuildFormatTransfer(args);
+  ASSERT_NE(transfer, nullptr);
+  TransResult result;
+  ASSERT_EQ(transfer->TransFormat(args, result), SUCCESS);
+  ASSERT_EQ(result.length, 3U * 16U * sizeof(uint16_t));
+  auto dst = reinterpret_cast<const uint16_t *>(result.data.get());
+  for (int64_t w = 0; w < 3; ++w) {
+    EXPECT_EQ(dst[w * 16], w);
+    EXPECT_EQ(dst[w * 16 + 1], 10 + w);
+    for (int64_t c0 = 2; c0 < 16; ++c0) {
+      EXPECT_EQ(dst[w * 16 + c0], 0);
+    }
+  }
+
+  std::vector<int64_t> dst_shape;
+  EXPECT_EQ(transfer->TransShape(FORMAT_NCHW, {8, 33, 3, 3}, DT_INT8, FORMAT_NC1HWC0, dst_shape), SUCCESS);
+  EXPECT_EQ(dst_shape, std::vector<int64_t>({8, 2, 3, 3, 32}));
+}
+
+TEST_F(UtestFormatTransfer, impls_are_ranked_and_bitwise_equal_to_reference) {
+  const std::vector<TransCase> cases = {
+      {FORMAT_NCHW, FORMAT_NC1HWC0, {2, 37, 5, 7}},     {FORMAT_NCHW, FORMAT_NC1HWC0, {1, 64, 9, 16}},
+      {FORMAT_NHWC, FORMAT_NC1HWC0, {2, 5, 7, 37}},     {FORMAT_NC1HWC0, FORMAT_NCHW, {2, 37, 5, 7}},
+      {FORMAT_NC1HWC0, FORMAT_NCHW, {1, 64, 9, 16}},    {FORMAT_NC1HWC0, FORMAT_NHWC, {2, 5, 7, 37}},
+      {FORMAT_NCHW, FORMAT_FRACTAL_Z, {20, 37, 3, 3}},  {FORMAT_NCHW, FORMAT_FRACTAL_Z, {32, 64, 3, 3}},
+  };
+  for (const auto &trans_case : cases) {
+    auto impls = GetFormatTransferImpls(trans_case.src_format, trans_case.dst_format);
+    ASSERT_GE(impls.size(), 2U);
+    EXPECT_EQ(impls.back(), "reference");
+    for (auto data_type : {DT_FLOAT, DT_FLOAT16, DT_INT8, DT_INT64}) {
+      auto args = MakeArgs(trans_case, data_type);
+      ASSERT_FALSE(args.dst_shape.empty());
+      auto data = MakeData(GetSize(args.src_shape, data_type));
+      auto expect = Trans(args, data, "reference");
+      ASSERT_NE(expect.data, nullptr);
+      for (const auto &impl : impls) {
+        auto result = Trans(args, data, impl);
+        if (result.data == nullptr) {
+          // registered for a CPU feature this machine lacks
+          continue;
+        }
+        ASSERT_EQ(result.length, expect.length) << impl;
+        EXPECT_EQ(memcmp(result.data.get(), expect.data.get(), expect.length), 0)
+            << impl << " " << trans_case.src_format << "->" << trans_case.dst_format << " dtype " << data_type;
+      }
+    }
+  }
+}
+
+TEST_F(UtestFormatTransfer, registered_transfer_ranks_above_builtin_kernels) {
+  auto impls = GetFormatTransferImpls(FORMAT_NC1HWC0, FORMAT_NHWC);
+  ASSERT_FALSE(impls.empty());
+  EXPECT_EQ(impls.front(), "default");
+  std::vector<uint16_t> src(16U * 3U, 1U);
+  TransArgs args{reinterpret_cast<const uint8_t *>(src.data()), FORMAT_NC1HWC0, FORMAT_NHWC, {1, 1, 1, 3, 16},
+                 {1, 1, 3, 16}, DT_FLOAT16};
+  auto transfer = BuildFormatTransfer(args);
+  ASSERT_NE(transfer, nullptr);
+  TransResult result;
+  int count = g_registered_transfer_count;
+  ASSERT_EQ(transfer->TransFormat(args, result), SUCCESS);
+  EXPECT_EQ(g_registered_transfer_count, count + 1);
+  EXPECT_EQ(result.length, src.size() * sizeof(uint16_t));
+}
+
+TEST_F(UtestFormatTransfer, invalid_args) {
+  std::vector<uint8_t> data(64);
+  TransArgs args{data.data(), FORMAT_NCHW, FORMAT_NC1HWC0, {1, 2, 1, 3}, {1, 1, 1, 3, 32}, DT_FLOAT16};
+  auto transfer = BuildFormatTransfer(args);
+  ASSERT_NE(transfer, nullptr);
+  TransResult result;
+  EXPECT_NE(transfer->TransFormat(args, result), SUCCESS);
+  args.dst_shape = {1, 1, 1, 3, 16};
+  args.src_data_type = DT_COMPLEX128;
+  EXPECT_NE(transfer->TransFormat(args, result), SUCCESS);
+  args.src_data_type = DT_FLOAT16;
+  args.dst_format = static_cast<Format>(GetFormatFromSub(FORMAT_NC1HWC0, 2));
+  EXPECT_NE(transfer->TransFormat(args, result), SUCCESS);
+  std::vector<int64_t> dst_shape;
+  EXPECT_NE(transfer->TransShape(FORMAT_NCHW, {1, 2, 1, 3}, DT_FLOAT16, args.dst_format, dst_shape), SUCCESS);
+  args.dst_format = FORMAT_NC1HWC0;
+  EXPECT_EQ(BuildFormatTransfer(args, "not_registered"), nullptr);
+  args.dst_format = FORMAT_HWCN;
+  EXPECT_FALSE(FormatTransferExists(args));
+}
+}  // namespace formats
+}  // namespace ge
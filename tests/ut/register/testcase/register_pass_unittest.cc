@@ -0,0 +1,176 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "register/custom_pass_helper.h"
+#include "graph/ge_context.h"
+#include "graph/ge_local_context.h"
+#include "graph/utils/thread_pool.h"
+
+namespace ge {
+namespace {
+std::mutex g_order_mutex;
+std::vector<std::string> g_run_order;
+// option ge.test.passTag and session id each read-only pass ran with
+std::vector<std::string> g_pass_contexts;
+std::atomic<int> g_running(0);
+std::atomic<int> g_max_running(0);
+bool g_fail_last = false;
+
+void Record(const std::string &name) {
+  std::lock_guard<std::mutex> lock(g_order_mutex);
+  g_run_order.push_back(name);
+}
+
+Status ReadOnlyPass(const std::string &name) {
+  int running = ++g_running;
+  int max_running = g_max_running.load();
+  while ((running > max_running) && !g_max_running.compare_exchange_weak(max_running, running)) {
+  }
+  Record(name);
+  std::string tag;
+  (void)GetContext().GetOption("ge.test.passTag", tag);
+  {
+    std::lock_guard<std::mutex> lock(g_order_mutex);
+    g_pass_contexts.push_back(tag + ":" + std::to_string(GetContext().SessionId()));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  --g_running;
+  return SUCCESS;
+}
+}  // namespace
+
+REGISTER_CUSTOM_PASS("last").CustomPassFn([](GraphPtr &) -> Status {
+  Record("last");
+  return g_fail_last ? FAILED : SUCCESS;
+});
+REGISTER_CUSTOM_PASS("analyse_b").Priority(2).ReadOnly(true).CustomPassFn([](GraphPtr &) -> Status {
+  return ReadOnlyPass("analyse_b");
+});
+REGISTER_CUSTOM_PASS("first").Priority(0).CustomPassFn([](GraphPtr &) -> Status {
+  Record("first");
+  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  return SUCCESS;
+});
+REGISTER_CUSTOM_PASS("analyse_a").Priority(1).ReadOnly(true).CustomPassFn([](GraphPtr &) -> Status {
+  return ReadOnlyPass("analyse_a");
+});
+
+class UtestRegisterPass : public testing::Test {
+ protected:
+  void SetUp() {
+    g_run_order.clear();
+    g_pass_contexts.clear();
+    g_max_running = 0;
+    g_fail_last = false;
+    CustomPassHelper::Instance().SetTimeBudget(0U);
+  }
+  void TearDown() {}
+};
+
+TEST_F(UtestRegisterPass, run_in_priority_order_with_stats) {
+  GraphPtr graph;
+  std::vector<CustomPassStat> stats;
+  ASSERT_EQ(CustomPassHelper::Instance().Run(graph, stats), SUCCESS);
+  ASSERT_EQ(g_run_order.size(), 4U);
+  EXPECT_EQ(g_run_order.front(), "first");
+  EXPECT_EQ(g_run_order.back(), "last");
+  if (ThreadPool::GetThreadNum(2U) > 1U) {
+    EXPECT_EQ(g_max_running.load(), 2);
+  }
+
+  ASSERT_EQ(stats.size(), 4U);
+  std::vector<std::string> names = {"first", "analyse_a", "analyse_b", "last"};
+  for (size_t i = 0U; i < stats.size(); ++i) {
+    EXPECT_EQ(stats[i].pass_name, names[i]);
+    EXPECT_FALSE(stats[i].skipped);
+    EXPECT_EQ(stats[i].status, SUCCESS);
+  }
+  EXPECT_TRUE(stats[1].read_only);
+  EXPECT_FALSE(stats[3].read_only);
+  EXPECT_EQ(stats[3].priority, INT_MAX);
+  EXPECT_GE(stats[1].cost_us, 20000U);
+
+  g_fail_last = true;
+  EXPECT_NE(CustomPassHelper::Instance().Run(graph), SUCCESS);
+  EXPECT_NE(CustomPassHelper::Instance().Run(graph, stats), SUCCESS);
+  ASSERT_EQ(stats.size(), 4U);
+  EXPECT_EQ(stats[3].status, FAILED);
+}
+
+TEST_F(UtestRegisterPass, budget_skips_low_priority_passes) {
+  // the failing pass is skipped, so it cannot fail the run
+  g_fail_last = true;
+  CustomPassHelper::Instance().SetTimeBudget(1U, 0);
+  GraphPtr graph;
+  std::vector<CustomPassStat> stats;
+  ASSERT_EQ(CustomPassHelper::Instance().Run(graph, stats), SUCCESS);
+  EXPECT_EQ(g_run_order, std::vector<std::string>({"first"}));
+  ASSERT_EQ(stats.size(), 4U);
+  EXPECT_FALSE(stats[0].skipped);
+  EXPECT_TRUE(stats[1].skipped);
+  EXPECT_TRUE(stats[2].skipped);
+  EXPECT_TRUE(stats[3].skipped);
+  EXPECT_EQ(stats[3].cost_us, 0U);
+}
+
+TEST_F(UtestRegisterPass, concurrent_runs_keep_their_own_stats) {
+  const size_t kRunNum = 4U;
+  std::vector<std::vector<CustomPassStat>> stats(kRunNum);
+  std::vector<Status> results(kRunNum, FAILED);
+  std::vector<std::thread> threads;
+  for (size_t i = 0U; i < kRunNum; ++i) {
+    threads.emplace_back([&stats, &results, i]() {
+      GraphPtr graph;
+      results[i] = CustomPassHelper::Instance().Run(graph, stats[i]);
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(g_run_order.size(), kRunNum * 4U);
+  for (size_t i = 0U; i < kRunNum; ++i) {
+    EXPECT_EQ(results[i], SUCCESS);
+    ASSERT_EQ(stats[i].size(), 4U);
+    EXPECT_EQ(stats[i][0].pass_name, "first");
+    EXPECT_GE(stats[i][1].cost_us, 20000U);
+    EXPECT_EQ(stats[i][3].status, SUCCESS);
+  }
+}
+
+TEST_F(UtestRegisterPass, read_only_passes_see_caller_context) {
+  auto graph_options = GetThreadLocalContext().GetAllGraphOptions();
+  auto session_id = GetContext().SessionId();
+  std::map<std::string, std::string> options = {{"ge.test.passTag", "tagged"}};
+  GetThreadLocalContext().SetGraphOption(options);
+  GetContext().SetSessionId(21);
+
+  GraphPtr graph;
+  EXPECT_EQ(CustomPassHelper::Instance().Run(graph), SUCCESS);
+  EXPECT_EQ(g_pass_contexts, std::vector<std::string>({"tagged:21", "tagged:21"}));
+  GetThreadLocalContext().SetGraphOption(graph_options);
+  GetContext().SetSessionId(session_id);
+}
+}  // namespace ge
@@ -17,6 +17,8 @@
 #ifndef INC_FRAMEWORK_COMMON_DEBUG_GE_LOG_H_
 #define INC_FRAMEWORK_COMMON_DEBUG_GE_LOG_H_
 
+#include <atomic>
+#include <chrono>
 #include <cstdint>
 
 #include "framework/common/ge_inner_error_codes.h"
@@ -47,9 +49,64 @@ class GE_FUNC_VISIBILITY GeLog {
 #endif
     return tid;
   }
+
+  // The debug to error levels of GE are kept in a mask and asked from slog again at most once a second, checked
+  // every kLevelCheckCalls calls of a thread. RefreshLogLevel makes the next call ask at once, e.g. after
+  // dlog_setlevel. The level cache is a local change of this copy of ge_log.h, keep it when syncing with upstream.
+  static void RefreshLogLevel() {
+    GetLevelMask().store(0U, std::memory_order_relaxed);
+  }
+
+  static bool IsLevelEnable(int log_level) {
+    thread_local static uint32_t call_num = 0U;
+    uint32_t mask = GetLevelMask().load(std::memory_order_relaxed);
+    if (((mask & kLevelMaskValid) == 0U) || (((++call_num % kLevelCheckCalls) == 0U) && IsLevelMaskExpired())) {
+      mask = LoadLevelMask();
+    }
+    return (mask & (1U << static_cast<uint32_t>(log_level))) != 0U;
+  }
+
+ private:
+  static const uint32_t kLevelMaskValid = 1U << 31;
+  static const uint32_t kLevelCheckCalls = 1024U;
+  static const int64_t kLevelExpireMs = 1000;
+
+  static std::atomic<uint32_t> &GetLevelMask() {
+    static std::atomic<uint32_t> level_mask(0U);
+    return level_mask;
+  }
+
+  static std::atomic<int64_t> &GetLevelLoadTime() {
+    static std::atomic<int64_t> load_time(0);
+    return load_time;
+  }
+
+  static int64_t GetNowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  static bool IsLevelMaskExpired() {
+    return (GetNowMs() - GetLevelLoadTime().load(std::memory_order_relaxed)) >= kLevelExpireMs;
+  }
+
+  static uint32_t LoadLevelMask() {
+    uint32_t mask = kLevelMaskValid;
+    for (int level = DLOG_DEBUG; level <= DLOG_ERROR; ++level) {
+      if (CheckLogLevel(GE_MODULE_NAME, level) == 1) {
+        mask |= (1U << static_cast<uint32_t>(level));
+      }
+    }
+    GetLevelLoadTime().store(GetNowMs(), std::memory_order_relaxed);
+    GetLevelMask().store(mask, std::memory_order_relaxed);
+    return mask;
+  }
 };
 
 inline bool IsLogEnable(int module_name, int log_level) {
+  if ((module_name == GE_MODULE_NAME) && (log_level >= DLOG_DEBUG) && (log_level <= DLOG_ERROR)) {
+    return GeLog::IsLevelEnable(log_level);
+  }
   int32_t enable = CheckLogLevel(module_name, log_level);
   // 1:enable, 0:disable
   return (enable == 1);
@@ -58,15 +115,25 @@ inline bool IsLogEnable(int module_name, int log_level) {
 #define GELOGE(ERROR_CODE, fmt, ...)                                                                    \
   dlog_error(GE_MODULE_NAME, "%lu %s: ErrorNo: %d(%s) " fmt, GeLog::GetTid(), __FUNCTION__, ERROR_CODE, \
              ((GE_GET_ERRORNO_STR(ERROR_CODE)).c_str()), ##__VA_ARGS__)
-#define GELOGW(fmt, ...)                      \
-  if (IsLogEnable(GE_MODULE_NAME, DLOG_WARN)) \
-  dlog_warn(GE_MODULE_NAME, "%lu %s:" fmt, GeLog::GetTid(), __FUNCTION__, ##__VA_ARGS__)
-#define GELOGI(fmt, ...)                      \
-  if (IsLogEnable(GE_MODULE_NAME, DLOG_INFO)) \
-  dlog_info(GE_MODULE_NAME, "%lu %s:" fmt, GeLog::GetTid(), __FUNCTION__, ##__VA_ARGS__)
-#define GELOGD(fmt, ...)                       \
-  if (IsLogEnable(GE_MODULE_NAME, DLOG_DEBUG)) \
-  dlog_debug(GE_MODULE_NAME, "%lu %s:" fmt, GeLog::GetTid(), __FUNCTION__, ##__VA_ARGS__)
+// The arguments are only evaluated when the level is enabled
+#define GELOGW(fmt, ...)                                                                           \
+  do {                                                                                             \
+    if (IsLogEnable(GE_MODULE_NAME, DLOG_WARN)) {                                                  \
+      dlog_warn(GE_MODULE_NAME, "%lu %s:" fmt, GeLog::GetTid(), __FUNCTION__, ##__VA_ARGS__);      \
+    }                                                                                              \
+  } while (0)
+#define GELOGI(fmt, ...)                                                                           \
+  do {                                                                                             \
+    if (IsLogEnable(GE_MODULE_NAME, DLOG_INFO)) {                                                  \
+      dlog_info(GE_MODULE_NAME, "%lu %s:" fmt, GeLog::GetTid(), __FUNCTION__, ##__VA_ARGS__);      \
+    }                                                                                              \
+  } while (0)
+#define GELOGD(fmt, ...)                                                                           \
+  do {                                                                                             \
+    if (IsLogEnable(GE_MODULE_NAME, DLOG_DEBUG)) {                                                 \
+      dlog_debug(GE_MODULE_NAME, "%lu %s:" fmt, GeLog::GetTid(), __FUNCTION__, ##__VA_ARGS__);     \
+    }                                                                                              \
+  } while (0)
 
 #define GEEVENT(fmt, ...) dlog_event(GE_MODULE_NAME, "%lu %s:" fmt, GeLog::GetTid(), __FUNCTION__, ##__VA_ARGS__)
 